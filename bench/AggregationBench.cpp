@@ -0,0 +1,249 @@
+/**
+ * @file AggregationBench.cpp
+ * @brief Medição das consultas sobre todas as playlists (PlaylistAggregator)
+ * com diferentes números de threads.
+ *
+ * Cria playlists com músicas sorteadas do catálogo (as primeiras músicas são
+ * mais comuns, como em bibliotecas reais) e, para cada número de threads,
+ * mede as músicas e os autores presentes em mais playlists, exatos e
+ * aproximados, e o histograma de tamanhos, com o ganho em relação a uma
+ * thread. Os resultados são conferidos com uma contagem simples: as
+ * contagens exatas devem ser iguais às reais, com qualquer número de
+ * threads, e as aproximadas devem ficar entre a real e a real mais o erro
+ * informado.
+ *
+ * Retorna 1 se algum resultado não conferir.
+ *
+ * Uso: aggregationBench [playlists] [músicas] [resumo] [threads...]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+#include "PlaylistAggregator.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//! Número de músicas e autores de cada classificação.
+static const size_t rankSize = 10;
+
+//! Contagem real de playlists por música.
+typedef std::unordered_map<const Song*, size_t, SongHash, SongEqual> SongCounts;
+//! Contagem real de playlists por autor.
+typedef std::unordered_map<std::string, size_t> AuthorCounts;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em milissegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Milissegundos decorridos.
+ */
+static double milliseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Conta, percorrendo cada playlist, em quantas playlists cada música
+ * e cada autor aparecem.
+ *
+ * @param playlists Playlists.
+ * @param songs Recebe as contagens das músicas.
+ * @param authors Recebe as contagens dos autores.
+ */
+static void countAll(LinkedList<Playlist> &playlists, SongCounts &songs, AuthorCounts &authors){
+    for(Node<Playlist> *node = playlists.getHead(); node != nullptr; node = node->getNext()){
+        SongSet seen;
+        std::unordered_map<std::string, bool> seenAuthors;
+        for(const Node<Song> *curr = node->getValue().readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+            const Song &song = curr->getValue();
+            if(seen.insert(&song).second){
+                songs[&song]++;
+            }
+            std::string author = song.getAuthorKey().str();
+            if(!author.empty() && seenAuthors.insert(std::make_pair(author, true)).second){
+                authors[author]++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Confere uma classificação com as contagens reais: cada contagem
+ * deve estar entre a real e a real mais o erro, e as contagens exatas devem
+ * ser as maiores contagens reais, em ordem.
+ *
+ * @param subject O que foi contado.
+ * @param ranked Classificação obtida.
+ * @param songs Contagens reais das músicas.
+ * @param authors Contagens reais dos autores.
+ * @param largest Maiores contagens reais, em ordem decrescente.
+ * @return true se a classificação confere.
+ */
+static bool matches(PlaylistAggregator::Subject subject, const std::vector<PlaylistAggregator::Ranked> &ranked,
+                    SongCounts &songs, AuthorCounts &authors, const std::vector<size_t> &largest){
+    for(size_t i = 0; i < ranked.size(); i++){
+        size_t real;
+        if(subject == PlaylistAggregator::Songs){
+            Song song(ranked[i].title, ranked[i].author);
+            SongCounts::iterator found = songs.find(&song);
+            real = (found != songs.end()) ? found->second : 0;
+        }
+        else{
+            AuthorCounts::iterator found = authors.find(Song("", ranked[i].author).getAuthorKey().str());
+            real = (found != authors.end()) ? found->second : 0;
+        }
+        if(ranked[i].count < real || ranked[i].count - ranked[i].error > real){
+            return false;
+        }
+        if(ranked[i].error == 0 && (i >= largest.size() || ranked[i].count != largest[i])){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Playlists, músicas do catálogo, itens dos resumos aproximados e
+ * os números de threads medidos (por padrão 1, 2, 4, 8 e um por núcleo).
+ * @return 0 se todos os resultados conferem, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t playlistCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t songCount = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    size_t capacity = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 4096;
+    std::vector<unsigned> threadCounts;
+    for(int i = 4; i < argc; i++){
+        threadCounts.push_back((unsigned)std::strtoul(argv[i], nullptr, 10));
+    }
+    if(threadCounts.empty()){
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned count = 1; count <= std::max(8u, cores); count *= 2){
+            threadCounts.push_back(count);
+        }
+        if(cores > 8 && std::find(threadCounts.begin(), threadCounts.end(), cores) == threadCounts.end()){
+            threadCounts.push_back(cores);
+        }
+    }
+    if(songCount == 0){
+        std::cerr << "Uso: aggregationBench [playlists] [músicas] [resumo] [threads...]\n";
+        return 1;
+    }
+
+    std::mt19937 random(7);
+    std::vector<Song> catalog;
+    catalog.reserve(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        catalog.push_back(Song("Música " + std::to_string(i), "Autor " + std::to_string(i % 3000)));
+    }
+    std::vector<double> weights(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        weights[i] = 1.0 / std::pow(i + 1.0, 0.8);
+    }
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    // Playlists de 1 a 60 músicas, algumas com até 400 e algumas vazias
+    Clock::time_point begin = Clock::now();
+    size_t entries = 0;
+    LinkedList<Playlist> playlists;
+    for(size_t p = 0; p < playlistCount; p++){
+        playlists.add(Playlist("Playlist " + std::to_string(p)));
+        size_t size = (random() % 200 == 0) ? 0 : 1 + random() % ((random() % 10 == 0) ? 400 : 60);
+        std::vector<Song*> chosen;
+        for(size_t k = 0; k < size; k++){
+            chosen.push_back(&catalog[pick(random)]);
+        }
+        playlists.getTail()->getValue().addSongs(chosen);
+        entries += size;
+    }
+    std::cout << playlistCount << " playlists com " << entries << " músicas criadas em "
+              << milliseconds(begin) / 1000 << " s\n";
+
+    begin = Clock::now();
+    SongCounts songs;
+    AuthorCounts authors;
+    countAll(playlists, songs, authors);
+    std::vector<size_t> largestSongs, largestAuthors;
+    for(SongCounts::iterator it = songs.begin(); it != songs.end(); ++it){
+        largestSongs.push_back(it->second);
+    }
+    for(AuthorCounts::iterator it = authors.begin(); it != authors.end(); ++it){
+        largestAuthors.push_back(it->second);
+    }
+    std::sort(largestSongs.rbegin(), largestSongs.rend());
+    std::sort(largestAuthors.rbegin(), largestAuthors.rend());
+    std::cout << "Contagem simples, com uma thread: " << milliseconds(begin) << " ms\n\n";
+
+    std::cout << "threads\tmúsicas\taprox.\tautores\taprox.\thistograma\tganho\n";
+    bool failed = false;
+    double single = 0;
+    for(size_t t = 0; t < threadCounts.size(); t++){
+        PlaylistAggregator aggregator(playlists, threadCounts[t]);
+        std::vector<PlaylistAggregator::Ranked> ranked;
+        double times[5];
+        double total = 0;
+
+        PlaylistAggregator::Subject subjects[2] = {PlaylistAggregator::Songs, PlaylistAggregator::Authors};
+        for(int s = 0; s < 2; s++){
+            const std::vector<size_t> &largest = (s == 0) ? largestSongs : largestAuthors;
+            begin = Clock::now();
+            aggregator.top(subjects[s], rankSize, ranked);
+            times[2 * s] = milliseconds(begin);
+            if(!matches(subjects[s], ranked, songs, authors, largest)){
+                std::cout << "Erro: classificação exata diferente da contagem real com "
+                          << aggregator.getThreads() << " threads.\n";
+                failed = true;
+            }
+            begin = Clock::now();
+            aggregator.approximateTop(subjects[s], rankSize, capacity, ranked);
+            times[2 * s + 1] = milliseconds(begin);
+            if(!matches(subjects[s], ranked, songs, authors, largest)){
+                std::cout << "Erro: contagem aproximada fora do erro informado com "
+                          << aggregator.getThreads() << " threads.\n";
+                failed = true;
+            }
+        }
+
+        std::vector<PlaylistAggregator::SizeBucket> histogram;
+        begin = Clock::now();
+        aggregator.sizeHistogram(histogram);
+        times[4] = milliseconds(begin);
+        size_t counted = 0;
+        for(size_t i = 0; i < histogram.size(); i++){
+            counted += histogram[i].playlists;
+        }
+        if(counted != playlistCount){
+            std::cout << "Erro: o histograma não conta todas as playlists.\n";
+            failed = true;
+        }
+
+        for(int i = 0; i < 5; i++){
+            total += times[i];
+        }
+        if(t == 0){
+            single = total;
+        }
+        std::cout << aggregator.getThreads();
+        for(int i = 0; i < 5; i++){
+            std::cout << "\t" << times[i] << " ms";
+        }
+        std::cout << "\t" << single / total << "x\n";
+    }
+    std::cout << "\nNúcleos disponíveis: " << std::max(1u, std::thread::hardware_concurrency())
+              << "; o ganho é relativo à primeira linha.\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file ColumnarScanBench.cpp
+ * @brief Medição das buscas sem índice no catálogo: a cópia em colunas
+ * (ColumnarCatalog, com as funções vetorizadas de ScanKernels) contra a
+ * passagem pela lista encadeada.
+ *
+ * Para cada consulta, os títulos ou autores normalizados de todas as músicas
+ * são percorridos das duas formas, e são exibidos o tempo da melhor de
+ * algumas passagens e a vazão, em GB/s de texto percorrido. As duas formas
+ * devem encontrar as mesmas músicas.
+ *
+ * Retorna 1 se algum resultado não conferir.
+ *
+ * Uso: columnarScanBench [músicas] [passagens]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "TextView.hpp"
+#include "SearchIndex.hpp"
+#include "ColumnarCatalog.hpp"
+#include "ScanKernels.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Consulta medida.
+ */
+struct Query{
+    const char *label; //!< Descrição exibida.
+    std::string text; //!< Texto procurado, antes da normalização.
+    ColumnarCatalog::Field field; //!< Campo consultado.
+    bool equal; //!< Indica se o campo deve ser igual ao texto, e não apenas contê-lo.
+};
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em milissegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Milissegundos decorridos.
+ */
+static double milliseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Busca percorrendo a lista encadeada, como antes da cópia em colunas.
+ *
+ * @param catalog Catálogo.
+ * @param key Texto normalizado.
+ * @param query Consulta.
+ * @param result Recebe as músicas encontradas, na ordem do catálogo.
+ */
+static void linkedScan(LinkedList<Song> &catalog, const std::string &key, const Query &query, std::vector<Song*> &result){
+    for(Node<Song> *curr = catalog.getHead(); curr != nullptr; curr = curr->getNext()){
+        Song &song = curr->getValue();
+        TextView text = (query.field == ColumnarCatalog::Title) ? song.getTitleKey() : song.getAuthorKey();
+        bool found = query.equal ? text == TextView(key) :
+                     std::search(text.begin(), text.end(), key.begin(), key.end()) != text.end();
+        if(found){
+            result.push_back(&song);
+        }
+    }
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Músicas do catálogo e passagens por consulta.
+ * @return 0 se as duas formas encontram as mesmas músicas, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t songCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    int rounds = (argc > 2) ? std::atoi(argv[2]) : 5;
+    if(songCount == 0 || rounds <= 0){
+        std::cerr << "Uso: columnarScanBench [músicas] [passagens]\n";
+        return 1;
+    }
+
+    const char *words[] = {"Amor", "Noite", "Canção", "Coração", "Estrada", "Lua", "Mar", "Saudade",
+                           "Sol", "Vento", "Cidade", "Rio", "Tempo", "Sonho", "Fogo", "Chuva"};
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    std::mt19937 random(5);
+    Clock::time_point begin = Clock::now();
+    LinkedList<Song> catalog;
+    Node<Song>::reserve(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        std::string title = std::string(words[random() % wordCount]) + " " + words[random() % wordCount] + " " + std::to_string(i);
+        catalog.add(Song(title, "Intérprete " + std::to_string(random() % 20000)));
+    }
+    ColumnarCatalog columns;
+    columns.build(catalog);
+    std::cout << songCount << " músicas criadas em " << milliseconds(begin) / 1000 << " s; "
+              << columns.getTextBytes() / 1048576.0 << " MB de texto nas colunas; funções: "
+              << scanImplementation() << "\n\n";
+
+    std::vector<Query> queries;
+    queries.push_back(Query{"título contém \"ção\"", "ção", ColumnarCatalog::Title, false});
+    queries.push_back(Query{"título contém \"lua mar\"", "Lua Mar", ColumnarCatalog::Title, false});
+    queries.push_back(Query{"título contém texto raro", "Sonho Fogo 4242", ColumnarCatalog::Title, false});
+    queries.push_back(Query{"autor contém \"99\"", "99", ColumnarCatalog::Author, false});
+    queries.push_back(Query{"autor igual", "Intérprete 1234", ColumnarCatalog::Author, true});
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "consulta\tresultados\tlista (ms)\tlista (GB/s)\tcolunas (ms)\tcolunas (GB/s)\tganho\n";
+    bool failed = false;
+    for(size_t q = 0; q < queries.size(); q++){
+        const Query &query = queries[q];
+        std::string key = SearchIndex::normalize(query.text);
+
+        // Texto percorrido: os campos de todas as músicas, iguais nas duas formas
+        size_t bytes = 0;
+        for(Node<Song> *curr = catalog.getHead(); curr != nullptr; curr = curr->getNext()){
+            const Song &song = curr->getValue();
+            bytes += (query.field == ColumnarCatalog::Title) ? song.getTitleKey().size() : song.getAuthorKey().size();
+        }
+
+        std::vector<Song*> linked, columnar;
+        double linkedTime = 0, columnarTime = 0;
+        for(int r = 0; r < rounds; r++){
+            linked.clear();
+            begin = Clock::now();
+            linkedScan(catalog, key, query, linked);
+            double elapsed = milliseconds(begin);
+            linkedTime = (r == 0) ? elapsed : std::min(linkedTime, elapsed);
+
+            columnar.clear();
+            begin = Clock::now();
+            if(query.equal){
+                columns.findEqual(key, query.field, columnar);
+            }
+            else{
+                columns.findSubstring(key, query.field, columnar);
+            }
+            elapsed = milliseconds(begin);
+            columnarTime = (r == 0) ? elapsed : std::min(columnarTime, elapsed);
+        }
+
+        std::cout << query.label << "\t" << columnar.size() << "\t\t" << linkedTime << "\t\t"
+                  << bytes / (linkedTime * 1e6) << "\t\t" << columnarTime << "\t\t"
+                  << bytes / (columnarTime * 1e6) << "\t\t" << linkedTime / columnarTime << "x\n";
+        if(linked != columnar){
+            std::cout << "Erro: as duas buscas encontraram músicas diferentes.\n";
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
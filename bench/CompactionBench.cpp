@@ -0,0 +1,238 @@
+/**
+ * @file CompactionBench.cpp
+ * @brief Medição da memória e do tempo de percorrer as playlists antes e
+ * depois da compactação (Library::compact), em uma biblioteca desgastada por
+ * alterações.
+ *
+ * As playlists crescem intercaladas, uma música de cada vez, de modo que os
+ * nós de cada uma ficam espalhados pela memória. Depois, uma thread que
+ * continua em execução até o fim da medição faz rodadas de alterações
+ * (remove uma música e adiciona outra em playlists sorteadas, publicando a
+ * cada rodada) e remove uma parte das músicas de cada playlist. Os espaços
+ * liberados por ela ficam na sua própria lista de espaços livres, que a
+ * compactação também precisa ver (NodePool::trim).
+ *
+ * São exibidos a reserva de nós das músicas, a memória residente do
+ * processo e o menor tempo de algumas passagens por todas as playlists, antes
+ * e depois da compactação. As passagens também leem o tamanho das chaves dos
+ * títulos, que ficam nos textos das músicas; a compactação só move os nós,
+ * então essa parte das passagens não fica em sequência.
+ *
+ * Retorna 1 se as passagens não somarem o mesmo valor antes e depois, ou se
+ * a compactação não devolver memória quando músicas foram removidas.
+ *
+ * Uso: compactionBench [playlists] [músicas por playlist] [catálogo] [rodadas] [% removida]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+#include "MemoryReport.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//! Número de passagens medidas; vale a mais rápida.
+static const int scanRounds = 5;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em milissegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Milissegundos decorridos.
+ */
+static double milliseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Percorre todas as músicas das playlists publicadas algumas vezes,
+ * somando as durações e o tamanho dos títulos, como fazem as consultas.
+ *
+ * @param library Biblioteca percorrida.
+ * @param sum Recebe a soma, para que as passagens não sejam descartadas.
+ * @return Tempo da passagem mais rápida, em milissegundos.
+ */
+static double scan(Library &library, unsigned long long &sum){
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+    double best = 0;
+    for(int r = 0; r < scanRounds; r++){
+        Clock::time_point begin = Clock::now();
+        sum = 0;
+        for(size_t i = 0; i < snapshot->playlists.size(); i++){
+            const LinkedList<Song> &songs = snapshot->playlists[i]->readSongs();
+            for(const Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+                sum += curr->getValue().getDuration() + curr->getValue().getTitleKey().size();
+            }
+        }
+        double elapsed = milliseconds(begin);
+        best = (r == 0) ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+/**
+ * @brief Cria o catálogo e as playlists, adicionando uma música a cada
+ * playlist por vez.
+ *
+ * @param library Biblioteca preenchida.
+ * @param playlists Número de playlists.
+ * @param size Músicas por playlist.
+ * @param songs Músicas do catálogo.
+ * @param random Gerador usado para sortear as músicas.
+ * @param catalog Recebe as músicas do catálogo.
+ */
+static void fill(Library &library, size_t playlists, size_t size, size_t songs, std::mt19937 &random,
+                 std::vector<Song*> &catalog){
+    Library::Editor editor(library);
+    for(size_t i = 0; i < songs; i++){
+        Song song("Música número " + std::to_string(i), "Autor " + std::to_string(i % 5000));
+        song.setDuration(100 + i % 300);
+        editor.songs().add(song);
+        catalog.push_back(&editor.songs().getTail()->getValue());
+        editor.index().add(catalog.back());
+    }
+    std::vector<Playlist*> created;
+    for(size_t p = 0; p < playlists; p++){
+        editor.playlists().add(Playlist("Playlist " + std::to_string(p)));
+        created.push_back(&editor.playlists().getTail()->getValue());
+    }
+    for(size_t k = 0; k < size; k++){
+        for(size_t p = 0; p < playlists; p++){
+            created[p]->addSong(*catalog[random() % songs]);
+        }
+    }
+    editor.history().clear();
+}
+
+/**
+ * @brief Faz rodadas de alterações, cada uma em um editor, removendo uma
+ * música e adicionando outra em um quarto das playlists, e por fim remove
+ * uma parte das músicas de cada playlist.
+ *
+ * @param library Biblioteca alterada.
+ * @param rounds Número de rodadas.
+ * @param percent Porcentagem das músicas removidas no final.
+ * @param random Gerador usado para sortear as alterações.
+ * @param catalog Músicas do catálogo.
+ */
+static void churn(Library &library, size_t rounds, unsigned percent, std::mt19937 &random,
+                  const std::vector<Song*> &catalog){
+    for(size_t r = 0; r < rounds; r++){
+        Library::Editor editor(library);
+        EditHistory::Pause pause(&editor.history());
+        std::vector<Playlist*> playlists;
+        for(Node<Playlist> *curr = editor.playlists().getHead(); curr != nullptr; curr = curr->getNext()){
+            playlists.push_back(&curr->getValue());
+        }
+        for(size_t k = 0; k < playlists.size() / 4; k++){
+            Playlist *playlist = playlists[random() % playlists.size()];
+            const Node<Song> *curr = playlist->readSongs().getHead();
+            for(size_t skip = random() % (playlist->getSize() + 1); skip > 0 && curr != nullptr && curr->getNext() != nullptr; skip--){
+                curr = curr->getNext();
+            }
+            if(curr != nullptr){
+                playlist->removeSong(curr->getValue());
+            }
+            playlists[random() % playlists.size()]->addSong(*catalog[random() % catalog.size()]);
+        }
+    }
+    Library::Editor editor(library);
+    EditHistory::Pause pause(&editor.history());
+    for(Node<Playlist> *curr = editor.playlists().getHead(); curr != nullptr; curr = curr->getNext()){
+        curr->getValue().getSongs().removeIf([&random, percent](Song &){
+            return random() % 100 < percent;
+        });
+    }
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Playlists, músicas por playlist, músicas do catálogo, rodadas
+ * de alterações e porcentagem das músicas removidas no final.
+ * @return 0 se as passagens conferem e a memória foi devolvida, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t playlists = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 50;
+    size_t songs = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 200000;
+    size_t rounds = (argc > 4) ? std::strtoul(argv[4], nullptr, 10) : 40;
+    unsigned percent = (argc > 5) ? (unsigned)std::strtoul(argv[5], nullptr, 10) : 70;
+    if(playlists == 0 || songs == 0){
+        std::cerr << "Uso: compactionBench [playlists] [músicas por playlist] [catálogo] [rodadas] [% removida]\n";
+        return 1;
+    }
+
+    Library library;
+    std::mt19937 random(7);
+    std::vector<Song*> catalog;
+    Clock::time_point begin = Clock::now();
+    fill(library, playlists, size, songs, random, catalog);
+    std::cout << playlists << " playlists com " << size << " músicas, de um catálogo de " << songs
+              << ", criadas em " << milliseconds(begin) / 1000 << " s\n";
+
+    // A thread das alterações só termina depois da compactação
+    std::atomic<bool> churned(false);
+    std::atomic<bool> measured(false);
+    begin = Clock::now();
+    std::thread editor([&](){
+        churn(library, rounds, percent, random, catalog);
+        churned = true;
+        while(!measured){
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while(!churned){
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::cout << rounds << " rodadas de alterações e " << percent << "% das músicas removidas em "
+              << milliseconds(begin) / 1000 << " s\n\n";
+
+    unsigned long long before, after;
+    size_t reservedBefore = NodePool<sizeof(Node<Song>)>::getReservedBytes();
+    size_t residentBefore = MemoryReport::residentBytes();
+    double scanBefore = scan(library, before);
+
+    begin = Clock::now();
+    size_t released = library.compact();
+    double compaction = milliseconds(begin);
+
+    size_t reservedAfter = NodePool<sizeof(Node<Song>)>::getReservedBytes();
+    size_t residentAfter = MemoryReport::residentBytes();
+    double scanAfter = scan(library, after);
+    measured = true;
+    editor.join();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\tnós (MB)\tresidente (MB)\tpassagem (ms)\n";
+    std::cout << "antes\t" << reservedBefore / 1048576.0 << "\t\t" << residentBefore / 1048576.0
+              << "\t\t" << scanBefore << "\n";
+    std::cout << "depois\t" << reservedAfter / 1048576.0 << "\t\t" << residentAfter / 1048576.0
+              << "\t\t" << scanAfter << "\n";
+    std::cout << "Compactação: " << compaction << " ms, " << released / 1048576.0
+              << " MB de nós devolvidos ao sistema\n";
+
+    if(before != after){
+        std::cout << "Erro: as playlists mudaram com a compactação.\n";
+        return 1;
+    }
+    if(percent > 0 && released == 0){
+        std::cout << "Erro: nenhum bloco de nós foi devolvido ao sistema.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file LibraryStressBench.cpp
+ * @brief Medição da biblioteca (Library) com vários leitores e escritores ao
+ * mesmo tempo.
+ *
+ * Primeiro, mede o custo de uma publicação: um editor que adiciona uma música
+ * ao catálogo, um que altera uma playlist e um que não altera nada. Depois,
+ * N threads leem versões publicadas enquanto M threads fazem alterações, e
+ * são exibidas as leituras e alterações por segundo.
+ *
+ * Cada escritor adiciona a mesma música, em um único editor, a duas
+ * playlists suas (e ao catálogo), e às vezes remove a música mais antiga das
+ * duas. Os leitores conferem que, em toda versão, as duas playlists de cada
+ * escritor são iguais e que as versões nunca voltam. Retorna 1 se alguma
+ * leitura viu uma alteração pela metade.
+ *
+ * Uso: libraryStressBench [leitores] [escritores] [segundos] [músicas] [playlists]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "Library.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//! Músicas mantidas em cada playlist de escritor; acima disso, a mais antiga sai.
+static const size_t writerPlaylistSize = 64;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em microssegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Microssegundos decorridos.
+ */
+static double microseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Adiciona uma música nova ao catálogo do editor, como o comando
+ * ADD_SONG do servidor.
+ *
+ * @param editor Editor da biblioteca.
+ * @param song Música adicionada.
+ * @return Ponteiro para a música no catálogo.
+ */
+static Song *addToCatalog(Library::Editor &editor, const Song &song){
+    editor.songs().add(song);
+    Song *added = &editor.songs().getTail()->getValue();
+    editor.index().add(added);
+    return added;
+}
+
+/**
+ * @brief Cria a biblioteca inicial: o catálogo e playlists com 50 músicas do
+ * catálogo cada, além das duas playlists de cada escritor.
+ *
+ * @param library Biblioteca preenchida.
+ * @param songs Número de músicas do catálogo.
+ * @param playlists Número de playlists.
+ * @param writers Número de escritores.
+ */
+static void fill(Library &library, size_t songs, size_t playlists, size_t writers){
+    Library::Editor editor(library);
+    std::vector<Song*> catalog;
+    for(size_t i = 0; i < songs; i++){
+        catalog.push_back(addToCatalog(editor, Song("Música " + std::to_string(i), "Autor " + std::to_string(i % 997))));
+    }
+    std::mt19937 random(1);
+    for(size_t i = 0; i < playlists; i++){
+        editor.playlists().add(Playlist("Playlist " + std::to_string(i)));
+        std::vector<Song*> chosen;
+        for(size_t k = 0; k < 50 && !catalog.empty(); k++){
+            chosen.push_back(catalog[random() % catalog.size()]);
+        }
+        editor.playlists().getTail()->getValue().addSongs(chosen);
+    }
+    for(size_t w = 0; w < writers; w++){
+        editor.playlists().add(Playlist("Escritor " + std::to_string(w) + " A"));
+        editor.playlists().add(Playlist("Escritor " + std::to_string(w) + " B"));
+    }
+    editor.history().clear();
+}
+
+/**
+ * @brief Mede o tempo médio de editores que fazem a mesma alteração.
+ *
+ * @param library Biblioteca alterada.
+ * @param label Descrição exibida.
+ * @param rounds Número de editores.
+ * @param change Alteração feita em cada editor, recebendo o editor e o número da rodada.
+ */
+template <typename Change>
+static void measurePublish(Library &library, const std::string &label, size_t rounds, Change change){
+    Clock::time_point begin = Clock::now();
+    for(size_t i = 0; i < rounds; i++){
+        Library::Editor editor(library);
+        change(editor, i);
+    }
+    std::cout << label << ": " << microseconds(begin) / rounds << " us por editor\n";
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Leitores, escritores, segundos, músicas e playlists.
+ * @return 0 se todas as versões lidas estavam completas, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t readers = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4;
+    size_t writers = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 2;
+    double seconds = (argc > 3) ? std::atof(argv[3]) : 3;
+    size_t songs = (argc > 4) ? std::strtoul(argv[4], nullptr, 10) : 1000000;
+    size_t playlists = (argc > 5) ? std::strtoul(argv[5], nullptr, 10) : 20000;
+
+    Library library;
+    Clock::time_point begin = Clock::now();
+    fill(library, songs, playlists, writers);
+    std::cout << songs << " músicas e " << playlists << " playlists criadas em " << microseconds(begin) / 1e6 << " s\n";
+
+    // Custo de uma publicação, sem concorrência
+    size_t rounds = 200;
+    measurePublish(library, "Editor sem alterações", rounds, [](Library::Editor &, size_t){});
+    measurePublish(library, "Música adicionada ao catálogo", rounds, [](Library::Editor &editor, size_t i){
+        addToCatalog(editor, Song("Medição " + std::to_string(i), "Medição"));
+    });
+    measurePublish(library, "Música adicionada a uma playlist", rounds, [](Library::Editor &editor, size_t i){
+        Playlist *pl = editor.playlists().searchValue(Playlist("Playlist 0"));
+        if(pl != nullptr){
+            pl->addSong(editor.songs().getHead()->getValue());
+            if(i % 2 == 1){
+                pl->removeSong(editor.songs().getHead()->getValue());
+            }
+        }
+    });
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> inconsistent(false);
+    std::vector<unsigned long long> reads(readers, 0);
+    std::vector<unsigned long long> writes(writers, 0);
+    std::vector<std::thread> threads;
+
+    for(size_t r = 0; r < readers; r++){
+        threads.push_back(std::thread([&, r](){
+            std::mt19937 random(r + 1);
+            unsigned long long lastVersion = 0;
+            while(!stop.load(std::memory_order_relaxed)){
+                std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+                if(snapshot->version < lastVersion){
+                    inconsistent = true;
+                }
+                lastVersion = snapshot->version;
+                // Um par de playlists de escritor, procurado pelo nome
+                std::string name = "Escritor " + std::to_string(writers > 0 ? random() % writers : 0);
+                const Playlist *a = snapshot->findPlaylist(name + " A");
+                const Playlist *b = snapshot->findPlaylist(name + " B");
+                if(writers > 0 && (a == nullptr || b == nullptr)){
+                    inconsistent = true;
+                }
+                else if(a != nullptr){
+                    const Node<Song> *x = a->readSongs().getHead();
+                    const Node<Song> *y = b->readSongs().getHead();
+                    while(x != nullptr && y != nullptr && x->getValue().equals(y->getValue())){
+                        x = x->getNext();
+                        y = y->getNext();
+                    }
+                    if(x != nullptr || y != nullptr){
+                        inconsistent = true;
+                    }
+                }
+                reads[r]++;
+            }
+        }));
+    }
+    for(size_t w = 0; w < writers; w++){
+        threads.push_back(std::thread([&, w](){
+            std::string name = "Escritor " + std::to_string(w);
+            while(!stop.load(std::memory_order_relaxed)){
+                Library::Editor editor(library);
+                Song *song = addToCatalog(editor, Song(name + " " + std::to_string(writes[w]), name));
+                Playlist *a = editor.playlists().searchValue(Playlist(name + " A"));
+                Playlist *b = editor.playlists().searchValue(Playlist(name + " B"));
+                a->addSong(*song);
+                b->addSong(*song);
+                if(a->getSize() > writerPlaylistSize){
+                    Song oldest = a->readSongs().getHead()->getValue();
+                    a->removeSong(oldest);
+                    b->removeSong(oldest);
+                }
+                writes[w]++;
+            }
+        }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for(size_t i = 0; i < threads.size(); i++){
+        threads[i].join();
+    }
+
+    unsigned long long totalReads = 0;
+    unsigned long long totalWrites = 0;
+    for(size_t r = 0; r < readers; r++){
+        totalReads += reads[r];
+    }
+    for(size_t w = 0; w < writers; w++){
+        totalWrites += writes[w];
+    }
+    std::cout << readers << " leitores e " << writers << " escritores por " << seconds << " s: "
+              << totalReads / seconds << " leituras/s, " << totalWrites / seconds << " alterações/s\n";
+
+    if(inconsistent){
+        std::cout << "Erro: uma leitura viu uma versão incompleta.\n";
+        return 1;
+    }
+    std::cout << "Todas as versões lidas estavam completas.\n";
+    return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file SimilarityBench.cpp
+ * @brief Medição das assinaturas MinHash (PlaylistSignature) e do índice de
+ * playlists parecidas (SimilarityIndex).
+ *
+ * Cria playlists com músicas sorteadas do catálogo (as primeiras músicas são
+ * mais comuns, como em bibliotecas reais) e, para algumas delas, uma cópia
+ * com parte das músicas trocadas. Mede:
+ * - o custo de manter a assinatura a cada música adicionada;
+ * - o erro da semelhança estimada em relação à semelhança de Jaccard exata,
+ *   nos pares de cópias;
+ * - a criação e a atualização do índice;
+ * - a busca de playlists parecidas, comparada a percorrer todas as
+ *   assinaturas e a calcular a semelhança exata com todas as playlists;
+ * - a busca de pares quase iguais e quantos pares de cópias ela encontra.
+ *
+ * Retorna 1 se o erro da estimativa passar do esperado para assinaturas de
+ * PlaylistSignature::size funções, ou se a busca deixar de encontrar as
+ * cópias muito parecidas.
+ *
+ * Uso: similarityBench [playlists] [músicas] [cópias] [threads]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_set>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+#include "PlaylistSignature.hpp"
+#include "SimilarityIndex.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//! Semelhança mínima usada nas buscas de playlists parecidas.
+static const double similarThreshold = 0.5;
+//! Semelhança mínima usada na busca de pares quase iguais.
+static const double duplicateThreshold = 0.8;
+//! Semelhança exata a partir da qual a busca deve encontrar a cópia.
+static const double expectedFound = 0.7;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em milissegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Milissegundos decorridos.
+ */
+static double milliseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Calcula a semelhança de Jaccard exata entre as músicas de duas playlists.
+ *
+ * @param a Uma playlist.
+ * @param b Outra playlist.
+ * @return Músicas em comum dividido pelas músicas das duas, sem repetições.
+ */
+static double exactSimilarity(Playlist &a, Playlist &b){
+    SongSet first;
+    for(const Node<Song> *curr = a.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+        first.insert(&curr->getValue());
+    }
+    SongSet second;
+    size_t common = 0;
+    for(const Node<Song> *curr = b.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+        if(second.insert(&curr->getValue()).second && first.count(&curr->getValue()) > 0){
+            common++;
+        }
+    }
+    size_t total = first.size() + second.size() - common;
+    return total > 0 ? (double)common / total : 1.0;
+}
+
+/**
+ * @brief Par formado por uma playlist e sua cópia alterada.
+ */
+struct Planted{
+    Playlist *original; //!< Playlist original.
+    Playlist *copy; //!< Cópia com parte das músicas trocadas.
+    double exact; //!< Semelhança de Jaccard exata entre as duas.
+};
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Playlists, músicas do catálogo, cópias e threads (0 para uma por núcleo).
+ * @return 0 se a estimativa e as buscas ficaram dentro do esperado, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t playlistCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t songCount = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    size_t plantedCount = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 2000;
+    unsigned threads = (argc > 4) ? (unsigned)std::strtoul(argv[4], nullptr, 10) : 0;
+    if(songCount == 0 || plantedCount > playlistCount){
+        std::cerr << "Uso: similarityBench [playlists] [músicas] [cópias] [threads]\n";
+        return 1;
+    }
+
+    std::mt19937 random(7);
+    std::vector<Song> catalog;
+    catalog.reserve(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        catalog.push_back(Song("Música " + std::to_string(i), "Autor " + std::to_string(i % 3000)));
+    }
+    std::vector<double> weights(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        weights[i] = 1.0 / std::pow(i + 1.0, 0.8);
+    }
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    // Playlists de 20 a 60 músicas
+    Clock::time_point begin = Clock::now();
+    size_t entries = 0;
+    LinkedList<Playlist> playlists;
+    for(size_t p = 0; p < playlistCount; p++){
+        playlists.add(Playlist("Playlist " + std::to_string(p)));
+        std::vector<Song*> chosen;
+        size_t size = 20 + random() % 41;
+        for(size_t k = 0; k < size; k++){
+            chosen.push_back(&catalog[pick(random)]);
+        }
+        playlists.getTail()->getValue().addSongs(chosen);
+        entries += size;
+    }
+
+    // Cópias com 0% a 50% das músicas trocadas
+    std::vector<Planted> planted;
+    Node<Playlist> *source = playlists.getHead();
+    for(size_t p = 0; p < plantedCount; p++, source = source->getNext()){
+        std::vector<const Song*> chosen;
+        double swapped = 0.5 * p / (plantedCount > 1 ? plantedCount - 1 : 1);
+        for(const Node<Song> *curr = source->getValue().readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+            bool swap = std::uniform_real_distribution<double>(0, 1)(random) < swapped;
+            chosen.push_back(swap ? &catalog[random() % songCount] : &curr->getValue());
+        }
+        playlists.add(Playlist("Cópia " + std::to_string(p)));
+        playlists.getTail()->getValue().addSongs(chosen);
+        entries += chosen.size();
+
+        Planted pair;
+        pair.original = &source->getValue();
+        pair.copy = &playlists.getTail()->getValue();
+        pair.exact = exactSimilarity(*pair.original, *pair.copy);
+        planted.push_back(pair);
+    }
+    std::cout << playlistCount + plantedCount << " playlists com " << entries << " músicas criadas em "
+              << milliseconds(begin) / 1000 << " s\n";
+
+    // Custo de manter a assinatura
+    begin = Clock::now();
+    size_t added = 0;
+    PlaylistSignature signature;
+    for(size_t round = 0; added < 2000000; round++){
+        signature.clear();
+        for(size_t i = 0; i < songCount && added < 2000000; i++, added++){
+            signature.add(catalog[(i * 7919 + round) % songCount]);
+        }
+    }
+    std::cout << "Assinatura: " << milliseconds(begin) * 1e6 / added << " ns por música adicionada\n";
+
+    // Estimativa x semelhança exata
+    double squared = 0, bias = 0, squaredHigh = 0;
+    size_t high = 0;
+    for(size_t i = 0; i < planted.size(); i++){
+        double estimate = planted[i].original->getSignature().similarity(planted[i].copy->getSignature());
+        double difference = estimate - planted[i].exact;
+        squared += difference * difference;
+        bias += difference;
+        if(planted[i].exact >= duplicateThreshold){
+            squaredHigh += difference * difference;
+            high++;
+        }
+    }
+    double rmse = planted.empty() ? 0 : std::sqrt(squared / planted.size());
+    // Desvio padrão de uma estimativa com semelhança 0,5, o pior caso, com
+    // uma folga para as funções de hash, que não são independentes
+    double expected = 1.2 * 0.5 / std::sqrt((double)PlaylistSignature::size);
+    std::cout << "Estimativa x Jaccard exato em " << planted.size() << " pares: erro quadrático médio " << rmse
+              << " (esperado até " << expected << "), viés " << (planted.empty() ? 0 : bias / planted.size());
+    if(high > 0){
+        std::cout << ", erro com semelhança >= " << duplicateThreshold << ": " << std::sqrt(squaredHigh / high);
+    }
+    std::cout << "\n";
+
+    // Criação e atualização do índice
+    SimilarityIndex index;
+    begin = Clock::now();
+    index.update(playlists);
+    std::cout << "Índice criado em " << milliseconds(begin) << " ms\n";
+    begin = Clock::now();
+    index.update(playlists);
+    std::cout << "Atualização sem alterações: " << milliseconds(begin) << " ms\n";
+    size_t changed = std::min<size_t>(100, playlistCount);
+    Node<Playlist> *curr = playlists.getHead();
+    for(size_t i = 0; i < changed; i++, curr = curr->getNext()){
+        curr->getValue().addSong(catalog[random() % songCount]);
+    }
+    begin = Clock::now();
+    index.update(playlists);
+    std::cout << "Atualização com " << changed << " playlists alteradas: " << milliseconds(begin) << " ms\n";
+    for(size_t i = 0; i < planted.size(); i++){
+        planted[i].exact = exactSimilarity(*planted[i].original, *planted[i].copy);
+    }
+
+    // Busca de playlists parecidas
+    std::vector<SimilarityIndex::Match> matches;
+    size_t eligible = 0, found = 0;
+    begin = Clock::now();
+    for(size_t i = 0; i < planted.size(); i++){
+        index.findSimilar(*planted[i].original, similarThreshold, matches);
+        if(planted[i].exact >= expectedFound){
+            eligible++;
+            std::string name = planted[i].copy->getName();
+            for(size_t m = 0; m < matches.size(); m++){
+                if(matches[m].name == name){
+                    found++;
+                    break;
+                }
+            }
+        }
+    }
+    double indexed = planted.empty() ? 0 : milliseconds(begin) / planted.size();
+
+    size_t queries = std::min<size_t>(20, planted.size());
+    begin = Clock::now();
+    size_t scanned = 0;
+    for(size_t i = 0; i < queries; i++){
+        const PlaylistSignature &wanted = planted[i].original->getSignature();
+        for(Node<Playlist> *node = playlists.getHead(); node != nullptr; node = node->getNext()){
+            if(wanted.similarity(node->getValue().getSignature()) >= similarThreshold){
+                scanned++;
+            }
+        }
+    }
+    double scan = queries > 0 ? milliseconds(begin) / queries : 0;
+    size_t exactQueries = std::min<size_t>(3, planted.size());
+    begin = Clock::now();
+    for(size_t i = 0; i < exactQueries; i++){
+        for(Node<Playlist> *node = playlists.getHead(); node != nullptr; node = node->getNext()){
+            if(exactSimilarity(*planted[i].original, node->getValue()) >= similarThreshold){
+                scanned++;
+            }
+        }
+    }
+    double exact = exactQueries > 0 ? milliseconds(begin) / exactQueries : 0;
+    std::cout << "Busca de parecidas (>= " << similarThreshold << "): " << indexed << " ms com o índice, "
+              << scan << " ms percorrendo as assinaturas, " << exact << " ms com a semelhança exata\n";
+    std::cout << "Cópias com semelhança >= " << expectedFound << " encontradas: " << found << " de " << eligible << "\n";
+
+    // Pares quase iguais
+    std::vector<SimilarityIndex::Pair> pairs;
+    begin = Clock::now();
+    index.findDuplicates(duplicateThreshold, threads, pairs);
+    double duplicates = milliseconds(begin);
+    std::unordered_set<std::string> reported;
+    for(size_t i = 0; i < pairs.size(); i++){
+        reported.insert(pairs[i].first + "\n" + pairs[i].second);
+        reported.insert(pairs[i].second + "\n" + pairs[i].first);
+    }
+    size_t nearCopies = 0, nearFound = 0;
+    for(size_t i = 0; i < planted.size(); i++){
+        if(planted[i].exact >= duplicateThreshold){
+            nearCopies++;
+            if(reported.count(planted[i].original->getName() + "\n" + planted[i].copy->getName()) > 0){
+                nearFound++;
+            }
+        }
+    }
+    std::cout << "Pares quase iguais (>= " << duplicateThreshold << "): " << pairs.size() << " em " << duplicates
+              << " ms; cópias com semelhança exata >= " << duplicateThreshold << " encontradas: "
+              << nearFound << " de " << nearCopies << "\n";
+
+    bool failed = false;
+    if(rmse > expected){
+        std::cout << "Erro: a estimativa passou do erro esperado.\n";
+        failed = true;
+    }
+    if(found < eligible * 0.9){
+        std::cout << "Erro: a busca deixou de encontrar cópias muito parecidas.\n";
+        failed = true;
+    }
+    return failed ? 1 : 0;
+}
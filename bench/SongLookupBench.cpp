@@ -0,0 +1,157 @@
+/**
+ * @file SongLookupBench.cpp
+ * @brief Medição da procura de uma música do catálogo pela identidade
+ * (título e autor, pela impressão digital de 64 bits) contra a passagem
+ * pela lista comparando só o título, como era feito antes.
+ *
+ * O catálogo tem vários autores para cada título. Cada forma procura as
+ * mesmas músicas sorteadas: SongSet e SearchIndex::find pela impressão
+ * digital, e a passagem pela lista pelo primeiro título igual. São exibidos
+ * o tempo médio por procura e quantas procuras devolveram outra música.
+ *
+ * Retorna 1 se SongSet ou SearchIndex::find devolverem alguma música errada.
+ *
+ * Uso: songLookupBench [músicas] [procuras] [procuras na lista]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "SearchIndex.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//! Número de autores diferentes de cada título.
+static const size_t authorsPerTitle = 3;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em nanossegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Nanossegundos decorridos.
+ */
+static double nanoseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Procura a primeira música do catálogo com o mesmo título, sem olhar
+ * o autor.
+ *
+ * @param catalog Catálogo.
+ * @param song Música procurada.
+ * @return A música encontrada, ou nullptr.
+ */
+static Song *scanTitle(LinkedList<Song> &catalog, const Song &song){
+    for(Node<Song> *curr = catalog.getHead(); curr != nullptr; curr = curr->getNext()){
+        if(curr->getValue().compareTitle(song) == 0){
+            return &curr->getValue();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Exibe uma linha de resultado.
+ *
+ * @param label Forma de procura.
+ * @param lookups Número de procuras.
+ * @param elapsed Tempo total, em nanossegundos.
+ * @param wrong Procuras que devolveram outra música.
+ */
+static void report(const char *label, size_t lookups, double elapsed, size_t wrong){
+    std::cout << label << "\t" << lookups << "\t\t" << elapsed / lookups << "\t\t" << wrong << "\n";
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Músicas do catálogo, procuras pela identidade e procuras pela
+ * passagem na lista, que custa O(n) cada.
+ * @return 0 se as procuras pela identidade acertaram todas, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t songCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t lookups = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    size_t scans = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 200;
+    if(songCount == 0 || lookups == 0){
+        std::cerr << "Uso: songLookupBench [músicas] [procuras] [procuras na lista]\n";
+        return 1;
+    }
+
+    LinkedList<Song> catalog;
+    SongSet set;
+    SearchIndex index;
+    Clock::time_point begin = Clock::now();
+    Node<Song>::reserve(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        catalog.add(Song("Música " + std::to_string(i / authorsPerTitle), "Autor " + std::to_string(i % 7919)));
+    }
+    std::vector<Song*> songs;
+    for(Node<Song> *curr = catalog.getHead(); curr != nullptr; curr = curr->getNext()){
+        songs.push_back(&curr->getValue());
+        set.insert(&curr->getValue());
+        index.add(&curr->getValue());
+    }
+    std::cout << songCount << " músicas (" << authorsPerTitle << " autores por título) indexadas em "
+              << nanoseconds(begin) / 1e9 << " s\n\n";
+
+    // Cópias das músicas sorteadas, como as que chegam de um arquivo ou de um cliente
+    std::mt19937 random(11);
+    std::vector<Song> wanted;
+    for(size_t i = 0; i < lookups; i++){
+        wanted.push_back(*songs[random() % songs.size()]);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "forma\t\tprocuras\tns/procura\tmúsica errada\n";
+    size_t wrong = 0;
+    begin = Clock::now();
+    for(size_t i = 0; i < lookups; i++){
+        SongSet::const_iterator found = set.find(&wanted[i]);
+        if(found == set.end() || !(*found)->equals(wanted[i])){
+            wrong++;
+        }
+    }
+    report("SongSet", lookups, nanoseconds(begin), wrong);
+    bool failed = wrong > 0;
+
+    wrong = 0;
+    begin = Clock::now();
+    for(size_t i = 0; i < lookups; i++){
+        Song *found = index.find(wanted[i]);
+        if(found == nullptr || !found->equals(wanted[i])){
+            wrong++;
+        }
+    }
+    report("SearchIndex", lookups, nanoseconds(begin), wrong);
+    failed = failed || wrong > 0;
+
+    if(scans > lookups){
+        scans = lookups;
+    }
+    wrong = 0;
+    begin = Clock::now();
+    for(size_t i = 0; i < scans; i++){
+        Song *found = scanTitle(catalog, wanted[i]);
+        if(found == nullptr || !found->equals(wanted[i])){
+            wrong++;
+        }
+    }
+    report("lista (título)", scans, nanoseconds(begin), wrong);
+
+    if(failed){
+        std::cout << "Erro: a procura pela identidade devolveu uma música errada.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file SortBench.cpp
+ * @brief Medição da ordenação de listas de músicas (LinkedList::sort) em uma
+ * thread e dividida entre várias threads.
+ *
+ * Cria uma lista de músicas com títulos sorteados, com repetições, e, para
+ * cada número de threads, ordena uma cópia da lista pelo título, com o ganho
+ * em relação a uma thread. Cada música guarda a posição original no número
+ * de execuções, para conferir que a ordenação é estável: músicas com o mesmo
+ * título mantêm a ordem de inserção.
+ *
+ * Retorna 1 se alguma ordenação não conferir.
+ *
+ * Uso: sortBench [músicas] [threads...]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongOrder.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em milissegundos.
+ *
+ * @param begin Instante inicial.
+ * @return Milissegundos decorridos.
+ */
+static double milliseconds(Clock::time_point begin){
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Confere que a lista está ordenada pelo título e que músicas com o
+ * mesmo título estão na ordem de inserção.
+ *
+ * @param songs Lista ordenada.
+ * @param order Ordenação usada.
+ * @param size Número de músicas esperado.
+ * @return true se a ordenação confere.
+ */
+static bool sorted(const LinkedList<Song> &songs, const SongOrder &order, size_t size){
+    size_t count = 0;
+    const Node<Song> *prev = nullptr;
+    for(const Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+        if(prev != nullptr){
+            if(order(curr->getValue(), prev->getValue())){
+                return false;
+            }
+            if(!order(prev->getValue(), curr->getValue()) && prev->getValue().getPlays() > curr->getValue().getPlays()){
+                return false;
+            }
+        }
+        prev = curr;
+        count++;
+    }
+    return count == size;
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Músicas da lista e os números de threads medidos (por padrão
+ * 1, 2, 4, 8 e um por núcleo).
+ * @return 0 se todas as ordenações conferem, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t songCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    std::vector<unsigned> threadCounts;
+    for(int i = 2; i < argc; i++){
+        threadCounts.push_back((unsigned)std::strtoul(argv[i], nullptr, 10));
+    }
+    if(threadCounts.empty()){
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned count = 1; count <= std::max(8u, cores); count *= 2){
+            threadCounts.push_back(count);
+        }
+        if(cores > 8 && std::find(threadCounts.begin(), threadCounts.end(), cores) == threadCounts.end()){
+            threadCounts.push_back(cores);
+        }
+    }
+    if(songCount == 0){
+        std::cerr << "Uso: sortBench [músicas] [threads...]\n";
+        return 1;
+    }
+
+    // Títulos sorteados entre um quarto do número de músicas, para haver empates
+    std::mt19937 random(3);
+    Clock::time_point begin = Clock::now();
+    LinkedList<Song> songs;
+    Node<Song>::reserve(songCount);
+    for(size_t i = 0; i < songCount; i++){
+        Song song("Música " + std::to_string(random() % (songCount / 4 + 1)), "Autor " + std::to_string(i % 5000));
+        song.setPlays((unsigned)i);
+        songs.add(song);
+    }
+    std::cout << songCount << " músicas criadas em " << milliseconds(begin) / 1000 << " s\n\n";
+
+    SongOrder order{SongOrder::Title};
+    std::cout << "threads\tordenação\tganho\n";
+    bool failed = false;
+    double single = 0;
+    for(size_t t = 0; t < threadCounts.size(); t++){
+        LinkedList<Song> copy(songs);
+        begin = Clock::now();
+        copy.sort(order, threadCounts[t]);
+        double elapsed = milliseconds(begin);
+        if(t == 0){
+            single = elapsed;
+        }
+        std::cout << threadCounts[t] << "\t" << elapsed << " ms\t" << single / elapsed << "x\n";
+        if(!sorted(copy, order, songCount)){
+            std::cout << "Erro: a lista ordenada com " << threadCounts[t] << " threads não confere.\n";
+            failed = true;
+        }
+    }
+    std::cout << "\nNúcleos disponíveis: " << std::max(1u, std::thread::hardware_concurrency())
+              << "; o ganho é relativo à primeira linha. Listas com menos de "
+              << +LinkedList<Song>::parallelSortThreshold << " músicas são ordenadas em uma thread.\n";
+    return failed ? 1 : 0;
+}
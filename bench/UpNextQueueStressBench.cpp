@@ -0,0 +1,253 @@
+/**
+ * @file UpNextQueueStressBench.cpp
+ * @brief Medição da fila de músicas a tocar em seguida (UpNextQueue) e da
+ * fila circular sem travas (MpscRing) com vários produtores ao mesmo tempo.
+ *
+ * Primeiro, confere que limpar a fila vale mesmo quando as músicas pendentes
+ * estão cheias e há um pedido esperando espaço. Depois, N produtores enviam
+ * valores à fila circular, e o consumidor confere que os valores de cada
+ * produtor chegam todos, uma vez e em ordem. Por fim, N produtores disputam
+ * a fila de músicas com pedidos de adicionar ao fim, ao início e limpar,
+ * enquanto uma thread envia rodadas de músicas maiores que a fila, cada uma
+ * seguida de um pedido de limpar, e a reprodução tira músicas devagar, para
+ * que a fila fique cheia. Depois de tirar uma música de uma rodada, nenhuma
+ * música das rodadas anteriores pode ser tirada. São exibidos os pedidos por
+ * segundo.
+ *
+ * Retorna 1 se alguma verificação falhar.
+ *
+ * Uso: upNextQueueStressBench [produtores] [pedidos por produtor] [capacidade]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+#include "Song.hpp"
+#include "MpscRing.hpp"
+#include "UpNextQueue.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Retorna o tempo decorrido desde um instante, em segundos.
+ *
+ * @param begin Instante inicial.
+ * @return Segundos decorridos.
+ */
+static double seconds(Clock::time_point begin){
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+/**
+ * @brief Confere, em uma thread, que limpar a fila descarta as músicas
+ * pendentes cheias e o pedido que esperava espaço.
+ *
+ * @param capacity Capacidade da fila.
+ * @return true se a fila ficou vazia depois de limpar.
+ */
+static bool clearWhenFull(size_t capacity){
+    std::vector<Song> songs(4 * capacity + 4, Song("Música"));
+    UpNextQueue queue(capacity);
+
+    // Cada getSize aplica o pedido anterior; o último fica esperando espaço
+    size_t filled = 0;
+    while(filled < songs.size() - 1 && queue.push(&songs[filled]) && queue.getSize() == filled + 1){
+        filled++;
+    }
+    bool accepted = queue.push(&songs.back());
+    bool cleared = queue.clear();
+    const Song *next = queue.take();
+    if(!accepted || !cleared || next != nullptr){
+        std::cout << "Erro: limpar com " << filled << " músicas pendentes não esvaziou a fila.\n";
+        return false;
+    }
+    queue.push(&songs[0]);
+    if(queue.take() != &songs[0] || queue.take() != nullptr){
+        std::cout << "Erro: a fila não voltou a funcionar depois de limpar.\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Confere que os valores de cada produtor chegam à fila circular
+ * todos, uma vez e em ordem.
+ *
+ * @param producers Número de produtores.
+ * @param requests Valores enviados por produtor.
+ * @param capacity Capacidade da fila.
+ * @return true se nenhum valor foi perdido, repetido ou trocado de ordem.
+ */
+static bool ringOrder(size_t producers, size_t requests, size_t capacity){
+    MpscRing<size_t> ring(capacity);
+    std::atomic<size_t> full(0);
+    std::vector<std::thread> threads;
+    Clock::time_point begin = Clock::now();
+    for(size_t p = 0; p < producers; p++){
+        threads.push_back(std::thread([&ring, &full, p, requests](){
+            size_t retries = 0;
+            for(size_t i = 0; i < requests; i++){
+                while(!ring.push(p * requests + i)){
+                    retries++;
+                    std::this_thread::yield();
+                }
+            }
+            full += retries;
+        }));
+    }
+
+    std::vector<size_t> next(producers, 0);
+    size_t received = 0, wrong = 0, value;
+    while(received < producers * requests){
+        if(!ring.pop(value)){
+            std::this_thread::yield();
+            continue;
+        }
+        size_t producer = value / requests;
+        if(producer >= producers || value % requests != next[producer]){
+            wrong++;
+        }
+        else{
+            next[producer]++;
+        }
+        received++;
+    }
+    for(size_t p = 0; p < producers; p++){
+        threads[p].join();
+    }
+    double elapsed = seconds(begin);
+
+    std::cout << "MpscRing\t" << received / elapsed / 1e6 << " M valores/s, " << full
+              << " tentativas com a fila cheia, " << wrong << " fora de ordem\n";
+    if(wrong > 0){
+        std::cout << "Erro: a fila circular perdeu, repetiu ou trocou a ordem de valores.\n";
+    }
+    return wrong == 0;
+}
+
+/**
+ * @brief Disputa a fila de músicas entre vários produtores e confere que
+ * cada pedido de limpar descarta as rodadas anteriores a ele.
+ *
+ * @param producers Número de produtores de pedidos sorteados.
+ * @param requests Pedidos por produtor.
+ * @param capacity Capacidade da fila.
+ * @return true se nenhuma música inválida ou de uma rodada já limpa foi tirada.
+ */
+static bool queueContention(size_t producers, size_t requests, size_t capacity){
+    const size_t rounds = 200;
+    const size_t roundSize = 2 * capacity;
+    std::vector<Song> noise(1000, Song("Sorteada"));
+    std::vector<Song> marked(rounds * roundSize, Song("Rodada"));
+    UpNextQueue queue(capacity);
+
+    std::atomic<size_t> accepted(0);
+    std::atomic<size_t> finished(0);
+    std::vector<std::thread> threads;
+    Clock::time_point begin = Clock::now();
+    for(size_t p = 0; p < producers; p++){
+        threads.push_back(std::thread([&, p](){
+            std::mt19937 random((unsigned)p + 1);
+            size_t sent = 0;
+            for(size_t i = 0; i < requests; i++){
+                const Song *song = &noise[random() % noise.size()];
+                unsigned kind = random() % 10;
+                sent += kind < 7 ? queue.push(song) : kind < 9 ? queue.insertNext(song) : queue.clear();
+                if(i % 8 == 0){
+                    std::this_thread::yield();
+                }
+            }
+            accepted += sent;
+            finished++;
+        }));
+    }
+    // Rodadas maiores que a fila, cada uma seguida de limpar
+    threads.push_back(std::thread([&](){
+        size_t sent = 0;
+        for(size_t r = 0; r < rounds; r++){
+            for(size_t i = 0; i < roundSize; i++){
+                sent += queue.push(&marked[r * roundSize + i]);
+            }
+            while(!queue.clear()){
+                std::this_thread::yield();
+            }
+            sent++;
+            std::this_thread::yield();
+        }
+        accepted += sent;
+        finished++;
+    }));
+
+    // Reprodução lenta: só tira uma música a cada poucas consultas
+    size_t taken = 0, invalid = 0, stale = 0, polls = 0;
+    size_t lastRound = 0;
+    bool done = false;
+    while(!done){
+        done = (finished == producers + 1);
+        // As músicas pendentes têm a capacidade arredondada para uma potência de 2
+        if(queue.getSize() > 2 * capacity){
+            invalid++;
+        }
+        if(polls++ % 4 != 0 && !done){
+            std::this_thread::yield();
+            continue;
+        }
+        const Song *song;
+        while((song = queue.take()) != nullptr){
+            taken++;
+            if(song >= &marked[0] && song <= &marked.back()){
+                size_t round = (song - &marked[0]) / roundSize;
+                if(round < lastRound){
+                    stale++;
+                }
+                lastRound = std::max(lastRound, round);
+            }
+            else if(song < &noise[0] || song > &noise.back()){
+                invalid++;
+            }
+            if(!done){
+                break;
+            }
+        }
+    }
+    for(size_t p = 0; p < threads.size(); p++){
+        threads[p].join();
+    }
+    double elapsed = seconds(begin);
+
+    std::cout << "UpNextQueue\t" << accepted / elapsed / 1e6 << " M pedidos/s, " << taken << " músicas tiradas, "
+              << invalid << " inválidas, " << stale << " de rodadas já limpas\n";
+    if(invalid > 0 || stale > 0){
+        std::cout << "Erro: a fila de músicas devolveu uma música inválida ou de uma rodada já limpa.\n";
+    }
+    return invalid == 0 && stale == 0;
+}
+
+/**
+ * @brief Executa a medição.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Produtores, pedidos por produtor e capacidade das filas.
+ * @return 0 se todas as verificações passaram, 1 caso contrário.
+ */
+int main(int argc, char **argv){
+    size_t producers = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4;
+    size_t requests = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    size_t capacity = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 64;
+    if(producers == 0 || requests == 0 || capacity == 0){
+        std::cerr << "Uso: upNextQueueStressBench [produtores] [pedidos por produtor] [capacidade]\n";
+        return 1;
+    }
+
+    bool passed = clearWhenFull(4);
+    passed = clearWhenFull(capacity) && passed;
+    passed = ringOrder(producers, requests, capacity) && passed;
+    passed = queueContention(producers, requests, capacity) && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file ColumnarCatalog.hpp
+ * @brief Arquivo que contém a classe ColumnarCatalog.
+ */
+
+#ifndef COLUMNARCATALOG_HPP
+#define COLUMNARCATALOG_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "TextView.hpp"
+#include "Song.hpp"
+#include "LinkedList.hpp"
+
+/**
+ * @brief Classe que guarda uma cópia em colunas dos títulos e autores do catálogo,
+ * para buscas que não podem usar um índice.
+ *
+ * Os textos normalizados de cada campo ficam em um único bloco contíguo, separados
+ * por um byte nulo, com vetores de posições, tamanhos e hashes por música. Assim,
+ * uma busca por trecho percorre o bloco inteiro com as funções vetorizadas de
+ * ScanKernels.hpp, em vez de seguir os ponteiros da lista encadeada.
+ *
+ * @note A cópia não acompanha alterações do catálogo; use isValid para saber se
+ * ela precisa ser reconstruída.
+ */
+class ColumnarCatalog{
+
+public:
+    /**
+     * @brief Campo da música consultado.
+     */
+    enum Field{
+        Title, //!< Título da música.
+        Author //!< Autor da música.
+    };
+
+private:
+    /**
+     * @brief Coluna de texto de um campo.
+     */
+    struct Column{
+        std::vector<char> arena; //!< Textos de todas as músicas, separados por '\0'.
+        std::vector<uint32_t> offsets; //!< Posição do texto de cada música no bloco.
+        std::vector<uint32_t> lengths; //!< Tamanho do texto de cada música.
+        std::vector<uint64_t> hashes; //!< Hash do texto de cada música.
+    };
+
+    std::vector<Song*> songs; //!< Música correspondente a cada linha.
+    Column titles; //!< Coluna dos títulos normalizados.
+    Column authors; //!< Coluna dos autores normalizados.
+    unsigned long long version; //!< Versão do catálogo copiado, ou 0 se não foi construído.
+
+    // Adiciona um texto ao fim de uma coluna.
+    static void appendText(Column &column, TextView text);
+
+public:
+    // Construtor da cópia vazia.
+    ColumnarCatalog();
+    // Remove todas as músicas da cópia.
+    void clear();
+    // Adiciona uma música, com os campos já normalizados.
+    void append(Song *song, TextView title, TextView author);
+    // Reconstrói a cópia a partir do catálogo.
+    void build(LinkedList<Song> &catalog);
+    // Verifica se a cópia ainda corresponde ao catálogo.
+    bool isValid(LinkedList<Song> &catalog) const;
+    // Retorna o número de músicas da cópia.
+    size_t getSize() const;
+    // Retorna o número de bytes de texto das colunas.
+    size_t getTextBytes() const;
+    // Retorna a memória ocupada pela cópia.
+    size_t getBytes() const;
+    // Busca as músicas cujo campo contém o texto normalizado.
+    void findSubstring(const std::string &key, Field field, std::vector<Song*> &result) const;
+    // Busca as músicas cujo campo é igual ao texto normalizado.
+    void findEqual(const std::string &key, Field field, std::vector<Song*> &result) const;
+};
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @file EditHistory.hpp
+ * @brief Arquivo que contém a classe EditHistory, que permite desfazer e refazer alterações.
+ */
+
+#ifndef EDITHISTORY_HPP
+#define EDITHISTORY_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <unordered_map>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongOrder.hpp"
+#include "Playlist.hpp"
+#include "SearchIndex.hpp"
+
+/**
+ * @brief Histórico das alterações do catálogo, da lista de playlists e das
+ * músicas de cada playlist, que permite desfazê-las e refazê-las.
+ *
+ * Cada alteração é guardada como a operação que a desfaz, e não como uma
+ * cópia da lista: músicas ou playlists adicionadas ao final guardam apenas
+ * quantas foram adicionadas, e as retiradas guardam suas posições e os próprios nós,
+ * que saem da lista sem serem copiados nem destruídos. Registrar uma
+ * alteração custa O(1), mais o custo de percorrer os elementos adicionados ou
+ * de guardar os retirados, e adições seguidas à mesma lista ocupam uma única
+ * operação.
+ *
+ * As operações são agrupadas em passos: tudo o que é registrado entre begin e
+ * end (ou durante um Batch) é desfeito de uma vez. O histórico guarda no
+ * máximo maxSteps passos e maxBytes bytes estimados, descartando os passos
+ * mais antigos.
+ *
+ * Cada operação guarda a versão que a lista tinha depois da alteração. Se a
+ * lista mudou sem que a mudança fosse registrada, a operação não pode ser
+ * desfeita com segurança; nesse caso o histórico é descartado e undo retorna
+ * Conflict.
+ *
+ * @note Deve ser usado com a trava de escrita da biblioteca obtida.
+ */
+class EditHistory{
+
+public:
+    /**
+     * @brief Resultado de undo e redo.
+     */
+    enum Result{
+        Applied, //!< O passo foi desfeito ou refeito.
+        Nothing, //!< Não há passo para desfazer ou refazer.
+        Conflict //!< As listas mudaram sem registro; o histórico foi descartado.
+    };
+
+    /**
+     * @brief Agrupa em um único passo as alterações registradas enquanto existir.
+     */
+    class Batch{
+        EditHistory *history; //!< Histórico, ou nullptr para não agrupar nada.
+
+    public:
+        // Construtor, que abre o passo.
+        Batch(EditHistory *history, const std::string &label, bool extend = false);
+        // Destrutor, que fecha o passo.
+        ~Batch();
+    };
+
+    /**
+     * @brief Suspende o registro das alterações enquanto existir.
+     */
+    class Pause{
+        EditHistory *history; //!< Histórico, ou nullptr.
+
+    public:
+        // Construtor, que suspende o registro.
+        Pause(EditHistory *history);
+        // Destrutor, que retoma o registro.
+        ~Pause();
+    };
+
+private:
+    /**
+     * @brief Tipo de uma operação guardada.
+     */
+    enum Kind{
+        Truncate, //!< Retira os count últimos nós.
+        Append, //!< Devolve os nós guardados ao final da lista.
+        Erase, //!< Retira os nós das posições indicadas.
+        Restore, //!< Devolve os nós guardados às posições indicadas.
+        Reorder, //!< Leva o nó de cada posição i para a posição positions[i].
+        Replace //!< Troca os nós da lista pelos guardados.
+    };
+
+    /**
+     * @brief Lista alterada por uma operação.
+     */
+    enum Target{
+        Catalog, //!< Catálogo de músicas.
+        Playlists, //!< Lista de playlists.
+        Songs //!< Músicas da playlist name.
+    };
+
+    /**
+     * @brief Operação que desfaz (ou refaz) uma alteração.
+     */
+    struct Operation{
+        Kind kind; //!< Tipo da operação.
+        Target target; //!< Lista alterada.
+        std::string name; //!< Nome da playlist, no alvo Songs.
+        unsigned long long expected; //!< Versão que a lista deve ter para a operação ser aplicada.
+        unsigned long long result; //!< Versão da lista depois de a operação ser aplicada.
+        size_t count; //!< Número de nós retirados do final, em Truncate.
+        std::vector<uint32_t> positions; //!< Posições, em Erase, Restore e Reorder, em ordem crescente nas duas primeiras.
+        LinkedList<Song> songs; //!< Músicas guardadas, em Append, Restore e Replace.
+        LinkedList<Playlist> playlists; //!< Playlists guardadas, em Append e Restore.
+        size_t bytes; //!< Memória estimada da operação.
+    };
+
+    /**
+     * @brief Alterações desfeitas ou refeitas juntas.
+     */
+    struct Step{
+        std::string label; //!< Descrição do passo.
+        std::deque<Operation> operations; //!< Operações, aplicadas da última para a primeira.
+        size_t bytes; //!< Memória estimada das operações.
+    };
+
+    LinkedList<Song> &catalog; //!< Catálogo de músicas.
+    LinkedList<Playlist> &playlists; //!< Lista de playlists.
+    SearchIndex &index; //!< Índice de busca, que acompanha as músicas que entram e saem do catálogo.
+    std::deque<Step> undoSteps; //!< Passos que podem ser desfeitos, do mais antigo ao mais recente.
+    std::deque<Step> redoSteps; //!< Passos desfeitos que podem ser refeitos, do mais antigo ao mais recente.
+    std::unordered_map<unsigned long long, unsigned long long> equivalent; //!< Versão registrada equivalente à versão atual de uma lista desfeita ou refeita.
+    size_t maxSteps; //!< Número máximo de passos guardados.
+    size_t maxBytes; //!< Memória máxima estimada dos passos guardados.
+    size_t bytes; //!< Memória estimada dos passos guardados.
+    unsigned depth; //!< Número de begin sem o end correspondente.
+    unsigned paused; //!< Número de Pause existentes.
+    std::string batchLabel; //!< Descrição do passo aberto por begin.
+    bool batchExtends; //!< Indica se o passo aberto pode continuar o último passo.
+    bool batchOpen; //!< Indica se o passo aberto já foi criado.
+    bool extendable; //!< Indica se o último passo pode ser continuado por um passo com a mesma descrição.
+
+    // Retorna a versão registrada equivalente a uma versão.
+    unsigned long long logical(unsigned long long version) const;
+    // Retorna o passo que recebe uma nova operação, criando-o se preciso.
+    Step &current(Target target, const std::string &name);
+    // Acrescenta uma operação ao passo atual.
+    Operation *start(Kind kind, Target target, const std::string &name, unsigned long long prior);
+    // Completa uma operação acrescentada por start.
+    void finish(Operation &operation, unsigned long long version);
+    // Registra elementos adicionados ao final de uma lista.
+    void appended(Target target, const std::string &name, unsigned long long prior, size_t count, unsigned long long version);
+    // Retira o primeiro elemento escolhido de uma lista, guardando-o.
+    template <typename T, typename Match>
+    bool take(Target target, const std::string &name, LinkedList<T> &list, Match matches);
+    // Ordena uma lista de músicas, registrando a ordem anterior.
+    void sortList(Target target, const std::string &name, LinkedList<Song> &list, const SongOrder &order);
+    // Aplica uma operação a uma lista, montando a operação inversa.
+    template <typename T>
+    static void apply(Operation &operation, LinkedList<T> &list, Operation &inverse);
+    // Retorna as músicas guardadas por uma operação.
+    static LinkedList<Song> &held(Operation &operation, LinkedList<Song> &list);
+    // Retorna as playlists guardadas por uma operação.
+    static LinkedList<Playlist> &held(Operation &operation, LinkedList<Playlist> &list);
+    // Estima a memória de uma operação.
+    static size_t sizeOf(Operation &operation);
+    // Desfaz o último passo de uma pilha, guardando o inverso na outra.
+    Result replay(std::deque<Step> &from, std::deque<Step> &to, std::string &label);
+    // Descarta os passos mais antigos enquanto os limites forem excedidos.
+    void trim();
+
+public:
+    // Construtor, que acompanha as listas da biblioteca.
+    EditHistory(LinkedList<Song> &catalog, LinkedList<Playlist> &playlists, SearchIndex &index,
+                size_t maxSteps = 100, size_t maxBytes = 64 << 20);
+    // Abre um passo que agrupa as próximas alterações.
+    void begin(const std::string &label, bool extend = false);
+    // Fecha o passo aberto por begin.
+    void end();
+    // Registra músicas adicionadas ao final do catálogo.
+    void catalogAppended(unsigned long long prior, Node<Song> *lastKnown);
+    // Registra playlists adicionadas ao final da lista de playlists.
+    void playlistsAppended(unsigned long long prior, Node<Playlist> *lastKnown);
+    // Registra músicas adicionadas ao final de uma playlist.
+    void songsAppended(Playlist &playlist, unsigned long long prior, Node<Song> *lastKnown);
+    // Registra músicas retiradas de uma playlist.
+    void songsErased(Playlist &playlist, unsigned long long prior, std::vector<uint32_t> &positions, LinkedList<Song> &removed);
+    // Registra a troca de todas as músicas de uma playlist.
+    void songsReplaced(Playlist &playlist, unsigned long long prior, LinkedList<Song> &previous);
+    // Registra que as músicas de uma playlist mudaram de lugar na memória, sem outra alteração.
+    void songsRelocated(Playlist &playlist, unsigned long long prior);
+    // Remove uma música do catálogo, guardando-a no histórico.
+    bool removeFromCatalog(const Song &song);
+    // Remove uma playlist pelo nome, guardando-a no histórico.
+    bool removePlaylist(const std::string &name);
+    // Remove as playlists escolhidas, guardando-as no histórico.
+    template <typename Predicate>
+    size_t removePlaylistsIf(Predicate matches);
+    // Remove a primeira ocorrência de uma música de uma playlist, guardando-a no histórico.
+    bool removeFromPlaylist(Playlist &playlist, const Song &song);
+    // Ordena o catálogo, registrando a ordem anterior.
+    void sortCatalog(const SongOrder &order);
+    // Ordena as músicas de uma playlist, registrando a ordem anterior.
+    void sortSongs(Playlist &playlist, const SongOrder &order);
+    // Desfaz o último passo.
+    Result undo(std::string &label);
+    // Refaz o último passo desfeito.
+    Result redo(std::string &label);
+    // Descarta todos os passos.
+    void clear();
+    // Retorna o número de passos que podem ser desfeitos.
+    size_t getUndoSteps() const;
+    // Retorna o número de passos que podem ser refeitos.
+    size_t getRedoSteps() const;
+    // Retorna a memória estimada dos passos guardados.
+    size_t getBytes() const;
+};
+
+/**
+ * @brief Remove, em uma única passagem, as playlists escolhidas por um
+ * predicado. Os nós vão para o histórico, que pode devolvê-los às mesmas
+ * posições.
+ *
+ * @param matches Predicado que recebe uma playlist e retorna true se ela deve ser removida.
+ * @return Número de playlists removidas.
+ */
+template <typename Predicate>
+size_t EditHistory::removePlaylistsIf(Predicate matches){
+    unsigned long long prior = playlists.getVersion();
+    LinkedList<Playlist> removed;
+    std::vector<uint32_t> positions;
+    Node<Playlist> *prev = nullptr;
+    Node<Playlist> *curr = playlists.getHead();
+    for(uint32_t position = 0; curr != nullptr; position++){
+        Node<Playlist> *next = curr->getNext();
+        if(matches(curr->getValue())){
+            removed.spliceAfter(removed.getTail(), playlists, prev, curr);
+            positions.push_back(position);
+        }
+        else{
+            prev = curr;
+        }
+        curr = next;
+    }
+    if(positions.empty()){
+        return 0;
+    }
+
+    size_t count = positions.size();
+    Operation *operation = start(Restore, Playlists, "", prior);
+    if(operation != nullptr){
+        operation->positions.swap(positions);
+        operation->playlists = std::move(removed);
+        finish(*operation, playlists.getVersion());
+    }
+    return count;
+}
+
+#endif
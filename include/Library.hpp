@@ -0,0 +1,154 @@
+/**
+ * @file Library.hpp
+ * @brief Arquivo que contém a classe Library.
+ */
+
+#ifndef LIBRARY_HPP
+#define LIBRARY_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "SearchIndex.hpp"
+#include "SmartPlaylists.hpp"
+#include "EditHistory.hpp"
+
+/**
+ * @brief Classe que reúne as músicas, as playlists e o índice de busca do sistema,
+ * permitindo que várias threads os usem ao mesmo tempo.
+ *
+ * As alterações são feitas por um Editor, que garante que apenas uma thread
+ * altera a biblioteca por vez. Quando o Editor termina, uma nova versão
+ * imutável (Snapshot) é publicada. Leitores obtêm a versão atual com snapshot()
+ * sem esperar por editores, e continuam vendo a mesma versão enquanto a usarem.
+ *
+ * Ao publicar, apenas as playlists alteradas desde a versão anterior são
+ * copiadas; as demais são compartilhadas entre as versões. As playlists se
+ * colocam na lista de alteradas ao mudar, então a publicação só percorre
+ * todas quando playlists entram ou saem da lista. O catálogo publicado é
+ * dividido em partes de até segmentSize músicas, e só as partes alteradas
+ * são copiadas; músicas adicionadas ao final custam apenas a cópia da última
+ * parte. Antes disso, as playlists inteligentes (SmartPlaylists) recebem as
+ * alterações feitas.
+ *
+ * As alterações feitas pelos editores são registradas no histórico
+ * (EditHistory), que permite desfazê-las e refazê-las.
+ *
+ * Depois de muitas alterações, os nós das listas ficam espalhados pela
+ * memória. compact copia as músicas de cada playlist, e as cópias publicadas,
+ * para nós lado a lado, e devolve ao sistema os blocos que ficaram livres.
+ */
+class Library{
+
+public:
+    /**
+     * @brief Versão imutável da biblioteca.
+     * @note As playlists e músicas de uma versão não devem ser alteradas. As
+     * playlists são constantes, e seus totais e assinaturas são atualizados
+     * antes da publicação, então várias threads podem lê-las ao mesmo tempo.
+     */
+    struct Snapshot{
+        unsigned long long version; //!< Número da versão, crescente a cada publicação.
+        std::vector<std::shared_ptr<LinkedList<Song>>> songs; //!< Músicas do sistema, em partes consecutivas do catálogo.
+        std::vector<std::shared_ptr<const Playlist>> playlists; //!< Playlists do sistema, em ordem.
+
+        // Procura uma playlist pelo nome.
+        const Playlist *findPlaylist(const std::string &name) const;
+        // Retorna o número de músicas do catálogo.
+        size_t getSongCount() const;
+    };
+
+    /**
+     * @brief Acesso exclusivo à biblioteca para alterações. Enquanto existir,
+     * outros editores esperam; ao ser destruído, publica uma nova versão.
+     */
+    class Editor{
+        Library &library; //!< Biblioteca alterada.
+        std::unique_lock<std::mutex> lock; //!< Trava de escrita da biblioteca.
+        bool publishOnRelease; //!< Indica se as alterações são publicadas na destruição.
+
+    public:
+        // Construtor, que espera até obter acesso exclusivo.
+        Editor(Library &library);
+        // Destrutor, que publica as alterações.
+        ~Editor();
+        // Retorna a lista de músicas do sistema.
+        LinkedList<Song> &songs();
+        // Retorna a lista de playlists do sistema.
+        LinkedList<Playlist> &playlists();
+        // Procura uma playlist da lista de playlists pelo nome.
+        Playlist *findPlaylist(const std::string &name);
+        // Retorna o índice de busca das músicas.
+        SearchIndex &index();
+        // Retorna as playlists inteligentes, que devem ser avisadas das alterações no catálogo.
+        SmartPlaylists &smartPlaylists();
+        // Retorna o histórico, que deve registrar as alterações no catálogo e na lista de playlists.
+        EditHistory &history();
+        // Publica as alterações feitas até agora.
+        void publish();
+        // Deixa a publicação das alterações para o próximo editor.
+        void deferPublish();
+    };
+
+private:
+    /**
+     * @brief Cópia publicada de uma playlist, reaproveitada enquanto ela não mudar.
+     */
+    struct Published{
+        unsigned long long version; //!< Versão da lista de músicas copiada.
+        unsigned long long seen; //!< Última publicação em que a playlist estava na lista.
+        size_t position; //!< Posição da playlist na lista publicada.
+        std::string name; //!< Nome da playlist copiada.
+        std::shared_ptr<Playlist> copy; //!< Cópia publicada.
+    };
+
+    //! Número máximo de músicas em cada parte do catálogo publicado.
+    static const size_t segmentSize = 1024;
+
+    std::mutex writeMutex; //!< Trava que serializa os editores.
+    LinkedList<Song> songs; //!< Lista de músicas alterada pelos editores.
+    LinkedList<Playlist> playlists; //!< Lista de playlists alterada pelos editores.
+    SearchIndex index; //!< Índice de busca das músicas.
+    SmartPlaylists smart; //!< Playlists inteligentes, atualizadas a cada publicação.
+    EditHistory history; //!< Histórico das alterações, para desfazê-las.
+    std::unordered_map<const Playlist*, Published> published; //!< Cópias publicadas de cada playlist.
+    std::vector<Playlist*> changed; //!< Playlists alteradas desde a última publicação.
+    unsigned long long publishedSongs; //!< Versão da lista de músicas publicada.
+    Node<Song> *publishedTail; //!< Último nó da lista de músicas publicada, ou nullptr se ela estava vazia.
+    unsigned long long publishedPlaylists; //!< Versão da lista de playlists publicada.
+    std::unordered_map<std::string, Playlist*> names; //!< Playlists pelo nome, montado a partir de uma lista publicada.
+    unsigned long long namesVersion; //!< Versão da lista de playlists quando names foi montado.
+    bool namesRenamed; //!< Indica se uma playlist publicada mudou de nome depois que names foi montado.
+    unsigned long long publications; //!< Número de publicações, que marca as playlists vistas em cada uma.
+    bool compactCopies; //!< Indica se a publicação copia todas as listas para nós lado a lado.
+    std::shared_ptr<const Snapshot> current; //!< Versão publicada mais recente.
+
+    // Publica uma nova versão com as alterações feitas pelos editores.
+    void publish();
+    // Monta as partes do catálogo publicado, reaproveitando as que não mudaram.
+    bool publishSongs(const Snapshot &previous, Snapshot &next);
+    // Monta a lista de playlists publicada, copiando só as playlists alteradas.
+    bool publishPlaylists(const Snapshot &previous, Snapshot &next);
+    // Procura uma playlist da lista alterada pelos editores pelo nome.
+    Playlist *findPlaylist(const std::string &name);
+
+public:
+    // Construtor da biblioteca vazia.
+    Library();
+    // Destrutor, que remove todas as músicas e playlists.
+    ~Library();
+    // Retorna a versão publicada mais recente.
+    std::shared_ptr<const Snapshot> snapshot() const;
+    // Busca músicas no índice, sem publicar uma nova versão.
+    size_t search(const std::string &query, SearchIndex::Field field, SearchIndex::Mode mode,
+                  size_t offset, size_t limit, std::vector<Song> &found);
+    // Copia as músicas das playlists para nós lado a lado e devolve a memória livre ao sistema.
+    size_t compact();
+};
+
+#endif
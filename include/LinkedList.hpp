@@ -7,8 +7,46 @@
 #define LINKEDLIST_HPP
 
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <iterator>
+#include <initializer_list>
 #include "Song.hpp"
 #include "Node.hpp"
+#include "ListPrinter.hpp"
+
+/**
+ * @brief Gera um novo número de versão para uma lista encadeada.
+ *
+ * Os números são únicos entre todas as listas, então uma versão guardada
+ * só volta a ser válida para a mesma lista enquanto ela não for alterada.
+ *
+ * @return Nova versão, sempre maior que zero.
+ */
+inline unsigned long long nextListVersion(){
+    static std::atomic<unsigned long long> counter(0);
+    return ++counter;
+}
+
+/**
+ * @brief Posição de uma listagem em páginas de uma lista encadeada.
+ *
+ * Guarda o nó em que a próxima página começa, então continuar a listagem não
+ * percorre de novo as páginas anteriores. O nó só é usado enquanto a lista
+ * tiver a mesma versão; se ela mudar, a página é encontrada pela posição.
+ *
+ * @tparam T Tipo do valor armazenado na lista.
+ */
+template <typename T>
+struct ListCursor{
+    size_t offset; //!< Posição do primeiro elemento da próxima página.
+    const Node<T> *node; //!< Nó na posição offset, ou nullptr se ainda não foi encontrado.
+    unsigned long long version; //!< Versão da lista quando o nó foi guardado.
+
+    // Construtor do cursor, que começa na posição especificada.
+    ListCursor(size_t offset = 0) : offset(offset), node(nullptr), version(0) {}
+};
 
 /**
  * @brief Classe que implementa uma lista encadeada template.
@@ -21,18 +59,46 @@ class LinkedList{
 private:
     Node<T> *head; //!< Ponteiro para o primeiro elemento da lista
     Node<T> *tail; //!< Ponteiro para o último elemento da lista
+    unsigned long long version; //!< Versão da lista, alterada a cada modificação
+    unsigned long long rewritten; //!< Versão da última modificação que não foi só uma adição ao final
+
+    // Ordena recursivamente os nós a partir de first, dividindo o trabalho entre threads.
+    template <typename Compare>
+    static Node<T> *mergeSort(Node<T> *first, size_t size, const Compare &less, unsigned depth);
+    // Intercala duas sequências de nós já ordenadas.
+    template <typename Compare>
+    static Node<T> *merge(Node<T> *a, Node<T> *b, const Compare &less);
+    // Liga ao final da lista uma sequência de nós novos.
+    void append(Node<T> *first, Node<T> *last);
+    // Retorna o valor de um elemento de um intervalo, que pode ser um valor ou um ponteiro.
+    static const T &valueOf(const T &value) {return value;}
+    static const T &valueOf(const T *value) {return *value;}
 
 public:
+    //! Tamanho mínimo de lista para que a ordenação use várias threads.
+    static const size_t parallelSortThreshold = 1 << 16;
+
     // Construtor da lista encadeada. 
     LinkedList();
     LinkedList(const LinkedList<T>& otherList);
+    // Construtor de movimentação, que toma os nós da outra lista sem copiá-los.
+    LinkedList(LinkedList<T>&& otherList);
     ~LinkedList();
+    // Atribuição por cópia, que copia todos os elementos da outra lista.
+    LinkedList<T>& operator=(const LinkedList<T>& otherList);
+    // Atribuição por movimentação, que toma os nós da outra lista sem copiá-los.
+    LinkedList<T>& operator=(LinkedList<T>&& otherList);
     // Remove todos os elementos da lista. 
     void clear();
     // Retorna o tamanho da lista encadeada. 
     size_t getSize() const;
+    // Retorna a versão atual da lista.
+    unsigned long long getVersion() const;
+    // Retorna a versão da última modificação que não foi só uma adição ao final.
+    unsigned long long getRewriteVersion() const;
     // Retorna a cabeça da lista. 
     Node<T> *getHead();
+    const Node<T> *getHead() const;
     // Retorna a cauda da lista. 
     Node<T> *getTail();
     // Altera o ponteiro cabeça da lista. 
@@ -45,14 +111,42 @@ public:
     T *searchValue(T value);
     // Remove o elemento especificado da lista. 
     void removeValue(T value);
-    // Imprime todos os elementos da lista recursivamente. 
-    void print();
+    // Imprime todos os elementos da lista, um por linha.
+    void print(std::ostream &os = std::cout);
+    //Visita os elementos de uma página da lista e avança o cursor para a página seguinte.
+    template <typename Visit>
+    size_t visitPage(ListCursor<T> &cursor, size_t limit, Visit visit) const;
+    //Adiciona ao final da lista, de uma só vez, os elementos de um intervalo.
+    template <typename Iterator>
+    void addAll(Iterator first, Iterator last);
+    //Adiciona ao final da lista, de uma só vez, os elementos de uma lista de inicialização.
+    void addAll(std::initializer_list<T> values);
     //Adiciona os elementos de uma lista à lista atual.
-    void addList(LinkedList<T>& otherList);
+    void addList(const LinkedList<T>& otherList);
+    //Move todos os nós de outra lista para o final da lista atual.
+    void splice(LinkedList<T>& otherList);
+    //Move um trecho de nós de outra lista para depois de um nó da lista atual.
+    void spliceAfter(Node<T> *position, LinkedList<T>& otherList, Node<T> *beforeFirst, Node<T> *last);
     //Remove os elementos de uma lista na lista atual.
     void removeList(LinkedList<T>& otherList);
+    //Remove, em uma única passagem, todos os elementos que satisfazem o predicado.
+    template <typename Predicate>
+    size_t removeIf(Predicate matches);
+    //Ordena a lista usando merge sort, sem copiar os elementos.
+    template <typename Compare>
+    void sort(Compare less, unsigned threads = 0);
+    //Verifica se cada nó está logo depois do anterior na memória.
+    bool isContiguous() const;
+    //Copia os elementos para nós novos, lado a lado na memória, e libera os antigos.
+    void compact();
     //Sobrecarga do operador de adição.
-    LinkedList<T> operator+(LinkedList<T>& otherList);
+    LinkedList<T> operator+(LinkedList<T>& otherList) &;
+    //Sobrecarga do operador de adição, que move os nós da lista temporária.
+    LinkedList<T> operator+(LinkedList<T>&& otherList) &;
+    //Sobrecarga do operador de adição para uma lista temporária à esquerda.
+    LinkedList<T> operator+(LinkedList<T>& otherList) &&;
+    //Sobrecarga do operador de adição entre duas listas temporárias.
+    LinkedList<T> operator+(LinkedList<T>&& otherList) &&;
     //Sobrecarga do operador de subtração.
     LinkedList<T> operator-(LinkedList<T>& otherList);
     //Sobrecarga do operador de extração.
@@ -76,6 +170,8 @@ template <typename T>
 LinkedList<T>::LinkedList(){
     head = nullptr;
     tail = nullptr;
+    version = nextListVersion();
+    rewritten = version;
 }
 
 /**
@@ -101,6 +197,8 @@ void LinkedList<T>::clear(){
     }
     head = nullptr;
     tail = nullptr;
+    version = nextListVersion();
+    rewritten = version;
 }
 
 /**
@@ -120,6 +218,35 @@ size_t LinkedList<T>::getSize() const{
     return size;
 }
 
+/**
+ * @brief Retorna a versão atual da lista.
+ *
+ * A versão muda sempre que elementos são adicionados, removidos ou reordenados
+ * pela própria lista, e pode ser usada para validar dados calculados a partir dela.
+ * @note Alterações feitas diretamente nos valores dos nós não mudam a versão.
+ *
+ * @return Versão da lista.
+ */
+template <typename T>
+unsigned long long LinkedList<T>::getVersion() const{
+    return version;
+}
+
+/**
+ * @brief Retorna a versão da última modificação que não foi só uma adição de
+ * elementos ao final (add, addAll, addList, ou splice e spliceAfter com o
+ * trecho inserido depois da cauda).
+ *
+ * Se ela não passou de uma versão já vista, os nós daquela versão continuam
+ * na lista, na mesma ordem, e os elementos novos vêm depois da cauda antiga.
+ *
+ * @return Versão da última modificação que não foi só uma adição ao final.
+ */
+template <typename T>
+unsigned long long LinkedList<T>::getRewriteVersion() const{
+    return rewritten;
+}
+
 /**
  * @brief Retorna a cabeça da lista.
  * 
@@ -130,6 +257,16 @@ Node<T> *LinkedList<T>::getHead(){
     return head;
 }
 
+/**
+ * @brief Retorna a cabeça de uma lista constante.
+ * 
+ * @return Ponteiro para o primeiro elemento da lista, somente para leitura.
+ */
+template <typename T>
+const Node<T> *LinkedList<T>::getHead() const{
+    return head;
+}
+
 /**
  * @brief Retorna a cauda da lista.
  * 
@@ -148,6 +285,8 @@ Node<T> *LinkedList<T>::getTail(){
 template <typename T>
 void LinkedList<T>::setHead(Node<T> *head){
     this->head = head;
+    version = nextListVersion();
+    rewritten = version;
 }
 
 /**
@@ -158,6 +297,8 @@ void LinkedList<T>::setHead(Node<T> *head){
 template <typename T>
 void LinkedList<T>::setTail(Node<T> *tail){
     this->tail = tail;
+    version = nextListVersion();
+    rewritten = version;
 }
 
 /**
@@ -178,6 +319,7 @@ void LinkedList<T>::add(T value){
         tail->setNext(newNode);
         tail = newNode;
     }
+    version = nextListVersion();
 }
 
 /**
@@ -226,6 +368,8 @@ void LinkedList<T>::removeValue(T value){
                 }
             }
             delete curr;
+            version = nextListVersion();
+            rewritten = version;
             return;
         }
         prev = curr;
@@ -235,40 +379,204 @@ void LinkedList<T>::removeValue(T value){
 
 
 /**
- * @brief Imprime todos os elementos da lista recursivamente.
+ * @brief Imprime todos os elementos da lista, um por linha. As linhas passam
+ * por um ListPrinter, então o fluxo é escrito em blocos, e não a cada linha.
+ *
+ * @param os Fluxo que recebe os elementos.
  */
 template <typename T>
-void LinkedList<T>::print(){
-    printAux(head);
+void LinkedList<T>::print(std::ostream &os){
+    ListPrinter out(os);
+    for(Node<T> *curr = head; curr != nullptr; curr = curr->getNext()){
+        out.line(curr->getValue());
+    }
 }
 
 /**
- * @brief Auxiliar para a função print. Imprime a lista recursivamente a partir
- * do elemento especificado.
- * 
- * @param curr Primeiro elemento da lista a ser impresso.
+ * @brief Visita até limit elementos a partir da posição do cursor e avança o
+ * cursor para o elemento seguinte ao último visitado.
+ *
+ * Se a lista não mudou desde a página anterior, a visita começa no nó
+ * guardado no cursor, em O(1); caso contrário, a lista é percorrida até a
+ * posição do cursor.
+ *
+ * @param cursor Posição da página, atualizada para a página seguinte.
+ * @param limit Número máximo de elementos visitados.
+ * @param visit Função chamada com cada elemento da página.
+ * @return Número de elementos visitados. Zero indica que não há mais páginas.
  */
 template <typename T>
-void printAux(Node<T> *curr){
-    if(curr != nullptr){
-        std::cout << curr->getValue() << std::endl;
-        printAux(curr->getNext());
+template <typename Visit>
+size_t LinkedList<T>::visitPage(ListCursor<T> &cursor, size_t limit, Visit visit) const{
+    const Node<T> *curr = cursor.node;
+    if(curr == nullptr || cursor.version != version){
+        curr = head;
+        for(size_t i = 0; i < cursor.offset && curr != nullptr; i++){
+            curr = curr->getNext();
+        }
+    }
+
+    size_t visited = 0;
+    while(visited < limit && curr != nullptr){
+        visit(curr->getValue());
+        curr = curr->getNext();
+        visited++;
     }
+
+    cursor.offset += visited;
+    cursor.node = curr;
+    cursor.version = version;
+    return visited;
 }
 
 /**
- * @brief Adiciona todos os elementos de outra lista à lista atual.
+ * @brief Adiciona todos os elementos de outra lista à lista atual. Os
+ * elementos são copiados para nós reservados de uma vez e ligados à lista
+ * em uma única passagem.
  *
  * @tparam T Tipo dos elementos da lista.
  * @param otherList A lista da qual os elementos serão adicionados.
  */
 template <typename T>
-void LinkedList<T>::addList(LinkedList<T>& otherList) {
-    Node<T>* curr = otherList.head;
+void LinkedList<T>::addList(const LinkedList<T>& otherList) {
+    if (otherList.head == nullptr) {
+        return;
+    }
+    Node<T>::reserve(otherList.getSize());
+
+    Node<T>* first = new Node<T>(otherList.head->getValue());
+    Node<T>* last = first;
+    for (Node<T>* curr = otherList.head->getNext(); curr != nullptr; curr = curr->getNext()) {
+        Node<T>* node = new Node<T>(curr->getValue());
+        last->setNext(node);
+        last = node;
+    }
+    append(first, last);
+}
 
-    while (curr != nullptr) {
-        add(curr->getValue());
-        curr = curr->getNext();
+/**
+ * @brief Adiciona ao final da lista os elementos de um intervalo. A memória
+ * de todos os nós é reservada de uma vez e os nós são ligados à lista em uma
+ * única passagem, com uma única mudança de versão.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @tparam Iterator Iterador de avanço sobre valores do tipo T ou ponteiros para T.
+ * @param first Início do intervalo.
+ * @param last Fim do intervalo.
+ */
+template <typename T>
+template <typename Iterator>
+void LinkedList<T>::addAll(Iterator first, Iterator last) {
+    if (first == last) {
+        return;
+    }
+    Node<T>::reserve(std::distance(first, last));
+
+    Node<T>* chainFirst = new Node<T>(valueOf(*first));
+    Node<T>* chainLast = chainFirst;
+    for (++first; first != last; ++first) {
+        Node<T>* node = new Node<T>(valueOf(*first));
+        chainLast->setNext(node);
+        chainLast = node;
+    }
+    append(chainFirst, chainLast);
+}
+
+/**
+ * @brief Adiciona ao final da lista os elementos de uma lista de
+ * inicialização, como em list.addAll({a, b, c}).
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param values Valores a adicionar.
+ */
+template <typename T>
+void LinkedList<T>::addAll(std::initializer_list<T> values) {
+    addAll(values.begin(), values.end());
+}
+
+/**
+ * @brief Liga ao final da lista uma sequência de nós que ainda não pertence
+ * a nenhuma lista.
+ *
+ * @param first Primeiro nó da sequência.
+ * @param last Último nó da sequência, cujo próximo é nullptr.
+ */
+template <typename T>
+void LinkedList<T>::append(Node<T> *first, Node<T> *last) {
+    if (tail != nullptr) {
+        tail->setNext(first);
+    }
+    else {
+        head = first;
+    }
+    tail = last;
+    version = nextListVersion();
+}
+
+/**
+ * @brief Move todos os nós de outra lista para o final da lista atual, em
+ * tempo constante. A outra lista fica vazia.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista cujos nós serão movidos.
+ */
+template <typename T>
+void LinkedList<T>::splice(LinkedList<T>& otherList) {
+    if (this == &otherList || otherList.head == nullptr) {
+        return;
+    }
+    spliceAfter(tail, otherList, nullptr, otherList.tail);
+}
+
+/**
+ * @brief Move os nós de outra lista que vêm depois de beforeFirst, até last
+ * inclusive, para depois de position na lista atual, em tempo constante.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param position Nó da lista atual depois do qual o trecho é inserido, ou
+ * nullptr para inserir no início.
+ * @param otherList A lista de onde os nós são retirados. Pode ser a própria
+ * lista, desde que position não esteja no trecho.
+ * @param beforeFirst Nó de otherList anterior ao primeiro nó do trecho, ou
+ * nullptr se o trecho começa na cabeça.
+ * @param last Último nó do trecho, que deve vir depois de beforeFirst em otherList.
+ */
+template <typename T>
+void LinkedList<T>::spliceAfter(Node<T> *position, LinkedList<T>& otherList, Node<T> *beforeFirst, Node<T> *last) {
+    Node<T>* first = (beforeFirst != nullptr) ? beforeFirst->getNext() : otherList.head;
+    if (first == nullptr || last == nullptr || position == last || (this == &otherList && position == beforeFirst)) {
+        return;
+    }
+
+    // Retira o trecho da outra lista
+    if (beforeFirst != nullptr) {
+        beforeFirst->setNext(last->getNext());
+    }
+    else {
+        otherList.head = last->getNext();
+    }
+    if (otherList.tail == last) {
+        otherList.tail = beforeFirst;
+    }
+    otherList.version = nextListVersion();
+    otherList.rewritten = otherList.version;
+
+    // Insere o trecho depois de position
+    bool atEnd = (position == tail);
+    if (position != nullptr) {
+        last->setNext(position->getNext());
+        position->setNext(first);
+    }
+    else {
+        last->setNext(head);
+        head = first;
+    }
+    if (last->getNext() == nullptr) {
+        tail = last;
+    }
+    version = nextListVersion();
+    if (!atEnd) {
+        rewritten = version;
     }
 }
 
@@ -288,6 +596,50 @@ void LinkedList<T>::removeList(LinkedList<T>& otherList) {
     }
 }
 
+/**
+ * @brief Remove todos os elementos que satisfazem o predicado, percorrendo a
+ * lista uma única vez.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @tparam Predicate Função que recebe T& e retorna true se o elemento deve ser removido.
+ * @param matches Predicado.
+ * @return Número de elementos removidos.
+ */
+template <typename T>
+template <typename Predicate>
+size_t LinkedList<T>::removeIf(Predicate matches) {
+    size_t removed = 0;
+    Node<T>* prev = nullptr;
+    Node<T>* curr = head;
+
+    while (curr != nullptr) {
+        Node<T>* next = curr->getNext();
+        if (matches(curr->getValue())) {
+            if (prev != nullptr) {
+                prev->setNext(next);
+            }
+            else {
+                head = next;
+            }
+            if (curr == tail) {
+                tail = prev;
+            }
+            delete curr;
+            removed++;
+        }
+        else {
+            prev = curr;
+        }
+        curr = next;
+    }
+
+    if (removed > 0) {
+        version = nextListVersion();
+        rewritten = version;
+    }
+    return removed;
+}
+
 /**
  * @brief Construtor de cópia que retorna uma cópia da lista recebida como parâmetro.
  *
@@ -298,32 +650,298 @@ template <typename T>
 LinkedList<T>::LinkedList(const LinkedList<T>& otherList) {
     head = nullptr;
     tail = nullptr;
+    version = nextListVersion();
+    rewritten = version;
 
-    Node<T>* curr = otherList.head;
+    addList(otherList);
+}
 
-    while (curr != nullptr) {
-        add(curr->getValue());
-        curr = curr->getNext();
+/**
+ * @brief Atribuição por cópia. Remove os elementos atuais e copia todos os
+ * elementos da lista recebida.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista que será copiada.
+ * @return Referência para a lista atual.
+ */
+template <typename T>
+LinkedList<T>& LinkedList<T>::operator=(const LinkedList<T>& otherList) {
+    if (this == &otherList) {
+        return *this;
+    }
+    clear();
+    addList(otherList);
+
+    return *this;
+}
+
+/**
+ * @brief Construtor de movimentação. Toma os nós da lista recebida, que fica
+ * vazia, sem copiar os elementos.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista cujos nós serão tomados.
+ */
+template <typename T>
+LinkedList<T>::LinkedList(LinkedList<T>&& otherList) {
+    head = otherList.head;
+    tail = otherList.tail;
+    version = nextListVersion();
+    rewritten = version;
+
+    otherList.head = nullptr;
+    otherList.tail = nullptr;
+    otherList.version = nextListVersion();
+    otherList.rewritten = otherList.version;
+}
+
+/**
+ * @brief Atribuição por movimentação. Remove os elementos atuais e toma os
+ * nós da lista recebida, que fica vazia, sem copiar os elementos.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista cujos nós serão tomados.
+ * @return Referência para a lista atual.
+ */
+template <typename T>
+LinkedList<T>& LinkedList<T>::operator=(LinkedList<T>&& otherList) {
+    if (this == &otherList) {
+        return *this;
+    }
+    clear();
+    splice(otherList);
+    return *this;
+}
+
+/**
+ * @brief Ordena a lista usando merge sort, religando os nós sem copiar os elementos.
+ *
+ * A ordenação é estável: elementos equivalentes mantêm a ordem de inserção.
+ * Listas com pelo menos parallelSortThreshold elementos são divididas entre
+ * as threads disponíveis.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @tparam Compare Tipo do comparador.
+ * @param less Comparador que retorna true se o primeiro elemento vem antes do segundo.
+ * @param threads Número máximo de threads, arredondado para a potência de 2
+ * acima; 0 usa uma por núcleo e 1 ordena só na thread atual.
+ */
+template <typename T>
+template <typename Compare>
+void LinkedList<T>::sort(Compare less, unsigned threads){
+    size_t size = getSize();
+    if(size < 2){
+        return;
+    }
+
+    unsigned depth = 0;
+    if(size >= parallelSortThreshold){
+        if(threads == 0){
+            threads = std::thread::hardware_concurrency();
+        }
+        while((1u << depth) < threads){
+            depth++;
+        }
+    }
+
+    head = mergeSort(head, size, less, depth);
+    tail = head;
+    while(tail->getNext() != nullptr){
+        tail = tail->getNext();
+    }
+    version = nextListVersion();
+    rewritten = version;
+}
+
+/**
+ * @brief Verifica se cada nó da lista está logo depois do anterior na
+ * memória, como depois de compact.
+ *
+ * @return true se os nós estão lado a lado, ou se a lista tem menos de dois elementos.
+ */
+template <typename T>
+bool LinkedList<T>::isContiguous() const{
+    for(const Node<T> *curr = head; curr != nullptr && curr->getNext() != nullptr; curr = curr->getNext()){
+        if(curr->getNext() != curr + 1){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Copia os elementos, na ordem da lista, para nós novos obtidos de um
+ * único bloco, e libera os nós antigos. Depois de muitas alterações, os nós
+ * de uma lista ficam espalhados pela memória; lado a lado, percorrer a lista
+ * volta a aproveitar o cache. Os valores são copiados pelo construtor de
+ * cópia; o que eles alocam fora do nó só muda de lugar se a cópia alocar de
+ * novo (Song, por exemplo, compartilha os textos com a cópia).
+ *
+ * Se os nós já estão lado a lado, nada é feito. Caso contrário, a versão da
+ * lista muda, como em qualquer alteração, e ponteiros para os nós ou valores
+ * antigos deixam de ser válidos.
+ */
+template <typename T>
+void LinkedList<T>::compact(){
+    if(isContiguous()){
+        return;
+    }
+    Node<T>::reserveContiguous(getSize());
+    LinkedList<T> copy(*this);
+    clear();
+    head = copy.head;
+    tail = copy.tail;
+    copy.head = nullptr;
+    copy.tail = nullptr;
+}
+
+/**
+ * @brief Ordena recursivamente uma sequência de nós terminada em nullptr.
+ *
+ * Enquanto depth for maior que zero e a sequência for grande, a segunda metade
+ * é ordenada em outra thread.
+ *
+ * @param first Primeiro nó da sequência.
+ * @param size Número de nós da sequência.
+ * @param less Comparador dos elementos.
+ * @param depth Número de níveis que ainda podem criar threads.
+ * @return Primeiro nó da sequência ordenada.
+ */
+template <typename T>
+template <typename Compare>
+Node<T> *LinkedList<T>::mergeSort(Node<T> *first, size_t size, const Compare &less, unsigned depth){
+    if(size < 2){
+        return first;
+    }
+
+    size_t half = size / 2;
+    Node<T> *mid = first;
+    for(size_t i = 1; i < half; i++){
+        mid = mid->getNext();
+    }
+    Node<T> *second = mid->getNext();
+    mid->setNext(nullptr);
+
+    if(depth > 0 && size >= parallelSortThreshold){
+        std::thread worker([&second, size, half, &less, depth](){
+            second = mergeSort(second, size - half, less, depth - 1);
+        });
+        first = mergeSort(first, half, less, depth - 1);
+        worker.join();
+    }
+    else{
+        first = mergeSort(first, half, less, 0);
+        second = mergeSort(second, size - half, less, 0);
+    }
+
+    return merge(first, second, less);
+}
+
+/**
+ * @brief Intercala duas sequências de nós ordenadas. Em caso de empate, o nó
+ * da primeira sequência vem antes, mantendo a ordenação estável.
+ *
+ * @param a Primeira sequência.
+ * @param b Segunda sequência.
+ * @param less Comparador dos elementos.
+ * @return Primeiro nó da sequência intercalada.
+ */
+template <typename T>
+template <typename Compare>
+Node<T> *LinkedList<T>::merge(Node<T> *a, Node<T> *b, const Compare &less){
+    if(a == nullptr){
+        return b;
+    }
+    if(b == nullptr){
+        return a;
+    }
+
+    Node<T> *result;
+    if(less(b->getValue(), a->getValue())){
+        result = b;
+        b = b->getNext();
+    }
+    else{
+        result = a;
+        a = a->getNext();
     }
+
+    Node<T> *last = result;
+    while(a != nullptr && b != nullptr){
+        if(less(b->getValue(), a->getValue())){
+            last->setNext(b);
+            last = b;
+            b = b->getNext();
+        }
+        else{
+            last->setNext(a);
+            last = a;
+            a = a->getNext();
+        }
+    }
+    last->setNext(a != nullptr ? a : b);
+
+    return result;
 }
 
 /**
- * @brief Sobrecarga do operador "+" para a concatenação de duas listas.
+ * @brief Sobrecarga do operador "+" para a concatenação de duas listas. A
+ * memória dos nós das duas cópias é reservada de uma vez (addList).
  *
  * @tparam T Tipo dos elementos da lista.
  * @param otherList A lista que será concatenada com a lista atual.
  * @return A lista resultante da concatenação.
  */
 template <typename T>
-LinkedList<T> LinkedList<T>::operator+(LinkedList<T>& otherList) {
+LinkedList<T> LinkedList<T>::operator+(LinkedList<T>& otherList) & {
+    Node<T>::reserve(getSize() + otherList.getSize());
     LinkedList<T> result(*this);
+    result.addList(otherList);
+    return result;
+}
 
-    Node<T>* curr = otherList.head;
-    while (curr != nullptr) {
-        result.add(curr->getValue());
-        curr = curr->getNext();
-    }
+/**
+ * @brief Concatena uma lista temporária à lista atual. Apenas a lista atual
+ * é copiada; os nós da lista temporária são religados ao resultado.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista temporária, que fica vazia.
+ * @return A lista resultante da concatenação.
+ */
+template <typename T>
+LinkedList<T> LinkedList<T>::operator+(LinkedList<T>&& otherList) & {
+    LinkedList<T> result(*this);
+    result.splice(otherList);
+    return result;
+}
 
+/**
+ * @brief Concatena uma lista a uma lista temporária, como em (a + b) + c.
+ * Os nós da lista temporária são reaproveitados e apenas otherList é copiada.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista que será concatenada.
+ * @return A lista resultante da concatenação.
+ */
+template <typename T>
+LinkedList<T> LinkedList<T>::operator+(LinkedList<T>& otherList) && {
+    LinkedList<T> result(std::move(*this));
+    result.addList(otherList);
+    return result;
+}
+
+/**
+ * @brief Concatena duas listas temporárias em tempo constante, sem copiar
+ * nenhum elemento.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @param otherList A lista temporária, que fica vazia.
+ * @return A lista resultante da concatenação.
+ */
+template <typename T>
+LinkedList<T> LinkedList<T>::operator+(LinkedList<T>&& otherList) && {
+    LinkedList<T> result(std::move(*this));
+    result.splice(otherList);
     return result;
 }
 
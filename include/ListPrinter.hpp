@@ -0,0 +1,53 @@
+/**
+ * @file ListPrinter.hpp
+ * @brief Arquivo que contém a classe ListPrinter, usada para imprimir listagens longas.
+ */
+
+#ifndef LISTPRINTER_HPP
+#define LISTPRINTER_HPP
+
+#include <ostream>
+#include <sstream>
+
+/**
+ * @brief Classe que imprime uma listagem linha a linha com um buffer próprio.
+ *
+ * As linhas são acumuladas em memória e escritas no fluxo em blocos de até
+ * bufferSize bytes, sem esvaziar o fluxo a cada linha como std::endl faz. O
+ * que restar no buffer é escrito pelo destrutor.
+ */
+class ListPrinter{
+
+    std::ostream &os; //!< Fluxo que recebe as linhas.
+    std::ostringstream buffer; //!< Linhas ainda não escritas no fluxo.
+
+public:
+    //! Tamanho, em bytes, a partir do qual o buffer é escrito no fluxo.
+    static const std::streamoff bufferSize = 1 << 16;
+
+    // Construtor.
+    ListPrinter(std::ostream &os);
+    // Destrutor, que escreve as linhas restantes.
+    ~ListPrinter();
+    // Adiciona uma linha com o valor especificado.
+    template <typename V>
+    void line(const V &value);
+    // Escreve no fluxo as linhas acumuladas.
+    void write();
+};
+
+/**
+ * @brief Adiciona uma linha com o valor especificado, escrevendo o buffer no
+ * fluxo quando ele atinge bufferSize bytes.
+ *
+ * @param value Valor da linha, impresso com o operador de inserção.
+ */
+template <typename V>
+void ListPrinter::line(const V &value){
+    buffer << value << '\n';
+    if(static_cast<std::streamoff>(buffer.tellp()) >= bufferSize){
+        write();
+    }
+}
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file LoadGenerator.hpp
+ * @brief Arquivo que contém a classe LoadGenerator, cliente de carga do servidor.
+ */
+
+#ifndef LOADGENERATOR_HPP
+#define LOADGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+
+/**
+ * @brief Cliente que abre várias conexões com o servidor (Server), envia
+ * requisições em paralelo em cada uma e mede o tempo de resposta de cada
+ * requisição. Ao final, exibe a vazão e os percentis do tempo de resposta.
+ *
+ * A maior parte das requisições são consultas (buscas, listagem de playlists
+ * e PING); uma em cada dez cria ou remove uma playlist.
+ */
+class LoadGenerator{
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Estado de uma conexão com o servidor.
+     */
+    struct Connection{
+        int fd; //!< Descritor da conexão.
+        size_t id; //!< Número da conexão, usado nos nomes das playlists criadas.
+        size_t sent; //!< Requisições enviadas.
+        size_t received; //!< Respostas recebidas.
+        size_t total; //!< Requisições a enviar.
+        long pendingLines; //!< Linhas que faltam na resposta atual, ou -1 se falta o cabeçalho.
+        std::deque<Clock::time_point> inFlight; //!< Horário de envio das requisições sem resposta.
+        std::string input; //!< Bytes recebidos ainda não analisados.
+        std::string output; //!< Requisições ainda não enviadas.
+        size_t written; //!< Bytes de output já enviados.
+    };
+
+    std::string path; //!< Caminho do socket do servidor.
+    size_t connectionCount; //!< Número de conexões.
+    size_t requestCount; //!< Número total de requisições.
+    size_t depth; //!< Número máximo de requisições sem resposta por conexão.
+    std::vector<double> latencies; //!< Tempos de resposta, em microssegundos.
+    size_t errors; //!< Respostas de erro.
+
+    // Monta a requisição de número n de uma conexão.
+    std::string makeRequest(const Connection &connection, size_t n) const;
+    // Envia requisições até o limite de requisições sem resposta.
+    bool fill(Connection &connection);
+    // Analisa as respostas recebidas.
+    void parse(Connection &connection);
+    // Exibe a vazão e os percentis do tempo de resposta.
+    void report(double seconds);
+
+public:
+    // Construtor.
+    LoadGenerator(const std::string &path, size_t connections, size_t requests, size_t depth);
+    // Executa a carga e exibe o resultado.
+    bool run();
+};
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file Loader.hpp
+ * @brief Arquivo que contém a classe Loader, que carrega playlists em segundo plano.
+ */
+
+#ifndef LOADER_HPP
+#define LOADER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <unordered_map>
+#include <ostream>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "SongSet.hpp"
+#include "Library.hpp"
+
+/**
+ * @brief Classe que importa arquivos de playlists em segundo plano e adiciona
+ * as playlists à biblioteca em lotes, conforme são lidas.
+ *
+ * Os arquivos são lidos ao mesmo tempo por várias threads, e uma thread
+ * adiciona os lotes lidos à biblioteca. Músicas repetidas (mesmo título e
+ * autor) entram no catálogo uma única vez, e playlists com o mesmo nome são
+ * unidas em uma só.
+ *
+ * Os lotes são adicionados com um Library::Editor assim que são lidos, e
+ * publicados periodicamente, então o restante do programa pode usar a parte
+ * já carregada. O intervalo entre publicações cresce com o tempo gasto para
+ * publicar, para que a publicação não ocupe mais que uma pequena parte do
+ * carregamento.
+ */
+class Loader{
+
+public:
+    //! Situação do carregamento.
+    enum State{
+        Idle, //!< Nenhum carregamento iniciado.
+        Loading, //!< Carregamento em andamento.
+        Finished, //!< Todos os arquivos foram lidos.
+        Cancelled, //!< Carregamento interrompido por cancel.
+        Failed //!< Nenhum arquivo pôde ser lido.
+    };
+
+    /**
+     * @brief Andamento do carregamento.
+     */
+    struct Progress{
+        State state; //!< Situação do carregamento.
+        size_t bytesRead; //!< Bytes dos arquivos já lidos.
+        size_t totalBytes; //!< Tamanho total dos arquivos.
+        size_t playlists; //!< Playlists já adicionadas à biblioteca.
+        double seconds; //!< Tempo decorrido, ou duração total se o carregamento terminou.
+
+        // Retorna a porcentagem dos arquivos já lida.
+        int getPercent() const;
+    };
+
+    /**
+     * @brief Resultado da leitura de um arquivo.
+     */
+    struct FileReport{
+        std::string path; //!< Caminho do arquivo.
+        size_t bytes; //!< Tamanho do arquivo.
+        size_t playlists; //!< Playlists lidas.
+        size_t songs; //!< Músicas lidas, contando as repetidas.
+        double seconds; //!< Tempo gasto para ler o arquivo.
+        std::string error; //!< Mensagem de erro, ou vazia se o arquivo foi lido.
+    };
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Playlists lidas de um arquivo, ainda não adicionadas à biblioteca.
+     */
+    struct Batch{
+        LinkedList<Playlist> playlists; //!< Playlists lidas.
+    };
+
+    Library &library; //!< Biblioteca que recebe as playlists.
+    std::vector<std::string> paths; //!< Arquivos e pastas a importar.
+    std::vector<FileReport> reports; //!< Resultado de cada arquivo, válido após o fim do carregamento.
+    bool verbose; //!< Indica se o resultado é exibido ao fim do carregamento.
+    std::thread worker; //!< Thread que adiciona os lotes à biblioteca.
+    std::atomic<int> state; //!< Situação do carregamento (State).
+    std::atomic<bool> cancelRequested; //!< Indica se o carregamento deve ser interrompido.
+    std::atomic<size_t> bytesRead; //!< Bytes dos arquivos já lidos.
+    std::atomic<size_t> totalBytes; //!< Tamanho total dos arquivos.
+    std::atomic<size_t> playlists; //!< Playlists já adicionadas à biblioteca.
+    std::atomic<long long> duration; //!< Duração do carregamento em microssegundos, ou -1.
+    Clock::time_point startTime; //!< Início do carregamento.
+
+    std::mutex queueMutex; //!< Trava da fila de lotes lidos.
+    std::condition_variable queueChanged; //!< Avisa mudanças na fila de lotes.
+    std::deque<std::unique_ptr<Batch>> queue; //!< Lotes lidos e ainda não adicionados.
+    size_t activeReaders; //!< Threads de leitura ainda em execução.
+
+    SongSet knownSongs; //!< Músicas do catálogo, para evitar repetições.
+    unsigned long long knownSongsVersion; //!< Versão do catálogo em knownSongs.
+    std::unordered_map<std::string, Playlist*> knownPlaylists; //!< Playlists da biblioteca, pelo nome.
+    unsigned long long knownPlaylistsVersion; //!< Versão da lista de playlists em knownPlaylists.
+    size_t newSongs; //!< Músicas adicionadas ao catálogo.
+    size_t duplicateSongs; //!< Músicas ignoradas por já estarem no catálogo.
+    size_t mergedPlaylists; //!< Playlists unidas a outra com o mesmo nome.
+
+    // Coordena a importação. Executado na thread do carregamento.
+    void load();
+    // Lê arquivos e envia os lotes lidos para a fila.
+    void read(const std::vector<std::string> *files, std::atomic<size_t> *next);
+    // Lê um arquivo.
+    void readFile(const std::string &path, FileReport &report);
+    // Envia um lote lido para a fila.
+    void push(std::unique_ptr<Batch> batch);
+    // Adiciona os lotes lidos à biblioteca.
+    Clock::duration apply(std::vector<std::unique_ptr<Batch>> &batches, bool publish);
+    // Encerra o carregamento com a situação indicada.
+    void finish(State result);
+
+public:
+    // Construtor.
+    Loader(Library &library);
+    // Destrutor, que cancela o carregamento em andamento.
+    ~Loader();
+    // Inicia a importação de arquivos e pastas.
+    bool start(const std::vector<std::string> &paths);
+    // Define se o resultado é exibido ao fim do carregamento.
+    void setVerbose(bool verbose);
+    // Pede a interrupção do carregamento.
+    void cancel();
+    // Espera o fim do carregamento.
+    void wait();
+    // Retorna o andamento do carregamento.
+    Progress getProgress() const;
+    // Exibe o resultado do carregamento.
+    void printReport(std::ostream &os) const;
+
+    // Analisa uma linha de um arquivo de playlists.
+    static Playlist parsePlaylist(const std::string &line);
+    // Lista os arquivos de um caminho, que pode ser um arquivo ou uma pasta.
+    static bool listFiles(const std::string &path, std::vector<std::string> &files, std::string &error);
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file MemoryReport.hpp
+ * @brief Arquivo que contém a classe MemoryReport, que mede a memória usada pela biblioteca.
+ */
+
+#ifndef MEMORYREPORT_HPP
+#define MEMORYREPORT_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Library.hpp"
+
+/**
+ * @brief Memória usada por cada parte da biblioteca: o catálogo, as
+ * playlists, a versão publicada, o índice de busca e o histórico, e por cada
+ * playlist.
+ *
+ * Para as listas, são contados os nós e os textos alocados fora das músicas
+ * (Song::getHeapBytes); o índice e o histórico informam a própria estimativa.
+ * Também é contado quantos nós seguidos de cada lista estão lado a lado na
+ * memória: depois de muitas alterações essa proporção cai, e percorrer a
+ * lista fica mais lento. Library::compact a recupera para os nós; os textos,
+ * compartilhados entre as cópias das músicas, continuam onde foram alocados.
+ *
+ * A reserva de nós (NodePool) e a memória residente do processo, lida do
+ * sistema quando disponível, mostram quanto foi obtido do sistema além do que
+ * as listas usam.
+ */
+class MemoryReport{
+
+public:
+    /**
+     * @brief Memória usada por um contêiner ou por uma playlist.
+     */
+    struct Usage{
+        std::string name; //!< Nome do contêiner ou da playlist.
+        std::string unit; //!< Nome dos elementos contados, no plural.
+        size_t elements; //!< Número de elementos: músicas, ou passos no histórico.
+        size_t nodeBytes; //!< Memória dos nós das listas.
+        size_t stringBytes; //!< Memória dos textos alocada fora dos objetos.
+        size_t otherBytes; //!< Memória das demais estruturas (tabelas, vetores, objetos).
+        size_t links; //!< Número de pares de nós seguidos nas listas.
+        size_t adjacent; //!< Pares em que o segundo nó está logo depois do primeiro na memória.
+
+        // Construtor do uso vazio.
+        Usage(const std::string &name = "", const std::string &unit = "músicas");
+        // Retorna a memória total.
+        size_t getTotal() const;
+        // Retorna a porcentagem de nós seguidos que estão lado a lado.
+        double getContiguity() const;
+    };
+
+private:
+    std::vector<Usage> containers; //!< Uso de cada contêiner, em ordem fixa.
+    std::vector<Usage> playlists; //!< Uso de cada playlist, da que mais ocupa memória para a que menos ocupa.
+    size_t reserved; //!< Memória dos blocos de nós obtidos do sistema.
+    size_t listed; //!< Memória dos nós contados nas listas.
+    size_t resident; //!< Memória residente do processo, ou 0 se desconhecida.
+
+    // Soma as músicas de uma lista a um uso.
+    static void addSongs(const LinkedList<Song> &songs, Usage &usage);
+
+public:
+    // Construtor do relatório vazio.
+    MemoryReport();
+    // Mede a memória da biblioteca.
+    void measure(Library &library);
+    // Retorna o uso de cada contêiner.
+    const std::vector<Usage> &getContainers() const;
+    // Retorna o uso de cada playlist, da que mais ocupa memória para a que menos ocupa.
+    const std::vector<Usage> &getPlaylists() const;
+    // Retorna a memória dos blocos de nós obtidos do sistema.
+    size_t getReservedBytes() const;
+    // Retorna a memória residente do processo na medição.
+    size_t getResidentBytes() const;
+    // Imprime os contêineres e as playlists que mais ocupam memória.
+    void print(std::ostream &os, size_t limit) const;
+    // Lê a memória residente do processo.
+    static size_t residentBytes();
+};
+
+#endif
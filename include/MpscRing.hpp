@@ -0,0 +1,161 @@
+/**
+ * @file MpscRing.hpp
+ * @brief Arquivo que contém a classe MpscRing, uma fila circular limitada sem travas.
+ */
+
+#ifndef MPSCRING_HPP
+#define MPSCRING_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Fila circular de capacidade fixa, sem travas, com vários produtores
+ * e um único consumidor.
+ *
+ * Cada posição tem um número de sequência que indica de quem é a vez de
+ * usá-la. Um produtor reserva uma posição avançando o fim da fila com
+ * compare-and-swap, escreve o valor e publica a posição atualizando a
+ * sequência; o consumidor só lê posições já publicadas. Nenhuma operação
+ * espera por outra thread nem aloca memória depois da construção. Com a fila
+ * cheia, push falha em vez de esperar; um produtor pode pedir que algumas
+ * posições fiquem livres para pedidos mais importantes (spare).
+ *
+ * tail e head são separados por preenchimento, e não por alignas, para que
+ * a fila (e as classes que a contêm) possam ser criadas com new em C++11,
+ * que não garante alinhamentos maiores que o de max_align_t. Cada um fica em
+ * uma linha de cache diferente da do outro e da dos campos só lidos.
+ *
+ * @tparam T Tipo dos valores, que deve poder ser copiado e construído sem argumentos.
+ */
+template <typename T>
+class MpscRing{
+
+    /**
+     * @brief Posição da fila.
+     */
+    struct Cell{
+        std::atomic<size_t> sequence; //!< Igual ao índice de escrita quando livre e a ele + 1 quando publicada.
+        T value; //!< Valor guardado.
+    };
+
+    //! Tamanho de uma linha de cache.
+    static const size_t cacheLine = 64;
+
+    std::unique_ptr<Cell[]> cells; //!< Posições da fila.
+    size_t mask; //!< Número de posições - 1; o número de posições é uma potência de 2.
+    char tailPadding[cacheLine]; //!< Separa tail dos campos só lidos.
+    std::atomic<size_t> tail; //!< Próximo índice de escrita, disputado pelos produtores.
+    char headPadding[cacheLine]; //!< Separa head de tail.
+    size_t head; //!< Próximo índice de leitura, usado apenas pelo consumidor.
+    char endPadding[cacheLine]; //!< Separa head dos campos de quem contém a fila.
+
+public:
+    // Construtor da fila vazia, com capacidade para pelo menos capacity valores.
+    MpscRing(size_t capacity);
+    // As posições guardam números de sequência, então a fila não pode ser copiada.
+    MpscRing(const MpscRing &other) = delete;
+    MpscRing &operator=(const MpscRing &other) = delete;
+    // Adiciona um valor ao fim da fila, se spare posições continuarem livres. Pode ser chamado por qualquer thread.
+    bool push(const T &value, size_t spare = 0);
+    // Retira o valor do início da fila. Chamado apenas pelo consumidor.
+    bool pop(T &value);
+    // Retorna a capacidade da fila.
+    size_t getCapacity() const;
+};
+
+/**
+ * @brief Construtor da fila vazia. A capacidade é arredondada para a
+ * próxima potência de 2.
+ *
+ * @param capacity Número mínimo de valores que a fila comporta.
+ */
+template <typename T>
+MpscRing<T>::MpscRing(size_t capacity) : tail(0), head(0){
+    size_t size = 2;
+    while(size < capacity){
+        size <<= 1;
+    }
+    cells.reset(new Cell[size]);
+    for(size_t i = 0; i < size; i++){
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = size - 1;
+}
+
+/**
+ * @brief Adiciona um valor ao fim da fila, sem esperar por outras threads.
+ *
+ * Com spare maior que 0, o valor só é adicionado se as spare posições
+ * seguintes também estiverem livres. Como as posições são liberadas em
+ * ordem, basta conferir a última delas. Produtores que passam spare = 0
+ * podem usar essas posições.
+ *
+ * @param value Valor a ser adicionado.
+ * @param spare Número de posições que devem continuar livres, menor que a capacidade.
+ * @return true se o valor foi adicionado, false se a fila está cheia.
+ */
+template <typename T>
+bool MpscRing<T>::push(const T &value, size_t spare){
+    size_t pos = tail.load(std::memory_order_relaxed);
+    Cell *cell;
+    while(true){
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if(sequence == pos && spare > 0 &&
+           cells[(pos + spare) & mask].sequence.load(std::memory_order_acquire) < pos + spare){
+            // Há espaço só para as posições reservadas
+            return false;
+        }
+        if(sequence == pos){
+            // A posição está livre: tenta reservá-la
+            if(tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                break;
+            }
+        }
+        else if(sequence < pos){
+            // A posição ainda guarda um valor de uma volta anterior
+            return false;
+        }
+        else{
+            // Outro produtor reservou a posição
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Retira o valor do início da fila. Deve ser chamado sempre pela
+ * mesma thread.
+ *
+ * @param value Recebe o valor retirado.
+ * @return true se um valor foi retirado, false se a fila está vazia ou o
+ * próximo valor ainda não foi publicado.
+ */
+template <typename T>
+bool MpscRing<T>::pop(T &value){
+    Cell *cell = &cells[head & mask];
+    if(cell->sequence.load(std::memory_order_acquire) != head + 1){
+        return false;
+    }
+    value = cell->value;
+    cell->sequence.store(head + mask + 1, std::memory_order_release);
+    head++;
+    return true;
+}
+
+/**
+ * @brief Retorna a capacidade da fila.
+ *
+ * @return Número de valores que a fila comporta.
+ */
+template <typename T>
+size_t MpscRing<T>::getCapacity() const{
+    return mask + 1;
+}
+
+#endif
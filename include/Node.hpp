@@ -6,6 +6,9 @@
 #ifndef NODE_HPP
 #define NODE_HPP
 
+#include <cstddef>
+#include "NodePool.hpp"
+
 /**
  * @brief Classe que implementa um nó de uma lista encadeada (LinkedList) template.
  * 
@@ -19,11 +22,21 @@ class Node{
 
 public:
     //Construtor que recebe o valor a ser colocado no nó.
-    Node(T &value);
+    Node(const T &value);
+    //Obtém a memória do nó na reserva de nós do mesmo tamanho.
+    static void *operator new(size_t size);
+    //Devolve a memória do nó à reserva.
+    static void operator delete(void *node);
+    //Reserva memória para count nós de uma só vez.
+    static void reserve(size_t count);
+    //Reserva um bloco novo em que os próximos count nós ficam lado a lado.
+    static void reserveContiguous(size_t count);
     //Retorna o valor do nó atual.
     T &getValue();
+    const T &getValue() const;
     //Retorna o ponteiro para o próximo nó.
     Node *getNext();
+    const Node *getNext() const;
     //Altera o valor do nó atual.
     void setValue(T value);
     //Altera o ponteiro para o próximo nó.
@@ -31,16 +44,59 @@ public:
 };
 
 /**
- * @brief Construtor que recebe o valor a ser colocado no nó.
+ * @brief Construtor que recebe o valor a ser colocado no nó. O valor é
+ * copiado diretamente, sem construir um valor padrão antes.
  * 
  * @param value Valor do nó.
  */
 template <typename T>
-Node<T>::Node(T &value){
-    setValue(value);
+Node<T>::Node(const T &value) : value(value){
     setNext(nullptr);
 }
 
+/**
+ * @brief Obtém a memória do nó na reserva (NodePool) compartilhada pelos nós
+ * do mesmo tamanho. O tamanho pedido, sempre sizeof(Node<T>), não é usado.
+ *
+ * @return Memória para o nó.
+ */
+template <typename T>
+void *Node<T>::operator new(size_t){
+    return NodePool<sizeof(Node<T>)>::allocate();
+}
+
+/**
+ * @brief Devolve a memória de um nó à reserva.
+ *
+ * @param node Memória do nó.
+ */
+template <typename T>
+void Node<T>::operator delete(void *node){
+    NodePool<sizeof(Node<T>)>::release(node);
+}
+
+/**
+ * @brief Reserva, em um único bloco se necessário, memória para os próximos
+ * count nós criados pela thread atual.
+ *
+ * @param count Número de nós.
+ */
+template <typename T>
+void Node<T>::reserve(size_t count){
+    NodePool<sizeof(Node<T>)>::reserve(count);
+}
+
+/**
+ * @brief Reserva um bloco novo para os próximos count nós criados pela thread
+ * atual, que ficam lado a lado na memória, na ordem em que forem criados.
+ *
+ * @param count Número de nós.
+ */
+template <typename T>
+void Node<T>::reserveContiguous(size_t count){
+    NodePool<sizeof(Node<T>)>::reserveContiguous(count);
+}
+
 /**
  * @brief Retorna o valor do nó.
  * 
@@ -51,6 +107,16 @@ T &Node<T>::getValue(){
     return value;
 }
 
+/**
+ * @brief Retorna o valor de um nó constante.
+ * 
+ * @return Valor do nó, somente para leitura.
+ */
+template <typename T>
+const T &Node<T>::getValue() const{
+    return value;
+}
+
 /**
  * @brief Retorna o ponteiro para o próximo nó na lista.
  * 
@@ -61,6 +127,16 @@ Node<T> *Node<T>::getNext(){
     return next;
 }
 
+/**
+ * @brief Retorna o ponteiro para o próximo nó de um nó constante.
+ * 
+ * @return Ponteiro para o próximo nó, somente para leitura.
+ */
+template <typename T>
+const Node<T> *Node<T>::getNext() const{
+    return next;
+}
+
 /**
  * @brief Altera o valor do nó.
  * 
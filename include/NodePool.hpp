@@ -0,0 +1,533 @@
+/**
+ * @file NodePool.hpp
+ * @brief Arquivo que contém a classe NodePool, que guarda a memória dos nós das listas encadeadas.
+ */
+
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Reserva de memória para objetos de tamanho fixo, usada pelos nós
+ * (Node) das listas encadeadas.
+ *
+ * A memória é obtida do sistema em blocos com vários espaços. Quando uma
+ * lista vai receber vários elementos de uma vez, reserve obtém um único bloco
+ * com espaço para todo o lote, em vez de uma alocação por nó.
+ *
+ * Cada thread tem sua própria lista de espaços livres (ThreadList), com uma
+ * trava que só trim disputa, então alocar e liberar um nó não espera por
+ * outras threads. Um espaço liberado entra na lista da thread que o liberou;
+ * quando essa lista cresce demais, parte dela vai para uma lista
+ * compartilhada, de onde as outras threads retiram espaços antes de pedir
+ * novos blocos ao sistema. Quando uma thread termina, todos os seus espaços
+ * livres, inclusive os reservados e ainda não usados, vão para a lista
+ * compartilhada.
+ *
+ * Depois de muitas alterações, os espaços livres ficam espalhados pelos
+ * blocos. reserveContiguous obtém um bloco novo para que os próximos nós
+ * fiquem lado a lado, na ordem em que forem criados, e trim devolve ao
+ * sistema os blocos que ficaram inteiramente livres, olhando as listas de
+ * todas as threads.
+ *
+ * @tparam Size Tamanho, em bytes, de cada espaço.
+ */
+template <size_t Size>
+class NodePool{
+
+    /**
+     * @brief Espaço livre, ligado ao próximo espaço livre.
+     */
+    struct Slot{
+        Slot *next; //!< Próximo espaço livre.
+    };
+
+    /**
+     * @brief Sequência de espaços livres passada entre threads.
+     */
+    struct Chunk{
+        Slot *first; //!< Primeiro espaço da sequência.
+        Slot *last; //!< Último espaço da sequência.
+        size_t count; //!< Número de espaços da sequência.
+    };
+
+    /**
+     * @brief Bloco obtido do sistema.
+     */
+    struct Block{
+        char *start; //!< Início do bloco.
+        size_t count; //!< Número de espaços do bloco.
+    };
+
+    /**
+     * @brief Espaços livres de uma thread. A lista se registra no estado
+     * compartilhado ao ser criada, para que trim a veja, e ao ser destruída,
+     * no fim da thread, devolve os espaços à lista compartilhada.
+     */
+    struct ThreadList{
+        std::mutex mutex; //!< Trava da lista, usada pela thread dona e por trim.
+        Slot *freeSlots; //!< Espaços livres da thread.
+        size_t freeCount; //!< Número de espaços livres da thread.
+
+        // Construtor, que registra a lista.
+        ThreadList();
+        // Destrutor, que devolve os espaços livres da thread.
+        ~ThreadList();
+    };
+
+    /**
+     * @brief Estado compartilhado entre as threads.
+     */
+    struct Shared{
+        std::mutex mutex; //!< Trava do estado compartilhado; é obtida antes da trava de uma ThreadList.
+        std::vector<Chunk> chunks; //!< Sequências de espaços livres devolvidas pelas threads.
+        std::vector<Block> blocks; //!< Blocos obtidos do sistema.
+        std::vector<ThreadList*> threads; //!< Listas das threads em execução.
+        size_t reserved; //!< Número de espaços de todos os blocos.
+    };
+
+    static thread_local ThreadList *current; //!< Lista da thread, ou nullptr antes do primeiro uso e depois do fim da thread.
+    static thread_local bool threadListCreated; //!< Indica se threadList já foi criado nesta thread.
+    static thread_local ThreadList threadList; //!< Lista da thread, criada no primeiro uso.
+
+    // Retorna o estado compartilhado.
+    static Shared &shared();
+    // Retorna a lista da thread, ou nullptr se a thread já terminou.
+    static ThreadList *threadSlots();
+    // Obtém do sistema um bloco com count espaços e os coloca à frente da lista.
+    static void grow(ThreadList *list, size_t count);
+    // Retorna um espaço da lista compartilhada, para threads que já terminaram.
+    static void *allocateShared();
+
+public:
+    //! Número mínimo de espaços de um bloco.
+    static const size_t blockSlots = 256;
+    //! Número de espaços de cada sequência passada para a lista compartilhada.
+    static const size_t chunkSlots = 4096;
+
+    // Retorna um espaço livre.
+    static void *allocate();
+    // Devolve um espaço.
+    static void release(void *slot);
+    // Garante que a thread tenha pelo menos count espaços livres.
+    static void reserve(size_t count);
+    // Obtém um bloco novo com count espaços, entregues em ordem pelos próximos allocate da thread.
+    static void reserveContiguous(size_t count);
+    // Devolve ao sistema os blocos inteiramente livres.
+    static size_t trim();
+    // Retorna a memória de todos os blocos obtidos do sistema.
+    static size_t getReservedBytes();
+};
+
+template <size_t Size>
+thread_local typename NodePool<Size>::ThreadList *NodePool<Size>::current = nullptr;
+
+template <size_t Size>
+thread_local bool NodePool<Size>::threadListCreated = false;
+
+template <size_t Size>
+thread_local typename NodePool<Size>::ThreadList NodePool<Size>::threadList;
+
+/**
+ * @brief Retorna o estado compartilhado entre as threads. Ele nunca é
+ * destruído, pois nós podem ser liberados durante o encerramento do programa.
+ *
+ * @return Estado compartilhado.
+ */
+template <size_t Size>
+typename NodePool<Size>::Shared &NodePool<Size>::shared(){
+    static Shared *state = new Shared();
+    return *state;
+}
+
+/**
+ * @brief Cria a lista vazia e a registra no estado compartilhado.
+ */
+template <size_t Size>
+NodePool<Size>::ThreadList::ThreadList(){
+    freeSlots = nullptr;
+    freeCount = 0;
+    Shared &state = shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.threads.push_back(this);
+}
+
+/**
+ * @brief Retira a lista do estado compartilhado e devolve à lista
+ * compartilhada, como uma única sequência, os espaços livres da thread que
+ * está terminando. Sem isso, os espaços ficariam perdidos, e os blocos que os
+ * contêm nunca poderiam ser devolvidos (trim). Nós liberados depois disso
+ * pela mesma thread vão direto para a lista compartilhada.
+ */
+template <size_t Size>
+NodePool<Size>::ThreadList::~ThreadList(){
+    current = nullptr;
+    Shared &state = shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.threads.erase(std::find(state.threads.begin(), state.threads.end(), this));
+    if(freeSlots == nullptr){
+        return;
+    }
+    Chunk chunk;
+    chunk.first = freeSlots;
+    chunk.last = freeSlots;
+    while(chunk.last->next != nullptr){
+        chunk.last = chunk.last->next;
+    }
+    chunk.count = freeCount;
+    freeSlots = nullptr;
+    freeCount = 0;
+    state.chunks.push_back(chunk);
+}
+
+/**
+ * @brief Retorna a lista da thread, criando-a no primeiro uso.
+ * threadListCreated evita o custo da criação sob demanda nas demais chamadas
+ * e impede que a lista seja recriada depois do fim da thread.
+ *
+ * @return Lista da thread, ou nullptr se a thread já está terminando.
+ */
+template <size_t Size>
+typename NodePool<Size>::ThreadList *NodePool<Size>::threadSlots(){
+    if(current == nullptr && !threadListCreated){
+        threadListCreated = true;
+        current = &threadList;
+    }
+    return current;
+}
+
+/**
+ * @brief Obtém do sistema um único bloco com count espaços e os coloca, em
+ * ordem, à frente dos espaços livres da thread (ou na lista compartilhada,
+ * se a thread já terminou).
+ *
+ * @param list Lista da thread, ou nullptr.
+ * @param count Número de espaços do bloco.
+ */
+template <size_t Size>
+void NodePool<Size>::grow(ThreadList *list, size_t count){
+    char *block = static_cast<char*>(::operator new(count * Size));
+    for(size_t i = 0; i + 1 < count; i++){
+        reinterpret_cast<Slot*>(block + i * Size)->next = reinterpret_cast<Slot*>(block + (i + 1) * Size);
+    }
+    Chunk chunk;
+    chunk.first = reinterpret_cast<Slot*>(block);
+    chunk.last = reinterpret_cast<Slot*>(block + (count - 1) * Size);
+    chunk.count = count;
+    chunk.last->next = nullptr;
+
+    Shared &state = shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    Block added;
+    added.start = block;
+    added.count = count;
+    state.blocks.push_back(added);
+    state.reserved += count;
+    if(list == nullptr){
+        state.chunks.push_back(chunk);
+        return;
+    }
+    std::lock_guard<std::mutex> own(list->mutex);
+    chunk.last->next = list->freeSlots;
+    list->freeSlots = chunk.first;
+    list->freeCount += count;
+}
+
+/**
+ * @brief Retorna um espaço da lista compartilhada, obtendo um bloco se ela
+ * estiver vazia. Usado apenas quando a thread já terminou e não tem mais
+ * lista própria.
+ *
+ * @return Espaço com Size bytes.
+ */
+template <size_t Size>
+void *NodePool<Size>::allocateShared(){
+    Shared &state = shared();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if(!state.chunks.empty()){
+            Chunk &chunk = state.chunks.back();
+            Slot *slot = chunk.first;
+            chunk.first = slot->next;
+            if(--chunk.count == 0){
+                state.chunks.pop_back();
+            }
+            return slot;
+        }
+    }
+    grow(nullptr, blockSlots);
+    return allocateShared();
+}
+
+/**
+ * @brief Garante que a thread tenha pelo menos count espaços livres,
+ * retirando sequências da lista compartilhada e, se ainda faltarem espaços,
+ * obtendo um único bloco com todos os que faltam.
+ *
+ * @param count Número de espaços necessários.
+ */
+template <size_t Size>
+void NodePool<Size>::reserve(size_t count){
+    ThreadList *list = threadSlots();
+    if(list == nullptr){
+        return;
+    }
+    size_t missing;
+    {
+        std::lock_guard<std::mutex> own(list->mutex);
+        if(list->freeCount >= count){
+            return;
+        }
+        missing = count - list->freeCount;
+    }
+    {
+        Shared &state = shared();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if(!state.chunks.empty()){
+            std::lock_guard<std::mutex> own(list->mutex);
+            while(list->freeCount < count && !state.chunks.empty()){
+                Chunk chunk = state.chunks.back();
+                state.chunks.pop_back();
+
+                chunk.last->next = list->freeSlots;
+                list->freeSlots = chunk.first;
+                list->freeCount += chunk.count;
+            }
+            missing = (list->freeCount < count) ? count - list->freeCount : 0;
+        }
+    }
+    if(missing > 0){
+        grow(list, missing < blockSlots ? blockSlots : missing);
+    }
+}
+
+/**
+ * @brief Retorna um espaço livre da thread, obtendo mais espaços se necessário.
+ *
+ * @return Espaço com Size bytes, alinhado para qualquer tipo.
+ */
+template <size_t Size>
+void *NodePool<Size>::allocate(){
+    ThreadList *list = threadSlots();
+    if(list == nullptr){
+        return allocateShared();
+    }
+    for(;;){
+        {
+            std::lock_guard<std::mutex> own(list->mutex);
+            Slot *slot = list->freeSlots;
+            if(slot != nullptr){
+                list->freeSlots = slot->next;
+                list->freeCount--;
+                return slot;
+            }
+        }
+        reserve(1);
+    }
+}
+
+/**
+ * @brief Devolve um espaço aos espaços livres da thread. Quando a thread
+ * tem pelo menos duas sequências de espaços livres, uma delas vai para a
+ * lista compartilhada.
+ *
+ * @param slot Espaço obtido com allocate.
+ */
+template <size_t Size>
+void NodePool<Size>::release(void *slot){
+    if(slot == nullptr){
+        return;
+    }
+    Slot *freed = static_cast<Slot*>(slot);
+    ThreadList *list = threadSlots();
+    Chunk chunk;
+    if(list == nullptr){
+        freed->next = nullptr;
+        chunk.first = freed;
+        chunk.last = freed;
+        chunk.count = 1;
+    }
+    else{
+        std::lock_guard<std::mutex> own(list->mutex);
+        freed->next = list->freeSlots;
+        list->freeSlots = freed;
+        list->freeCount++;
+        if(list->freeCount < 2 * chunkSlots){
+            return;
+        }
+        chunk.first = list->freeSlots;
+        chunk.count = chunkSlots;
+        Slot *last = list->freeSlots;
+        for(size_t i = 1; i < chunkSlots; i++){
+            last = last->next;
+        }
+        list->freeSlots = last->next;
+        list->freeCount -= chunkSlots;
+        last->next = nullptr;
+        chunk.last = last;
+    }
+
+    // A trava da thread já foi solta, pois a compartilhada vem sempre antes
+    Shared &state = shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.chunks.push_back(chunk);
+}
+
+/**
+ * @brief Obtém do sistema um bloco novo com count espaços, colocados à
+ * frente dos espaços livres da thread. Os próximos count espaços entregues
+ * por allocate nesta thread são consecutivos no bloco, na ordem dos pedidos,
+ * mesmo que a thread tenha outros espaços livres espalhados.
+ *
+ * @param count Número de espaços.
+ */
+template <size_t Size>
+void NodePool<Size>::reserveContiguous(size_t count){
+    if(count > 0){
+        grow(threadSlots(), count);
+    }
+}
+
+/**
+ * @brief Devolve ao sistema os blocos cujos espaços estão todos livres, nas
+ * listas de todas as threads ou na lista compartilhada. As listas das threads
+ * ficam travadas durante a chamada, então as outras threads só esperam se
+ * alocarem ou liberarem nós nesse intervalo. Custa O(F log B), com F espaços
+ * livres e B blocos.
+ *
+ * @return Bytes devolvidos ao sistema.
+ */
+template <size_t Size>
+size_t NodePool<Size>::trim(){
+    Shared &state = shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<Block> &blocks = state.blocks;
+    if(blocks.empty()){
+        return 0;
+    }
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for(size_t i = 0; i < state.threads.size(); i++){
+        locks.push_back(std::unique_lock<std::mutex>(state.threads[i]->mutex));
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const Block &a, const Block &b){
+        return a.start < b.start;
+    });
+
+    // Bloco que contém um espaço livre
+    auto owner = [&blocks](Slot *slot){
+        char *address = reinterpret_cast<char*>(slot);
+        size_t low = 0;
+        size_t high = blocks.size();
+        while(high - low > 1){
+            size_t mid = (low + high) / 2;
+            if(blocks[mid].start <= address){
+                low = mid;
+            }
+            else{
+                high = mid;
+            }
+        }
+        return low;
+    };
+
+    std::vector<size_t> freeInBlock(blocks.size(), 0);
+    for(size_t i = 0; i < state.threads.size(); i++){
+        for(Slot *slot = state.threads[i]->freeSlots; slot != nullptr; slot = slot->next){
+            freeInBlock[owner(slot)]++;
+        }
+    }
+    for(size_t i = 0; i < state.chunks.size(); i++){
+        Slot *slot = state.chunks[i].first;
+        for(size_t k = 0; k < state.chunks[i].count; k++){
+            freeInBlock[owner(slot)]++;
+            slot = slot->next;
+        }
+    }
+
+    std::vector<char> released(blocks.size(), 0);
+    bool any = false;
+    for(size_t i = 0; i < blocks.size(); i++){
+        if(freeInBlock[i] == blocks[i].count){
+            released[i] = 1;
+            any = true;
+        }
+    }
+    if(!any){
+        return 0;
+    }
+
+    // Retira das listas os espaços dos blocos devolvidos, mantendo a ordem dos demais
+    for(size_t i = 0; i < state.threads.size(); i++){
+        ThreadList &list = *state.threads[i];
+        Slot *kept = nullptr;
+        Slot **link = &kept;
+        list.freeCount = 0;
+        for(Slot *slot = list.freeSlots; slot != nullptr; slot = slot->next){
+            if(!released[owner(slot)]){
+                *link = slot;
+                link = &slot->next;
+                list.freeCount++;
+            }
+        }
+        *link = nullptr;
+        list.freeSlots = kept;
+    }
+
+    std::vector<Slot*> remaining;
+    for(size_t i = 0; i < state.chunks.size(); i++){
+        Slot *slot = state.chunks[i].first;
+        for(size_t k = 0; k < state.chunks[i].count; k++){
+            if(!released[owner(slot)]){
+                remaining.push_back(slot);
+            }
+            slot = slot->next;
+        }
+    }
+    state.chunks.clear();
+    for(size_t i = 0; i < remaining.size(); i += chunkSlots){
+        size_t end = std::min(remaining.size(), i + chunkSlots);
+        for(size_t k = i; k + 1 < end; k++){
+            remaining[k]->next = remaining[k + 1];
+        }
+        remaining[end - 1]->next = nullptr;
+        Chunk chunk;
+        chunk.first = remaining[i];
+        chunk.last = remaining[end - 1];
+        chunk.count = end - i;
+        state.chunks.push_back(chunk);
+    }
+
+    size_t bytes = 0;
+    size_t next = 0;
+    for(size_t i = 0; i < blocks.size(); i++){
+        if(released[i]){
+            bytes += blocks[i].count * Size;
+            state.reserved -= blocks[i].count;
+            ::operator delete(blocks[i].start);
+        }
+        else{
+            blocks[next++] = blocks[i];
+        }
+    }
+    blocks.resize(next);
+    return bytes;
+}
+
+/**
+ * @brief Retorna a memória de todos os blocos obtidos do sistema, livres ou não.
+ *
+ * @return Bytes reservados.
+ */
+template <size_t Size>
+size_t NodePool<Size>::getReservedBytes(){
+    Shared &state = shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.reserved * Size;
+}
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file PlaybackScheduler.hpp
+ * @brief Arquivo que contém a classe PlaybackScheduler, que toca várias playlists ao mesmo tempo.
+ */
+
+#ifndef PLAYBACKSCHEDULER_HPP
+#define PLAYBACKSCHEDULER_HPP
+
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "Library.hpp"
+#include "TimerWheel.hpp"
+#include "UpNextQueue.hpp"
+
+/**
+ * @brief Classe que simula a reprodução de várias playlists ao mesmo tempo,
+ * como canais tocando sem parar.
+ *
+ * Cada sessão toca uma playlist em sequência, voltando ao início quando ela
+ * acaba. A troca de música de cada sessão é um temporizador em uma roda
+ * hierárquica (TimerWheel) com resolução de 1 ms, agendado pela duração da
+ * música atual; cada troca custa O(1), independente do número de sessões.
+ * Músicas sem duração usam uma duração padrão.
+ *
+ * O tempo pode ser simulado, avançando o mais rápido possível (advance), ou
+ * acompanhar o relógio, com um fator de velocidade (run). As playlists vêm de
+ * uma versão publicada da biblioteca, guardada enquanto o agendador existir.
+ *
+ * Cada sessão pode ter uma fila de músicas a tocar em seguida (UpNextQueue),
+ * criada no primeiro getQueue. Na troca de música, a sessão toca a próxima
+ * música da fila; com a fila vazia, continua a playlist de onde parou. As
+ * filas podem ser alteradas por outras threads enquanto a reprodução avança,
+ * sem travas; os demais métodos devem ser chamados pela thread de reprodução,
+ * e as sessões devem ser criadas antes de outras threads usarem as filas.
+ */
+class PlaybackScheduler{
+
+public:
+    /**
+     * @brief Troca de música de uma sessão.
+     */
+    struct TrackChange{
+        size_t session; //!< Identificador da sessão.
+        const Song *song; //!< Música que começou a tocar.
+        size_t position; //!< Posição da música na playlist, começando em 0, ou da última música tocada da playlist se queued.
+        bool queued; //!< Indica se a música veio da fila da sessão.
+        unsigned long long due; //!< Tempo previsto da troca, em ms.
+        double late; //!< Atraso da troca em relação ao relógio, em ms, ou 0 no tempo simulado.
+    };
+
+private:
+    /**
+     * @brief Sessão de reprodução de uma playlist.
+     */
+    struct Session{
+        TimerWheel::Timer timer; //!< Temporizador da próxima troca de música.
+        const Playlist *playlist; //!< Playlist tocada.
+        const Node<Song> *track; //!< Música atual da playlist, ou a última tocada dela se current veio da fila.
+        const Song *current; //!< Música atual, ou nullptr se a playlist está vazia.
+        size_t position; //!< Posição de track.
+        std::atomic<UpNextQueue*> queue; //!< Fila de músicas a tocar em seguida, ou nullptr se ainda não foi criada.
+
+        // Construtor de uma sessão parada, sem fila.
+        Session() : playlist(nullptr), track(nullptr), current(nullptr), position(0), queue(nullptr) {}
+    };
+
+    std::shared_ptr<const Library::Snapshot> snapshot; //!< Versão da biblioteca com as playlists tocadas.
+    TimerWheel wheel; //!< Trocas de música agendadas, em ms.
+    std::deque<Session> sessions; //!< Sessões, pelo identificador; o deque não move as sessões.
+    unsigned defaultDuration; //!< Duração, em segundos, das músicas sem duração.
+    size_t active; //!< Número de sessões tocando.
+
+    // Retorna a duração de uma música, em ms.
+    unsigned long long durationOf(const Song &song) const;
+    // Passa uma sessão para a próxima música e agenda a troca seguinte.
+    TrackChange next(TimerWheel::Timer &timer);
+
+public:
+    //! Número de músicas, e de pedidos ainda não aplicados, que cabem na fila de cada sessão.
+    static const size_t queueCapacity = 64;
+
+    // Construtor do agendador, que toca playlists de uma versão da biblioteca.
+    PlaybackScheduler(std::shared_ptr<const Library::Snapshot> snapshot, unsigned defaultDuration = 180);
+    // Destrutor, que libera as filas das sessões.
+    ~PlaybackScheduler();
+    // Começa uma sessão que toca uma playlist.
+    size_t addSession(const Playlist *playlist, size_t position = 0, unsigned long long elapsed = 0);
+    // Interrompe uma sessão.
+    void stopSession(size_t id);
+    // Retorna a música atual de uma sessão.
+    const Song *getTrack(size_t id) const;
+    // Retorna a fila de músicas a tocar em seguida de uma sessão. Pode ser chamado por qualquer thread.
+    UpNextQueue &getQueue(size_t id);
+    // Retorna o tempo atual, em ms.
+    unsigned long long getTime() const;
+    // Retorna o número de sessões tocando.
+    size_t getActiveSessions() const;
+    // Avança o tempo simulado, informando as trocas de música.
+    template <typename Handler>
+    size_t advance(unsigned long long to, Handler onChange);
+    // Avança o tempo acompanhando o relógio, informando as trocas de música.
+    template <typename Handler>
+    size_t run(unsigned long long until, double speed, Handler onChange);
+};
+
+/**
+ * @brief Avança o tempo simulado até o instante especificado, sem esperar
+ * pelo relógio. As trocas são informadas em ordem de tempo; trocas no mesmo
+ * milissegundo não têm ordem definida.
+ *
+ * @param to Instante final, em ms.
+ * @param onChange Função chamada com cada troca de música (const TrackChange&).
+ * @return Número de trocas de música.
+ */
+template <typename Handler>
+size_t PlaybackScheduler::advance(unsigned long long to, Handler onChange){
+    return wheel.advance(to, [this, &onChange](TimerWheel::Timer &timer){
+        TrackChange change = next(timer);
+        onChange(change);
+    });
+}
+
+/**
+ * @brief Avança o tempo acompanhando o relógio até o instante especificado.
+ * Cada milissegundo simulado dura 1 / speed ms no relógio; o atraso de cada
+ * troca é a diferença entre o horário em que ela foi feita e o previsto.
+ *
+ * @param until Instante final, em ms de tempo simulado.
+ * @param speed Fator de velocidade em relação ao relógio, maior que zero.
+ * @param onChange Função chamada com cada troca de música (const TrackChange&).
+ * @return Número de trocas de música.
+ */
+template <typename Handler>
+size_t PlaybackScheduler::run(unsigned long long until, double speed, Handler onChange){
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::duration<double, std::milli> Millis;
+
+    Clock::time_point begin = Clock::now();
+    unsigned long long start = wheel.getTime();
+    size_t changes = 0;
+
+    while(wheel.getTime() < until){
+        double elapsed = Millis(Clock::now() - begin).count();
+        unsigned long long target = start + (unsigned long long)(elapsed * speed);
+        if(target > until){
+            target = until;
+        }
+
+        changes += wheel.advance(target, [this, &onChange, elapsed, start, speed](TimerWheel::Timer &timer){
+            TrackChange change = next(timer);
+            change.late = elapsed - (change.due - start) / speed;
+            onChange(change);
+        });
+
+        Millis wait((wheel.getTime() + 1 - start) / speed);
+        std::this_thread::sleep_until(begin + std::chrono::duration_cast<Clock::duration>(wait));
+    }
+    return changes;
+}
+
+#endif
@@ -7,49 +7,141 @@
 #define PLAYLIST_HPP
 
 #include <string>
+#include <vector>
+#include <initializer_list>
 #include "Node.hpp"
 #include "LinkedList.hpp"
 #include "Song.hpp"
+#include "PlaylistView.hpp"
+#include "SongOrder.hpp"
+#include "SortedView.hpp"
+#include "PlaylistStats.hpp"
+#include "PlaylistSignature.hpp"
+#include "SongSet.hpp"
+
+class SmartPlaylists;
+class EditHistory;
 
 /**
  * @brief Classe que implementa uma playlist, contendo uma lista encadeada 
  * (LinkedList) de músicas (Song).
+ *
+ * Os totais da playlist (PlaylistStats) são atualizados pelos métodos que
+ * alteram as músicas. Se a lista for alterada diretamente, por getSongs, a
+ * versão da lista muda e os totais são recalculados na próxima consulta.
+ *
+ * Uma playlist da biblioteca também avisa cada música adicionada ou
+ * removida às playlists inteligentes (SmartPlaylists), que usam os avisos
+ * para se atualizar sem recalcular suas regras. As cópias não avisam.
+ *
+ * Da mesma forma, uma playlist da biblioteca registra suas alterações no
+ * histórico (EditHistory), para que possam ser desfeitas. As cópias não
+ * registram.
+ *
+ * Na primeira alteração depois de cada publicação, uma playlist da
+ * biblioteca também se coloca na lista de playlists alteradas
+ * (setChangeList), para que a publicação não precise percorrer as demais.
+ * Como getSongs permite alterar a lista, chamá-lo já conta como alteração;
+ * quem só lê as músicas usa readSongs, que não conta.
+ *
+ * Os métodos constantes não alteram nada, nem os totais e a visão ordenada
+ * guardados, então podem ser chamados por várias threads ao mesmo tempo, como
+ * nas cópias publicadas pela biblioteca (Library::Snapshot).
  */
 class Playlist{
 
 private:
     std::string name; //!< Nome da playlist.
     LinkedList<Song> songs; //!< Lista de músicas da playlist.
+    SortedView<Song, SongOrder> sortedSongs; //!< Última visão ordenada calculada.
+    PlaylistStats stats; //!< Totais das músicas, válidos enquanto a lista tiver a versão statsVersion.
+    unsigned long long statsVersion; //!< Versão da lista quando os totais foram atualizados.
+    SmartPlaylists *smart; //!< Playlists inteligentes avisadas das alterações, ou nullptr.
+    EditHistory *history; //!< Histórico que registra as alterações, ou nullptr.
+    std::vector<Playlist*> *changed; //!< Lista de playlists alteradas desde a última publicação, ou nullptr.
+    bool listed; //!< Indica se a playlist já está na lista de playlists alteradas.
+
+    // Retorna os totais, recalculando-os se a lista foi alterada diretamente.
+    PlaylistStats &syncStats();
+    // Avisa as playlists inteligentes das músicas adicionadas a partir de um nó.
+    void notifyAdded(unsigned long long prior, const Node<Song> *first);
+    // Registra no histórico as músicas adicionadas depois de um nó.
+    void recordAdded(unsigned long long prior, Node<Song> *lastKnown);
+    // Coloca a playlist na lista de playlists alteradas, se ainda não estiver nela.
+    void markChanged();
 
 public:
     // Construtor padrão da playlist. 
     Playlist();
     //Construtor cópia da playlist.
     Playlist(Playlist *playlist);
+    Playlist(const Playlist &playlist);
+    //Atribuição por cópia, que copia o nome, as músicas e os totais.
+    Playlist &operator=(const Playlist &playlist);
     // Construtor da playlist que recebe seu nome. 
     Playlist(std::string name);
     // Destrutor da playlist, que remove todas as músicas. 
     ~Playlist();
     // Retorna o tamanho da playlist.
-    size_t getSize();
+    size_t getSize() const;
     // Retorna o nome da playlist. 
-    std::string getName();
+    std::string getName() const;
     // Retorna uma referência para a lista encadeada de músicas. 
     LinkedList<Song> &getSongs();
+    // Retorna a lista encadeada de músicas, somente para leitura.
+    const LinkedList<Song> &readSongs() const;
     // Adiciona uma música à playlist. 
     void addSong(Song song);
+    // Adiciona de uma só vez as músicas, ou ponteiros para músicas, de um intervalo.
+    template <typename Iterator>
+    void addSongs(Iterator first, Iterator last);
+    // Adiciona de uma só vez as músicas de uma lista de inicialização.
+    void addSongs(std::initializer_list<Song> songs);
+    // Adiciona de uma só vez músicas do catálogo, indicadas por ponteiros.
+    void addSongs(const std::vector<Song*> &catalogSongs);
+    void addSongs(const std::vector<const Song*> &catalogSongs);
     // Remove a música especificada da playlist. 
     void removeSong(Song song);
+    // Remove de uma só vez todas as ocorrências das músicas de um conjunto.
+    size_t removeSongs(const SongSet &removed);
+    // Substitui as músicas da playlist pelas de outra, sem copiá-las.
+    void replaceSongs(Playlist &source);
+    // Copia as músicas para nós lado a lado na memória, na ordem da playlist.
+    void compact();
+    // Retorna os totais das músicas da playlist.
+    const PlaylistStats &getStats();
+    // Retorna os totais guardados, sem recalculá-los.
+    const PlaylistStats &getStats() const;
+    // Retorna a assinatura MinHash das músicas.
+    const PlaylistSignature &getSignature();
+    // Retorna a assinatura guardada, sem recalculá-la.
+    const PlaylistSignature &getSignature() const;
+    // Define as playlists inteligentes avisadas das alterações.
+    void setSmartPlaylists(SmartPlaylists *smart);
+    // Define o histórico que registra as alterações.
+    void setEditHistory(EditHistory *history);
+    // Define a lista que recebe a playlist quando ela for alterada.
+    void setChangeList(std::vector<Playlist*> *changed);
     // Procura uma música na playlist. 
     Song *searchSong(Song song);
     // Imprime as músicas da playlist. 
     void printSongs();
+    // Imprime as músicas da playlist na ordenação especificada.
+    void printSongs(SongOrder order);
+    // Retorna as músicas da playlist ordenadas, sem alterar a playlist.
+    std::vector<Song*> &getSortedSongs(SongOrder order);
+    // Ordena as músicas da playlist.
+    void sort(SongOrder order);
     // Sobrecarga de operador de igualdade. 
     friend std::ostream& operator<<(std::ostream& os, const Playlist& playlist);
     // Sobrecarga de operador de inserção da playlist. 
     void addSong(Playlist &playlist);
     //Sobrecarga de operador de remoção de playlist.
     void removeSong(Playlist &playlist);
+    // Move todas as músicas de outra playlist para o final desta, sem copiá-las.
+    void moveSongs(Playlist &source);
+    // Move um trecho de músicas de outra playlist para o final desta, sem copiá-las.
+    size_t moveSongs(Playlist &source, size_t position, size_t count);
     //Sobrecarga do operador de adição.
     Playlist operator+(Playlist &b);
     //Sobrecarga do operador de adição.
@@ -58,6 +150,8 @@ public:
     Playlist operator-(Playlist &b);
     //Sobrecarga do operador de subtração.
     Playlist operator-(Song &song);
+    // Retorna uma visão preguiçosa da playlist, que pode ser combinada com outras.
+    PlaylistView view() const;
     //Sobrecarga do operador de extração.
     void operator>>(Song &song);
     //Sobrecarga do operador de inserção.
@@ -70,11 +164,34 @@ public:
     //Sobrecarga do operador de atribuição de valor.
     template <typename T>
     void operator=(T b){
+        markChanged();
         this->name = b.getName();
-        this->songs = b.getSongs();}
+        this->songs = b.readSongs();}
 
 };
 
+/**
+ * @brief Adiciona de uma só vez as músicas, ou ponteiros para músicas, de um
+ * intervalo, reservando a memória dos nós de uma vez. Os totais recebem as
+ * músicas novas, a partir do antigo último nó.
+ *
+ * @param first Início do intervalo.
+ * @param last Fim do intervalo.
+ */
+template <typename Iterator>
+void Playlist::addSongs(Iterator first, Iterator last){
+    markChanged();
+    PlaylistStats &totals = syncStats();
+    unsigned long long prior = songs.getVersion();
+    Node<Song> *lastKnown = songs.getTail();
+    songs.addAll(first, last);
+    Node<Song> *added = (lastKnown != nullptr) ? lastKnown->getNext() : songs.getHead();
+    totals.add(added);
+    statsVersion = songs.getVersion();
+    notifyAdded(prior, added);
+    recordAdded(prior, lastKnown);
+}
+
 #endif
 
 
@@ -0,0 +1,86 @@
+/**
+ * @file PlaylistAggregator.hpp
+ * @brief Arquivo que contém a classe PlaylistAggregator, com as consultas que percorrem todas as playlists.
+ */
+
+#ifndef PLAYLISTAGGREGATOR_HPP
+#define PLAYLISTAGGREGATOR_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "LinkedList.hpp"
+#include "Playlist.hpp"
+
+/**
+ * @brief Consultas sobre todas as playlists: as músicas e os autores presentes
+ * em mais playlists e a distribuição do tamanho das playlists.
+ *
+ * As playlists são repartidas entre as threads em grupos, pegos conforme cada
+ * thread termina o anterior. Cada thread conta em tabelas próprias, sem
+ * travas, divididas em uma parte por thread pelo hash da chave; depois, cada
+ * thread junta a mesma parte das tabelas de todas e escolhe os k maiores
+ * dela, e os k maiores de cada parte são ordenados no final.
+ *
+ * As contagens exatas guardam todas as músicas (ou autores) distintas. Para
+ * bibliotecas enormes, as versões aproximadas usam um resumo Space-Saving de
+ * tamanho fixo por thread (SpaceSaving), com as contagens estimadas e o erro
+ * máximo de cada uma.
+ *
+ * As playlists não podem ser alteradas durante uma consulta; em geral elas
+ * vêm de uma versão publicada da biblioteca (Library::Snapshot).
+ */
+class PlaylistAggregator{
+
+public:
+    /**
+     * @brief Música ou autor de uma classificação.
+     */
+    struct Ranked{
+        std::string title; //!< Título da música, ou vazio na classificação de autores.
+        std::string author; //!< Autor.
+        size_t count; //!< Número de playlists em que a música ou o autor aparece (estimado nas consultas aproximadas).
+        size_t error; //!< Quanto count pode passar do valor real; 0 nas consultas exatas.
+    };
+
+    /**
+     * @brief Faixa de tamanhos do histograma.
+     */
+    struct SizeBucket{
+        size_t low; //!< Menor tamanho da faixa.
+        size_t high; //!< Maior tamanho da faixa.
+        size_t playlists; //!< Número de playlists com tamanho na faixa.
+    };
+
+    /**
+     * @brief O que é contado: cada música ou o autor de cada música.
+     */
+    enum Subject{
+        Songs, //!< Músicas, pela identidade (título e autor).
+        Authors //!< Autores, pela chave normalizada do autor.
+    };
+
+private:
+    std::vector<const Playlist*> playlists; //!< Playlists consultadas.
+    unsigned threads; //!< Número de threads usadas.
+
+    // Executa work(t) em threads threads, t de 0 a threads - 1.
+    template <typename Work>
+    void run(unsigned count, Work work) const;
+
+public:
+    // Construtor que consulta as playlists de uma lista.
+    PlaylistAggregator(const LinkedList<Playlist> &playlists, unsigned threads = 0);
+    // Construtor que consulta as playlists de uma versão publicada.
+    PlaylistAggregator(const std::vector<std::shared_ptr<const Playlist>> &playlists, unsigned threads = 0);
+    // Retorna as k músicas ou autores presentes em mais playlists.
+    void top(Subject subject, size_t k, std::vector<Ranked> &result) const;
+    // Estima as k músicas ou autores presentes em mais playlists, com resumos de capacity itens.
+    void approximateTop(Subject subject, size_t k, size_t capacity, std::vector<Ranked> &result) const;
+    // Conta as playlists por faixa de tamanho (0, 1, 2-3, 4-7, ...).
+    void sizeHistogram(std::vector<SizeBucket> &result) const;
+    // Retorna o número de threads usadas.
+    unsigned getThreads() const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file PlaylistCombiner.hpp
+ * @brief Arquivo que contém a classe PlaylistCombiner, que combina várias playlists de uma vez.
+ */
+
+#ifndef PLAYLISTCOMBINER_HPP
+#define PLAYLISTCOMBINER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+
+/**
+ * @brief Combina qualquer número de playlists com uma só passagem por elas:
+ * união, interseção ou diferença.
+ *
+ * Os resultados são os mesmos de aplicar os operadores de Playlist da
+ * esquerda para a direita (A + B + C, A - B - C), mas sem criar playlists
+ * intermediárias: cada música de cada playlist é lida uma vez e procurada uma
+ * vez em uma tabela de hash compartilhada, indexada pela identidade da
+ * música. As músicas ficam na ordem em que aparecem pela primeira vez, e as
+ * músicas repetidas da primeira playlist são mantidas, como nos operadores.
+ *
+ * Com mais de uma thread, as músicas são divididas entre as threads pelo hash
+ * da identidade: cada thread lê algumas playlists e separa as músicas por
+ * parte, e depois cada thread percorre a sua parte de todas as playlists em
+ * ordem, decidindo quais ocorrências entram no resultado. A ordem do
+ * resultado é a mesma com qualquer número de threads.
+ *
+ * @note As playlists não podem ser alteradas enquanto o combinador é usado.
+ */
+class PlaylistCombiner{
+
+public:
+    /**
+     * @brief Operação aplicada às playlists.
+     */
+    enum Operation{
+        Union, //!< Músicas de todas as playlists.
+        Intersection, //!< Músicas da primeira playlist presentes em todas as outras.
+        Difference //!< Músicas da primeira playlist ausentes de todas as outras.
+    };
+
+private:
+    /**
+     * @brief Ocorrências de uma playlist.
+     */
+    struct Input{
+        std::vector<const Song*> songs; //!< Músicas da playlist, em ordem.
+        std::vector<std::vector<uint32_t>> parts; //!< Posições das músicas de cada parte, em ordem.
+        std::vector<char> kept; //!< Indica, para cada posição, se a ocorrência entra no resultado.
+    };
+
+    std::vector<const Playlist*> playlists; //!< Playlists combinadas, na ordem da operação.
+    unsigned threads; //!< Número de threads usadas.
+
+    // Decide quais ocorrências de uma parte entram no resultado.
+    void combinePart(Operation operation, size_t part, std::vector<Input> &inputs) const;
+
+public:
+    // Construtor que recebe as playlists, na ordem da operação.
+    PlaylistCombiner(const std::vector<const Playlist*> &playlists, unsigned threads = 1);
+    // Calcula as músicas do resultado da operação.
+    void combine(Operation operation, std::vector<const Song*> &result) const;
+    // Cria uma playlist com o resultado da operação.
+    Playlist materialize(Operation operation, std::string name = "") const;
+    // Retorna o número de threads usadas.
+    unsigned getThreads() const;
+};
+
+#endif
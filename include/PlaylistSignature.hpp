@@ -0,0 +1,62 @@
+/**
+ * @file PlaylistSignature.hpp
+ * @brief Arquivo que contém a classe PlaylistSignature, a assinatura MinHash das músicas de uma playlist.
+ */
+
+#ifndef PLAYLISTSIGNATURE_HPP
+#define PLAYLISTSIGNATURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "Node.hpp"
+#include "Song.hpp"
+
+/**
+ * @brief Assinatura MinHash do conjunto de músicas de uma playlist, usada
+ * para estimar a semelhança entre playlists sem compará-las música a música.
+ *
+ * A assinatura guarda, para cada uma de size funções de hash, o menor hash
+ * entre as músicas da playlist. A fração de posições iguais nas assinaturas
+ * de duas playlists estima a semelhança de Jaccard entre elas (músicas em
+ * comum dividido pelas músicas de qualquer uma), com erro padrão de cerca de
+ * 1/sqrt(size). Os hashes partem da identidade já calculada em cada música
+ * (getFingerprint).
+ *
+ * Adicionar uma música custa O(size). Um mínimo não pode ser desfeito, então
+ * retirar uma música que era o mínimo de alguma posição marca a assinatura
+ * como desatualizada; quem tem as músicas a recalcula quando precisar dela.
+ */
+class PlaylistSignature{
+
+public:
+    //! Número de funções de hash da assinatura.
+    static const size_t size = 64;
+
+private:
+    uint32_t mins[size]; //!< Menor hash das músicas em cada função.
+    bool stale; //!< Indica se uma música retirada pode ter sido um dos mínimos.
+
+public:
+    // Construtor da assinatura de uma playlist vazia.
+    PlaylistSignature();
+    // Adiciona uma música à assinatura.
+    void add(const Song &song);
+    // Adiciona à assinatura as músicas de um nó até o fim da lista.
+    void add(const Node<Song> *first);
+    // Retira uma música da assinatura, marcando-a como desatualizada se preciso.
+    void remove(const Song &song);
+    // Adiciona à assinatura as músicas de outra assinatura.
+    void merge(const PlaylistSignature &other);
+    // Volta à assinatura de uma playlist vazia.
+    void clear();
+    // Verifica se a assinatura deve ser recalculada.
+    bool isStale() const;
+    // Verifica se a assinatura é de uma playlist vazia.
+    bool isEmpty() const;
+    // Retorna o menor hash da função especificada.
+    uint32_t get(size_t function) const;
+    // Estima a semelhança de Jaccard com outra assinatura, entre 0 e 1.
+    double similarity(const PlaylistSignature &other) const;
+};
+
+#endif
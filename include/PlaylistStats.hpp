@@ -0,0 +1,77 @@
+/**
+ * @file PlaylistStats.hpp
+ * @brief Arquivo que contém a classe PlaylistStats, com os totais das músicas de uma playlist.
+ */
+
+#ifndef PLAYLISTSTATS_HPP
+#define PLAYLISTSTATS_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "PlaylistSignature.hpp"
+
+/**
+ * @brief Totais das músicas de uma playlist: número de músicas, duração
+ * total e número de autores diferentes.
+ *
+ * Os totais são atualizados música a música, quando elas entram ou saem da
+ * playlist, então consultá-los custa O(1). Para contar os autores, é
+ * guardado quantas músicas de cada autor a playlist tem, pelo hash de 64
+ * bits da chave do autor, sem copiar os nomes. Enquanto a playlist tem poucos
+ * autores, as contagens ficam em um vetor pequeno, percorrido a cada
+ * alteração; a tabela de hash só é criada quando ele enche.
+ *
+ * Os totais também mantêm a assinatura MinHash das músicas
+ * (PlaylistSignature), usada para encontrar playlists parecidas.
+ */
+class PlaylistStats{
+
+private:
+    size_t tracks; //!< Número de músicas.
+    unsigned long long duration; //!< Soma das durações conhecidas, em segundos.
+    size_t untimed; //!< Número de músicas com duração desconhecida.
+    std::vector<std::pair<uint64_t, size_t>> fewAuthors; //!< Número de músicas de cada autor, enquanto há poucos autores.
+    std::unordered_map<uint64_t, size_t> authors; //!< Número de músicas de cada autor, depois que fewAuthors enche.
+    PlaylistSignature signature; //!< Assinatura MinHash das músicas.
+
+    // Soma count à contagem do autor com o hash especificado.
+    void addAuthor(uint64_t hash, size_t count);
+
+public:
+    //! Número máximo de autores guardados em fewAuthors.
+    static const size_t fewAuthorsLimit = 16;
+
+    // Construtor dos totais de uma playlist vazia.
+    PlaylistStats();
+    // Adiciona uma música aos totais.
+    void add(const Song &song);
+    // Adiciona aos totais as músicas de um nó até o fim da lista.
+    void add(const Node<Song> *first);
+    // Retira uma música dos totais.
+    void remove(const Song &song);
+    // Soma aos totais os de outra playlist, deixando os dela vazios.
+    void merge(PlaylistStats &other);
+    // Zera os totais.
+    void clear();
+    // Retorna o número de músicas.
+    size_t getTracks() const;
+    // Retorna a soma das durações conhecidas, em segundos.
+    unsigned long long getDuration() const;
+    // Retorna o número de músicas com duração desconhecida.
+    size_t getUntimedTracks() const;
+    // Retorna o número de autores diferentes.
+    size_t getAuthors() const;
+    // Retorna a assinatura MinHash das músicas, que pode estar desatualizada.
+    const PlaylistSignature &getSignature() const;
+    // Recalcula a assinatura a partir das músicas de um nó até o fim da lista.
+    void refreshSignature(const Node<Song> *first);
+    // Sobrecarga do operador de inserção.
+    friend std::ostream& operator<<(std::ostream& os, const PlaylistStats& stats);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file PlaylistView.hpp
+ * @brief Arquivo que contém a classe PlaylistView.
+ */
+
+#ifndef PLAYLISTVIEW_HPP
+#define PLAYLISTVIEW_HPP
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Node.hpp"
+#include "Song.hpp"
+
+class Playlist;
+
+/**
+ * @brief Classe que implementa uma visão preguiçosa de uma combinação de playlists.
+ *
+ * A visão guarda apenas ponteiros para as playlists envolvidas e a operação
+ * (mescla ou diferença) aplicada a cada uma. As músicas são calculadas durante
+ * a iteração, sem criar playlists intermediárias, e o resultado é o mesmo dos
+ * operadores + e - de Playlist aplicados da esquerda para a direita.
+ *
+ * Na primeira iteração, as ocorrências visíveis de cada termo são marcadas
+ * em uma única passagem pelas playlists; as iterações seguintes (getSize,
+ * print, materialize) reaproveitam as marcas enquanto nenhuma playlist da
+ * visão for alterada.
+ *
+ * @note As playlists usadas na visão devem continuar existindo enquanto ela for usada.
+ */
+class PlaylistView{
+
+public:
+    class Iterator;
+
+private:
+    /**
+     * @brief Termo da expressão: uma playlist e a operação aplicada a ela.
+     */
+    struct Term{
+        const Playlist *playlist; //!< Playlist do termo.
+        bool subtract; //!< true se o termo é subtraído, false se é mesclado.
+    };
+
+    std::vector<Term> terms; //!< Termos da expressão, na ordem em que foram aplicados.
+    std::vector<unsigned long long> versions; //!< Versão da lista de cada termo quando as marcas foram calculadas.
+    std::vector<std::vector<bool>> visible; //!< Marca de cada ocorrência dos termos mesclados que faz parte do resultado.
+
+    // Recalcula as ocorrências visíveis se alguma playlist mudou.
+    void refresh();
+    // Encontra a primeira ocorrência visível a partir de uma posição.
+    void seek(size_t &term, const Node<Song> *&node, size_t &position);
+
+public:
+    // Construtor da visão que contém apenas uma playlist.
+    PlaylistView(const Playlist &playlist);
+    // Retorna uma visão que mescla outra playlist à visão atual.
+    PlaylistView operator+(const Playlist &b) const &;
+    PlaylistView operator+(const Playlist &b) &&;
+    // Retorna uma visão que remove as músicas de outra playlist da visão atual.
+    PlaylistView operator-(const Playlist &b) const &;
+    PlaylistView operator-(const Playlist &b) &&;
+    // Retorna o iterador para a primeira música da visão.
+    Iterator begin();
+    // Retorna o iterador que indica o fim da visão.
+    Iterator end();
+    // Retorna o número de músicas da visão.
+    size_t getSize();
+    // Imprime as músicas da visão, uma por linha.
+    void print(std::ostream &os = std::cout);
+    // Cria uma playlist com as músicas da visão.
+    Playlist materialize(std::string name = "");
+};
+
+/**
+ * @brief Iterador que percorre as músicas de uma PlaylistView, pulando as
+ * ocorrências que a visão marcou como fora do resultado.
+ */
+class PlaylistView::Iterator{
+
+    PlaylistView *view; //!< Visão percorrida.
+    size_t term; //!< Índice do termo atual.
+    const Node<Song> *node; //!< Nó atual dentro da playlist do termo.
+    size_t position; //!< Posição do nó atual na playlist do termo.
+
+public:
+    // Construtor do iterador.
+    Iterator(PlaylistView *view, size_t term, const Node<Song> *node, size_t position = 0);
+    // Retorna a música atual.
+    const Song &operator*();
+    // Retorna um ponteiro para a música atual.
+    const Song *operator->();
+    // Avança para a próxima música da visão.
+    Iterator &operator++();
+    // Sobrecarga do operador de igualdade.
+    bool operator==(const Iterator &b) const;
+    // Sobrecarga do operador de desigualdade.
+    bool operator!=(const Iterator &b) const {return !(*this == b);}
+};
+
+#endif
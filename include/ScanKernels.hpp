@@ -0,0 +1,24 @@
+/**
+ * @file ScanKernels.hpp
+ * @brief Arquivo que contém as funções de varredura vetorizada usadas nas
+ * buscas sem índice.
+ */
+
+#ifndef SCANKERNELS_HPP
+#define SCANKERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//! Valor retornado pelas varreduras quando nada é encontrado.
+const size_t SCAN_NOT_FOUND = (size_t)-1;
+
+// Procura uma sequência de bytes em um bloco de memória.
+size_t scanFind(const char *data, size_t size, const char *needle, size_t length);
+// Procura um valor em um vetor de hashes.
+size_t scanHash(const uint64_t *hashes, size_t size, uint64_t hash);
+// Retorna o nome da implementação vetorizada em uso.
+std::string scanImplementation();
+
+#endif
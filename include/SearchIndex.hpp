@@ -0,0 +1,124 @@
+/**
+ * @file SearchIndex.hpp
+ * @brief Arquivo que contém a classe SearchIndex.
+ */
+
+#ifndef SEARCHINDEX_HPP
+#define SEARCHINDEX_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "LinkedList.hpp"
+#include "ColumnarCatalog.hpp"
+
+/**
+ * @brief Página de resultados de uma busca.
+ */
+struct SearchPage{
+    std::vector<Song*> songs; //!< Músicas da página.
+    size_t offset; //!< Posição da primeira música da página no resultado completo.
+    size_t total; //!< Número total de músicas encontradas.
+
+    // Verifica se existem resultados depois desta página.
+    bool hasMore() const {return offset + songs.size() < total;}
+    // Retorna a posição da próxima página.
+    size_t nextOffset() const {return offset + songs.size();}
+};
+
+/**
+ * @brief Classe que implementa um índice de busca sobre os títulos e autores
+ * das músicas do catálogo.
+ *
+ * Buscas por prefixo usam um mapa ordenado com o início de cada palavra dos
+ * campos. Buscas por trecho usam um índice de trigramas (sequências de três
+ * bytes), verificando apenas as músicas que contêm o trigrama menos frequente
+ * da consulta. Consultas curtas e por igualdade percorrem uma cópia em colunas
+ * (ColumnarCatalog) com funções vetorizadas. O índice guarda ponteiros para as
+ * músicas do catálogo, então deve ser atualizado sempre que músicas forem
+ * adicionadas ou removidas. Uma tabela pela identidade (título e autor)
+ * encontra a música do catálogo que corresponde a uma música qualquer.
+ */
+class SearchIndex{
+
+public:
+    /**
+     * @brief Campo em que a busca é feita.
+     */
+    enum Field{
+        Title, //!< Título da música.
+        Author, //!< Autor da música.
+        Any //!< Título ou autor.
+    };
+
+    /**
+     * @brief Tipo de busca.
+     */
+    enum Mode{
+        Prefix, //!< Alguma palavra do campo começa com a consulta.
+        Substring, //!< O campo contém a consulta.
+        Exact //!< O campo é igual à consulta.
+    };
+
+private:
+    /**
+     * @brief Campos normalizados de uma música indexada.
+     */
+    struct Entry{
+        std::string title; //!< Título normalizado.
+        std::string author; //!< Autor normalizado.
+    };
+
+    std::unordered_map<Song*, Entry> entries; //!< Músicas indexadas.
+    std::unordered_set<Song*, SongHash, SongEqual> identities; //!< Músicas indexadas, pela identidade.
+    std::map<std::string, std::vector<Song*>> titleWords; //!< Início de cada palavra dos títulos.
+    std::map<std::string, std::vector<Song*>> authorWords; //!< Início de cada palavra dos autores.
+    std::unordered_map<uint32_t, std::vector<Song*>> titleTrigrams; //!< Trigramas dos títulos.
+    std::unordered_map<uint32_t, std::vector<Song*>> authorTrigrams; //!< Trigramas dos autores.
+    ColumnarCatalog columns; //!< Cópia em colunas, usada nas buscas que percorrem todas as músicas.
+    bool columnsStale; //!< Indica se a cópia em colunas precisa ser reconstruída.
+
+    // Reconstrói a cópia em colunas, se necessário.
+    void refreshColumns();
+
+    // Adiciona ou remove um campo de uma música nos índices.
+    static void indexField(const std::string &key, Song *song, bool insert,
+                           std::map<std::string, std::vector<Song*>> &words,
+                           std::unordered_map<uint32_t, std::vector<Song*>> &trigrams);
+    // Busca as músicas com alguma palavra do campo começando com a consulta.
+    void searchPrefix(const std::string &query, std::map<std::string, std::vector<Song*>> &words,
+                      std::vector<Song*> &result);
+    // Busca as músicas cujo campo contém a consulta.
+    void searchSubstring(const std::string &query, bool author,
+                         std::unordered_map<uint32_t, std::vector<Song*>> &trigrams,
+                         std::vector<Song*> &result);
+
+public:
+    // Construtor do índice vazio.
+    SearchIndex();
+    // Normaliza um texto para comparação nas buscas.
+    static std::string normalize(const std::string &text);
+    // Adiciona uma música ao índice.
+    void add(Song *song);
+    // Remove uma música do índice.
+    void remove(Song *song);
+    // Remove todas as músicas do índice.
+    void clear();
+    // Reconstrói o índice a partir de todas as músicas do catálogo.
+    void rebuild(LinkedList<Song> &songs);
+    // Retorna o número de músicas indexadas.
+    size_t getSize() const;
+    // Estima a memória ocupada pelo índice.
+    size_t getBytes() const;
+    // Procura a música do catálogo com a mesma identidade.
+    Song *find(const Song &song) const;
+    // Busca músicas e retorna uma página do resultado.
+    SearchPage search(const std::string &query, Field field, Mode mode, size_t offset, size_t limit);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file Server.hpp
+ * @brief Arquivo que contém a classe Server, que atende clientes locais por um
+ * socket Unix.
+ *
+ * Protocolo: cada requisição é uma linha terminada em '\n', com o comando e os
+ * argumentos separados por tabulação. Cada resposta começa com "OK <n>\n",
+ * seguida de n linhas de resultado, ou é uma única linha "ERR <mensagem>\n".
+ * Um cliente pode enviar várias requisições sem esperar as respostas; elas
+ * são respondidas na ordem em que chegaram.
+ *
+ * Comandos:
+ * - PING
+ * - LIST_PLAYLISTS: uma linha por playlist, com o nome.
+ * - ADD_PLAYLIST nome / REMOVE_PLAYLIST nome
+ * - LIST_SONGS [playlist]: uma linha "título\tautor" por música do sistema ou da playlist.
+ * - ADD_SONG título autor / REMOVE_SONG título autor
+ * - ADD_TO_PLAYLIST playlist título autor / REMOVE_FROM_PLAYLIST playlist título autor
+ * - MERGE_PLAYLIST playlist origem: adiciona a playlist as músicas de origem
+ *   que ela ainda não tem.
+ * - BEGIN / COMMIT / ABORT: entre BEGIN e COMMIT, ADD_PLAYLIST, REMOVE_PLAYLIST,
+ *   ADD_TO_PLAYLIST, REMOVE_FROM_PLAYLIST e MERGE_PLAYLIST só são guardados
+ *   (Transaction) e respondem "OK 0". COMMIT aplica todos ou nenhum e responde
+ *   com o número de alterações aplicadas, ou com o erro da primeira alteração
+ *   inválida; ABORT descarta as alterações guardadas.
+ * - UNDO / REDO: desfaz a última alteração, ou refaz a última desfeita, feita
+ *   pelo servidor ou pelo menu; a linha do resultado é a descrição da alteração.
+ * - SEARCH campo modo início limite texto: campo é TITLE, AUTHOR ou ANY e modo é
+ *   PREFIX, SUBSTRING ou EXACT. A primeira linha é o total de resultados e as
+ *   demais são as músicas da página, como em LIST_SONGS.
+ * - TOP_SONGS k [APPROX]: as k músicas presentes em mais playlists, uma linha
+ *   "playlists\ttítulo\tautor" por música. Com APPROX, as contagens são
+ *   estimadas com memória fixa (PlaylistAggregator::approximateTop).
+ * - TOP_AUTHORS k [APPROX]: como TOP_SONGS, com uma linha "playlists\tautor" por autor.
+ * - SIZE_HISTOGRAM: uma linha "menor\tmaior\tplaylists" por faixa de tamanho das playlists.
+ */
+
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "Library.hpp"
+#include "Transaction.hpp"
+
+/**
+ * @brief Servidor que atende muitos clientes ao mesmo tempo com um único laço
+ * de eventos (epoll). As consultas usam a versão publicada da biblioteca, as
+ * buscas usam o índice sem publicar (Library::search) e as alterações usam um
+ * Library::Editor.
+ */
+class Server{
+    /**
+     * @brief Estado de uma conexão com um cliente.
+     */
+    struct Connection{
+        std::string input; //!< Bytes recebidos que ainda não formam uma requisição completa.
+        std::string output; //!< Respostas ainda não enviadas.
+        size_t written; //!< Bytes de output já enviados.
+        uint32_t events; //!< Eventos registrados no epoll para a conexão.
+        bool inputClosed; //!< Indica se o cliente encerrou o envio; a conexão só espera enviar as respostas.
+        bool transactionOpen; //!< Indica se a conexão abriu uma transação com BEGIN.
+        Transaction transaction; //!< Alterações guardadas desde o BEGIN.
+    };
+
+    Library &library; //!< Biblioteca atendida.
+    std::string path; //!< Caminho do socket.
+    int listenFd; //!< Socket que aceita conexões.
+    int epollFd; //!< Descritor do epoll.
+    int stopFd; //!< Descritor usado para interromper o laço de eventos.
+    bool accepting; //!< Indica se o socket que aceita conexões está registrado no epoll.
+    std::unordered_map<int, Connection> connections; //!< Conexões abertas, indexadas pelo descritor.
+    unsigned long long requests; //!< Número de requisições atendidas.
+
+    // Aceita as conexões pendentes.
+    void acceptConnections();
+    // Volta a observar, ou deixa de observar, o socket que aceita conexões.
+    void setAccepting(bool accepting);
+    // Lê e atende as requisições de uma conexão.
+    bool receive(int fd, Connection &connection);
+    // Envia as respostas pendentes de uma conexão.
+    bool send(int fd, Connection &connection);
+    // Fecha uma conexão.
+    void closeConnection(int fd);
+    // Atende as requisições completas de uma conexão.
+    bool process(int fd, Connection &connection);
+    // Atualiza os eventos registrados no epoll para uma conexão.
+    void watch(int fd, Connection &connection);
+    // Atende uma requisição e acrescenta a resposta.
+    void handle(Connection &connection, const std::string &request, std::string &response);
+
+public:
+    // Construtor.
+    Server(Library &library, const std::string &path);
+    // Destrutor, que fecha todas as conexões e remove o socket.
+    ~Server();
+    // Cria o socket e começa a aceitar conexões.
+    bool start();
+    // Executa o laço de eventos até stop ser chamado.
+    void run();
+    // Interrompe o laço de eventos. Pode ser chamado por um tratador de sinal.
+    void stop();
+    // Retorna o número de requisições atendidas.
+    unsigned long long getRequests() const;
+};
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file SimilarityIndex.hpp
+ * @brief Arquivo que contém a classe SimilarityIndex, o índice de playlists parecidas.
+ */
+
+#ifndef SIMILARITYINDEX_HPP
+#define SIMILARITYINDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "LinkedList.hpp"
+#include "Playlist.hpp"
+#include "PlaylistSignature.hpp"
+
+/**
+ * @brief Índice que encontra playlists parecidas sem comparar todos os pares,
+ * usando as assinaturas MinHash das playlists (PlaylistSignature).
+ *
+ * A assinatura é dividida em bands faixas de rows funções. Duas playlists
+ * caem no mesmo balde de uma faixa quando têm os mesmos mínimos em todas as
+ * funções dela, o que acontece com probabilidade s^rows para semelhança s.
+ * Com 21 faixas de 3 funções, playlists com semelhança 0,5 dividem algum
+ * balde com probabilidade de 94%, e acima de 0,7 quase sempre, enquanto
+ * playlists com poucas músicas em comum raramente dividem um balde. Uma busca
+ * só compara a playlist com as que dividem algum balde com ela.
+ *
+ * Os baldes de cada faixa ficam em um vetor de pares (chave, playlist)
+ * ordenado pela chave, então um balde é um trecho contíguo do vetor: uma
+ * busca faz uma busca binária por faixa, e a busca de quase iguais percorre
+ * os vetores em ordem. O índice guarda uma cópia do nome e da assinatura de
+ * cada playlist, e é atualizado por update, que só recalcula as playlists
+ * cuja lista de músicas mudou desde a última atualização, como a publicação
+ * da biblioteca.
+ */
+class SimilarityIndex{
+
+public:
+    //! Número de funções de cada faixa.
+    static const size_t rows = 3;
+    //! Número de faixas da assinatura.
+    static const size_t bands = PlaylistSignature::size / rows;
+
+    /**
+     * @brief Playlist encontrada por uma busca.
+     */
+    struct Match{
+        std::string name; //!< Nome da playlist.
+        double similarity; //!< Semelhança estimada com a playlist buscada.
+    };
+
+    /**
+     * @brief Par de playlists quase iguais.
+     */
+    struct Pair{
+        std::string first; //!< Nome de uma das playlists.
+        std::string second; //!< Nome da outra playlist.
+        double similarity; //!< Semelhança estimada entre elas.
+    };
+
+private:
+    /**
+     * @brief Playlist indexada.
+     */
+    struct Entry{
+        const Playlist *playlist; //!< Playlist indexada, usada apenas como chave, ou nullptr se a posição está livre.
+        std::string name; //!< Nome da playlist quando foi indexada.
+        unsigned long long version; //!< Versão da lista de músicas indexada.
+        unsigned long long seen; //!< Última atualização em que a playlist foi encontrada.
+        bool indexed; //!< Indica se a playlist está nos baldes (playlists vazias não estão).
+        PlaylistSignature signature; //!< Assinatura da playlist.
+    };
+
+    /**
+     * @brief Playlist no balde de uma faixa.
+     */
+    struct Slot{
+        uint32_t key; //!< Chave da faixa, que identifica o balde.
+        uint32_t entry; //!< Posição da playlist em entries.
+
+        bool operator<(const Slot &other) const{
+            return key != other.key ? key < other.key : entry < other.entry;
+        }
+    };
+
+    /**
+     * @brief Balde com mais de uma playlist, comparado por findDuplicates.
+     */
+    struct Bucket{
+        size_t band; //!< Faixa do balde.
+        size_t begin; //!< Primeira posição do balde no vetor da faixa.
+        size_t end; //!< Posição depois da última do balde.
+    };
+
+    std::vector<Entry> entries; //!< Playlists indexadas.
+    std::vector<uint32_t> freeEntries; //!< Posições livres em entries.
+    std::unordered_map<const Playlist*, uint32_t> positions; //!< Posição de cada playlist em entries.
+    std::vector<std::vector<Slot>> slots; //!< Baldes de cada faixa, ordenados pela chave.
+    unsigned long long generation; //!< Número de atualizações feitas.
+    size_t indexed; //!< Número de playlists nos baldes.
+
+    // Retorna a chave de uma faixa da assinatura.
+    static uint32_t bandKey(const PlaylistSignature &signature, size_t band);
+    // Verifica se duas assinaturas têm os mesmos mínimos em uma faixa.
+    static bool sameBand(const PlaylistSignature &a, const PlaylistSignature &b, size_t band);
+    // Tira dos baldes as playlists marcadas e coloca as novas.
+    void rebucket(const std::vector<char> &dropped, const std::vector<uint32_t> &added);
+    // Compara os pares de alguns baldes, procurando playlists quase iguais.
+    void comparePairs(const std::vector<Bucket> &buckets, size_t begin, size_t end, double threshold,
+                      std::vector<Pair> &pairs) const;
+
+public:
+    // Construtor do índice vazio.
+    SimilarityIndex();
+    // Atualiza o índice com as playlists da lista, retornando quantas foram recalculadas.
+    size_t update(LinkedList<Playlist> &playlists);
+    // Busca as playlists indexadas parecidas com uma playlist.
+    void findSimilar(Playlist &playlist, double threshold, std::vector<Match> &matches) const;
+    // Busca os pares de playlists indexadas quase iguais, em paralelo.
+    void findDuplicates(double threshold, unsigned threads, std::vector<Pair> &pairs) const;
+    // Retorna o número de playlists indexadas, sem contar as vazias.
+    size_t getSize() const;
+};
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file SmartPlaylists.hpp
+ * @brief Arquivo que contém a classe SmartPlaylists, que mantém playlists definidas por regras.
+ */
+
+#ifndef SMARTPLAYLISTS_HPP
+#define SMARTPLAYLISTS_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+
+class Playlist;
+
+/**
+ * @brief Classe que mantém playlists inteligentes: playlists cujas músicas
+ * são definidas por uma regra, como "autor:Simone Mendes" ou
+ * "playlist:Rock & ano>=2000", e atualizadas conforme o catálogo e as
+ * playlists usadas na regra mudam.
+ *
+ * Uma regra é uma árvore: as folhas escolhem músicas do catálogo (por autor
+ * ou por atributo) ou de uma playlist, e os nós internos são união (|),
+ * interseção (&) ou diferença (-). Cada nó guarda, para cada música, se ela
+ * faz parte do seu resultado; as folhas guardam quantas vezes a música
+ * aparece na fonte. As playlists da biblioteca e os pontos que alteram o
+ * catálogo avisam cada música adicionada ou removida, e o aviso atualiza
+ * apenas as folhas daquela fonte e os nós acima delas, para aquela música.
+ * As mudanças no resultado são aplicadas às playlists inteligentes quando a
+ * biblioteca publica uma nova versão (sync).
+ *
+ * Cada aviso informa a versão da lista antes da alteração. Se a versão não é
+ * a última vista, a lista foi alterada sem aviso (diretamente, por
+ * getSongs), e suas folhas são recalculadas por completo no próximo sync,
+ * como os totais de Playlist.
+ *
+ * Uma regra pode usar playlists inteligentes definidas antes dela, e elas
+ * são atualizadas em ordem de definição. Uma playlist inteligente alterada
+ * diretamente volta ao resultado da regra no próximo sync, e uma playlist
+ * inteligente removida da biblioteca deixa de ser mantida.
+ */
+class SmartPlaylists{
+
+    //! Índice que indica a ausência de um nó.
+    static const size_t none = (size_t)-1;
+
+    /**
+     * @brief Nó da árvore de uma regra.
+     */
+    struct Rule{
+        enum Kind{
+            Author, //!< Músicas do catálogo de um autor.
+            Member, //!< Músicas de uma playlist.
+            Attribute, //!< Músicas do catálogo com um atributo em um intervalo.
+            Union, //!< Músicas de qualquer um dos filhos.
+            Intersection, //!< Músicas dos dois filhos.
+            Difference //!< Músicas do filho da esquerda que não estão no da direita.
+        };
+        enum Field{Year, Duration, Plays};
+
+        Kind kind; //!< Tipo do nó.
+        std::string text; //!< Chave do autor ou nome da playlist, nas folhas Author e Member.
+        Field field; //!< Atributo comparado, nas folhas Attribute.
+        unsigned low; //!< Menor valor aceito do atributo.
+        unsigned high; //!< Maior valor aceito do atributo.
+        size_t left; //!< Filho da esquerda, nos nós internos.
+        size_t right; //!< Filho da direita, nos nós internos.
+        size_t parent; //!< Nó pai, ou none na raiz.
+        bool scanned; //!< Indica se a folha já leu sua fonte.
+        std::vector<uint32_t> count; //!< Ocorrências de cada música na folha, ou 0/1 nos nós internos, pelo identificador da música.
+    };
+
+    /**
+     * @brief Playlist inteligente.
+     */
+    struct Smart{
+        std::string name; //!< Nome da playlist.
+        std::string text; //!< Regra, como foi escrita.
+        std::vector<Rule> rules; //!< Nós da regra.
+        size_t root; //!< Raiz da regra.
+        std::vector<size_t> touched; //!< Músicas que entraram ou saíram da raiz desde o último sync.
+        std::vector<char> isTouched; //!< Indica se cada música está em touched.
+        std::vector<char> listed; //!< Indica se cada música está na playlist.
+        unsigned long long outputVersion; //!< Versão da lista da playlist no último sync, ou 0 antes do primeiro.
+    };
+
+    /**
+     * @brief Lista acompanhada: o catálogo ou uma playlist usada em regras.
+     */
+    struct Source{
+        const LinkedList<Song> *list; //!< Lista acompanhada, ou nullptr se a playlist não existe.
+        unsigned long long version; //!< Última versão da lista vista pelos avisos.
+        bool stale; //!< Indica se a lista mudou sem aviso e suas folhas devem ser recalculadas.
+        std::vector<std::pair<size_t, size_t>> leaves; //!< Folhas que leem a lista, como (playlist inteligente, nó).
+    };
+
+    const LinkedList<Song> &catalog; //!< Catálogo de músicas.
+    std::vector<Smart> smarts; //!< Playlists inteligentes, em ordem de definição.
+    Source catalogSource; //!< Folhas que leem o catálogo.
+    std::unordered_map<std::string, Source> playlistSources; //!< Folhas que leem cada playlist, pelo nome.
+    std::unordered_map<const LinkedList<Song>*, Source*> bound; //!< Fonte de cada lista acompanhada.
+    std::deque<Song> songs; //!< Cópia de cada música já vista pelas folhas, pelo identificador.
+    std::unordered_map<const Song*, size_t, SongHash, SongEqual> ids; //!< Identificador de cada música, pela identidade.
+    std::unordered_map<std::string, Playlist*> byName; //!< Playlists da biblioteca pelo nome, refeito a cada sync com reshaped.
+
+    // Retorna o identificador de uma música, guardando uma cópia se ela é nova.
+    size_t intern(const Song &song);
+    // Verifica se uma música faz parte do resultado de um nó.
+    static bool contains(const Rule &rule, size_t id);
+    // Verifica se uma música da fonte de uma folha é escolhida por ela.
+    static bool matches(const Rule &rule, const Song &song);
+    // Altera o número de ocorrências de uma música em uma folha e propaga a mudança.
+    void count(size_t smart, size_t leaf, size_t id, uint32_t occurrences);
+    // Recalcula o resultado dos nós acima de um nó, para uma música.
+    void propagate(Smart &smart, size_t node, size_t id);
+    // Recalcula uma folha a partir da sua fonte.
+    void scan(size_t smart, size_t leaf, const LinkedList<Song> *list);
+    // Liga uma fonte à sua lista atual e recalcula as folhas necessárias.
+    void refresh(Source &source, const LinkedList<Song> *list);
+    // Aplica à playlist inteligente as mudanças no resultado da regra.
+    void flush(Smart &smart, Playlist &output);
+    // Refaz a lista de folhas de cada fonte.
+    void relink();
+    // Retorna a fonte de uma lista, se o aviso com a versão prior está em ordem.
+    Source *accept(const LinkedList<Song> &list, unsigned long long prior);
+
+    // Adiciona à regra um nó interno que combina dois nós.
+    static size_t combine(std::vector<Rule> &rules, Rule::Kind kind, size_t left, size_t right);
+    // Lê termos ligados por | e -.
+    static size_t parseUnion(const std::string &text, size_t &pos, std::vector<Rule> &rules, std::string &error);
+    // Lê termos ligados por &.
+    static size_t parseIntersection(const std::string &text, size_t &pos, std::vector<Rule> &rules, std::string &error);
+    // Lê uma expressão entre parênteses ou uma folha.
+    static size_t parseTerm(const std::string &text, size_t &pos, std::vector<Rule> &rules, std::string &error);
+
+public:
+    // Construtor, que acompanha o catálogo especificado.
+    SmartPlaylists(const LinkedList<Song> &catalog);
+    // Cria uma playlist inteligente na lista de playlists.
+    bool define(const std::string &name, const std::string &text, LinkedList<Playlist> &playlists, std::string &error);
+    // Aplica às playlists inteligentes as mudanças desde o último sync.
+    void sync(LinkedList<Playlist> &playlists, bool reshaped);
+    // Avisa que uma música foi adicionada a uma lista que estava na versão prior.
+    void added(const LinkedList<Song> &list, unsigned long long prior, const Song &song);
+    // Avisa que uma música foi removida de uma lista que estava na versão prior.
+    void removed(const LinkedList<Song> &list, unsigned long long prior, const Song &song);
+    // Avisa que uma lista que estava na versão prior mudou de ordem, sem mudar as músicas.
+    void reordered(const LinkedList<Song> &list, unsigned long long prior);
+    // Avisa que as músicas de uma lista foram trocadas e devem ser lidas de novo.
+    void replaced(const LinkedList<Song> &list);
+    // Retorna o número de playlists inteligentes.
+    size_t getSize() const;
+    // Exibe o nome e a regra de cada playlist inteligente.
+    void print(std::ostream &os) const;
+};
+
+#endif
@@ -8,35 +8,124 @@
 
 #include <string>
 #include <iostream>
+#include <cstdint>
+#include <atomic>
+#include "TextView.hpp"
 
 /**
  * @brief Classe que representa uma música, contendo título e autor.
+ *
+ * A identidade da música é o par (título, autor): músicas com o mesmo título
+ * e autores diferentes são músicas diferentes. Duração, ano e número de
+ * execuções são opcionais e não fazem parte da identidade; o valor 0 indica
+ * que o atributo é desconhecido.
+ *
+ * O título, o autor e suas chaves de comparação ficam em uma única alocação
+ * (Text), compartilhada entre as cópias da música e liberada pela última
+ * delas: copiar uma música para uma playlist ou para a versão publicada não
+ * copia os textos. A alocação nunca é alterada; os métodos que mudam o título
+ * ou o autor criam outra. A música sem título e sem autor não aloca nada.
  */
 class Song{
 
 private:
-    std::string title; //!< Título da música.
-    std::string author; //!< Autor da música.
+    /**
+     * @brief Cabeçalho da alocação dos textos, seguido pelos textos: título,
+     * autor, chave do título e chave do autor, cada um terminado por '\0'.
+     * Uma chave igual ao texto original não é repetida e aponta para ele.
+     */
+    struct Text{
+        std::atomic<uint32_t> refs; //!< Número de músicas que usam a alocação.
+        uint32_t start[4]; //!< Posição de cada texto depois do cabeçalho.
+        uint32_t size[4]; //!< Número de bytes de cada texto.
+    };
+
+    //! Índice de cada texto em Text.
+    enum TextField{Title, Author, TitleKey, AuthorKey};
+
+    Text *text; //!< Alocação dos textos, ou nullptr se o título e o autor são vazios.
+    uint64_t titleHash; //!< Hash de titleKey, comparado antes da chave nas buscas por título.
+    uint64_t fingerprint; //!< Hash do par (titleKey, authorKey), comparado antes das chaves.
+    unsigned duration; //!< Duração em segundos, ou 0 se desconhecida.
+    unsigned year; //!< Ano de lançamento, ou 0 se desconhecido.
+    unsigned plays; //!< Número de execuções, ou 0 se desconhecido.
+
+    // Substitui os textos da música e recalcula os hashes.
+    void setText(const std::string &title, const std::string &author);
+    // Libera a alocação dos textos, se esta for a última música que a usa.
+    void releaseText();
+    // Retorna um dos textos da música.
+    TextView getText(TextField field) const;
 
 public:
     //Construtor padrão.
     Song();
     //Construtor que recebe título e autor.
     Song(std::string title, std::string author = "");
+    //Construtor de cópia, que compartilha os textos.
+    Song(const Song &b);
+    //Construtor de movimento.
+    Song(Song &&b);
+    //Destrutor.
+    ~Song();
+    //Atribuição por cópia, que compartilha os textos.
+    Song &operator=(const Song &b);
+    //Atribuição por movimento.
+    Song &operator=(Song &&b);
     //Retorna o título da música.
     std::string getTitle();
     //Retorna o autor da música.
     std::string getAuthor();
+    //Retorna o título da música sem copiá-lo.
+    TextView getTitleView() const;
+    //Retorna o autor da música sem copiá-lo.
+    TextView getAuthorView() const;
     //Altera o título da música.
     void setTitle(std::string title);
     //Altera o autor da música.
     void setAuthor(std::string author);
+    //Retorna a duração da música, em segundos.
+    unsigned getDuration() const;
+    //Altera a duração da música, em segundos.
+    void setDuration(unsigned duration);
+    //Retorna o ano de lançamento da música.
+    unsigned getYear() const;
+    //Altera o ano de lançamento da música.
+    void setYear(unsigned year);
+    //Retorna o número de execuções da música.
+    unsigned getPlays() const;
+    //Altera o número de execuções da música.
+    void setPlays(unsigned plays);
+    //Retorna a chave de comparação do título.
+    TextView getTitleKey() const;
+    //Retorna a chave de comparação do autor.
+    TextView getAuthorKey() const;
+    //Retorna o hash da chave do título.
+    uint64_t getTitleHash() const;
+    //Retorna o hash da identidade (título e autor) da música.
+    uint64_t getFingerprint() const;
+    //Retorna a parte desta música na memória alocada pelos textos.
+    size_t getHeapBytes() const;
+    //Verifica se duas músicas têm o mesmo título, independente do autor.
+    bool hasSameTitle(const Song &b) const;
+    //Verifica se duas músicas têm o mesmo título e o mesmo autor.
+    bool equals(const Song &b) const;
+    //Verifica se a música é uma cópia de outra, com os mesmos textos e dados.
+    bool isCopyOf(const Song &b) const;
+    //Compara o título com o de outra música, sem copiá-los.
+    int compareTitle(const Song &b) const;
+    //Compara o autor com o de outra música, sem copiá-los.
+    int compareAuthor(const Song &b) const;
     //Sobrecarga do operador de igualdade.
     bool operator==(Song &b);
     //Sobrecarga do operador de diferente.
-    bool operator!=(Song &b) {return (title != b.getTitle() || author != b.getAuthor());}
+    bool operator!=(Song &b) {return !equals(b);}
     //Sobrecarga do operador de inserção.
     friend std::ostream& operator<<(std::ostream& os, const Song& song);
+    //Converte uma duração escrita como segundos, m:ss ou h:mm:ss.
+    static bool parseDuration(const std::string &text, unsigned &seconds);
+    //Escreve uma duração como m:ss ou h:mm:ss.
+    static std::string formatDuration(unsigned long long seconds);
     //Sobrecarga do operador que atribui igualdade.
     template <typename T>
     void operator=(T b);
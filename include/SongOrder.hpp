@@ -0,0 +1,52 @@
+/**
+ * @file SongOrder.hpp
+ * @brief Arquivo que contém a classe SongOrder.
+ */
+
+#ifndef SONGORDER_HPP
+#define SONGORDER_HPP
+
+#include <string>
+#include <vector>
+#include <initializer_list>
+#include "Song.hpp"
+
+/**
+ * @brief Classe que define uma ordenação de músicas por uma ou mais chaves.
+ *
+ * As chaves são comparadas em sequência: a segunda só é usada quando as
+ * músicas empatam na primeira, e assim por diante. Uma ordenação sem chaves
+ * representa a ordem de inserção.
+ */
+class SongOrder{
+
+public:
+    /**
+     * @brief Chaves que podem ser usadas na ordenação.
+     */
+    enum Key{
+        Title, //!< Título da música.
+        Author //!< Autor da música.
+    };
+
+private:
+    std::vector<Key> keys; //!< Chaves da ordenação, da mais para a menos importante.
+
+public:
+    // Construtor da ordenação sem chaves (ordem de inserção).
+    SongOrder();
+    // Construtor que recebe as chaves da ordenação.
+    SongOrder(std::initializer_list<Key> keys);
+    // Verifica se a ordenação não tem chaves.
+    bool isEmpty() const;
+    // Retorna a descrição da ordenação.
+    std::string getDescription() const;
+    // Compara duas músicas segundo a ordenação.
+    bool operator()(const Song &a, const Song &b) const;
+    // Sobrecarga do operador de igualdade.
+    bool operator==(const SongOrder &b) const;
+    // Sobrecarga do operador de desigualdade.
+    bool operator!=(const SongOrder &b) const {return !(*this == b);}
+};
+
+#endif
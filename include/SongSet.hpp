@@ -0,0 +1,31 @@
+/**
+ * @file SongSet.hpp
+ * @brief Arquivo que contém o conjunto de músicas indexado pela identidade.
+ */
+
+#ifndef SONGSET_HPP
+#define SONGSET_HPP
+
+#include <cstddef>
+#include <unordered_set>
+#include "Song.hpp"
+
+/**
+ * @brief Função de hash de um ponteiro para música, que usa o hash da
+ * identidade (título e autor) já calculado na música.
+ */
+struct SongHash{
+    size_t operator()(const Song *song) const {return (size_t)song->getFingerprint();}
+};
+
+/**
+ * @brief Comparação de dois ponteiros para música pela identidade.
+ */
+struct SongEqual{
+    bool operator()(const Song *a, const Song *b) const {return a->equals(*b);}
+};
+
+//! Conjunto de ponteiros para músicas, sem repetir músicas com a mesma identidade.
+typedef std::unordered_set<const Song*, SongHash, SongEqual> SongSet;
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file SortedView.hpp
+ * @brief Arquivo que contém a classe SortedView.
+ */
+
+#ifndef SORTEDVIEW_HPP
+#define SORTEDVIEW_HPP
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "ListPrinter.hpp"
+
+/**
+ * @brief Classe que guarda uma visão ordenada de uma lista encadeada, sem alterar
+ * a ordem da lista.
+ *
+ * A visão é um vetor de ponteiros para os elementos da lista. Ela é calculada
+ * na primeira consulta e reaproveitada enquanto a versão da lista não mudar.
+ *
+ * @tparam T Tipo dos elementos da lista.
+ * @tparam Compare Tipo do comparador usado na ordenação.
+ */
+template <typename T, typename Compare>
+class SortedView{
+
+private:
+    Compare less; //!< Comparador da ordenação.
+    std::vector<T*> items; //!< Elementos da lista, ordenados.
+    unsigned long long version; //!< Versão da lista usada no cálculo, ou 0 se não há cálculo.
+
+public:
+    // Construtor que recebe o comparador.
+    SortedView(Compare less = Compare());
+    // Retorna o comparador atual.
+    Compare getOrder() const;
+    // Altera o comparador, descartando a ordenação calculada.
+    void setOrder(Compare less);
+    // Verifica se a ordenação calculada ainda vale para a lista.
+    bool isValid(LinkedList<T> &list) const;
+    // Retorna os elementos da lista ordenados, recalculando se necessário.
+    std::vector<T*> &get(LinkedList<T> &list);
+    // Imprime os elementos da lista ordenados, um por linha.
+    void print(LinkedList<T> &list, std::ostream &os = std::cout);
+};
+
+/**
+ * @brief Construtor que recebe o comparador.
+ *
+ * @param less Comparador da ordenação.
+ */
+template <typename T, typename Compare>
+SortedView<T, Compare>::SortedView(Compare less) : less(less){
+    version = 0;
+}
+
+/**
+ * @brief Retorna o comparador atual.
+ *
+ * @return Comparador da ordenação.
+ */
+template <typename T, typename Compare>
+Compare SortedView<T, Compare>::getOrder() const{
+    return less;
+}
+
+/**
+ * @brief Altera o comparador, descartando a ordenação calculada.
+ *
+ * @param less Novo comparador.
+ */
+template <typename T, typename Compare>
+void SortedView<T, Compare>::setOrder(Compare less){
+    this->less = less;
+    items.clear();
+    version = 0;
+}
+
+/**
+ * @brief Verifica se a ordenação calculada ainda vale para a lista.
+ *
+ * @param list Lista consultada.
+ * @return Retorna true se a lista não mudou desde o último cálculo.
+ */
+template <typename T, typename Compare>
+bool SortedView<T, Compare>::isValid(LinkedList<T> &list) const{
+    return version != 0 && version == list.getVersion();
+}
+
+/**
+ * @brief Retorna os elementos da lista ordenados. A ordenação só é recalculada
+ * se a lista mudou desde a última consulta.
+ *
+ * @param list Lista a ser ordenada.
+ * @return Vetor de ponteiros para os elementos, válido até a próxima alteração da lista.
+ */
+template <typename T, typename Compare>
+std::vector<T*> &SortedView<T, Compare>::get(LinkedList<T> &list){
+    if(isValid(list)){
+        return items;
+    }
+
+    items.clear();
+    Node<T> *curr = list.getHead();
+    while(curr != nullptr){
+        items.push_back(&(curr->getValue()));
+        curr = curr->getNext();
+    }
+
+    const Compare &order = less;
+    std::stable_sort(items.begin(), items.end(), [&order](T *a, T *b){
+        return order(*a, *b);
+    });
+    version = list.getVersion();
+
+    return items;
+}
+
+/**
+ * @brief Imprime os elementos da lista ordenados, um por linha.
+ *
+ * @param list Lista a ser impressa.
+ * @param os Fluxo que recebe os elementos.
+ */
+template <typename T, typename Compare>
+void SortedView<T, Compare>::print(LinkedList<T> &list, std::ostream &os){
+    std::vector<T*> &sorted = get(list);
+    ListPrinter out(os);
+    for(size_t i = 0; i < sorted.size(); i++){
+        out.line(*sorted[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file SpaceSaving.hpp
+ * @brief Arquivo que contém a classe SpaceSaving, que estima os itens mais frequentes com memória limitada.
+ */
+
+#ifndef SPACESAVING_HPP
+#define SPACESAVING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Song.hpp"
+
+/**
+ * @brief Resumo Space-Saving: acompanha no máximo capacity itens, identificados
+ * por um hash de 64 bits, e estima quantas vezes cada um foi contado.
+ *
+ * Enquanto há espaço, cada item novo é acompanhado com contagem exata. Com o
+ * resumo cheio, um item novo toma o lugar do item de menor contagem m, e
+ * começa com contagem m + 1 e erro m. A contagem estimada de um item nunca é
+ * menor que a real, e passa dela em no máximo o erro guardado, que é no
+ * máximo o total contado dividido por capacity. Assim, todo item contado
+ * mais que total / capacity vezes está no resumo.
+ *
+ * Os itens ficam em um heap de mínimo pela contagem, com a posição de cada
+ * um em uma tabela de hash de endereçamento aberto, de tamanho fixo e sem
+ * alocações durante a contagem, então contar custa O(log capacity). Resumos
+ * feitos em paralelo sobre partes dos dados podem ser unidos com merge,
+ * mantendo as mesmas garantias sobre o total.
+ */
+class SpaceSaving{
+
+public:
+    /**
+     * @brief Item acompanhado pelo resumo.
+     */
+    struct Item{
+        uint64_t key; //!< Hash que identifica o item.
+        size_t count; //!< Contagem estimada, nunca menor que a real.
+        size_t error; //!< Quanto a contagem estimada pode passar da real.
+        size_t last; //!< Último grupo (playlist) em que o item foi contado.
+        const Song *sample; //!< Música que representa o item, para exibição.
+    };
+
+private:
+    /**
+     * @brief Posição da tabela de hash.
+     */
+    struct Slot{
+        uint64_t key; //!< Hash do item.
+        size_t position; //!< Posição do item no heap, ou empty se a posição da tabela está livre.
+    };
+
+    //! Marca de posição livre da tabela.
+    static const size_t empty = (size_t)-1;
+
+    size_t capacity; //!< Número máximo de itens acompanhados.
+    std::vector<Item> heap; //!< Itens, em um heap de mínimo pela contagem.
+    std::vector<Slot> slots; //!< Posição de cada item no heap, com sondagem linear.
+    size_t mask; //!< Tamanho da tabela menos 1; o tamanho é uma potência de 2.
+
+    // Retorna a posição da tabela com o item, ou a posição livre onde ele entraria.
+    size_t find(uint64_t key) const;
+    // Tira um item da tabela.
+    void erase(uint64_t key);
+
+    // Desce um item no heap até a posição correta.
+    void siftDown(size_t position);
+    // Sobe um item no heap até a posição correta.
+    void siftUp(size_t position);
+    // Reconstrói o heap e as posições a partir dos itens.
+    void rebuild();
+
+public:
+    // Construtor do resumo vazio, que acompanha até capacity itens.
+    SpaceSaving(size_t capacity);
+    // Conta um item, uma única vez por grupo.
+    void add(uint64_t key, const Song *sample, size_t group);
+    // Une a este resumo um resumo feito sobre outra parte dos dados.
+    void merge(const SpaceSaving &other);
+    // Retorna a menor contagem, que limita a contagem de itens fora do resumo.
+    size_t getMinimum() const;
+    // Retorna o número máximo de itens acompanhados.
+    size_t getCapacity() const;
+    // Retorna os itens acompanhados, sem ordem definida.
+    const std::vector<Item> &getItems() const;
+};
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file TextKey.hpp
+ * @brief Arquivo que contém as funções que geram chaves de comparação de textos.
+ */
+
+#ifndef TEXTKEY_HPP
+#define TEXTKEY_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Gera a chave de comparação de um texto, sem acentos e em minúsculas.
+std::string foldText(const std::string &text);
+// Calcula o hash de uma sequência de bytes.
+uint64_t hashBytes(const char *data, size_t size);
+// Retorna a memória alocada por um texto fora do próprio objeto.
+size_t heapBytes(const std::string &text);
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file TextView.hpp
+ * @brief Arquivo que contém a classe TextView, que lê um texto sem copiá-lo.
+ */
+
+#ifndef TEXTVIEW_HPP
+#define TEXTVIEW_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <ostream>
+
+/**
+ * @brief Trecho de texto somente para leitura, guardado em outro lugar, como
+ * std::string_view (que não existe em C++11).
+ *
+ * Não copia nem libera o texto: vale enquanto o dono do texto existir e não
+ * o alterar. Pode ser comparado com outros trechos e com std::string, e é
+ * convertido para std::string quando uma cópia é necessária.
+ */
+class TextView{
+
+    const char *text; //!< Primeiro caractere do trecho.
+    size_t length; //!< Número de bytes do trecho.
+
+public:
+    // Construtor do trecho vazio.
+    TextView() : text(""), length(0) {}
+    // Construtor que lê size bytes a partir de data.
+    TextView(const char *data, size_t size) : text(data), length(size) {}
+    // Construtor que lê um texto inteiro.
+    TextView(const std::string &text) : text(text.data()), length(text.size()) {}
+    // Retorna o primeiro caractere do trecho.
+    const char *data() const {return text;}
+    // Retorna o número de bytes do trecho.
+    size_t size() const {return length;}
+    // Verifica se o trecho é vazio.
+    bool empty() const {return length == 0;}
+    // Retorna o byte da posição especificada.
+    char operator[](size_t position) const {return text[position];}
+    // Retorna o início do trecho, para percorrê-lo.
+    const char *begin() const {return text;}
+    // Retorna o fim do trecho.
+    const char *end() const {return text + length;}
+    // Compara com outro trecho, byte a byte, como std::string::compare.
+    int compare(const TextView &b) const;
+    // Copia o trecho para um std::string.
+    std::string str() const {return std::string(text, length);}
+    // Conversão para std::string, que copia o trecho.
+    operator std::string() const {return str();}
+};
+
+/**
+ * @brief Compara com outro trecho, byte a byte, como std::string::compare.
+ *
+ * @param b Trecho comparado.
+ * @return Valor negativo, zero ou positivo.
+ */
+inline int TextView::compare(const TextView &b) const{
+    size_t common = (length < b.length) ? length : b.length;
+    int result = (common > 0) ? std::memcmp(text, b.text, common) : 0;
+    if(result != 0){
+        return result;
+    }
+    return (length < b.length) ? -1 : (length > b.length) ? 1 : 0;
+}
+
+// Verifica se dois trechos têm os mesmos bytes.
+inline bool operator==(const TextView &a, const TextView &b){
+    return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+// Verifica se dois trechos são diferentes.
+inline bool operator!=(const TextView &a, const TextView &b){
+    return !(a == b);
+}
+
+// Verifica se um trecho vem antes de outro, byte a byte.
+inline bool operator<(const TextView &a, const TextView &b){
+    return a.compare(b) < 0;
+}
+
+// Escreve o trecho em um fluxo.
+inline std::ostream &operator<<(std::ostream &os, const TextView &text){
+    return os.write(text.data(), text.size());
+}
+
+#endif
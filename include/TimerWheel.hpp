@@ -0,0 +1,132 @@
+/**
+ * @file TimerWheel.hpp
+ * @brief Arquivo que contém a classe TimerWheel, que agenda temporizadores em uma roda hierárquica.
+ */
+
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <cstddef>
+
+/**
+ * @brief Roda de temporizadores hierárquica, com resolução de um tique.
+ *
+ * A roda tem levels níveis de slotCount posições. O nível 0 guarda os
+ * temporizadores que vencem nos próximos slotCount tiques, uma posição por
+ * tique; cada nível seguinte cobre um intervalo slotCount vezes maior. Quando
+ * o nível 0 dá uma volta completa, a posição correspondente do nível 1 é
+ * redistribuída nos níveis de baixo, e assim por diante.
+ *
+ * Cada posição é uma lista duplamente encadeada de temporizadores, então
+ * agendar e cancelar custam O(1). Um temporizador desce no máximo levels - 1
+ * vezes antes de vencer. Os temporizadores pertencem a quem os agenda; a roda
+ * apenas os liga às suas listas.
+ */
+class TimerWheel{
+
+public:
+    /**
+     * @brief Temporizador agendado na roda. Deve continuar existindo, no
+     * mesmo endereço, enquanto estiver agendado.
+     */
+    struct Timer{
+        Timer *prev; //!< Temporizador anterior na posição da roda, ou nullptr se não está agendado.
+        Timer *next; //!< Próximo temporizador na posição da roda.
+        unsigned long long expires; //!< Tique em que o temporizador vence.
+        size_t id; //!< Identificador definido pelo dono do temporizador.
+
+        // Construtor de um temporizador não agendado.
+        Timer() : prev(nullptr), next(nullptr), expires(0), id(0) {}
+        // Verifica se o temporizador está agendado.
+        bool isScheduled() const {return prev != nullptr;}
+    };
+
+    //! Número de bits do índice de cada nível.
+    static const unsigned levelBits = 8;
+    //! Número de posições de cada nível.
+    static const size_t slotCount = (size_t)1 << levelBits;
+    //! Número de níveis da roda.
+    static const unsigned levels = 4;
+
+private:
+    Timer slots[levels][slotCount]; //!< Sentinelas das listas circulares de cada posição.
+    unsigned long long now; //!< Tique atual.
+    size_t pending; //!< Número de temporizadores agendados.
+
+    // Liga um temporizador à posição da roda que corresponde ao seu vencimento.
+    void insert(Timer &timer);
+    // Redistribui nos níveis de baixo os temporizadores de uma posição.
+    void cascade(unsigned level, size_t index);
+    // Desliga um temporizador da lista em que está.
+    static void unlink(Timer &timer);
+
+public:
+    // Construtor da roda vazia, começando no tique especificado.
+    TimerWheel(unsigned long long start = 0);
+    // A roda guarda ponteiros para suas próprias sentinelas, então não pode ser copiada.
+    TimerWheel(const TimerWheel &other) = delete;
+    TimerWheel &operator=(const TimerWheel &other) = delete;
+    // Agenda, ou reagenda, um temporizador para o tique especificado.
+    void schedule(Timer &timer, unsigned long long expires);
+    // Cancela um temporizador agendado.
+    void cancel(Timer &timer);
+    // Retorna o tique atual.
+    unsigned long long getTime() const;
+    // Retorna o número de temporizadores agendados.
+    size_t getPending() const;
+    // Avança até um tique, disparando os temporizadores vencidos.
+    template <typename Fire>
+    size_t advance(unsigned long long to, Fire fire);
+};
+
+/**
+ * @brief Avança a roda, tique a tique, até o tique especificado. Em cada
+ * tique, os temporizadores que vencem nele são desligados da roda e fire é
+ * chamada com cada um deles, podendo reagendá-los ou cancelar outros.
+ *
+ * @param to Tique final.
+ * @param fire Função chamada com cada temporizador vencido (Timer&).
+ * @return Número de temporizadores disparados.
+ */
+template <typename Fire>
+size_t TimerWheel::advance(unsigned long long to, Fire fire){
+    size_t fired = 0;
+
+    while(now < to){
+        if(pending == 0){
+            now = to;
+            break;
+        }
+        now++;
+
+        size_t index = (size_t)(now & (slotCount - 1));
+        for(unsigned level = 1; index == 0 && level < levels; level++){
+            index = (size_t)((now >> (level * levelBits)) & (slotCount - 1));
+            cascade(level, index);
+        }
+
+        // Os vencidos são retirados da posição antes de disparar, pois fire pode reagendá-los
+        Timer &head = slots[0][now & (slotCount - 1)];
+        if(head.next == &head){
+            continue;
+        }
+        Timer due;
+        due.next = head.next;
+        due.prev = head.prev;
+        due.next->prev = &due;
+        due.prev->next = &due;
+        head.next = &head;
+        head.prev = &head;
+
+        while(due.next != &due){
+            Timer &timer = *due.next;
+            unlink(timer);
+            pending--;
+            fired++;
+            fire(timer);
+        }
+    }
+    return fired;
+}
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file Transaction.hpp
+ * @brief Arquivo que contém a classe Transaction, que aplica várias alterações de uma vez.
+ */
+
+#ifndef TRANSACTION_HPP
+#define TRANSACTION_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+#include "Library.hpp"
+
+/**
+ * @brief Conjunto de alterações nas playlists de uma biblioteca, aplicadas
+ * todas ou nenhuma.
+ *
+ * As alterações (criar e remover playlists, adicionar e remover músicas e
+ * mesclar uma playlist em outra) são apenas guardadas até commit. Ao
+ * confirmar, cada alteração é conferida na ordem em que foi feita, já
+ * considerando as anteriores, e a nova lista de músicas de cada playlist
+ * afetada é montada à parte, sem tocar a biblioteca. Só depois que tudo foi
+ * conferido e montado as novas listas são trocadas pelas antigas, sob um único
+ * Library::Editor, então os leitores veem a versão anterior ou a versão com
+ * todas as alterações, nunca parte delas. Se alguma alteração é inválida, a
+ * biblioteca não é alterada.
+ *
+ * O custo é proporcional às playlists afetadas, e não à biblioteca: as
+ * playlists são procuradas pelo nome (Library::Editor::findPlaylist) e as
+ * músicas no índice de busca pela identidade. Cada playlist afetada é
+ * percorrida uma vez, contando só as músicas que as alterações procuram, sem
+ * copiar a lista; as alterações guardam apenas as músicas adicionadas e
+ * quantas ocorrências de cada música foram removidas. As playlists que só
+ * recebem músicas no final recebem apenas os nós novos, e as demais playlists
+ * continuam compartilhadas com a versão anterior ao publicar. As alterações
+ * confirmadas formam um único passo do histórico (EditHistory).
+ */
+class Transaction{
+
+    /**
+     * @brief Tipo de uma alteração guardada.
+     */
+    enum Kind{
+        CreatePlaylist, //!< Cria uma playlist vazia.
+        RemovePlaylist, //!< Remove uma playlist.
+        AddSong, //!< Adiciona uma música do catálogo ao final de uma playlist.
+        RemoveSong, //!< Remove uma música de uma playlist.
+        Merge //!< Adiciona a uma playlist as músicas de outra que ela não tem.
+    };
+
+    /**
+     * @brief Alteração guardada.
+     */
+    struct Change{
+        Kind kind; //!< Tipo da alteração.
+        std::string playlist; //!< Nome da playlist alterada.
+        std::string source; //!< Nome da playlist mesclada, em Merge.
+        Song song; //!< Música adicionada ou removida, pela identidade.
+    };
+
+    /**
+     * @brief Ocorrências de uma música na playlist da biblioteca.
+     */
+    struct Occurrences{
+        size_t live; //!< Número de ocorrências na playlist da biblioteca.
+        size_t removed; //!< Quantas das primeiras ocorrências foram removidas pelas alterações já conferidas.
+    };
+
+    //! Ocorrências de cada música, pela identidade.
+    typedef std::unordered_map<const Song*, Occurrences, SongHash, SongEqual> SongCounts;
+
+    /**
+     * @brief Estado de uma playlist durante a conferência das alterações.
+     */
+    struct Staged{
+        Playlist *live; //!< Playlist da biblioteca com este nome, ou nullptr.
+        bool exists; //!< Indica se a playlist existe depois das alterações já conferidas.
+        bool created; //!< Indica se a playlist foi criada pela transação, substituindo live.
+        bool keepsLive; //!< Indica se as músicas de live continuam na playlist (não foi removida nem recriada).
+        bool complete; //!< Indica se counts tem todas as músicas de live, e não só as procuradas pelas alterações.
+        bool rewritten; //!< Indica se alguma música de live foi removida, e a lista inteira é trocada.
+        size_t creation; //!< Ordem da criação, entre as playlists criadas.
+        SongCounts counts; //!< Ocorrências em live das músicas procuradas pelas alterações.
+        std::vector<const Song*> added; //!< Músicas adicionadas ao final pela transação, em ordem.
+        SongSet addedMembers; //!< Músicas presentes em added.
+        Playlist content; //!< Músicas montadas para a troca.
+    };
+
+    std::vector<Change> changes; //!< Alterações guardadas, em ordem.
+
+    // Confere as alterações, montando o estado de cada playlist afetada.
+    bool stage(Library::Editor &editor, std::unordered_map<std::string, Staged> &staged, std::string &error);
+    // Verifica se uma playlist tem uma música, depois das alterações já conferidas.
+    static bool contains(Staged &playlist, const Song *song);
+    // Monta as músicas de uma playlist depois das alterações já conferidas.
+    static void listSongs(Staged &playlist, std::vector<const Song*> &songs);
+    // Guarda uma alteração.
+    void push(Kind kind, const std::string &playlist, const std::string &source, const Song &song);
+
+public:
+    // Guarda a criação de uma playlist vazia.
+    void createPlaylist(const std::string &name);
+    // Guarda a remoção de uma playlist.
+    void removePlaylist(const std::string &name);
+    // Guarda a adição de uma música do catálogo a uma playlist.
+    void addSong(const std::string &playlist, const Song &song);
+    // Guarda a remoção de uma música de uma playlist.
+    void removeSong(const std::string &playlist, const Song &song);
+    // Guarda a mescla de uma playlist em outra.
+    void merge(const std::string &playlist, const std::string &source);
+    // Retorna o número de alterações guardadas.
+    size_t getSize() const;
+    // Descarta as alterações guardadas.
+    void clear();
+    // Confere e aplica todas as alterações, ou nenhuma.
+    bool commit(Library &library, std::string &error);
+};
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file UpNextQueue.hpp
+ * @brief Arquivo que contém a classe UpNextQueue, a fila de músicas a tocar em seguida.
+ */
+
+#ifndef UPNEXTQUEUE_HPP
+#define UPNEXTQUEUE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include "Song.hpp"
+#include "MpscRing.hpp"
+
+/**
+ * @brief Fila de músicas a tocar antes de continuar a playlist, alterada por
+ * threads de controle (a interface) e consumida pela thread de reprodução.
+ *
+ * As threads de controle não alteram a fila diretamente: cada pedido
+ * (adicionar ao fim, tocar em seguida ou limpar) vira um comando em uma fila
+ * circular sem travas (MpscRing). A thread de reprodução aplica os comandos,
+ * em ordem, às músicas pendentes quando precisa da próxima música; só ela
+ * acessa as músicas pendentes, guardadas em um vetor circular de tamanho
+ * fixo. Assim, nenhuma das threads usa travas e a reprodução não aloca
+ * memória.
+ *
+ * Se as músicas pendentes estão cheias, os comandos ficam na fila circular
+ * até haver espaço; quando ela também enche, os pedidos são recusados, exceto
+ * limpar, que tem uma posição guardada. Limpar também é contado em um
+ * contador atômico, que a reprodução confere antes dos outros comandos, então
+ * ele vale mesmo com comandos anteriores esperando espaço. As músicas devem
+ * continuar existindo enquanto estiverem na fila.
+ */
+class UpNextQueue{
+
+    /**
+     * @brief Pedido de uma thread de controle.
+     */
+    struct Command{
+        enum Type{
+            Push, //!< Adicionar a música ao fim da fila.
+            InsertNext, //!< Adicionar a música ao início da fila.
+            Clear //!< Remover todas as músicas da fila.
+        };
+        Type type; //!< Tipo do pedido.
+        const Song *song; //!< Música do pedido, ou nullptr para Clear.
+    };
+
+    MpscRing<Command> commands; //!< Pedidos ainda não aplicados.
+    std::vector<const Song*> pending; //!< Vetor circular com as músicas da fila; usado só pela reprodução.
+    size_t first; //!< Posição da primeira música em pending.
+    size_t count; //!< Número de músicas em pending.
+    Command stalled; //!< Pedido retirado de commands que esperava espaço em pending.
+    bool hasStalled; //!< Indica se stalled guarda um pedido.
+    std::atomic<size_t> clearsSent; //!< Pedidos Clear já enviados a commands, contados pelas threads de controle.
+    size_t clearsApplied; //!< Pedidos Clear retirados de commands; usado só pela reprodução.
+
+    // Envia um pedido à thread de reprodução.
+    bool send(Command::Type type, const Song *song);
+    // Aplica um pedido às músicas pendentes, se houver espaço.
+    bool apply(const Command &command);
+    // Aplica os pedidos recebidos, em ordem.
+    void drain();
+
+public:
+    // Construtor da fila vazia, com espaço para pelo menos capacity músicas e pedidos.
+    UpNextQueue(size_t capacity = 64);
+    // Adiciona uma música ao fim da fila. Chamado pelas threads de controle.
+    bool push(const Song *song);
+    // Adiciona uma música ao início da fila. Chamado pelas threads de controle.
+    bool insertNext(const Song *song);
+    // Remove todas as músicas da fila. Chamado pelas threads de controle.
+    bool clear();
+    // Retira a próxima música da fila. Chamado pela thread de reprodução.
+    const Song *take();
+    // Retorna a próxima música da fila, sem retirá-la. Chamado pela thread de reprodução.
+    const Song *peek();
+    // Retorna o número de músicas na fila. Chamado pela thread de reprodução.
+    size_t getSize();
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file Watcher.hpp
+ * @brief Arquivo que contém a classe Watcher, que recarrega arquivos de playlists alterados.
+ */
+
+#ifndef WATCHER_HPP
+#define WATCHER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include <ostream>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "SongSet.hpp"
+#include "Library.hpp"
+
+/**
+ * @brief Classe que acompanha arquivos e pastas de playlists e, quando um
+ * arquivo muda, aplica à biblioteca apenas as linhas alteradas.
+ *
+ * Cada linha de um arquivo é guardada pelo seu hash, junto com o texto e o
+ * nome da playlist. Ao recarregar, as linhas novas são analisadas e cada
+ * playlist com linhas novas ou removidas é montada de novo com todas as suas
+ * linhas atuais, em todos os arquivos, de modo que apagar uma de várias
+ * linhas com o mesmo nome também tira as músicas dela; uma playlist sem
+ * nenhuma linha nos arquivos é removida. As músicas do catálogo não são
+ * removidas, pois podem ter sido usadas em outras playlists.
+ *
+ * As mudanças são detectadas com inotify, nas pastas dos arquivos, e um
+ * arquivo é recarregado quando fica 200 ms sem mudanças.
+ */
+class Watcher{
+
+public:
+    /**
+     * @brief Resultado de uma recarga de arquivo.
+     */
+    struct Reload{
+        std::string path; //!< Caminho do arquivo.
+        size_t lines; //!< Linhas adicionadas ou removidas.
+        size_t added; //!< Playlists adicionadas.
+        size_t removed; //!< Playlists removidas.
+        size_t replaced; //!< Playlists com as músicas alteradas.
+        double seconds; //!< Tempo gasto para recarregar.
+        std::string error; //!< Mensagem de erro, ou vazia se o arquivo foi lido.
+    };
+
+private:
+    /**
+     * @brief Linha de um arquivo, guardada pelo hash.
+     */
+    struct Line{
+        std::string name; //!< Nome da playlist da linha.
+        std::string text; //!< Texto da linha, analisado de novo quando outra linha com o nome muda.
+        size_t position; //!< Posição da primeira ocorrência da linha no arquivo.
+        size_t count; //!< Número de vezes que a linha aparece no arquivo.
+    };
+
+    /**
+     * @brief Pasta acompanhada pelo inotify.
+     */
+    struct Watch{
+        std::string prefix; //!< Caminho da pasta, com '/' no final, ou vazio para a pasta atual.
+        bool tree; //!< Indica se todos os arquivos da pasta são acompanhados, e não só os já conhecidos.
+    };
+
+    Library &library; //!< Biblioteca que recebe as alterações.
+    std::vector<std::string> paths; //!< Arquivos e pastas acompanhados.
+    bool verbose; //!< Indica se o resultado de cada recarga é exibido.
+    std::thread worker; //!< Thread que acompanha os arquivos.
+    int inotifyFd; //!< Descritor do inotify.
+    int stopFd; //!< Descritor de evento que interrompe a thread.
+
+    std::map<std::string, std::unordered_map<uint64_t, Line>> files; //!< Linhas de cada arquivo, pelo hash.
+    std::unordered_map<std::string, size_t> names; //!< Número de linhas com cada nome, em todos os arquivos.
+    std::unordered_map<int, Watch> watches; //!< Pastas acompanhadas, pelo descritor do inotify.
+    std::map<std::string, int> watchedDirs; //!< Descritor do inotify de cada pasta acompanhada.
+
+    SongSet knownSongs; //!< Músicas do catálogo, para evitar repetições.
+    unsigned long long knownSongsVersion; //!< Versão do catálogo em knownSongs.
+    std::unordered_map<std::string, Playlist*> knownPlaylists; //!< Playlists da biblioteca, pelo nome.
+    unsigned long long knownPlaylistsVersion; //!< Versão da lista de playlists em knownPlaylists.
+
+    mutable std::mutex reportsMutex; //!< Trava dos resultados ainda não lidos.
+    std::vector<Reload> reports; //!< Resultados ainda não lidos.
+
+    // Acompanha os arquivos. Executado na thread do Watcher.
+    void run();
+    // Acompanha uma pasta.
+    void watch(const std::string &prefix, bool tree);
+    // Lê as linhas iniciais de um arquivo, sem alterar a biblioteca.
+    void track(const std::string &path);
+    // Trata os eventos do inotify, marcando os arquivos alterados.
+    void readEvents(std::set<std::string> &dirty);
+    // Recarrega um arquivo alterado.
+    Reload reload(const std::string &path);
+
+public:
+    // Construtor.
+    Watcher(Library &library);
+    // Destrutor, que interrompe o acompanhamento.
+    ~Watcher();
+    // Começa a acompanhar arquivos e pastas.
+    bool start(const std::vector<std::string> &paths);
+    // Interrompe o acompanhamento.
+    void stop();
+    // Define se o resultado de cada recarga é exibido.
+    void setVerbose(bool verbose);
+    // Retorna e descarta os resultados das recargas feitas desde a última chamada.
+    std::vector<Reload> takeReports();
+
+    // Exibe o resultado de uma recarga.
+    static void printReload(std::ostream &os, const Reload &reload);
+};
+
+#endif
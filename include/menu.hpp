@@ -7,20 +7,35 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 #include "Node.hpp"
 #include "LinkedList.hpp"
 #include "Song.hpp"
 #include "Playlist.hpp"
+#include "PlaylistView.hpp"
+#include "PlaylistStats.hpp"
+#include "UpNextQueue.hpp"
+#include "SearchIndex.hpp"
+#include "SmartPlaylists.hpp"
+#include "Library.hpp"
+#include "Loader.hpp"
+#include "Watcher.hpp"
+#include "EditHistory.hpp"
+#include "MemoryReport.hpp"
 
 // Menu de gerenciar playlists.
-void playlistMenu(LinkedList<Playlist> &playlists);
+void playlistMenu(Library &library);
 // Menu de gerenciar músicas.
-void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists);
+void songMenu(Library &library);
 // Menu de gerenciar músicas em playlists.
-void songPlaylistMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists);
+void songPlaylistMenu(Library &library);
 // Menu de tocar músicas.
-void playSongs(LinkedList<Playlist> &playlists);
+void playSongs(Library &library);
+// Toca as músicas de uma visão de playlist.
+void playView(PlaylistView view, std::string name, const PlaylistStats &stats, const std::vector<const LinkedList<Song>*> &catalog);
+// Menu de busca de músicas.
+void searchMenu(Library &library);
 //Menu que apresenta novos métodos, acrescidos posteriormente.
-void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists);
+void otherMethods(Library &library);
 // Menu principal.
-int mainMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists);
\ No newline at end of file
+int mainMenu(Library &library, Loader &loader, Watcher &watcher);
\ No newline at end of file
@@ -0,0 +1,183 @@
+/**
+ * @file ColumnarCatalog.cpp
+ * @brief Arquivo que implementa os métodos da classe ColumnarCatalog.
+ */
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include "Song.hpp"
+#include "LinkedList.hpp"
+#include "ScanKernels.hpp"
+#include "TextKey.hpp"
+#include "ColumnarCatalog.hpp"
+
+/**
+ * @brief Construtor da cópia vazia.
+ */
+ColumnarCatalog::ColumnarCatalog(){
+    version = 0;
+}
+
+/**
+ * @brief Remove todas as músicas da cópia.
+ */
+void ColumnarCatalog::clear(){
+    songs.clear();
+    titles = Column();
+    authors = Column();
+    version = 0;
+}
+
+/**
+ * @brief Adiciona um texto ao fim de uma coluna.
+ *
+ * @param column Coluna que recebe o texto.
+ * @param text Texto normalizado.
+ */
+void ColumnarCatalog::appendText(Column &column, TextView text){
+    column.offsets.push_back((uint32_t)column.arena.size());
+    column.lengths.push_back((uint32_t)text.size());
+    column.hashes.push_back(hashBytes(text.data(), text.size()));
+    column.arena.insert(column.arena.end(), text.begin(), text.end());
+    column.arena.push_back('\0');
+}
+
+/**
+ * @brief Adiciona uma música à cópia, com os campos já normalizados.
+ *
+ * @param song Ponteiro para a música no catálogo.
+ * @param title Título normalizado.
+ * @param author Autor normalizado.
+ */
+void ColumnarCatalog::append(Song *song, TextView title, TextView author){
+    songs.push_back(song);
+    appendText(titles, title);
+    appendText(authors, author);
+    version = 0;
+}
+
+/**
+ * @brief Reconstrói a cópia a partir de todas as músicas do catálogo.
+ *
+ * @param catalog Lista encadeada (LinkedList) de músicas (Song) do sistema.
+ */
+void ColumnarCatalog::build(LinkedList<Song> &catalog){
+    clear();
+    Node<Song> *curr = catalog.getHead();
+    while(curr != nullptr){
+        Song &song = curr->getValue();
+        append(&song, song.getTitleKey(), song.getAuthorKey());
+        curr = curr->getNext();
+    }
+    version = catalog.getVersion();
+}
+
+/**
+ * @brief Verifica se a cópia ainda corresponde ao catálogo.
+ *
+ * @param catalog Lista encadeada (LinkedList) de músicas (Song) do sistema.
+ * @return Retorna true se o catálogo não mudou desde a última chamada a build.
+ */
+bool ColumnarCatalog::isValid(LinkedList<Song> &catalog) const{
+    return version != 0 && version == catalog.getVersion();
+}
+
+/**
+ * @brief Retorna o número de músicas da cópia.
+ *
+ * @return Número de músicas.
+ */
+size_t ColumnarCatalog::getSize() const{
+    return songs.size();
+}
+
+/**
+ * @brief Retorna o número de bytes de texto das duas colunas.
+ *
+ * @return Número de bytes percorridos por uma busca em todos os campos.
+ */
+size_t ColumnarCatalog::getTextBytes() const{
+    return titles.arena.size() + authors.arena.size();
+}
+
+/**
+ * @brief Retorna a memória ocupada pela cópia: os blocos de texto e os
+ * vetores de cada coluna, pela capacidade reservada.
+ *
+ * @return Número de bytes.
+ */
+size_t ColumnarCatalog::getBytes() const{
+    size_t bytes = songs.capacity() * sizeof(Song*);
+    const Column *columns[] = {&titles, &authors};
+    for(size_t i = 0; i < 2; i++){
+        bytes += columns[i]->arena.capacity() + columns[i]->offsets.capacity() * sizeof(uint32_t) +
+                 columns[i]->lengths.capacity() * sizeof(uint32_t) + columns[i]->hashes.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Busca as músicas cujo campo contém o texto.
+ *
+ * O bloco da coluna é percorrido de uma vez. Como os textos são separados por
+ * '\0', uma ocorrência nunca atravessa duas músicas; depois de cada ocorrência
+ * a busca continua a partir da música seguinte.
+ *
+ * @param key Texto normalizado, sem bytes nulos.
+ * @param field Campo consultado.
+ * @param result Vetor que recebe as músicas encontradas, na ordem da cópia.
+ */
+void ColumnarCatalog::findSubstring(const std::string &key, Field field, std::vector<Song*> &result) const{
+    const Column &column = (field == Title) ? titles : authors;
+    if(key.empty()){
+        result.insert(result.end(), songs.begin(), songs.end());
+        return;
+    }
+
+    const char *data = column.arena.data();
+    size_t size = column.arena.size();
+    size_t pos = 0;
+
+    while(pos < size){
+        size_t found = scanFind(data + pos, size - pos, key.data(), key.size());
+        if(found == SCAN_NOT_FOUND){
+            break;
+        }
+        found += pos;
+
+        auto next = std::upper_bound(column.offsets.begin(), column.offsets.end(), (uint32_t)found);
+        size_t row = (next - column.offsets.begin()) - 1;
+        result.push_back(songs[row]);
+
+        pos = (next == column.offsets.end()) ? size : *next;
+    }
+}
+
+/**
+ * @brief Busca as músicas cujo campo é igual ao texto. Os hashes são comparados
+ * primeiro e o texto só é comparado quando os hashes coincidem.
+ *
+ * @param key Texto normalizado.
+ * @param field Campo consultado.
+ * @param result Vetor que recebe as músicas encontradas, na ordem da cópia.
+ */
+void ColumnarCatalog::findEqual(const std::string &key, Field field, std::vector<Song*> &result) const{
+    const Column &column = (field == Title) ? titles : authors;
+    uint64_t hash = hashBytes(key.data(), key.size());
+    size_t row = 0;
+
+    while(row < songs.size()){
+        size_t found = scanHash(column.hashes.data() + row, songs.size() - row, hash);
+        if(found == SCAN_NOT_FOUND){
+            break;
+        }
+        row += found;
+        if(column.lengths[row] == key.size() &&
+           std::memcmp(column.arena.data() + column.offsets[row], key.data(), key.size()) == 0){
+            result.push_back(songs[row]);
+        }
+        row++;
+    }
+}
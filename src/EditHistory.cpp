@@ -0,0 +1,849 @@
+/**
+ * @file EditHistory.cpp
+ * @brief Arquivo que implementa os métodos da classe EditHistory.
+ */
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <unordered_map>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongOrder.hpp"
+#include "Playlist.hpp"
+#include "SearchIndex.hpp"
+#include "EditHistory.hpp"
+
+/**
+ * @brief Conta os nós de uma lista depois de um nó.
+ *
+ * @param list Lista.
+ * @param last Nó da lista, ou nullptr para contar a lista inteira.
+ * @return Número de nós depois de last.
+ */
+template <typename T>
+static size_t countAfter(const LinkedList<T> &list, const Node<T> *last){
+    size_t count = 0;
+    for(const Node<T> *curr = (last != nullptr) ? last->getNext() : list.getHead(); curr != nullptr; curr = curr->getNext()){
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Construtor do histórico vazio.
+ *
+ * @param catalog Catálogo de músicas.
+ * @param playlists Lista de playlists.
+ * @param index Índice de busca do catálogo.
+ * @param maxSteps Número máximo de passos guardados.
+ * @param maxBytes Memória máxima estimada dos passos guardados.
+ */
+EditHistory::EditHistory(LinkedList<Song> &catalog, LinkedList<Playlist> &playlists, SearchIndex &index,
+                         size_t maxSteps, size_t maxBytes) : catalog(catalog), playlists(playlists), index(index){
+    this->maxSteps = maxSteps;
+    this->maxBytes = maxBytes;
+    bytes = 0;
+    depth = 0;
+    paused = 0;
+    batchExtends = false;
+    batchOpen = false;
+    extendable = false;
+}
+
+/**
+ * @brief Construtor que abre um passo no histórico, se houver.
+ *
+ * @param history Histórico, ou nullptr para não agrupar nada.
+ * @param label Descrição do passo.
+ * @param extend Indica se o passo pode continuar o último (veja EditHistory::begin).
+ */
+EditHistory::Batch::Batch(EditHistory *history, const std::string &label, bool extend) : history(history){
+    if(history != nullptr){
+        history->begin(label, extend);
+    }
+}
+
+/**
+ * @brief Destrutor, que fecha o passo.
+ */
+EditHistory::Batch::~Batch(){
+    if(history != nullptr){
+        history->end();
+    }
+}
+
+/**
+ * @brief Construtor que suspende o registro das alterações, usado para as
+ * alterações que são consequência de outras, como a atualização das
+ * playlists inteligentes.
+ *
+ * @param history Histórico, ou nullptr.
+ */
+EditHistory::Pause::Pause(EditHistory *history) : history(history){
+    if(history != nullptr){
+        history->paused++;
+    }
+}
+
+/**
+ * @brief Destrutor, que retoma o registro.
+ */
+EditHistory::Pause::~Pause(){
+    if(history != nullptr){
+        history->paused--;
+    }
+}
+
+/**
+ * @brief Abre um passo: as alterações registradas até o end correspondente
+ * são desfeitas de uma vez. Chamadas aninhadas fazem parte do mesmo passo.
+ *
+ * @param label Descrição do passo.
+ * @param extend Se true e o último passo tem a mesma descrição, também foi
+ * aberto com extend e nada foi registrado ou desfeito depois dele, as
+ * alterações continuam aquele passo. Usado pela importação, que adiciona as
+ * playlists aos poucos.
+ */
+void EditHistory::begin(const std::string &label, bool extend){
+    if(depth++ > 0){
+        return;
+    }
+    batchLabel = label;
+    batchExtends = extend;
+    batchOpen = false;
+}
+
+/**
+ * @brief Fecha o passo aberto por begin e descarta os passos mais antigos,
+ * se os limites foram excedidos.
+ */
+void EditHistory::end(){
+    if(depth == 0 || --depth > 0){
+        return;
+    }
+    if(batchOpen){
+        extendable = batchExtends;
+        batchOpen = false;
+    }
+    trim();
+}
+
+/**
+ * @brief Retorna a versão registrada equivalente a uma versão. Uma lista
+ * desfeita ou refeita recebe uma versão nova, mas tem o mesmo conteúdo que
+ * tinha com a versão registrada na operação.
+ *
+ * @param version Versão atual de uma lista.
+ * @return Versão registrada equivalente, ou a própria versão.
+ */
+unsigned long long EditHistory::logical(unsigned long long version) const{
+    auto it = equivalent.find(version);
+    return (it != equivalent.end()) ? it->second : version;
+}
+
+/**
+ * @brief Retorna o passo que recebe uma nova operação. Fora de um begin,
+ * cada operação forma um passo. Um passo novo descarta os passos desfeitos.
+ *
+ * @param target Lista alterada, usada na descrição de um passo avulso.
+ * @param name Nome da playlist alterada, no alvo Songs.
+ * @return Referência para o passo.
+ */
+EditHistory::Step &EditHistory::current(Target target, const std::string &name){
+    if(depth > 0 && batchOpen){
+        return undoSteps.back();
+    }
+    if(depth > 0 && batchExtends && extendable && redoSteps.empty() &&
+       !undoSteps.empty() && undoSteps.back().label == batchLabel){
+        batchOpen = true;
+        return undoSteps.back();
+    }
+
+    for(size_t i = 0; i < redoSteps.size(); i++){
+        bytes -= redoSteps[i].bytes;
+    }
+    redoSteps.clear();
+    extendable = false;
+
+    undoSteps.push_back(Step());
+    Step &step = undoSteps.back();
+    step.bytes = 0;
+    if(depth > 0){
+        step.label = batchLabel;
+        batchOpen = true;
+    }
+    else if(target == Catalog){
+        step.label = "Alterar o catálogo";
+    }
+    else if(target == Playlists){
+        step.label = "Alterar a lista de playlists";
+    }
+    else{
+        step.label = "Alterar a playlist " + name;
+    }
+    return step;
+}
+
+/**
+ * @brief Acrescenta uma operação ao passo atual. A operação deve ser
+ * completada por finish.
+ *
+ * @param kind Tipo da operação que desfaz a alteração.
+ * @param target Lista alterada.
+ * @param name Nome da playlist alterada, no alvo Songs.
+ * @param prior Versão da lista antes da alteração.
+ * @return Ponteiro para a operação, ou nullptr se o registro está suspenso.
+ */
+EditHistory::Operation *EditHistory::start(Kind kind, Target target, const std::string &name, unsigned long long prior){
+    if(paused > 0){
+        return nullptr;
+    }
+    unsigned long long before = logical(prior);
+    equivalent.erase(prior);
+
+    Step &step = current(target, name);
+    step.operations.push_back(Operation());
+    Operation &operation = step.operations.back();
+    operation.kind = kind;
+    operation.target = target;
+    operation.name = name;
+    operation.expected = 0;
+    operation.result = before;
+    operation.count = 0;
+    operation.bytes = 0;
+    return &operation;
+}
+
+/**
+ * @brief Completa uma operação acrescentada por start, contando sua memória.
+ *
+ * @param operation Operação, que é a última do passo atual.
+ * @param version Versão da lista depois da alteração.
+ */
+void EditHistory::finish(Operation &operation, unsigned long long version){
+    operation.expected = version;
+    size_t size = sizeOf(operation);
+    undoSteps.back().bytes += size - operation.bytes;
+    bytes += size - operation.bytes;
+    operation.bytes = size;
+    if(depth == 0){
+        trim();
+    }
+}
+
+/**
+ * @brief Registra elementos adicionados ao final de uma lista. Se a última
+ * operação do passo também registrou adições à mesma lista, logo antes desta,
+ * ela passa a cobrir as duas.
+ *
+ * @param target Lista alterada.
+ * @param name Nome da playlist alterada, no alvo Songs.
+ * @param prior Versão da lista antes da alteração.
+ * @param count Número de elementos adicionados.
+ * @param version Versão da lista depois da alteração.
+ */
+void EditHistory::appended(Target target, const std::string &name, unsigned long long prior, size_t count,
+                           unsigned long long version){
+    if(paused > 0 || count == 0){
+        return;
+    }
+    if(depth > 0 && batchOpen && !undoSteps.empty() && !undoSteps.back().operations.empty()){
+        Operation &previous = undoSteps.back().operations.back();
+        if(previous.kind == Truncate && previous.target == target && previous.name == name &&
+           previous.expected == prior){
+            previous.expected = version;
+            previous.count += count;
+            return;
+        }
+    }
+    Operation *operation = start(Truncate, target, name, prior);
+    operation->count = count;
+    finish(*operation, version);
+}
+
+/**
+ * @brief Registra músicas adicionadas ao final do catálogo.
+ *
+ * @param prior Versão do catálogo antes da alteração.
+ * @param lastKnown Último nó antes da alteração, ou nullptr se o catálogo estava vazio.
+ */
+void EditHistory::catalogAppended(unsigned long long prior, Node<Song> *lastKnown){
+    appended(Catalog, "", prior, countAfter(catalog, lastKnown), catalog.getVersion());
+}
+
+/**
+ * @brief Registra playlists adicionadas ao final da lista de playlists.
+ *
+ * @param prior Versão da lista antes da alteração.
+ * @param lastKnown Último nó antes da alteração, ou nullptr se a lista estava vazia.
+ */
+void EditHistory::playlistsAppended(unsigned long long prior, Node<Playlist> *lastKnown){
+    appended(Playlists, "", prior, countAfter(playlists, lastKnown), playlists.getVersion());
+}
+
+/**
+ * @brief Registra músicas adicionadas ao final de uma playlist.
+ *
+ * @param playlist Playlist alterada.
+ * @param prior Versão da lista de músicas antes da alteração.
+ * @param lastKnown Último nó antes da alteração, ou nullptr se a playlist estava vazia.
+ */
+void EditHistory::songsAppended(Playlist &playlist, unsigned long long prior, Node<Song> *lastKnown){
+    appended(Songs, playlist.getName(), prior, countAfter(playlist.readSongs(), lastKnown), playlist.readSongs().getVersion());
+}
+
+/**
+ * @brief Registra músicas retiradas de uma playlist, que voltam às suas
+ * posições quando a alteração for desfeita.
+ *
+ * @param playlist Playlist alterada.
+ * @param prior Versão da lista de músicas antes da alteração.
+ * @param positions Posições das músicas antes da alteração, em ordem
+ * crescente. O vetor é esvaziado.
+ * @param removed Músicas retiradas, na mesma ordem. Os nós são tomados.
+ */
+void EditHistory::songsErased(Playlist &playlist, unsigned long long prior, std::vector<uint32_t> &positions,
+                              LinkedList<Song> &removed){
+    if(positions.empty()){
+        return;
+    }
+    Operation *operation = start(Restore, Songs, playlist.getName(), prior);
+    if(operation == nullptr){
+        return;
+    }
+    operation->positions.swap(positions);
+    operation->songs = std::move(removed);
+    finish(*operation, playlist.readSongs().getVersion());
+}
+
+/**
+ * @brief Registra a troca de todas as músicas de uma playlist.
+ *
+ * @param playlist Playlist alterada.
+ * @param prior Versão da lista de músicas antes da alteração.
+ * @param previous Músicas anteriores. Os nós são tomados.
+ */
+void EditHistory::songsReplaced(Playlist &playlist, unsigned long long prior, LinkedList<Song> &previous){
+    Operation *operation = start(Replace, Songs, playlist.getName(), prior);
+    if(operation == nullptr){
+        return;
+    }
+    operation->songs = std::move(previous);
+    finish(*operation, playlist.readSongs().getVersion());
+}
+
+/**
+ * @brief Registra que as músicas de uma playlist foram copiadas para nós
+ * novos (Playlist::compact), na mesma ordem. Nenhum passo é criado: a nova
+ * versão da lista apenas passa a equivaler à anterior, para que as operações
+ * guardadas continuem podendo ser aplicadas.
+ *
+ * @param playlist Playlist alterada.
+ * @param prior Versão da lista de músicas antes da cópia.
+ */
+void EditHistory::songsRelocated(Playlist &playlist, unsigned long long prior){
+    unsigned long long version = playlist.readSongs().getVersion();
+    if(version == prior){
+        return;
+    }
+    unsigned long long before = logical(prior);
+    equivalent.erase(prior);
+    if(!undoSteps.empty() || !redoSteps.empty()){
+        equivalent[version] = before;
+    }
+}
+
+/**
+ * @brief Retira de uma lista o primeiro elemento escolhido. O nó vai para o
+ * histórico, ou é destruído se o registro está suspenso.
+ *
+ * @param target Lista alterada.
+ * @param name Nome da playlist alterada, no alvo Songs.
+ * @param list Lista alterada.
+ * @param matches Predicado que escolhe o elemento.
+ * @return true se um elemento foi retirado.
+ */
+template <typename T, typename Match>
+bool EditHistory::take(Target target, const std::string &name, LinkedList<T> &list, Match matches){
+    Node<T> *prev = nullptr;
+    Node<T> *curr = list.getHead();
+    uint32_t position = 0;
+    while(curr != nullptr && !matches(curr->getValue())){
+        prev = curr;
+        curr = curr->getNext();
+        position++;
+    }
+    if(curr == nullptr){
+        return false;
+    }
+
+    unsigned long long prior = list.getVersion();
+    LinkedList<T> removed;
+    removed.spliceAfter(nullptr, list, prev, curr);
+    Operation *operation = start(Restore, target, name, prior);
+    if(operation != nullptr){
+        operation->positions.push_back(position);
+        held(*operation, list) = std::move(removed);
+        finish(*operation, list.getVersion());
+    }
+    return true;
+}
+
+/**
+ * @brief Remove uma música do catálogo, como LinkedList::removeValue, mas
+ * guardando o nó no histórico. O endereço da música é mantido, então o
+ * índice de busca pode recebê-la de volta.
+ *
+ * @param song Música removida, comparada pela identidade.
+ * @return true se a música estava no catálogo.
+ */
+bool EditHistory::removeFromCatalog(const Song &song){
+    return take(Catalog, "", catalog, [&song](const Song &value){ return value.equals(song); });
+}
+
+/**
+ * @brief Remove uma playlist pelo nome, guardando o nó, com todas as suas
+ * músicas, no histórico.
+ *
+ * @param name Nome da playlist.
+ * @return true se a playlist existia.
+ */
+bool EditHistory::removePlaylist(const std::string &name){
+    return take(Playlists, "", playlists, [&name](Playlist &value){ return value.getName() == name; });
+}
+
+/**
+ * @brief Remove a primeira ocorrência de uma música de uma playlist,
+ * guardando o nó no histórico. Chamado pela própria playlist.
+ *
+ * @param playlist Playlist alterada.
+ * @param song Música removida, comparada pela identidade.
+ * @return true se a música estava na playlist.
+ */
+bool EditHistory::removeFromPlaylist(Playlist &playlist, const Song &song){
+    return take(Songs, playlist.getName(), playlist.getSongs(), [&song](const Song &value){ return value.equals(song); });
+}
+
+/**
+ * @brief Ordena uma lista de músicas, da mesma forma que LinkedList::sort,
+ * guardando a posição anterior de cada nó. Se a ordem não muda, nada é
+ * registrado.
+ *
+ * @param target Lista alterada.
+ * @param name Nome da playlist alterada, no alvo Songs.
+ * @param list Lista alterada.
+ * @param order Ordenação das músicas.
+ */
+void EditHistory::sortList(Target target, const std::string &name, LinkedList<Song> &list, const SongOrder &order){
+    if(paused > 0){
+        list.sort(order);
+        return;
+    }
+    std::vector<Node<Song>*> nodes;
+    for(Node<Song> *curr = list.getHead(); curr != nullptr; curr = curr->getNext()){
+        nodes.push_back(curr);
+    }
+    if(nodes.size() < 2){
+        return;
+    }
+
+    // sorted[i] é a posição anterior do nó que fica na posição i
+    std::vector<uint32_t> sorted(nodes.size());
+    for(uint32_t i = 0; i < sorted.size(); i++){
+        sorted[i] = i;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [&nodes, &order](uint32_t a, uint32_t b){
+        return order(nodes[a]->getValue(), nodes[b]->getValue());
+    });
+    bool moved = false;
+    for(uint32_t i = 0; i < sorted.size() && !moved; i++){
+        moved = sorted[i] != i;
+    }
+    if(!moved){
+        return;
+    }
+
+    unsigned long long prior = list.getVersion();
+    for(size_t i = 0; i + 1 < sorted.size(); i++){
+        nodes[sorted[i]]->setNext(nodes[sorted[i + 1]]);
+    }
+    nodes[sorted.back()]->setNext(nullptr);
+    list.setHead(nodes[sorted.front()]);
+    list.setTail(nodes[sorted.back()]);
+
+    Operation *operation = start(Reorder, target, name, prior);
+    operation->positions.swap(sorted);
+    finish(*operation, list.getVersion());
+}
+
+/**
+ * @brief Ordena o catálogo, registrando a ordem anterior.
+ *
+ * @param order Ordenação das músicas.
+ */
+void EditHistory::sortCatalog(const SongOrder &order){
+    sortList(Catalog, "", catalog, order);
+}
+
+/**
+ * @brief Ordena as músicas de uma playlist, registrando a ordem anterior.
+ * Chamado pela própria playlist.
+ *
+ * @param playlist Playlist alterada.
+ * @param order Ordenação das músicas.
+ */
+void EditHistory::sortSongs(Playlist &playlist, const SongOrder &order){
+    sortList(Songs, playlist.getName(), playlist.getSongs(), order);
+}
+
+/**
+ * @brief Retorna as músicas guardadas por uma operação sobre uma lista de músicas.
+ *
+ * @param operation Operação.
+ * @param list Lista da operação, usada apenas para escolher o tipo.
+ * @return Referência para as músicas guardadas.
+ */
+LinkedList<Song> &EditHistory::held(Operation &operation, LinkedList<Song> &){
+    return operation.songs;
+}
+
+/**
+ * @brief Retorna as playlists guardadas por uma operação sobre a lista de playlists.
+ *
+ * @param operation Operação.
+ * @param list Lista da operação, usada apenas para escolher o tipo.
+ * @return Referência para as playlists guardadas.
+ */
+LinkedList<Playlist> &EditHistory::held(Operation &operation, LinkedList<Playlist> &){
+    return operation.playlists;
+}
+
+/**
+ * @brief Estima a memória de uma operação: a própria operação, as posições
+ * e os nós guardados, incluindo as músicas das playlists guardadas.
+ *
+ * @param operation Operação.
+ * @return Memória estimada, em bytes.
+ */
+size_t EditHistory::sizeOf(Operation &operation){
+    size_t size = sizeof(Operation) + operation.name.capacity() + operation.positions.capacity() * sizeof(uint32_t);
+    for(Node<Song> *curr = operation.songs.getHead(); curr != nullptr; curr = curr->getNext()){
+        size += sizeof(Node<Song>);
+    }
+    for(Node<Playlist> *curr = operation.playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+        size += sizeof(Node<Playlist>) + curr->getValue().getStats().getTracks() * sizeof(Node<Song>);
+    }
+    return size;
+}
+
+/**
+ * @brief Aplica uma operação a uma lista e monta, em inverse, a operação que
+ * desfaz a aplicação. Os nós guardados pela operação passam para a lista, e
+ * os retirados da lista passam para inverse.
+ *
+ * @param operation Operação aplicada, cuja versão esperada já foi conferida.
+ * @param list Lista alterada.
+ * @param inverse Operação vazia, que recebe o tipo, as posições e os nós da inversa.
+ */
+template <typename T>
+void EditHistory::apply(Operation &operation, LinkedList<T> &list, Operation &inverse){
+    switch(operation.kind){
+        case Truncate: {
+            // Os nós são contados, e não guardados, pois uma música restaurada
+            // pode ser uma cópia do nó que existia quando a operação foi registrada
+            inverse.kind = Append;
+            size_t kept = countAfter(list, (Node<T>*)nullptr) - operation.count;
+            Node<T> *last = nullptr;
+            for(size_t i = 0; i < kept; i++){
+                last = (last != nullptr) ? last->getNext() : list.getHead();
+            }
+            if(operation.count > 0){
+                held(inverse, list).spliceAfter(nullptr, list, last, list.getTail());
+            }
+            break;
+        }
+
+        case Append:
+            inverse.kind = Truncate;
+            inverse.count = countAfter(held(operation, list), (Node<T>*)nullptr);
+            list.splice(held(operation, list));
+            break;
+
+        case Erase: {
+            inverse.kind = Restore;
+            LinkedList<T> &removed = held(inverse, list);
+            Node<T> *prev = nullptr;
+            Node<T> *curr = list.getHead();
+            size_t position = 0;
+            for(size_t i = 0; i < operation.positions.size(); i++){
+                while(position < operation.positions[i]){
+                    prev = curr;
+                    curr = curr->getNext();
+                    position++;
+                }
+                Node<T> *next = curr->getNext();
+                removed.spliceAfter(removed.getTail(), list, prev, curr);
+                curr = next;
+                position++;
+            }
+            inverse.positions.swap(operation.positions);
+            break;
+        }
+
+        case Restore: {
+            inverse.kind = Erase;
+            LinkedList<T> &restored = held(operation, list);
+            // prev é o nó da posição position - 1 da lista final
+            Node<T> *prev = nullptr;
+            size_t position = 0;
+            for(size_t i = 0; i < operation.positions.size(); i++){
+                while(position < operation.positions[i]){
+                    prev = (prev != nullptr) ? prev->getNext() : list.getHead();
+                    position++;
+                }
+                list.spliceAfter(prev, restored, nullptr, restored.getHead());
+                prev = (prev != nullptr) ? prev->getNext() : list.getHead();
+                position++;
+            }
+            inverse.positions.swap(operation.positions);
+            break;
+        }
+
+        case Reorder: {
+            inverse.kind = Reorder;
+            size_t size = operation.positions.size();
+            std::vector<Node<T>*> nodes(size);
+            inverse.positions.resize(size);
+            size_t position = 0;
+            for(Node<T> *curr = list.getHead(); curr != nullptr; curr = curr->getNext()){
+                nodes[operation.positions[position]] = curr;
+                inverse.positions[operation.positions[position]] = (uint32_t)position;
+                position++;
+            }
+            for(size_t i = 0; i + 1 < size; i++){
+                nodes[i]->setNext(nodes[i + 1]);
+            }
+            if(size > 0){
+                nodes[size - 1]->setNext(nullptr);
+                list.setHead(nodes[0]);
+                list.setTail(nodes[size - 1]);
+            }
+            break;
+        }
+
+        case Replace: {
+            inverse.kind = Replace;
+            LinkedList<T> current(std::move(list));
+            list = std::move(held(operation, list));
+            held(inverse, list) = std::move(current);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Desfaz o último passo de uma pilha e guarda o passo inverso na
+ * outra. Undo e redo são a mesma operação, com as pilhas trocadas.
+ *
+ * Antes de alterar qualquer lista, confere se cada lista ainda tem a versão
+ * registrada. As playlists são encontradas pelo nome; a de uma operação que
+ * só existirá depois que outra operação do passo for aplicada é conferida ao
+ * ser alterada. Se alguma versão não confere, o histórico é descartado.
+ *
+ * @param from Pilha de onde o passo é retirado.
+ * @param to Pilha que recebe o passo inverso.
+ * @param label Recebe a descrição do passo.
+ * @return Applied, Nothing ou Conflict.
+ */
+EditHistory::Result EditHistory::replay(std::deque<Step> &from, std::deque<Step> &to, std::string &label){
+    if(from.empty()){
+        return Nothing;
+    }
+    Step &step = from.back();
+    label = step.label;
+    batchOpen = false;
+    extendable = false;
+
+    std::unordered_map<std::string, Playlist*> byName;
+    bool namesKnown = false;
+    auto songsOf = [this, &byName, &namesKnown](const Operation &operation) -> LinkedList<Song>*{
+        if(operation.target == Catalog){
+            return &catalog;
+        }
+        if(!namesKnown){
+            byName.clear();
+            for(Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+                byName.insert(std::make_pair(curr->getValue().getName(), &curr->getValue()));
+            }
+            namesKnown = true;
+        }
+        auto it = byName.find(operation.name);
+        return (it != byName.end()) ? &it->second->getSongs() : nullptr;
+    };
+
+    // Versão de cada lista depois das operações já conferidas, pelo alvo
+    std::unordered_map<std::string, unsigned long long> versions;
+    for(size_t i = step.operations.size(); i-- > 0;){
+        Operation &operation = step.operations[i];
+        std::string key = std::string(1, (char)('0' + operation.target)) + operation.name;
+        auto it = versions.find(key);
+        unsigned long long version;
+        if(it != versions.end()){
+            version = it->second;
+        }
+        else if(operation.target == Playlists){
+            version = logical(playlists.getVersion());
+        }
+        else{
+            LinkedList<Song> *list = songsOf(operation);
+            if(list == nullptr){
+                continue;
+            }
+            version = logical(list->getVersion());
+        }
+        if(version != operation.expected){
+            clear();
+            return Conflict;
+        }
+        versions[key] = operation.result;
+    }
+
+    Step inverse;
+    inverse.label = step.label;
+    inverse.bytes = 0;
+    for(size_t i = step.operations.size(); i-- > 0;){
+        Operation &operation = step.operations[i];
+        inverse.operations.push_back(Operation());
+        Operation &undone = inverse.operations.back();
+        undone.target = operation.target;
+        undone.name = operation.name;
+        undone.expected = operation.result;
+        undone.result = operation.expected;
+        undone.count = 0;
+
+        unsigned long long before;
+        unsigned long long after;
+        if(operation.target == Playlists){
+            before = playlists.getVersion();
+            apply(operation, playlists, undone);
+            after = playlists.getVersion();
+            namesKnown = false;
+        }
+        else{
+            LinkedList<Song> *list = songsOf(operation);
+            if(list == nullptr || logical(list->getVersion()) != operation.expected){
+                clear();
+                return Conflict;
+            }
+            std::vector<Song*> entering;
+            if(operation.target == Catalog){
+                for(Node<Song> *curr = operation.songs.getHead(); curr != nullptr; curr = curr->getNext()){
+                    entering.push_back(&curr->getValue());
+                }
+            }
+            before = list->getVersion();
+            apply(operation, *list, undone);
+            after = list->getVersion();
+            if(operation.target == Catalog){
+                for(Node<Song> *curr = undone.songs.getHead(); curr != nullptr; curr = curr->getNext()){
+                    index.remove(&curr->getValue());
+                }
+                for(size_t k = 0; k < entering.size(); k++){
+                    index.add(entering[k]);
+                }
+            }
+        }
+        equivalent.erase(before);
+        equivalent[after] = operation.result;
+        undone.bytes = sizeOf(undone);
+        inverse.bytes += undone.bytes;
+    }
+
+    bytes -= step.bytes;
+    bytes += inverse.bytes;
+    from.pop_back();
+    to.push_back(std::move(inverse));
+    return Applied;
+}
+
+/**
+ * @brief Desfaz o último passo registrado.
+ *
+ * @param label Recebe a descrição do passo.
+ * @return Applied, Nothing se não há passo, ou Conflict se as listas mudaram
+ * sem registro; nesse caso o histórico é descartado.
+ */
+EditHistory::Result EditHistory::undo(std::string &label){
+    return replay(undoSteps, redoSteps, label);
+}
+
+/**
+ * @brief Refaz o último passo desfeito. Qualquer alteração registrada depois
+ * de desfazer um passo descarta os passos que podem ser refeitos.
+ *
+ * @param label Recebe a descrição do passo.
+ * @return Applied, Nothing ou Conflict, como em undo.
+ */
+EditHistory::Result EditHistory::redo(std::string &label){
+    return replay(redoSteps, undoSteps, label);
+}
+
+/**
+ * @brief Descarta os passos mais antigos enquanto houver mais de maxSteps
+ * passos ou mais de maxBytes bytes estimados. Um passo aberto não é descartado.
+ */
+void EditHistory::trim(){
+    while(!undoSteps.empty() && (undoSteps.size() > maxSteps || bytes > maxBytes)){
+        if(batchOpen && undoSteps.size() == 1){
+            break;
+        }
+        bytes -= undoSteps.front().bytes;
+        undoSteps.pop_front();
+    }
+    if(undoSteps.empty() && redoSteps.empty()){
+        equivalent.clear();
+        extendable = false;
+    }
+}
+
+/**
+ * @brief Descarta todos os passos, destruindo os nós guardados.
+ */
+void EditHistory::clear(){
+    undoSteps.clear();
+    redoSteps.clear();
+    equivalent.clear();
+    bytes = 0;
+    batchOpen = false;
+    extendable = false;
+}
+
+/**
+ * @brief Retorna o número de passos que podem ser desfeitos.
+ *
+ * @return Número de passos.
+ */
+size_t EditHistory::getUndoSteps() const{
+    return undoSteps.size();
+}
+
+/**
+ * @brief Retorna o número de passos que podem ser refeitos.
+ *
+ * @return Número de passos.
+ */
+size_t EditHistory::getRedoSteps() const{
+    return redoSteps.size();
+}
+
+/**
+ * @brief Retorna a memória estimada dos passos guardados.
+ *
+ * @return Memória estimada, em bytes.
+ */
+size_t EditHistory::getBytes() const{
+    return bytes;
+}
@@ -0,0 +1,562 @@
+/**
+ * @file Library.cpp
+ * @brief Arquivo que implementa os métodos da classe Library.
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "Node.hpp"
+#include "NodePool.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "SearchIndex.hpp"
+#include "SmartPlaylists.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+
+/**
+ * @brief Procura uma playlist da versão pelo nome.
+ *
+ * @param name Nome da playlist.
+ * @return Ponteiro para a playlist, ou nullptr caso ela não exista nesta versão.
+ */
+const Playlist *Library::Snapshot::findPlaylist(const std::string &name) const{
+    for(size_t i = 0; i < playlists.size(); i++){
+        if(playlists[i]->getName() == name){
+            return playlists[i].get();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Retorna o número de músicas do catálogo da versão, somando as partes.
+ *
+ * @return Número de músicas.
+ */
+size_t Library::Snapshot::getSongCount() const{
+    size_t count = 0;
+    for(size_t i = 0; i < songs.size(); i++){
+        count += songs[i]->getSize();
+    }
+    return count;
+}
+
+/**
+ * @brief Cria uma parte do catálogo publicado com cópias das músicas
+ * indicadas, reservando os nós de uma vez.
+ *
+ * @param pending Músicas da parte, em ordem; o vetor é esvaziado.
+ * @param contiguous Indica se os nós devem ficar lado a lado, em um bloco novo.
+ * @return A parte criada.
+ */
+static std::shared_ptr<LinkedList<Song>> makeSegment(std::vector<const Song*> &pending, bool contiguous){
+    if(contiguous){
+        Node<Song>::reserveContiguous(pending.size());
+    }
+    std::shared_ptr<LinkedList<Song>> segment = std::make_shared<LinkedList<Song>>();
+    segment->addAll(pending.begin(), pending.end());
+    pending.clear();
+    return segment;
+}
+
+/**
+ * @brief Verifica se uma parte publicada contém cópias das músicas do
+ * catálogo a partir de um nó, na mesma ordem.
+ *
+ * @param segment Parte publicada.
+ * @param curr Nó do catálogo correspondente à primeira música da parte.
+ * @return true se cada música da parte é cópia da música correspondente.
+ */
+static bool sameSongs(const LinkedList<Song> &segment, const Node<Song> *curr){
+    for(const Node<Song> *copy = segment.getHead(); copy != nullptr; copy = copy->getNext()){
+        if(curr == nullptr || !copy->getValue().isCopyOf(curr->getValue())){
+            return false;
+        }
+        curr = curr->getNext();
+    }
+    return true;
+}
+
+/**
+ * @brief Construtor da biblioteca vazia, que publica a versão inicial.
+ */
+Library::Library() : smart(songs), history(songs, playlists, index){
+    publishedSongs = 0;
+    publishedTail = nullptr;
+    publishedPlaylists = 0;
+    namesVersion = 0;
+    namesRenamed = false;
+    publications = 0;
+    compactCopies = false;
+    std::shared_ptr<Snapshot> initial = std::make_shared<Snapshot>();
+    initial->version = 0;
+    current = initial;
+}
+
+/**
+ * @brief Destrutor da biblioteca, que remove todas as músicas e playlists.
+ */
+Library::~Library(){
+    history.clear();
+    index.clear();
+    playlists.clear();
+    songs.clear();
+}
+
+/**
+ * @brief Retorna a versão publicada mais recente. A chamada nunca espera por editores.
+ *
+ * @return Ponteiro compartilhado para a versão, que continua válida enquanto for usada.
+ */
+std::shared_ptr<const Library::Snapshot> Library::snapshot() const{
+    return std::atomic_load(&current);
+}
+
+/**
+ * @brief Busca músicas no índice e copia as da página pedida.
+ *
+ * O índice aponta para o catálogo alterado pelos editores, então a busca
+ * espera que nenhum editor esteja ativo, mas, ao contrário de um Editor, não
+ * publica uma nova versão ao terminar. As cópias compartilham os textos das
+ * músicas do catálogo e continuam válidas depois que a trava é liberada.
+ *
+ * @param query Texto procurado.
+ * @param field Campo comparado.
+ * @param mode Modo de comparação.
+ * @param offset Posição da primeira música da página.
+ * @param limit Número máximo de músicas da página.
+ * @param found Recebe as músicas da página.
+ * @return Número total de músicas encontradas.
+ */
+size_t Library::search(const std::string &query, SearchIndex::Field field, SearchIndex::Mode mode,
+                       size_t offset, size_t limit, std::vector<Song> &found){
+    std::lock_guard<std::mutex> lock(writeMutex);
+    SearchPage page = index.search(query, field, mode, offset, limit);
+    found.clear();
+    found.reserve(page.songs.size());
+    for(size_t i = 0; i < page.songs.size(); i++){
+        found.push_back(*page.songs[i]);
+    }
+    return page.total;
+}
+
+/**
+ * @brief Publica uma nova versão com as alterações feitas pelos editores.
+ *
+ * Primeiro, as playlists inteligentes são atualizadas, sem que as
+ * alterações delas entrem no histórico, pois são consequência das outras.
+ * Depois, só as partes alteradas do catálogo (publishSongs) e as playlists
+ * alteradas (publishPlaylists) são copiadas; o resto é compartilhado com a
+ * versão anterior. Se nada mudou, a versão atual é mantida e a publicação
+ * não percorre nem o catálogo nem as playlists. Durante compact, também são
+ * copiadas as listas publicadas cujos nós não estão lado a lado, cada uma
+ * para um bloco novo de nós.
+ * @note Deve ser chamada com a trava de escrita obtida.
+ */
+void Library::publish(){
+    // Playlists que entraram, saíram ou mudaram de nome mudam os nomes que as regras usam
+    bool renamed = false;
+    for(size_t i = 0; i < changed.size() && !renamed; i++){
+        std::unordered_map<const Playlist*, Published>::const_iterator found = published.find(changed[i]);
+        renamed = found != published.end() && found->second.name != changed[i]->getName();
+    }
+    if(renamed){
+        namesRenamed = true;
+    }
+    bool reshaped = renamed || playlists.getVersion() != publishedPlaylists;
+    {
+        EditHistory::Pause pause(&history);
+        smart.sync(playlists, reshaped);
+    }
+    if(songs.getVersion() == publishedSongs && playlists.getVersion() == publishedPlaylists &&
+       changed.empty() && !compactCopies){
+        return;
+    }
+
+    std::shared_ptr<const Snapshot> previous = snapshot();
+    std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>();
+    bool songsChanged = publishSongs(*previous, *next);
+    bool playlistsChanged = publishPlaylists(*previous, *next);
+
+    if(songsChanged || playlistsChanged){
+        next->version = previous->version + 1;
+        std::atomic_store(&current, std::shared_ptr<const Snapshot>(next));
+    }
+}
+
+/**
+ * @brief Monta as partes do catálogo da nova versão.
+ *
+ * Se o catálogo só recebeu músicas no final desde a última publicação, as
+ * partes anteriores são compartilhadas, a última é completada (uma cópia de
+ * no máximo segmentSize músicas) e as músicas restantes formam partes novas.
+ * Caso contrário, o catálogo é percorrido, e cada parte publicada cujas
+ * músicas continuam em sequência no catálogo é compartilhada; só as músicas
+ * entre elas são copiadas, para partes novas. Partes pequenas são copiadas
+ * junto com as vizinhas, para que remoções repetidas não deixem o catálogo
+ * publicado em pedaços. Esse caminho compara ponteiros ao longo de todo o
+ * catálogo, mas só copia as partes alteradas.
+ *
+ * @param previous Versão publicada anterior.
+ * @param next Nova versão, que recebe as partes.
+ * @return true se alguma parte mudou.
+ */
+bool Library::publishSongs(const Snapshot &previous, Snapshot &next){
+    bool scattered = false;
+    for(size_t i = 0; i < previous.songs.size() && compactCopies && !scattered; i++){
+        scattered = !previous.songs[i]->isContiguous();
+    }
+    if(songs.getVersion() == publishedSongs && !scattered){
+        next.songs = previous.songs;
+        return false;
+    }
+
+    std::vector<const Song*> pending;
+    if(songs.getRewriteVersion() <= publishedSongs && !compactCopies){
+        next.songs = previous.songs;
+        if(!next.songs.empty() && next.songs.back()->getSize() < segmentSize){
+            for(const Node<Song> *kept = next.songs.back()->getHead(); kept != nullptr; kept = kept->getNext()){
+                pending.push_back(&kept->getValue());
+            }
+            next.songs.pop_back();
+        }
+        Node<Song> *curr = (publishedTail != nullptr) ? publishedTail->getNext() : songs.getHead();
+        for(; curr != nullptr; curr = curr->getNext()){
+            pending.push_back(&curr->getValue());
+            if(pending.size() == segmentSize){
+                next.songs.push_back(makeSegment(pending, false));
+            }
+        }
+    }
+    else{
+        // Partes publicadas pela primeira música, para reencontrá-las no catálogo
+        std::unordered_map<uint64_t, size_t> starts;
+        for(size_t i = 0; i < previous.songs.size(); i++){
+            starts[previous.songs[i]->getHead()->getValue().getFingerprint()] = i;
+        }
+        next.songs.reserve(previous.songs.size() + 1);
+        Node<Song> *curr = songs.getHead();
+        while(curr != nullptr){
+            std::unordered_map<uint64_t, size_t>::const_iterator found = starts.find(curr->getValue().getFingerprint());
+            if(found != starts.end() && sameSongs(*previous.songs[found->second], curr)){
+                const std::shared_ptr<LinkedList<Song>> &segment = previous.songs[found->second];
+                size_t size = segment->getSize();
+                bool merge = (!pending.empty() && pending.size() + size <= segmentSize) || size < segmentSize / 2 ||
+                             (compactCopies && !segment->isContiguous());
+                if(!merge){
+                    if(!pending.empty()){
+                        next.songs.push_back(makeSegment(pending, compactCopies));
+                    }
+                    next.songs.push_back(segment);
+                    for(size_t i = 0; i < size; i++){
+                        curr = curr->getNext();
+                    }
+                    continue;
+                }
+            }
+            pending.push_back(&curr->getValue());
+            if(pending.size() == segmentSize){
+                next.songs.push_back(makeSegment(pending, compactCopies));
+            }
+            curr = curr->getNext();
+        }
+    }
+    if(!pending.empty()){
+        next.songs.push_back(makeSegment(pending, compactCopies));
+    }
+    publishedSongs = songs.getVersion();
+    publishedTail = songs.getTail();
+    return true;
+}
+
+/**
+ * @brief Copia uma playlist para publicação. Os totais vêm atualizados do
+ * construtor cópia, e a assinatura é recalculada aqui se estiver
+ * desatualizada, pois as leituras da cópia publicada não a atualizam.
+ *
+ * @param playlist Playlist copiada.
+ * @return Cópia pronta para ser publicada.
+ */
+static std::shared_ptr<Playlist> publishedCopy(const Playlist &playlist){
+    std::shared_ptr<Playlist> copy = std::make_shared<Playlist>(playlist);
+    copy->getSignature();
+    return copy;
+}
+
+/**
+ * @brief Monta a lista de playlists da nova versão.
+ *
+ * Se nenhuma playlist entrou ou saiu da lista desde a última publicação,
+ * só as playlists que se colocaram na lista de alteradas são conferidas, e
+ * cada uma só é copiada se sua lista de músicas ou seu nome mudou; a cópia
+ * substitui a anterior na mesma posição. Caso contrário, a lista inteira é
+ * percorrida: as playlists novas são ligadas ao histórico e à lista de
+ * alteradas, e as cópias das playlists removidas são descartadas.
+ *
+ * @param previous Versão publicada anterior.
+ * @param next Nova versão, que recebe as playlists.
+ * @return true se alguma playlist mudou.
+ */
+bool Library::publishPlaylists(const Snapshot &previous, Snapshot &next){
+    bool copied = false;
+    if(playlists.getVersion() == publishedPlaylists && !compactCopies){
+        next.playlists = previous.playlists;
+        for(size_t i = 0; i < changed.size(); i++){
+            Playlist &playlist = *changed[i];
+            std::unordered_map<const Playlist*, Published>::iterator found = published.find(&playlist);
+            // Playlists fora da lista, guardadas pelo histórico, não são publicadas
+            if(found == published.end()){
+                continue;
+            }
+            Published &entry = found->second;
+            if(entry.version != playlist.readSongs().getVersion() || entry.name != playlist.getName()){
+                entry.version = playlist.readSongs().getVersion();
+                entry.name = playlist.getName();
+                entry.copy = publishedCopy(playlist);
+                next.playlists[entry.position] = entry.copy;
+                copied = true;
+            }
+        }
+        for(size_t i = 0; i < changed.size(); i++){
+            changed[i]->setChangeList(&changed);
+        }
+        changed.clear();
+        return copied;
+    }
+
+    changed.clear();
+    publications++;
+    next.playlists.reserve(previous.playlists.size());
+    Node<Playlist> *curr = playlists.getHead();
+    while(curr != nullptr){
+        Playlist &playlist = curr->getValue();
+        playlist.setEditHistory(&history);
+        Published &entry = published[&playlist];
+
+        if(entry.copy == nullptr || entry.version != playlist.readSongs().getVersion() ||
+           entry.name != playlist.getName() || (compactCopies && !entry.copy->readSongs().isContiguous())){
+            entry.version = playlist.readSongs().getVersion();
+            entry.name = playlist.getName();
+            if(compactCopies){
+                Node<Song>::reserveContiguous(playlist.getSize());
+            }
+            entry.copy = publishedCopy(playlist);
+            copied = true;
+        }
+        entry.seen = publications;
+        entry.position = next.playlists.size();
+
+        next.playlists.push_back(entry.copy);
+        // Volta a avisar a próxima alteração, pois a lista de alteradas foi esvaziada
+        playlist.setChangeList(&changed);
+        curr = curr->getNext();
+    }
+
+    // Playlists removidas
+    if(next.playlists.size() != published.size()){
+        for(auto it = published.begin(); it != published.end();){
+            if(it->second.seen != publications){
+                it = published.erase(it);
+            }
+            else{
+                ++it;
+            }
+        }
+    }
+    // Playlists que entraram, saíram ou mudaram de posição também geram uma nova versão
+    bool reshaped = playlists.getVersion() != publishedPlaylists;
+    publishedPlaylists = playlists.getVersion();
+    return copied || reshaped;
+}
+
+/**
+ * @brief Procura uma playlist da lista alterada pelos editores pelo nome.
+ *
+ * Enquanto a lista de playlists é a publicada, a busca usa names, montado
+ * uma vez a cada mudança na lista ou nome de playlist publicado, e as
+ * playlists renomeadas desde a publicação, que estão entre as alteradas. Se
+ * playlists entraram ou saíram desde a publicação, as novas ainda não avisam
+ * quando mudam de nome (setChangeList), então a lista é percorrida.
+ * @note Deve ser chamada com a trava de escrita obtida.
+ *
+ * @param name Nome da playlist.
+ * @return Ponteiro para a primeira playlist com o nome, ou nullptr se nenhuma tem esse nome.
+ */
+Playlist *Library::findPlaylist(const std::string &name){
+    if(playlists.getVersion() != publishedPlaylists){
+        for(Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+            if(curr->getValue().getName() == name){
+                return &curr->getValue();
+            }
+        }
+        return nullptr;
+    }
+
+    if(namesVersion != publishedPlaylists || namesRenamed){
+        names.clear();
+        for(Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+            names.insert(std::make_pair(curr->getValue().getName(), &curr->getValue()));
+        }
+        namesVersion = publishedPlaylists;
+        namesRenamed = false;
+    }
+    std::unordered_map<std::string, Playlist*>::const_iterator found = names.find(name);
+    if(found != names.end() && found->second->getName() == name){
+        return found->second;
+    }
+    for(size_t i = 0; i < changed.size(); i++){
+        if(changed[i]->getName() == name){
+            return changed[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Copia as músicas de cada playlist para nós novos, lado a lado na
+ * memória e na ordem da playlist (Playlist::compact), e publica uma versão
+ * em que as cópias das playlists e do catálogo também são feitas assim.
+ * Listas cujos nós já estão lado a lado não são copiadas.
+ * Depois, os blocos de nós que ficaram inteiramente livres são devolvidos ao
+ * sistema (NodePool::trim). Com a glibc, malloc_trim também devolve as
+ * páginas livres do heap, pois blocos pequenos liberados não voltam ao sistema
+ * sozinhos.
+ *
+ * O catálogo usado pelos editores não é copiado, pois o índice de busca e o
+ * histórico guardam ponteiros para suas músicas. Os textos das músicas
+ * (Song::Text) também não são movidos: cada um é compartilhado pelo
+ * catálogo, pelas playlists e pelas versões publicadas, inclusive as que
+ * leitores ainda percorrem sem trava, então movê-lo exigiria trocar todas as
+ * cópias ou dar a cada playlist textos próprios, multiplicando a memória
+ * deles. Passagens que só leem os campos guardados na música (duração,
+ * hashes) ficam com os acessos em sequência; as que leem títulos ou autores
+ * ainda visitam os textos onde foram alocados. Versões antigas ainda
+ * usadas por leitores só liberam seus nós quando deixam de ser usadas, e os
+ * blocos que os contêm continuam reservados até a próxima compactação.
+ *
+ * @return Bytes de nós devolvidos ao sistema.
+ */
+size_t Library::compact(){
+    Editor editor(*this);
+    for(Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+        curr->getValue().compact();
+    }
+    compactCopies = true;
+    publish();
+    compactCopies = false;
+    editor.deferPublish();
+    size_t released = NodePool<sizeof(Node<Song>)>::trim() + NodePool<sizeof(Node<Playlist>)>::trim();
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    return released;
+}
+
+/**
+ * @brief Construtor do editor, que espera até que nenhum outro editor esteja
+ * alterando a biblioteca.
+ *
+ * @param library Biblioteca a ser alterada.
+ */
+Library::Editor::Editor(Library &library) : library(library), lock(library.writeMutex){
+    publishOnRelease = true;
+}
+
+/**
+ * @brief Destrutor do editor, que publica as alterações, exceto se deferPublish
+ * foi chamado, e libera a biblioteca.
+ */
+Library::Editor::~Editor(){
+    if(publishOnRelease){
+        library.publish();
+    }
+}
+
+/**
+ * @brief Retorna a lista de músicas do sistema, que pode ser alterada enquanto
+ * o editor existir.
+ *
+ * @return Referência para a lista de músicas.
+ */
+LinkedList<Song> &Library::Editor::songs(){
+    return library.songs;
+}
+
+/**
+ * @brief Retorna a lista de playlists do sistema, que pode ser alterada enquanto
+ * o editor existir.
+ *
+ * @return Referência para a lista de playlists.
+ */
+LinkedList<Playlist> &Library::Editor::playlists(){
+    return library.playlists;
+}
+
+/**
+ * @brief Procura uma playlist da lista de playlists pelo nome. Sem mudanças
+ * na lista desde a última publicação, a busca não percorre as playlists.
+ *
+ * @param name Nome da playlist.
+ * @return Ponteiro para a primeira playlist com o nome, ou nullptr se nenhuma tem esse nome.
+ */
+Playlist *Library::Editor::findPlaylist(const std::string &name){
+    return library.findPlaylist(name);
+}
+
+/**
+ * @brief Retorna o índice de busca das músicas.
+ *
+ * @return Referência para o índice.
+ */
+SearchIndex &Library::Editor::index(){
+    return library.index;
+}
+
+/**
+ * @brief Retorna as playlists inteligentes. Quem adiciona ou remove músicas
+ * do catálogo deve avisá-las (added, removed), como faz com o índice de
+ * busca; as playlists da biblioteca avisam suas próprias alterações.
+ *
+ * @return Referência para as playlists inteligentes.
+ */
+SmartPlaylists &Library::Editor::smartPlaylists(){
+    return library.smart;
+}
+
+/**
+ * @brief Retorna o histórico das alterações. As playlists da biblioteca
+ * registram suas próprias alterações; quem altera o catálogo ou a lista de
+ * playlists deve registrá-las, ou usar os métodos do histórico que removem
+ * guardando os nós (removeFromCatalog, removePlaylist).
+ *
+ * @return Referência para o histórico.
+ */
+EditHistory &Library::Editor::history(){
+    return library.history;
+}
+
+/**
+ * @brief Publica as alterações feitas até agora, sem liberar a biblioteca.
+ * Permite que leitores vejam partes de uma alteração longa.
+ */
+void Library::Editor::publish(){
+    library.publish();
+}
+
+/**
+ * @brief Faz com que as alterações não sejam publicadas quando o editor for
+ * destruído. Elas ficam visíveis aos leitores quando o próximo editor publicar.
+ * Permite agrupar muitas alterações pequenas em uma única publicação.
+ */
+void Library::Editor::deferPublish(){
+    publishOnRelease = false;
+}
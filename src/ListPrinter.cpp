@@ -0,0 +1,36 @@
+/**
+ * @file ListPrinter.cpp
+ * @brief Arquivo que implementa os métodos da classe ListPrinter.
+ */
+
+#include <string>
+#include "ListPrinter.hpp"
+
+const std::streamoff ListPrinter::bufferSize;
+
+/**
+ * @brief Construtor.
+ *
+ * @param os Fluxo que recebe as linhas.
+ */
+ListPrinter::ListPrinter(std::ostream &os) : os(os) {}
+
+/**
+ * @brief Destrutor, que escreve no fluxo as linhas restantes.
+ */
+ListPrinter::~ListPrinter(){
+    write();
+}
+
+/**
+ * @brief Escreve no fluxo, de uma só vez, as linhas acumuladas e esvazia o
+ * buffer. O fluxo em si não é esvaziado.
+ */
+void ListPrinter::write(){
+    if(static_cast<std::streamoff>(buffer.tellp()) <= 0){
+        return;
+    }
+    std::string lines = buffer.str();
+    os.write(lines.data(), lines.size());
+    buffer.str(std::string());
+}
@@ -0,0 +1,308 @@
+/**
+ * @file LoadGenerator.cpp
+ * @brief Arquivo que implementa os métodos da classe LoadGenerator.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include "LoadGenerator.hpp"
+
+/**
+ * @brief Aumenta o limite de descritores abertos até o máximo permitido, para
+ * que o cliente abra milhares de conexões.
+ */
+static void raiseFileLimit(){
+    struct rlimit limit;
+    if(getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max){
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+/**
+ * @brief Construtor do cliente de carga.
+ *
+ * @param path Caminho do socket do servidor.
+ * @param connections Número de conexões abertas ao mesmo tempo.
+ * @param requests Número total de requisições, divididas entre as conexões.
+ * @param depth Número máximo de requisições sem resposta em cada conexão.
+ */
+LoadGenerator::LoadGenerator(const std::string &path, size_t connections, size_t requests, size_t depth)
+    : path(path), connectionCount(connections), requestCount(requests), depth(depth){
+    errors = 0;
+    if(connectionCount == 0) connectionCount = 1;
+    if(this->depth == 0) this->depth = 1;
+}
+
+/**
+ * @brief Monta uma requisição. As requisições seguem um ciclo de dez: cinco
+ * buscas, duas listagens de playlists, um PING, a criação de uma playlist e a
+ * remoção da playlist criada.
+ *
+ * @param connection Conexão que envia a requisição.
+ * @param n Número da requisição na conexão.
+ * @return Requisição, sem o '\n' final.
+ */
+std::string LoadGenerator::makeRequest(const Connection &connection, size_t n) const{
+    static const char *words[] = {"a", "love", "ra", "the", "son"};
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    switch(n % 10){
+        case 5: case 6:
+            return "LIST_PLAYLISTS";
+        case 7:
+            return "PING";
+        case 8:
+            return "ADD_PLAYLIST\tloadgen-" + std::to_string(connection.id) + "-" + std::to_string(n);
+        case 9:
+            return "REMOVE_PLAYLIST\tloadgen-" + std::to_string(connection.id) + "-" + std::to_string(n - 1);
+        default:
+            return std::string("SEARCH\tANY\tSUBSTRING\t0\t10\t") + words[(n / 10 + connection.id) % wordCount];
+    }
+}
+
+/**
+ * @brief Acrescenta requisições até o limite de requisições sem resposta e
+ * envia o máximo possível.
+ *
+ * @param connection Estado da conexão.
+ * @return Retorna false se a conexão foi perdida.
+ */
+bool LoadGenerator::fill(Connection &connection){
+    while(connection.sent < connection.total && connection.inFlight.size() < depth){
+        connection.output += makeRequest(connection, connection.sent);
+        connection.output += '\n';
+        connection.inFlight.push_back(Clock::now());
+        connection.sent++;
+    }
+
+    while(connection.written < connection.output.size()){
+        ssize_t count = send(connection.fd, connection.output.data() + connection.written,
+                             connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if(count > 0){
+            connection.written += count;
+        }
+        else if(count == -1 && errno == EINTR){
+            continue;
+        }
+        else if(count == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            return true;
+        }
+        else{
+            return false;
+        }
+    }
+    connection.output.clear();
+    connection.written = 0;
+    return true;
+}
+
+/**
+ * @brief Analisa as linhas completas recebidas e registra o tempo de resposta
+ * de cada resposta completa.
+ *
+ * @param connection Estado da conexão.
+ */
+void LoadGenerator::parse(Connection &connection){
+    size_t start = 0;
+    while(true){
+        size_t end = connection.input.find('\n', start);
+        if(end == std::string::npos){
+            break;
+        }
+
+        bool complete = false;
+        if(connection.pendingLines < 0){
+            if(connection.input.compare(start, 3, "OK ") == 0){
+                connection.pendingLines = std::strtol(connection.input.c_str() + start + 3, nullptr, 10);
+                complete = (connection.pendingLines == 0);
+            }
+            else{
+                errors++;
+                complete = true;
+            }
+        }
+        else{
+            connection.pendingLines--;
+            complete = (connection.pendingLines == 0);
+        }
+
+        if(complete && !connection.inFlight.empty()){
+            std::chrono::duration<double, std::micro> elapsed = Clock::now() - connection.inFlight.front();
+            latencies.push_back(elapsed.count());
+            connection.inFlight.pop_front();
+            connection.received++;
+            connection.pendingLines = -1;
+        }
+        start = end + 1;
+    }
+    connection.input.erase(0, start);
+}
+
+/**
+ * @brief Exibe o número de requisições, a vazão e os percentis do tempo de resposta.
+ *
+ * @param seconds Duração da carga, em segundos.
+ */
+void LoadGenerator::report(double seconds){
+    std::sort(latencies.begin(), latencies.end());
+    const double percentiles[] = {50, 90, 99, 99.9};
+    const char *labels[] = {"p50", "p90", "p99", "p99.9"};
+
+    std::cout << "Conexões: " << connectionCount << ", requisições por conexão em paralelo: " << depth << "\n";
+    std::cout << "Respostas: " << latencies.size() << " (" << errors << " erros) em "
+              << std::fixed << std::setprecision(3) << seconds << " s\n";
+    if(latencies.empty()){
+        return;
+    }
+    std::cout << "Vazão: " << std::setprecision(0) << latencies.size() / seconds << " requisições/s\n";
+    std::cout << "Tempo de resposta (us):";
+    std::cout << std::setprecision(1);
+    for(size_t i = 0; i < 4; i++){
+        size_t rank = (size_t)std::ceil(percentiles[i] / 100 * latencies.size());
+        std::cout << " " << labels[i] << "=" << latencies[rank == 0 ? 0 : rank - 1];
+    }
+    std::cout << " max=" << latencies.back() << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+/**
+ * @brief Abre as conexões, envia todas as requisições e exibe o resultado.
+ *
+ * @return Retorna false se não foi possível conectar ou se uma conexão foi perdida.
+ */
+bool LoadGenerator::run(){
+    struct sockaddr_un address;
+    if(path.size() >= sizeof(address.sun_path)){
+        std::cerr << "Erro: Caminho do socket muito longo.\n";
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    raiseFileLimit();
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(epollFd == -1){
+        std::cerr << "Erro: Não foi possível criar o laço de eventos: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    std::vector<Connection> connections(connectionCount);
+    latencies.reserve(requestCount);
+    bool ok = true;
+
+    for(size_t i = 0; i < connectionCount; i++){
+        connections[i].fd = -1;
+    }
+    for(size_t i = 0; i < connectionCount && ok; i++){
+        Connection &connection = connections[i];
+        connection.id = i;
+        connection.sent = 0;
+        connection.received = 0;
+        connection.total = requestCount / connectionCount + (i < requestCount % connectionCount ? 1 : 0);
+        connection.pendingLines = -1;
+        connection.written = 0;
+
+        connection.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(connection.fd == -1 || connect(connection.fd, (struct sockaddr*)&address, sizeof(address)) == -1){
+            std::cerr << "Erro: Não foi possível conectar a \"" << path << "\": " << std::strerror(errno) << "\n";
+            ok = false;
+            break;
+        }
+        fcntl(connection.fd, F_SETFL, fcntl(connection.fd, F_GETFL) | O_NONBLOCK);
+
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        event.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, connection.fd, &event);
+    }
+
+    Clock::time_point begin = Clock::now();
+    size_t finished = 0;
+    for(size_t i = 0; i < connectionCount && ok; i++){
+        if(connections[i].total == 0){
+            finished++;
+        }
+        else if(!fill(connections[i])){
+            ok = false;
+        }
+    }
+
+    const int maxEvents = 256;
+    struct epoll_event events[maxEvents];
+    char buffer[16 * 1024];
+
+    while(ok && finished < connectionCount){
+        int count = epoll_wait(epollFd, events, maxEvents, -1);
+        if(count == -1){
+            if(errno == EINTR){
+                continue;
+            }
+            ok = false;
+            break;
+        }
+
+        for(int i = 0; i < count && ok; i++){
+            Connection &connection = connections[events[i].data.u64];
+            if(connection.received == connection.total){
+                continue;
+            }
+
+            while(true){
+                ssize_t n = read(connection.fd, buffer, sizeof(buffer));
+                if(n > 0){
+                    connection.input.append(buffer, n);
+                }
+                else if(n == -1 && errno == EINTR){
+                    continue;
+                }
+                else if(n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+                    break;
+                }
+                else{
+                    std::cerr << "Erro: O servidor encerrou a conexão " << connection.id << ".\n";
+                    ok = false;
+                    break;
+                }
+            }
+            if(!ok){
+                break;
+            }
+
+            parse(connection);
+            if(connection.received == connection.total){
+                finished++;
+            }
+            else if(!fill(connection)){
+                ok = false;
+            }
+        }
+    }
+
+    std::chrono::duration<double> elapsed = Clock::now() - begin;
+    for(size_t i = 0; i < connections.size(); i++){
+        if(connections[i].fd != -1){
+            close(connections[i].fd);
+        }
+    }
+    close(epollFd);
+
+    report(elapsed.count());
+    return ok;
+}
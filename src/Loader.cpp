@@ -0,0 +1,630 @@
+/**
+ * @file Loader.cpp
+ * @brief Arquivo que implementa os métodos da classe Loader.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "SongSet.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+#include "Loader.hpp"
+
+//! Intervalo mínimo entre duas publicações.
+static const std::chrono::milliseconds minPublishInterval(100);
+//! Razão mínima entre o intervalo entre publicações e o tempo gasto para publicar.
+static const int publishIntervalFactor = 4;
+//! Número de playlists lidas enviadas de uma vez para a fila.
+static const size_t readBatchSize = 1024;
+//! Número máximo de lotes lidos esperando na fila.
+static const size_t maxQueuedBatches = 16;
+
+/**
+ * @brief Retorna a porcentagem dos arquivos já lida.
+ *
+ * @return Porcentagem entre 0 e 100.
+ */
+int Loader::Progress::getPercent() const{
+    if(totalBytes == 0){
+        return state == Loading ? 0 : 100;
+    }
+    return (int)(std::min(bytesRead, totalBytes) * 100 / totalBytes);
+}
+
+/**
+ * @brief Lê os atributos opcionais de uma música, escritos depois do autor
+ * como duração|ano|execuções. Campos vazios ou inválidos são ignorados, e os
+ * últimos campos podem ser omitidos.
+ *
+ * @param text Atributos, sem o '|' que os separa do autor.
+ * @param song Música que recebe os atributos.
+ */
+static void parseAttributes(const std::string &text, Song &song){
+    std::stringstream ss(text);
+    std::string field;
+    unsigned value;
+
+    if(std::getline(ss, field, '|') && Song::parseDuration(field, value)){
+        song.setDuration(value);
+    }
+    if(std::getline(ss, field, '|') && !field.empty() && field.size() <= 4 &&
+        field.find_first_not_of("0123456789") == std::string::npos){
+        song.setYear((unsigned)std::stoul(field));
+    }
+    if(std::getline(ss, field, '|') && !field.empty() && field.size() <= 9 &&
+        field.find_first_not_of("0123456789") == std::string::npos){
+        song.setPlays((unsigned)std::stoul(field));
+    }
+}
+
+/**
+ * @brief Analisa uma linha de um arquivo de texto e cria um objeto Playlist.
+ *
+ * Esta função recebe uma linha de um arquivo de texto que representa uma
+ * playlist com músicas e a analisa para criar um objeto Playlist. A linha
+ * deve ter o seguinte formato:
+ *    NomePlaylist;TituloMusica1:AutorMusica1,TituloMusica2:AutorMusica2,...
+ *
+ * Cada música pode ter, depois do autor, a duração, o ano e o número de
+ * execuções, separados por '|', como em Titulo:Autor|3:45|1999|120.
+ *
+ * @param line A linha do arquivo de texto que representa a playlist.
+ *
+ * @return O objeto Playlist analisado.
+ */
+Playlist Loader::parsePlaylist(const std::string& line) {
+    std::stringstream ss(line);
+    std::string playlistName;
+    std::getline(ss, playlistName, ';');
+
+    Playlist playlist(playlistName);
+    std::vector<Song> songs;
+
+    std::string songInfo;
+    while (std::getline(ss, songInfo, ',')) {
+        std::string attributes;
+        size_t bar = songInfo.find('|');
+        if (bar != std::string::npos) {
+            attributes = songInfo.substr(bar + 1);
+            songInfo.erase(bar);
+        }
+
+        std::stringstream songSS(songInfo);
+        std::string songTitle, songAuthor;
+        std::getline(songSS, songTitle, ':');
+        std::getline(songSS, songAuthor);
+
+        songs.push_back(Song(songTitle, songAuthor));
+        if (!attributes.empty()) {
+            parseAttributes(attributes, songs.back());
+        }
+    }
+
+    playlist.addSongs(songs.begin(), songs.end());
+    return playlist;
+}
+
+/**
+ * @brief Lista os arquivos de um caminho, sem entrar de novo em uma pasta já
+ * listada.
+ *
+ * @param path Caminho de um arquivo ou de uma pasta.
+ * @param files Vetor que recebe os caminhos dos arquivos.
+ * @param error Mensagem de erro, caso o caminho não possa ser lido.
+ * @param visited Pastas já listadas, identificadas pelo dispositivo e pelo inode.
+ * @return Retorna false caso o caminho não possa ser lido.
+ */
+static bool listFilesIn(const std::string &path, std::vector<std::string> &files, std::string &error,
+                        std::set<std::pair<dev_t, ino_t>> &visited){
+    struct stat info;
+    if(stat(path.c_str(), &info) == -1){
+        error = std::strerror(errno);
+        return false;
+    }
+    if(S_ISREG(info.st_mode)){
+        files.push_back(path);
+        return true;
+    }
+    if(!S_ISDIR(info.st_mode)){
+        error = "não é um arquivo nem uma pasta";
+        return false;
+    }
+    if(!visited.insert(std::make_pair(info.st_dev, info.st_ino)).second){
+        return true;
+    }
+
+    DIR *dir = opendir(path.c_str());
+    if(dir == nullptr){
+        error = std::strerror(errno);
+        return false;
+    }
+    std::vector<std::string> names;
+    while(struct dirent *entry = readdir(dir)){
+        if(entry->d_name[0] != '.'){
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    for(size_t i = 0; i < names.size(); i++){
+        std::string ignored;
+        listFilesIn(path + "/" + names[i], files, ignored, visited);
+    }
+    return true;
+}
+
+/**
+ * @brief Lista os arquivos de um caminho. Se o caminho é uma pasta, são
+ * listados os arquivos dela e de suas subpastas, em ordem alfabética,
+ * ignorando os nomes que começam com '.'.
+ *
+ * Links simbólicos para pastas são seguidos, mas cada pasta é listada uma
+ * única vez, então um link para uma pasta acima dela não cria um ciclo.
+ *
+ * @param path Caminho de um arquivo ou de uma pasta.
+ * @param files Vetor que recebe os caminhos dos arquivos.
+ * @param error Mensagem de erro, caso o caminho não possa ser lido.
+ * @return Retorna false caso o caminho não possa ser lido.
+ */
+bool Loader::listFiles(const std::string &path, std::vector<std::string> &files, std::string &error){
+    std::set<std::pair<dev_t, ino_t>> visited;
+    return listFilesIn(path, files, error, visited);
+}
+
+/**
+ * @brief Construtor do carregador, sem nenhum carregamento iniciado.
+ *
+ * @param library Biblioteca que recebe as playlists.
+ */
+Loader::Loader(Library &library) : library(library), verbose(false), state(Idle), cancelRequested(false),
+    bytesRead(0), totalBytes(0), playlists(0), duration(-1){
+    activeReaders = 0;
+    knownSongsVersion = 0;
+    knownPlaylistsVersion = 0;
+    newSongs = 0;
+    duplicateSongs = 0;
+    mergedPlaylists = 0;
+}
+
+/**
+ * @brief Destrutor do carregador, que interrompe o carregamento em andamento
+ * e espera a thread terminar.
+ */
+Loader::~Loader(){
+    cancel();
+    wait();
+}
+
+/**
+ * @brief Inicia, em uma thread separada, a importação de arquivos e pastas.
+ *
+ * @param paths Caminhos de arquivos ou pastas com playlists.
+ * @return Retorna false caso já exista um carregamento em andamento.
+ */
+bool Loader::start(const std::vector<std::string> &paths){
+    if(state == Loading){
+        return false;
+    }
+    wait();
+
+    this->paths = paths;
+    reports.clear();
+    queue.clear();
+    cancelRequested = false;
+    bytesRead = 0;
+    totalBytes = 0;
+    playlists = 0;
+    duration = -1;
+    newSongs = 0;
+    duplicateSongs = 0;
+    mergedPlaylists = 0;
+    startTime = Clock::now();
+    state = Loading;
+
+    worker = std::thread(&Loader::load, this);
+    return true;
+}
+
+/**
+ * @brief Define se o resultado de cada arquivo é exibido na saída padrão
+ * quando o carregamento termina.
+ *
+ * @param verbose Indica se o resultado deve ser exibido.
+ */
+void Loader::setVerbose(bool verbose){
+    this->verbose = verbose;
+}
+
+/**
+ * @brief Pede a interrupção do carregamento. As playlists já adicionadas
+ * permanecem na biblioteca.
+ */
+void Loader::cancel(){
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        cancelRequested = true;
+    }
+    queueChanged.notify_all();
+}
+
+/**
+ * @brief Espera o fim do carregamento em andamento, se houver.
+ */
+void Loader::wait(){
+    if(worker.joinable()){
+        worker.join();
+    }
+}
+
+/**
+ * @brief Retorna o andamento do carregamento. Pode ser chamado de qualquer thread.
+ *
+ * @return Andamento do carregamento.
+ */
+Loader::Progress Loader::getProgress() const{
+    Progress progress;
+    progress.state = (State)state.load();
+    progress.bytesRead = bytesRead;
+    progress.totalBytes = totalBytes;
+    progress.playlists = playlists;
+
+    long long micros = duration;
+    if(micros < 0){
+        std::chrono::duration<double> elapsed = Clock::now() - startTime;
+        progress.seconds = progress.state == Idle ? 0 : elapsed.count();
+    }
+    else{
+        progress.seconds = micros / 1e6;
+    }
+    return progress;
+}
+
+/**
+ * @brief Exibe o resultado de cada arquivo e o total de músicas e playlists
+ * importadas.
+ * @note Só deve ser chamado depois que o carregamento terminou.
+ *
+ * @param os Stream de saída.
+ */
+void Loader::printReport(std::ostream &os) const{
+    for(size_t i = 0; i < reports.size(); i++){
+        const FileReport &report = reports[i];
+        os << "  " << report.path << ": ";
+        if(!report.error.empty()){
+            os << "erro: " << report.error << "\n";
+        }
+        else{
+            os << report.playlists << " playlists, " << report.songs << " músicas em "
+               << (long long)(report.seconds * 1000) << " ms\n";
+        }
+    }
+    os << "  Total: " << playlists << " playlists novas, " << mergedPlaylists
+       << " unidas a playlists existentes, " << newSongs << " músicas novas, "
+       << duplicateSongs << " repetidas\n";
+}
+
+/**
+ * @brief Lê um arquivo e envia as playlists lidas para a fila em lotes.
+ *
+ * @param path Caminho do arquivo.
+ * @param report Resultado da leitura.
+ */
+void Loader::readFile(const std::string &path, FileReport &report){
+    Clock::time_point begin = Clock::now();
+    std::ifstream inputFile(path, std::ios::binary);
+    if(!inputFile.is_open()){
+        report.error = "não foi possível abrir o arquivo";
+        return;
+    }
+
+    std::unique_ptr<Batch> batch(new Batch);
+    size_t batchSize = 0;
+    size_t batchBytes = 0;
+
+    std::string line;
+    while(!cancelRequested && std::getline(inputFile, line)){
+        batchBytes += line.size() + 1;
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.erase(line.size() - 1);
+        }
+        if(line.empty()){
+            continue;
+        }
+
+        // Move as músicas lidas para o lote, sem copiá-las
+        Playlist playlist = parsePlaylist(line);
+        batch->playlists.add(Playlist(playlist.getName()));
+        batch->playlists.getTail()->getValue().moveSongs(playlist);
+        report.playlists++;
+        report.songs += batch->playlists.getTail()->getValue().getSize();
+
+        if(++batchSize == readBatchSize){
+            bytesRead += batchBytes;
+            push(std::move(batch));
+            batch.reset(new Batch);
+            batchSize = 0;
+            batchBytes = 0;
+        }
+    }
+
+    bytesRead += batchBytes;
+    if(batchSize > 0){
+        push(std::move(batch));
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - begin;
+    report.seconds = elapsed.count();
+}
+
+/**
+ * @brief Lê os arquivos ainda não lidos, um de cada vez. Executado por cada
+ * thread de leitura.
+ *
+ * @param files Arquivos a importar.
+ * @param next Índice do próximo arquivo a ser lido, compartilhado entre as threads.
+ */
+void Loader::read(const std::vector<std::string> *files, std::atomic<size_t> *next){
+    while(!cancelRequested){
+        size_t i = (*next)++;
+        if(i >= files->size()){
+            break;
+        }
+        readFile((*files)[i], reports[i]);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        activeReaders--;
+    }
+    queueChanged.notify_all();
+}
+
+/**
+ * @brief Envia um lote lido para a fila, esperando caso a fila esteja cheia.
+ * O lote é descartado se o carregamento for cancelado.
+ *
+ * @param batch Lote lido.
+ */
+void Loader::push(std::unique_ptr<Batch> batch){
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueChanged.wait(lock, [this]{ return queue.size() < maxQueuedBatches || cancelRequested; });
+        if(cancelRequested){
+            return;
+        }
+        queue.push_back(std::move(batch));
+    }
+    queueChanged.notify_all();
+}
+
+/**
+ * @brief Adiciona os lotes lidos à biblioteca e, se pedido, publica as alterações.
+ *
+ * Cada música entra no catálogo apenas se ainda não estiver nele, e cada
+ * playlist cujo nome já existe é unida à existente, recebendo apenas as
+ * músicas que ainda não tem. Os conjuntos usados para encontrar repetições
+ * só são refeitos se outra parte do programa alterou as listas. Para o
+ * histórico, toda a importação forma um único passo, desde que nada seja
+ * alterado entre uma chamada e outra.
+ *
+ * @param batches Lotes lidos, que são esvaziados.
+ * @param publish Indica se as alterações devem ser publicadas.
+ * @return Tempo gasto para publicar as alterações.
+ */
+Loader::Clock::duration Loader::apply(std::vector<std::unique_ptr<Batch>> &batches, bool publish){
+    size_t added = 0;
+    Clock::time_point published;
+    {
+        Library::Editor editor(library);
+        LinkedList<Song> &songs = editor.songs();
+        LinkedList<Playlist> &lists = editor.playlists();
+        EditHistory::Batch batch(&editor.history(), "Importar arquivos de playlists", true);
+        unsigned long long listsPrior = lists.getVersion();
+        Node<Playlist> *lastPlaylist = lists.getTail();
+
+        if(songs.getVersion() != knownSongsVersion){
+            knownSongs.clear();
+            for(Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+                knownSongs.insert(&curr->getValue());
+            }
+        }
+        if(lists.getVersion() != knownPlaylistsVersion){
+            knownPlaylists.clear();
+            for(Node<Playlist> *curr = lists.getHead(); curr != nullptr; curr = curr->getNext()){
+                knownPlaylists.insert(std::make_pair(curr->getValue().getName(), &curr->getValue()));
+            }
+        }
+
+        // Músicas novas, ainda nos lotes; entram no catálogo de uma vez no final
+        std::vector<const Song*> fresh;
+        for(size_t i = 0; i < batches.size(); i++){
+            LinkedList<Playlist> &batch = batches[i]->playlists;
+            Node<Playlist> *prev = nullptr;
+            Node<Playlist> *next = nullptr;
+            for(Node<Playlist> *pl = batch.getHead(); pl != nullptr; pl = next){
+                Playlist &playlist = pl->getValue();
+                next = pl->getNext();
+
+                for(const Node<Song> *curr = playlist.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    if(!knownSongs.insert(&curr->getValue()).second){
+                        duplicateSongs++;
+                        continue;
+                    }
+                    fresh.push_back(&curr->getValue());
+                }
+
+                auto existing = knownPlaylists.find(playlist.getName());
+                if(existing == knownPlaylists.end()){
+                    // Move o nó do lote para a biblioteca, sem copiar a playlist
+                    lists.spliceAfter(lists.getTail(), batch, prev, pl);
+                    knownPlaylists[playlist.getName()] = &playlist;
+                    added++;
+                    continue;
+                }
+
+                SongSet present;
+                Playlist *target = existing->second;
+                for(const Node<Song> *curr = target->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    present.insert(&curr->getValue());
+                }
+                // As músicas que faltam são acrescentadas de uma vez
+                std::vector<const Song*> missing;
+                for(const Node<Song> *curr = playlist.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    if(present.insert(&curr->getValue()).second){
+                        missing.push_back(&curr->getValue());
+                    }
+                }
+                if(!missing.empty()){
+                    target->addSongs(missing);
+                }
+                mergedPlaylists++;
+                prev = pl;
+            }
+        }
+
+        editor.history().playlistsAppended(listsPrior, lastPlaylist);
+
+        unsigned long long prior = songs.getVersion();
+        Node<Song> *lastKnown = songs.getTail();
+        songs.addAll(fresh.begin(), fresh.end());
+        editor.history().catalogAppended(prior, lastKnown);
+        for(Node<Song> *curr = (lastKnown != nullptr) ? lastKnown->getNext() : songs.getHead(); curr != nullptr; curr = curr->getNext()){
+            // Troca a música do lote pela cópia do catálogo
+            Song *song = &curr->getValue();
+            knownSongs.erase(song);
+            knownSongs.insert(song);
+            editor.index().add(song);
+            editor.smartPlaylists().added(songs, prior, *song);
+        }
+        newSongs += fresh.size();
+
+        knownSongsVersion = songs.getVersion();
+        knownPlaylistsVersion = lists.getVersion();
+        if(!publish){
+            editor.deferPublish();
+        }
+        published = Clock::now();
+    }
+    Clock::duration elapsed = Clock::now() - published;
+    playlists += added;
+    batches.clear();
+    return elapsed;
+}
+
+/**
+ * @brief Encerra o carregamento, registrando sua duração e, se pedido,
+ * exibindo o resultado.
+ *
+ * @param result Situação final.
+ */
+void Loader::finish(State result){
+    std::chrono::microseconds elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime);
+    duration = elapsed.count();
+    if(verbose){
+        std::cout << (result == Cancelled ? "Carregamento cancelado" : "Carregamento concluído")
+                  << " em " << elapsed.count() / 1000 << " ms:\n";
+        printReport(std::cout);
+    }
+    state = result;
+}
+
+/**
+ * @brief Lista os arquivos, inicia as threads de leitura e adiciona os lotes
+ * lidos à biblioteca. Executado na thread do carregamento.
+ */
+void Loader::load(){
+    std::vector<std::string> files;
+    std::vector<FileReport> failures;
+    for(size_t i = 0; i < paths.size(); i++){
+        FileReport failure = FileReport();
+        failure.path = paths[i];
+        if(!listFiles(paths[i], files, failure.error)){
+            failures.push_back(failure);
+        }
+    }
+
+    reports.assign(files.size(), FileReport());
+    size_t total = 0;
+    for(size_t i = 0; i < files.size(); i++){
+        struct stat info;
+        reports[i].path = files[i];
+        if(stat(files[i].c_str(), &info) == 0){
+            reports[i].bytes = info.st_size;
+            total += info.st_size;
+        }
+    }
+    totalBytes = total;
+
+    size_t readerCount = std::min<size_t>(files.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> readers;
+    activeReaders = readerCount;
+    for(size_t i = 0; i < readerCount; i++){
+        readers.push_back(std::thread(&Loader::read, this, &files, &next));
+    }
+
+    std::vector<std::unique_ptr<Batch>> pending;
+    Clock::time_point nextPublish = Clock::now() + minPublishInterval;
+    bool done = false;
+
+    while(!done){
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this]{ return !queue.empty() || activeReaders == 0 || cancelRequested; });
+            while(!queue.empty()){
+                pending.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            done = (activeReaders == 0) || cancelRequested;
+        }
+        queueChanged.notify_all();
+
+        if(cancelRequested){
+            break;
+        }
+
+        // Os lotes são adicionados logo, mas só publicados quando o prazo vence
+        bool publish = done || Clock::now() >= nextPublish;
+        Clock::duration elapsed = apply(pending, publish);
+        if(publish){
+            nextPublish = Clock::now() + std::max<Clock::duration>(minPublishInterval, elapsed * publishIntervalFactor);
+        }
+    }
+
+    for(size_t i = 0; i < readers.size(); i++){
+        readers[i].join();
+    }
+    reports.insert(reports.end(), failures.begin(), failures.end());
+
+    if(cancelRequested){
+        // Publica os lotes já adicionados
+        Library::Editor editor(library);
+        finish(Cancelled);
+        return;
+    }
+
+    bool anyRead = false;
+    for(size_t i = 0; i < reports.size(); i++){
+        if(reports[i].error.empty()){
+            anyRead = true;
+        }
+    }
+    finish(anyRead || reports.empty() ? Finished : Failed);
+}
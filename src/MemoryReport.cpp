@@ -0,0 +1,257 @@
+/**
+ * @file MemoryReport.cpp
+ * @brief Arquivo que implementa os métodos da classe MemoryReport.
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <unistd.h>
+#include "Node.hpp"
+#include "NodePool.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "TextKey.hpp"
+#include "SearchIndex.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+#include "MemoryReport.hpp"
+
+/**
+ * @brief Construtor do uso vazio.
+ *
+ * @param name Nome do contêiner ou da playlist.
+ * @param unit Nome dos elementos contados, no plural.
+ */
+MemoryReport::Usage::Usage(const std::string &name, const std::string &unit) : name(name), unit(unit){
+    elements = 0;
+    nodeBytes = 0;
+    stringBytes = 0;
+    otherBytes = 0;
+    links = 0;
+    adjacent = 0;
+}
+
+/**
+ * @brief Retorna a memória total do uso.
+ *
+ * @return Soma dos nós, dos textos e das demais estruturas, em bytes.
+ */
+size_t MemoryReport::Usage::getTotal() const{
+    return nodeBytes + stringBytes + otherBytes;
+}
+
+/**
+ * @brief Retorna a porcentagem de nós seguidos que estão lado a lado na
+ * memória. Uma lista recém-compactada tem 100%.
+ *
+ * @return Porcentagem, ou 100 se não há nós seguidos.
+ */
+double MemoryReport::Usage::getContiguity() const{
+    return (links == 0) ? 100.0 : 100.0 * adjacent / links;
+}
+
+/**
+ * @brief Construtor do relatório vazio.
+ */
+MemoryReport::MemoryReport(){
+    reserved = 0;
+    listed = 0;
+    resident = 0;
+}
+
+/**
+ * @brief Soma a um uso os nós e os textos das músicas de uma lista, e conta
+ * os nós seguidos que estão lado a lado.
+ *
+ * @param songs Lista de músicas.
+ * @param usage Uso que recebe a soma.
+ */
+void MemoryReport::addSongs(const LinkedList<Song> &songs, Usage &usage){
+    for(const Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+        usage.elements++;
+        usage.nodeBytes += sizeof(Node<Song>);
+        usage.stringBytes += curr->getValue().getHeapBytes();
+        if(curr->getNext() != nullptr){
+            usage.links++;
+            if(curr->getNext() == curr + 1){
+                usage.adjacent++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Mede a memória da biblioteca. As listas são percorridas com um
+ * editor, então outras alterações esperam a medição; leitores não esperam.
+ * Nenhuma versão nova é publicada.
+ *
+ * @param library Biblioteca medida.
+ */
+void MemoryReport::measure(Library &library){
+    containers.clear();
+    playlists.clear();
+
+    Library::Editor editor(library);
+    editor.deferPublish();
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+
+    Usage catalog("Catálogo");
+    addSongs(editor.songs(), catalog);
+
+    Usage live("Playlists");
+    for(Node<Playlist> *curr = editor.playlists().getHead(); curr != nullptr; curr = curr->getNext()){
+        Playlist &playlist = curr->getValue();
+        Usage usage(playlist.getName());
+        addSongs(playlist.readSongs(), usage);
+        usage.nodeBytes += sizeof(Node<Playlist>);
+        usage.stringBytes += heapBytes(playlist.getName());
+
+        live.elements += usage.elements;
+        live.nodeBytes += usage.nodeBytes;
+        live.stringBytes += usage.stringBytes;
+        live.links += usage.links;
+        live.adjacent += usage.adjacent;
+        playlists.push_back(usage);
+    }
+
+    Usage published("Versão publicada");
+    published.otherBytes += snapshot->songs.capacity() * sizeof(std::shared_ptr<LinkedList<Song>>);
+    for(size_t i = 0; i < snapshot->songs.size(); i++){
+        addSongs(*snapshot->songs[i], published);
+        published.otherBytes += sizeof(LinkedList<Song>);
+    }
+    published.otherBytes += snapshot->playlists.capacity() * sizeof(std::shared_ptr<const Playlist>);
+    for(size_t i = 0; i < snapshot->playlists.size(); i++){
+        addSongs(snapshot->playlists[i]->readSongs(), published);
+        published.otherBytes += sizeof(Playlist);
+        published.stringBytes += heapBytes(snapshot->playlists[i]->getName());
+    }
+
+    Usage index("Índice de busca");
+    index.elements = editor.index().getSize();
+    index.otherBytes = editor.index().getBytes();
+
+    Usage history("Histórico", "passos");
+    history.elements = editor.history().getUndoSteps() + editor.history().getRedoSteps();
+    history.otherBytes = editor.history().getBytes();
+
+    containers.push_back(catalog);
+    containers.push_back(live);
+    containers.push_back(published);
+    containers.push_back(index);
+    containers.push_back(history);
+
+    std::stable_sort(playlists.begin(), playlists.end(), [](const Usage &a, const Usage &b){
+        return a.getTotal() > b.getTotal();
+    });
+
+    listed = catalog.nodeBytes + live.nodeBytes + published.nodeBytes;
+    reserved = NodePool<sizeof(Node<Song>)>::getReservedBytes();
+    if(sizeof(Node<Playlist>) != sizeof(Node<Song>)){
+        reserved += NodePool<sizeof(Node<Playlist>)>::getReservedBytes();
+    }
+    resident = residentBytes();
+}
+
+/**
+ * @brief Retorna o uso de cada contêiner: catálogo, playlists, versão
+ * publicada, índice de busca e histórico, nessa ordem.
+ *
+ * @return Referência para os usos.
+ */
+const std::vector<MemoryReport::Usage> &MemoryReport::getContainers() const{
+    return containers;
+}
+
+/**
+ * @brief Retorna o uso de cada playlist, da que mais ocupa memória para a
+ * que menos ocupa.
+ *
+ * @return Referência para os usos.
+ */
+const std::vector<MemoryReport::Usage> &MemoryReport::getPlaylists() const{
+    return playlists;
+}
+
+/**
+ * @brief Retorna a memória dos blocos de nós obtidos do sistema na medição,
+ * usados ou livres.
+ *
+ * @return Número de bytes.
+ */
+size_t MemoryReport::getReservedBytes() const{
+    return reserved;
+}
+
+/**
+ * @brief Retorna a memória residente do processo na medição.
+ *
+ * @return Número de bytes, ou 0 se o sistema não informa.
+ */
+size_t MemoryReport::getResidentBytes() const{
+    return resident;
+}
+
+/**
+ * @brief Imprime a memória de cada contêiner, a reserva de nós, a memória
+ * residente e as playlists que mais ocupam memória.
+ *
+ * @param os Fluxo de saída.
+ * @param limit Número máximo de playlists exibidas.
+ */
+void MemoryReport::print(std::ostream &os, size_t limit) const{
+    const double megabyte = 1024.0 * 1024.0;
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(1);
+
+    os << "Memória da biblioteca:\n";
+    for(size_t i = 0; i < containers.size(); i++){
+        const Usage &usage = containers[i];
+        os << "  " << usage.name << ": " << usage.getTotal() / megabyte << " MB (nós " << usage.nodeBytes / megabyte
+           << " MB, textos " << usage.stringBytes / megabyte << " MB, outros " << usage.otherBytes / megabyte << " MB)";
+        os << ", " << usage.elements << " " << usage.unit;
+        if(usage.nodeBytes > 0){
+            os << ", " << usage.getContiguity() << "% dos nós contíguos";
+        }
+        os << "\n";
+    }
+
+    os << "  Reserva de nós: " << reserved / megabyte << " MB obtidos do sistema, "
+       << (reserved > listed ? reserved - listed : 0) / megabyte << " MB livres ou fora das listas medidas\n";
+    if(resident > 0){
+        os << "  Memória residente do processo: " << resident / megabyte << " MB\n";
+    }
+
+    if(!playlists.empty() && limit > 0){
+        os << "Playlists que mais ocupam memória:\n";
+        for(size_t i = 0; i < playlists.size() && i < limit; i++){
+            const Usage &usage = playlists[i];
+            os << std::setw(4) << i + 1 << ". \"" << usage.name << "\": " << usage.getTotal() / megabyte << " MB, "
+               << usage.elements << " músicas, " << usage.getContiguity() << "% dos nós contíguos\n";
+        }
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+/**
+ * @brief Lê a memória residente do processo em /proc/self/statm.
+ *
+ * @return Número de bytes, ou 0 se o sistema não informa.
+ */
+size_t MemoryReport::residentBytes(){
+    std::ifstream statm("/proc/self/statm");
+    size_t total = 0;
+    size_t pages = 0;
+    if(!(statm >> total >> pages)){
+        return 0;
+    }
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return (pageSize > 0) ? pages * (size_t)pageSize : 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file PlaybackScheduler.cpp
+ * @brief Arquivo que implementa os métodos da classe PlaybackScheduler.
+ */
+
+#include <memory>
+#include <atomic>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "Library.hpp"
+#include "TimerWheel.hpp"
+#include "UpNextQueue.hpp"
+#include "PlaybackScheduler.hpp"
+
+const size_t PlaybackScheduler::queueCapacity;
+
+/**
+ * @brief Construtor do agendador.
+ *
+ * @param snapshot Versão da biblioteca que contém as playlists tocadas.
+ * @param defaultDuration Duração, em segundos, usada para músicas sem duração.
+ */
+PlaybackScheduler::PlaybackScheduler(std::shared_ptr<const Library::Snapshot> snapshot, unsigned defaultDuration)
+    : snapshot(snapshot){
+    this->defaultDuration = defaultDuration > 0 ? defaultDuration : 1;
+    active = 0;
+}
+
+/**
+ * @brief Destrutor do agendador, que libera as filas criadas pelas sessões.
+ */
+PlaybackScheduler::~PlaybackScheduler(){
+    for(size_t i = 0; i < sessions.size(); i++){
+        delete sessions[i].queue.load(std::memory_order_acquire);
+    }
+}
+
+/**
+ * @brief Retorna a duração de uma música.
+ *
+ * @param song Música.
+ * @return Duração em ms, ou a duração padrão se a música não tem duração.
+ */
+unsigned long long PlaybackScheduler::durationOf(const Song &song) const{
+    unsigned seconds = song.getDuration() != 0 ? song.getDuration() : defaultDuration;
+    return seconds * 1000ULL;
+}
+
+/**
+ * @brief Passa a sessão de um temporizador vencido para a próxima música: a
+ * primeira da fila da sessão ou, com a fila vazia, a música da playlist
+ * seguinte à última tocada, voltando ao início depois da última. A troca seguinte é
+ * agendada a partir do horário previsto desta, e não do atual, para que os
+ * atrasos não se acumulem.
+ *
+ * @param timer Temporizador vencido.
+ * @return A troca de música feita.
+ */
+PlaybackScheduler::TrackChange PlaybackScheduler::next(TimerWheel::Timer &timer){
+    Session &session = sessions[timer.id];
+    UpNextQueue *queue = session.queue.load(std::memory_order_acquire);
+    const Song *queued = queue != nullptr ? queue->take() : nullptr;
+
+    if(queued != nullptr){
+        session.current = queued;
+    }
+    else{
+        session.track = session.track->getNext();
+        session.position++;
+        if(session.track == nullptr){
+            session.track = session.playlist->readSongs().getHead();
+            session.position = 0;
+        }
+        session.current = &session.track->getValue();
+    }
+
+    TrackChange change;
+    change.session = timer.id;
+    change.song = session.current;
+    change.position = session.position;
+    change.queued = queued != nullptr;
+    change.due = timer.expires;
+    change.late = 0;
+
+    wheel.schedule(timer, timer.expires + durationOf(*session.current));
+    return change;
+}
+
+/**
+ * @brief Começa uma sessão que toca uma playlist em sequência. A playlist
+ * deve ser da versão da biblioteca passada ao construtor.
+ *
+ * @param playlist Playlist tocada.
+ * @param position Posição da primeira música, começando em 0.
+ * @param elapsed Tempo, em ms, que a primeira música já tocou, tomado
+ * módulo a duração dela.
+ * @return Identificador da sessão. Uma playlist vazia gera uma sessão parada.
+ */
+size_t PlaybackScheduler::addSession(const Playlist *playlist, size_t position, unsigned long long elapsed){
+    sessions.emplace_back();
+    Session &session = sessions.back();
+    session.timer.id = sessions.size() - 1;
+    session.playlist = playlist;
+    session.track = playlist->readSongs().getHead();
+    session.position = 0;
+
+    if(session.track == nullptr){
+        return session.timer.id;
+    }
+    for(size_t i = 0; i < position; i++){
+        session.track = session.track->getNext();
+        session.position++;
+        if(session.track == nullptr){
+            session.track = playlist->readSongs().getHead();
+            session.position = 0;
+        }
+    }
+    session.current = &session.track->getValue();
+
+    unsigned long long duration = durationOf(session.track->getValue());
+    unsigned long long remaining = duration - elapsed % duration;
+    wheel.schedule(session.timer, wheel.getTime() + remaining);
+    active++;
+    return session.timer.id;
+}
+
+/**
+ * @brief Interrompe uma sessão, cancelando a próxima troca de música.
+ *
+ * @param id Identificador da sessão.
+ */
+void PlaybackScheduler::stopSession(size_t id){
+    Session &session = sessions[id];
+    if(session.timer.isScheduled()){
+        wheel.cancel(session.timer);
+        active--;
+    }
+}
+
+/**
+ * @brief Retorna a música atual de uma sessão.
+ *
+ * @param id Identificador da sessão.
+ * @return Ponteiro para a música, ou nullptr se a playlist da sessão está vazia.
+ */
+const Song *PlaybackScheduler::getTrack(size_t id) const{
+    return sessions[id].current;
+}
+
+/**
+ * @brief Retorna a fila de músicas a tocar em seguida de uma sessão,
+ * criando-a se necessário. Se duas threads criam a fila ao mesmo tempo, só
+ * uma delas é guardada, com compare-and-swap; a outra é descartada. As
+ * músicas adicionadas à fila devem ser da versão da biblioteca passada ao
+ * construtor, que o agendador mantém.
+ *
+ * @param id Identificador da sessão.
+ * @return Fila da sessão.
+ */
+UpNextQueue &PlaybackScheduler::getQueue(size_t id){
+    Session &session = sessions[id];
+    UpNextQueue *queue = session.queue.load(std::memory_order_acquire);
+    if(queue == nullptr){
+        UpNextQueue *created = new UpNextQueue(queueCapacity);
+        if(session.queue.compare_exchange_strong(queue, created, std::memory_order_acq_rel)){
+            queue = created;
+        }
+        else{
+            delete created;
+        }
+    }
+    return *queue;
+}
+
+/**
+ * @brief Retorna o tempo atual do agendador.
+ *
+ * @return Tempo em ms desde a criação do agendador.
+ */
+unsigned long long PlaybackScheduler::getTime() const{
+    return wheel.getTime();
+}
+
+/**
+ * @brief Retorna o número de sessões tocando.
+ *
+ * @return Sessões com uma troca de música agendada.
+ */
+size_t PlaybackScheduler::getActiveSessions() const{
+    return active;
+}
@@ -5,15 +5,28 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include "LinkedList.hpp"
 #include "Song.hpp"
 #include "Playlist.hpp"
+#include "PlaylistView.hpp"
+#include "ListPrinter.hpp"
+#include "SongSet.hpp"
+#include "SmartPlaylists.hpp"
+#include "PlaylistSignature.hpp"
+#include "EditHistory.hpp"
 
 /**
  * @brief Construtor padrão da playlist.
  */
 Playlist::Playlist(){
     this->name = "";
+    statsVersion = songs.getVersion();
+    smart = nullptr;
+    history = nullptr;
+    changed = nullptr;
+    listed = false;
 }
 
 /**
@@ -23,13 +36,85 @@ Playlist::Playlist(){
  */
 Playlist::Playlist(std::string name){
     this->name = name;
+    statsVersion = songs.getVersion();
+    smart = nullptr;
+    history = nullptr;
+    changed = nullptr;
+    listed = false;
+}
+
+/**
+ * @brief Construtor cópia da playlist. Os totais da outra playlist são
+ * copiados junto com as músicas, então a cópia não precisa recalculá-los.
+ * A visão ordenada não é copiada: ela aponta para as músicas da outra
+ * playlist e é refeita na primeira consulta.
+ * A cópia não avisa as playlists inteligentes nem registra alterações no histórico.
+ *
+ * @param playlist Playlist a ser copiada.
+ */
+Playlist::Playlist(const Playlist &playlist) : name(playlist.name), songs(playlist.songs){
+    if(playlist.statsVersion == playlist.songs.getVersion()){
+        stats = playlist.stats;
+    }
+    else{
+        stats.add(songs.getHead());
+    }
+    statsVersion = songs.getVersion();
+    smart = nullptr;
+    history = nullptr;
+    changed = nullptr;
+    listed = false;
+}
+
+/**
+ * @brief Atribuição por cópia, que copia o nome, as músicas e os totais de
+ * outra playlist. Para as playlists inteligentes e para o histórico, as
+ * músicas foram trocadas; o histórico guarda as músicas anteriores.
+ *
+ * @param playlist Playlist a ser copiada.
+ * @return Referência para esta playlist.
+ */
+Playlist &Playlist::operator=(const Playlist &playlist){
+    if(&playlist == this){
+        return *this;
+    }
+    markChanged();
+    unsigned long long prior = songs.getVersion();
+    LinkedList<Song> previous;
+    if(history != nullptr){
+        previous = std::move(songs);
+    }
+    name = playlist.name;
+    songs = playlist.songs;
+    sortedSongs = SortedView<Song, SongOrder>();
+    stats.clear();
+    if(playlist.statsVersion == playlist.songs.getVersion()){
+        stats = playlist.stats;
+    }
+    else{
+        stats.add(songs.getHead());
+    }
+    statsVersion = songs.getVersion();
+    if(smart != nullptr){
+        smart->replaced(songs);
+    }
+    if(history != nullptr){
+        history->songsReplaced(*this, prior, previous);
+    }
+    return *this;
 }
 
 /**
  * @brief Destrutor da playlist, que remove todas as músicas.
  */
 Playlist::~Playlist(){
-    getSongs().clear();
+    if(listed){
+        std::vector<Playlist*>::iterator self = std::find(changed->begin(), changed->end(), this);
+        if(self != changed->end()){
+            changed->erase(self);
+        }
+    }
+    songs.clear();
 }
 
 /**
@@ -37,8 +122,8 @@ Playlist::~Playlist(){
  * 
  * @return Número de músicas.
  */
-size_t Playlist::getSize(){
-    return getSongs().getSize();
+size_t Playlist::getSize() const{
+    return songs.getSize();
 }
 
 /**
@@ -46,35 +131,346 @@ size_t Playlist::getSize(){
  * 
  * @return Nome da playlist.
  */
-std::string Playlist::getName(){
+std::string Playlist::getName() const{
     return name;
 }
 
 /**
- * @brief Retorna uma referência para a lista encadeada de músicas.
+ * @brief Retorna uma referência para a lista encadeada de músicas. Como a
+ * lista pode ser alterada por ela, a playlist conta como alterada.
  * 
  * @return Referência para a lista de músicas.
  */
 LinkedList<Song> &Playlist::getSongs(){
+    markChanged();
+    return songs;
+}
+
+/**
+ * @brief Retorna a lista encadeada de músicas somente para leitura, sem
+ * colocar a playlist na lista de playlists alteradas.
+ *
+ * @return Referência constante para a lista de músicas.
+ */
+const LinkedList<Song> &Playlist::readSongs() const{
     return songs;
 }
 
+/**
+ * @brief Retorna os totais das músicas, recalculando-os se a lista foi
+ * alterada diretamente desde a última atualização.
+ *
+ * @return Referência para os totais, atualizados.
+ */
+PlaylistStats &Playlist::syncStats(){
+    if(statsVersion != songs.getVersion()){
+        stats.clear();
+        stats.add(songs.getHead());
+        statsVersion = songs.getVersion();
+    }
+    return stats;
+}
+
+/**
+ * @brief Retorna os totais das músicas da playlist: número de músicas,
+ * duração total e número de autores. Custa O(1), a menos que a lista tenha
+ * sido alterada diretamente por getSongs.
+ *
+ * @return Referência para os totais, válida até a próxima alteração da playlist.
+ */
+const PlaylistStats &Playlist::getStats(){
+    return syncStats();
+}
+
+/**
+ * @brief Retorna os totais guardados, sem recalculá-los. Só estão corretos se
+ * a lista não foi alterada diretamente depois da última atualização, como
+ * nas cópias publicadas, atualizadas antes da publicação.
+ *
+ * @return Referência para os totais guardados.
+ */
+const PlaylistStats &Playlist::getStats() const{
+    return stats;
+}
+
+/**
+ * @brief Retorna a assinatura MinHash das músicas da playlist, usada para
+ * estimar a semelhança com outras playlists. Ela é mantida junto com os
+ * totais e só é recalculada se uma música retirada era um dos seus mínimos.
+ *
+ * @return Referência para a assinatura, válida até a próxima alteração da playlist.
+ */
+const PlaylistSignature &Playlist::getSignature(){
+    PlaylistStats &totals = syncStats();
+    if(totals.getSignature().isStale()){
+        totals.refreshSignature(songs.getHead());
+    }
+    return totals.getSignature();
+}
+
+/**
+ * @brief Retorna a assinatura guardada, sem recalculá-la. Assim como em
+ * getStats() const, só está correta se foi atualizada depois da última
+ * alteração.
+ *
+ * @return Referência para a assinatura guardada.
+ */
+const PlaylistSignature &Playlist::getSignature() const{
+    return stats.getSignature();
+}
+
+/**
+ * @brief Define as playlists inteligentes que recebem os avisos das
+ * alterações desta playlist. Chamado pela biblioteca para as suas playlists.
+ *
+ * @param smart Playlists inteligentes, ou nullptr para não avisar.
+ */
+void Playlist::setSmartPlaylists(SmartPlaylists *smart){
+    this->smart = smart;
+}
+
+/**
+ * @brief Define o histórico que registra as alterações desta playlist.
+ * Chamado pela biblioteca para as suas playlists.
+ *
+ * @param history Histórico, ou nullptr para não registrar.
+ */
+void Playlist::setEditHistory(EditHistory *history){
+    this->history = history;
+}
+
+/**
+ * @brief Define a lista que recebe esta playlist na primeira alteração
+ * depois de cada publicação. Chamado pela biblioteca para as suas
+ * playlists; também indica que a playlist ainda não está na lista, então a
+ * biblioteca chama de novo depois de publicar as playlists alteradas.
+ *
+ * @param changed Lista de playlists alteradas, ou nullptr para não avisar.
+ */
+void Playlist::setChangeList(std::vector<Playlist*> *changed){
+    this->changed = changed;
+    listed = false;
+}
+
+/**
+ * @brief Coloca a playlist na lista de playlists alteradas, se houver uma e
+ * ela ainda não estiver nela. Chamado antes de qualquer alteração das músicas
+ * ou do nome.
+ */
+void Playlist::markChanged(){
+    if(changed != nullptr && !listed){
+        changed->push_back(this);
+        listed = true;
+    }
+}
+
+/**
+ * @brief Avisa as playlists inteligentes, se houver, de cada música
+ * adicionada por uma operação, do nó first até o final da lista.
+ *
+ * @param prior Versão da lista antes da operação.
+ * @param first Primeira música adicionada, ou nullptr se nenhuma foi.
+ */
+void Playlist::notifyAdded(unsigned long long prior, const Node<Song> *first){
+    if(smart == nullptr){
+        return;
+    }
+    for(const Node<Song> *curr = first; curr != nullptr; curr = curr->getNext()){
+        smart->added(songs, prior, curr->getValue());
+    }
+}
+
+/**
+ * @brief Registra no histórico, se houver, as músicas adicionadas por uma
+ * operação depois do nó lastKnown.
+ *
+ * @param prior Versão da lista antes da operação.
+ * @param lastKnown Último nó antes da operação, ou nullptr se a lista estava vazia.
+ */
+void Playlist::recordAdded(unsigned long long prior, Node<Song> *lastKnown){
+    if(history != nullptr){
+        history->songsAppended(*this, prior, lastKnown);
+    }
+}
+
 /**
  * @brief Adiciona uma música à playlist.
  * 
  * @param song Música a ser adicionada.
  */
 void Playlist::addSong(Song song){
+    PlaylistStats &totals = syncStats();
+    unsigned long long prior = songs.getVersion();
+    Node<Song> *lastKnown = songs.getTail();
     getSongs().add(song);
+    totals.add(song);
+    statsVersion = songs.getVersion();
+    notifyAdded(prior, songs.getTail());
+    recordAdded(prior, lastKnown);
+}
+
+/**
+ * @brief Adiciona as músicas de uma lista de inicialização, como em
+ * playlist.addSongs({a, b, c}), reservando a memória de uma vez.
+ *
+ * @param songs Músicas a adicionar.
+ */
+void Playlist::addSongs(std::initializer_list<Song> songs){
+    addSongs(songs.begin(), songs.end());
+}
+
+/**
+ * @brief Adiciona cópias de músicas do catálogo, como as retornadas pelas
+ * buscas, reservando a memória de uma vez.
+ *
+ * @param catalogSongs Ponteiros para as músicas, na ordem em que serão adicionadas.
+ */
+void Playlist::addSongs(const std::vector<Song*> &catalogSongs){
+    addSongs(catalogSongs.begin(), catalogSongs.end());
+}
+
+/**
+ * @brief Versão para músicas lidas de listas constantes, como as das cópias
+ * publicadas e as das visões de playlists.
+ *
+ * @param catalogSongs Ponteiros para as músicas, na ordem em que serão adicionadas.
+ */
+void Playlist::addSongs(const std::vector<const Song*> &catalogSongs){
+    addSongs(catalogSongs.begin(), catalogSongs.end());
 }
 
 /**
  * @brief Remove a música especificada da playlist.
  * 
- * @param title Título da música.
+ * @param song Música a ser removida.
  */
 void Playlist::removeSong(Song song){
-    getSongs().removeValue(song);
+    PlaylistStats &totals = syncStats();
+    unsigned long long prior = songs.getVersion();
+    Song *found = songs.searchValue(song);
+    if(found == nullptr){
+        return;
+    }
+    markChanged();
+    totals.remove(*found);
+    if(history != nullptr){
+        history->removeFromPlaylist(*this, song);
+    }
+    else{
+        getSongs().removeValue(song);
+    }
+    statsVersion = songs.getVersion();
+    if(smart != nullptr){
+        smart->removed(songs, prior, song);
+    }
+}
+
+/**
+ * @brief Remove, em uma única passagem, todas as ocorrências das músicas de
+ * um conjunto, atualizando os totais.
+ *
+ * @param removed Músicas a remover, comparadas pela identidade. Devem
+ * continuar existindo durante a chamada.
+ * @return Número de músicas removidas.
+ */
+size_t Playlist::removeSongs(const SongSet &removed){
+    markChanged();
+    PlaylistStats &totals = syncStats();
+    unsigned long long prior = songs.getVersion();
+    std::vector<const Song*> gone;
+    // Posições e cópias das músicas removidas, para o histórico
+    std::vector<uint32_t> positions;
+    LinkedList<Song> kept;
+    uint32_t position = 0;
+    size_t count = songs.removeIf([&](const Song &song){
+        SongSet::const_iterator it = removed.find(&song);
+        if(it == removed.end()){
+            position++;
+            return false;
+        }
+        totals.remove(song);
+        gone.push_back(*it);
+        if(history != nullptr){
+            positions.push_back(position);
+            kept.add(song);
+        }
+        position++;
+        return true;
+    });
+    statsVersion = songs.getVersion();
+    if(history != nullptr){
+        history->songsErased(*this, prior, positions, kept);
+    }
+    if(smart != nullptr){
+        for(size_t i = 0; i < gone.size(); i++){
+            smart->removed(songs, prior, *gone[i]);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Copia as músicas da playlist para nós novos, lado a lado na memória
+ * e na ordem da playlist, liberando os nós espalhados por alterações
+ * anteriores (LinkedList::compact). As músicas e a ordem não mudam, então os
+ * totais são mantidos, as playlists inteligentes não recalculam nada e o
+ * histórico não ganha um passo.
+ */
+void Playlist::compact(){
+    markChanged();
+    syncStats();
+    unsigned long long prior = songs.getVersion();
+    songs.compact();
+    statsVersion = songs.getVersion();
+    if(smart != nullptr){
+        smart->reordered(songs, prior);
+    }
+    if(history != nullptr){
+        history->songsRelocated(*this, prior);
+    }
+}
+
+/**
+ * @brief Substitui as músicas da playlist pelas de outra playlist. Os nós e
+ * os totais da outra são tomados sem cópia, e ela fica vazia.
+ *
+ * @param source A playlist de onde as músicas são retiradas.
+ */
+void Playlist::replaceSongs(Playlist &source){
+    if(&source == this){
+        return;
+    }
+    markChanged();
+    source.markChanged();
+    source.syncStats();
+    unsigned long long prior = songs.getVersion();
+    unsigned long long sourcePrior = source.songs.getVersion();
+    LinkedList<Song> previous;
+    LinkedList<Song> sourcePrevious;
+    if(history != nullptr){
+        previous = std::move(songs);
+    }
+    if(source.history != nullptr){
+        sourcePrevious = source.songs;
+    }
+    EditHistory::Batch batch(history != nullptr ? history : source.history, "Substituir as músicas de " + name);
+    songs = std::move(source.songs);
+    stats.clear();
+    stats.merge(source.stats);
+    statsVersion = songs.getVersion();
+    source.statsVersion = source.songs.getVersion();
+    if(smart != nullptr){
+        smart->replaced(songs);
+    }
+    if(source.smart != nullptr){
+        source.smart->replaced(source.songs);
+    }
+    if(history != nullptr){
+        history->songsReplaced(*this, prior, previous);
+    }
+    if(source.history != nullptr){
+        source.history->songsReplaced(source, sourcePrior, sourcePrevious);
+    }
 }
 
 /**
@@ -85,14 +481,68 @@ void Playlist::removeSong(Song song){
  * caso contrário.
  */
 Song *Playlist::searchSong(Song song){
-    return getSongs().searchValue(song);
+    return songs.searchValue(song);
 }
 
 /**
  * @brief Imprime as músicas da playlist.
  */
 void Playlist::printSongs(){
-    getSongs().print();
+    songs.print();
+}
+
+/**
+ * @brief Imprime as músicas da playlist na ordenação especificada, sem alterar
+ * a ordem da playlist.
+ *
+ * @param order Ordenação das músicas.
+ */
+void Playlist::printSongs(SongOrder order){
+    if(order.isEmpty()){
+        printSongs();
+        return;
+    }
+    std::vector<Song*> &sorted = getSortedSongs(order);
+    ListPrinter out(std::cout);
+    for(size_t i = 0; i < sorted.size(); i++){
+        out.line(*sorted[i]);
+    }
+}
+
+/**
+ * @brief Retorna as músicas da playlist ordenadas, sem alterar a playlist.
+ *
+ * A ordenação é guardada e reaproveitada enquanto a playlist não mudar e a
+ * mesma ordenação for pedida.
+ *
+ * @param order Ordenação das músicas.
+ * @return Vetor de ponteiros para as músicas, válido até a próxima alteração da playlist.
+ */
+std::vector<Song*> &Playlist::getSortedSongs(SongOrder order){
+    if(sortedSongs.getOrder() != order){
+        sortedSongs.setOrder(order);
+    }
+    return sortedSongs.get(songs);
+}
+
+/**
+ * @brief Ordena as músicas da playlist, alterando a ordem em que são tocadas.
+ *
+ * @param order Ordenação das músicas.
+ */
+void Playlist::sort(SongOrder order){
+    syncStats();
+    unsigned long long prior = songs.getVersion();
+    if(history != nullptr){
+        history->sortSongs(*this, order);
+    }
+    else{
+        getSongs().sort(order);
+    }
+    statsVersion = songs.getVersion();
+    if(smart != nullptr){
+        smart->reordered(songs, prior);
+    }
 }
 
 /**
@@ -106,10 +556,18 @@ bool Playlist::operator==(Playlist &b){
 }
 
 /**
- * @brief Sobrecarga de operador de inserção da playlist.
+ * @brief Sobrecarga de operador de inserção da playlist, com os totais das
+ * músicas. Se a lista foi alterada diretamente, os totais são calculados sem
+ * serem guardados, pois a playlist é constante.
  */
 std::ostream& operator<<(std::ostream& os, const Playlist& playlist){
-    os << "\"" << playlist.name << "\" - " << playlist.songs.getSize() << " música(s).";
+    PlaylistStats computed;
+    const PlaylistStats *totals = &playlist.stats;
+    if(playlist.statsVersion != playlist.songs.getVersion()){
+        computed.add(playlist.songs.getHead());
+        totals = &computed;
+    }
+    os << "\"" << playlist.name << "\" - " << *totals << ".";
     return os;
 }
 
@@ -119,46 +577,158 @@ std::ostream& operator<<(std::ostream& os, const Playlist& playlist){
  * @param playlist A playlist da qual as músicas serão adicionadas.
  */
 void Playlist::addSong(Playlist &playlist){
-    Node<Song> *aux = playlist.getSongs().getHead();
-    while(aux != nullptr){
-        this->addSong(aux->getValue());
-        aux = aux->getNext();
-    }
+    PlaylistStats &totals = syncStats();
+    unsigned long long prior = songs.getVersion();
+    Node<Song> *lastKnown = songs.getTail();
+    getSongs().addList(playlist.songs);
+    Node<Song> *added = (lastKnown != nullptr) ? lastKnown->getNext() : songs.getHead();
+    totals.add(added);
+    statsVersion = songs.getVersion();
+    notifyAdded(prior, added);
+    recordAdded(prior, lastKnown);
 }
 
 /**
- * @brief Remove todas as músicas de uma playlist da playlist atual.
+ * @brief Remove todas as músicas de uma playlist da playlist atual. No
+ * histórico, as remoções formam um único passo.
  *
  * @param playlist A playlist da qual as músicas serão removidas.
  */
 void Playlist::removeSong(Playlist &playlist){
-    Node<Song> *aux = playlist.getSongs().getHead();
+    EditHistory::Batch batch(history, "Remover as músicas de " + playlist.getName() + " da playlist " + name);
+    const Node<Song> *aux = playlist.songs.getHead();
     while(aux != nullptr){
         this->removeSong(aux->getValue());
         aux = aux->getNext();
     }
 }
 
+/**
+ * @brief Move todas as músicas de outra playlist para o final da playlist
+ * atual, religando os nós em tempo constante. A outra playlist fica vazia.
+ *
+ * @param source A playlist de onde as músicas são retiradas.
+ */
+void Playlist::moveSongs(Playlist &source){
+    if(&source == this){
+        return;
+    }
+    PlaylistStats &totals = syncStats();
+    unsigned long long prior = songs.getVersion();
+    unsigned long long sourcePrior = source.songs.getVersion();
+    Node<Song> *lastKnown = songs.getTail();
+    LinkedList<Song> sourcePrevious;
+    if(source.history != nullptr){
+        sourcePrevious = source.songs;
+    }
+    EditHistory::Batch batch(history != nullptr ? history : source.history, "Mover as músicas de " + source.name + " para " + name);
+    totals.merge(source.syncStats());
+    getSongs().splice(source.getSongs());
+    statsVersion = songs.getVersion();
+    source.statsVersion = source.songs.getVersion();
+    notifyAdded(prior, (lastKnown != nullptr) ? lastKnown->getNext() : songs.getHead());
+    recordAdded(prior, lastKnown);
+    if(source.smart != nullptr){
+        source.smart->replaced(source.songs);
+    }
+    if(source.history != nullptr){
+        source.history->songsReplaced(source, sourcePrior, sourcePrevious);
+    }
+}
+
+/**
+ * @brief Move um trecho de músicas de outra playlist para o final da
+ * playlist atual. Os nós são religados sem copiar as músicas, então o custo
+ * é apenas o de encontrar o trecho na outra playlist.
+ *
+ * @param source A playlist de onde as músicas são retiradas.
+ * @param position Posição da primeira música do trecho, começando em 0.
+ * @param count Número de músicas do trecho.
+ * @return Número de músicas movidas, menor que count se a playlist acabar antes.
+ */
+size_t Playlist::moveSongs(Playlist &source, size_t position, size_t count){
+    if(&source == this || count == 0){
+        return 0;
+    }
+
+    Node<Song> *beforeFirst = nullptr;
+    Node<Song> *curr = source.songs.getHead();
+    for(size_t i = 0; i < position && curr != nullptr; i++){
+        beforeFirst = curr;
+        curr = curr->getNext();
+    }
+    if(curr == nullptr){
+        return 0;
+    }
+
+    PlaylistStats &totals = syncStats();
+    PlaylistStats &sourceTotals = source.syncStats();
+    unsigned long long prior = songs.getVersion();
+    unsigned long long sourcePrior = source.songs.getVersion();
+    Node<Song> *first = curr;
+    size_t moved = 1;
+    Node<Song> *last = curr;
+    totals.add(last->getValue());
+    sourceTotals.remove(last->getValue());
+    while(moved < count && last->getNext() != nullptr){
+        last = last->getNext();
+        totals.add(last->getValue());
+        sourceTotals.remove(last->getValue());
+        moved++;
+    }
+
+    Node<Song> *lastKnown = songs.getTail();
+    EditHistory::Batch batch(history != nullptr ? history : source.history, "Mover músicas de " + source.name + " para " + name);
+    getSongs().spliceAfter(lastKnown, source.getSongs(), beforeFirst, last);
+    statsVersion = songs.getVersion();
+    source.statsVersion = source.songs.getVersion();
+    notifyAdded(prior, first);
+    recordAdded(prior, lastKnown);
+    if(source.smart != nullptr){
+        for(const Node<Song> *node = first; node != nullptr; node = node->getNext()){
+            source.smart->removed(source.songs, sourcePrior, node->getValue());
+        }
+    }
+    if(source.history != nullptr){
+        std::vector<uint32_t> positions;
+        LinkedList<Song> copies;
+        for(const Node<Song> *node = first; node != nullptr; node = node->getNext()){
+            positions.push_back((uint32_t)(position + positions.size()));
+            copies.add(node->getValue());
+        }
+        source.history->songsErased(source, sourcePrior, positions, copies);
+    }
+    return moved;
+}
+
 /**
  * @brief Sobrecarga do operador de adição (+) para mesclar duas playlists.
  *
+ * As músicas já adicionadas são guardadas em um conjunto indexado pela
+ * identidade, então cada música da segunda playlist é verificada em tempo constante.
+ *
  * @param b A playlist que será mesclada com a playlist atual.
  * @return A nova playlist resultante da mesclagem.
  */
 Playlist Playlist::operator+(Playlist &b){
     Playlist newPlaylist;
-    Node<Song> *aux = this->getSongs().getHead();
+    newPlaylist.addSong(*this);
+
+    SongSet seen;
+    std::vector<Song*> added;
+    Node<Song> *aux = songs.getHead();
     while(aux != nullptr){
-        newPlaylist.addSong(aux->getValue());
+        seen.insert(&(aux->getValue()));
         aux = aux->getNext();
     }
-    aux = b.getSongs().getHead();
+    aux = b.songs.getHead();
     while(aux != nullptr){
-        if(newPlaylist.searchSong(aux->getValue()) == nullptr){
-            newPlaylist.addSong(aux->getValue());
+        if(seen.insert(&(aux->getValue())).second){
+            added.push_back(&(aux->getValue()));
         }
         aux = aux->getNext();
     }
+    newPlaylist.addSongs(added);
     return newPlaylist;
 }
 
@@ -170,11 +740,7 @@ Playlist Playlist::operator+(Playlist &b){
  */
 Playlist Playlist::operator+(Song &song){
     Playlist newPlaylist;
-    Node<Song> *aux = this->getSongs().getHead();
-    while(aux != nullptr){
-        newPlaylist.addSong(aux->getValue());
-        aux = aux->getNext();
-    }
+    newPlaylist.addSong(*this);
     newPlaylist.addSong(song);
     return newPlaylist;
 }
@@ -187,13 +753,21 @@ Playlist Playlist::operator+(Song &song){
  */
 Playlist Playlist::operator-(Playlist &b){
     Playlist newPlaylist;
-    Node<Song> *aux = this->getSongs().getHead();
+    SongSet removed;
+    std::vector<Song*> kept;
+    Node<Song> *aux = b.songs.getHead();
+    while(aux != nullptr){
+        removed.insert(&(aux->getValue()));
+        aux = aux->getNext();
+    }
+    aux = songs.getHead();
     while(aux != nullptr){
-        if(b.searchSong(aux->getValue()) == nullptr){
-            newPlaylist.addSong(aux->getValue());
+        if(removed.count(&(aux->getValue())) == 0){
+            kept.push_back(&(aux->getValue()));
         }
         aux = aux->getNext();
     }
+    newPlaylist.addSongs(kept);
     return newPlaylist;
 }
 
@@ -205,23 +779,37 @@ Playlist Playlist::operator-(Playlist &b){
  */
 Playlist Playlist::operator-(Song &song){
     Playlist newPlaylist;
-    Node<Song> *aux = this->getSongs().getHead();
+    std::vector<Song*> kept;
+    Node<Song> *aux = songs.getHead();
     while(aux != nullptr){
         if(aux->getValue() != song){
-            newPlaylist.addSong(aux->getValue());
+            kept.push_back(&(aux->getValue()));
         }
         aux = aux->getNext();
     }
+    newPlaylist.addSongs(kept);
     return newPlaylist;
 }
 
+/**
+ * @brief Retorna uma visão preguiçosa da playlist.
+ *
+ * A visão pode ser combinada com outras playlists usando + e -, como em
+ * pl.view() + b - c, sem criar playlists intermediárias.
+ *
+ * @return Visão que contém as músicas da playlist.
+ */
+PlaylistView Playlist::view() const{
+    return PlaylistView(*this);
+}
+
 /**
  * @brief Sobrecarga do operador de inserção (>>) para retirar a última música da playlist.
  *
  * @param song A música que receberá a última música retirada da playlist.
  */
 void Playlist::operator>>(Song &song){
-    Node<Song> *aux = this->getSongs().getHead();
+    Node<Song> *aux = songs.getHead();
     
         while(aux->getNext() != nullptr){
             aux = aux->getNext();
@@ -248,7 +836,12 @@ void Playlist::operator<<(Song &song){
  */
 Playlist::Playlist(Playlist *playlist){
     this->name = playlist->getName();
-    Node<Song> *aux = playlist->getSongs().getHead();
+    statsVersion = songs.getVersion();
+    smart = nullptr;
+    history = nullptr;
+    changed = nullptr;
+    listed = false;
+    const Node<Song> *aux = playlist->songs.getHead();
     while(aux != nullptr){
         this->addSong(aux->getValue());
         aux = aux->getNext();
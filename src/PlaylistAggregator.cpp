@@ -0,0 +1,376 @@
+/**
+ * @file PlaylistAggregator.cpp
+ * @brief Arquivo que implementa os métodos da classe PlaylistAggregator.
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include "LinkedList.hpp"
+#include "Playlist.hpp"
+#include "TextView.hpp"
+#include "Song.hpp"
+#include "TextKey.hpp"
+#include "SpaceSaving.hpp"
+#include "PlaylistAggregator.hpp"
+
+//! Número de playlists que cada thread pega por vez.
+static const size_t playlistsPerTask = 64;
+
+//! Número de faixas do histograma: tamanho 0 e uma faixa por bit do tamanho.
+static const size_t sizeBuckets = std::numeric_limits<size_t>::digits + 1;
+
+/**
+ * @brief Contagem de uma música ou autor em uma thread.
+ */
+struct Tally{
+    size_t count; //!< Número de playlists em que o item apareceu.
+    size_t last; //!< Última playlist em que o item foi contado.
+    const Song *sample; //!< Música que representa o item.
+};
+
+/**
+ * @brief Item candidato à classificação.
+ */
+struct Candidate{
+    uint64_t key; //!< Hash que identifica o item.
+    size_t count; //!< Contagem do item.
+    size_t error; //!< Erro máximo da contagem.
+    const Song *sample; //!< Música que representa o item.
+};
+
+typedef std::unordered_map<uint64_t, Tally> TallyMap;
+
+/**
+ * @brief Ordena os candidatos da maior para a menor contagem, e pela chave
+ * nos empates, para que o resultado não dependa do número de threads.
+ */
+static bool ranksHigher(const Candidate &a, const Candidate &b){
+    if(a.count != b.count){
+        return a.count > b.count;
+    }
+    return a.key < b.key;
+}
+
+/**
+ * @brief Calcula a chave do item contado para uma música.
+ *
+ * @param subject O que é contado.
+ * @param song Música.
+ * @param key Recebe a chave.
+ * @return false se a música não conta (autor vazio na contagem de autores).
+ */
+static bool subjectKey(PlaylistAggregator::Subject subject, const Song &song, uint64_t &key){
+    if(subject == PlaylistAggregator::Songs){
+        key = song.getFingerprint();
+        return true;
+    }
+    TextView author = song.getAuthorKey();
+    if(author.empty()){
+        return false;
+    }
+    key = hashBytes(author.data(), author.size());
+    return true;
+}
+
+/**
+ * @brief Mantém os k melhores candidatos, ordenados.
+ *
+ * @param candidates Candidatos, cortados para os k melhores.
+ * @param k Número de candidatos mantidos.
+ */
+static void keepBest(std::vector<Candidate> &candidates, size_t k){
+    if(candidates.size() > k){
+        std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), ranksHigher);
+        candidates.resize(k);
+    }
+    else{
+        std::sort(candidates.begin(), candidates.end(), ranksHigher);
+    }
+}
+
+/**
+ * @brief Monta a classificação a partir dos candidatos.
+ *
+ * @param subject O que foi contado.
+ * @param candidates Candidatos, em ordem.
+ * @param result Recebe a classificação.
+ */
+static void buildRanking(PlaylistAggregator::Subject subject, const std::vector<Candidate> &candidates,
+                         std::vector<PlaylistAggregator::Ranked> &result){
+    result.clear();
+    result.reserve(candidates.size());
+    for(size_t i = 0; i < candidates.size(); i++){
+        Song sample = *candidates[i].sample;
+        PlaylistAggregator::Ranked ranked;
+        if(subject == PlaylistAggregator::Songs){
+            ranked.title = sample.getTitle();
+        }
+        ranked.author = sample.getAuthor();
+        ranked.count = candidates[i].count;
+        ranked.error = candidates[i].error;
+        result.push_back(ranked);
+    }
+}
+
+/**
+ * @brief Construtor que consulta as playlists de uma lista.
+ *
+ * @param playlists Lista de playlists, que não pode ser alterada enquanto o agregador é usado.
+ * @param threads Número de threads; 0 usa uma por núcleo.
+ */
+PlaylistAggregator::PlaylistAggregator(const LinkedList<Playlist> &playlists, unsigned threads){
+    for(const Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+        this->playlists.push_back(&curr->getValue());
+    }
+    if(threads == 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t tasks = (this->playlists.size() + playlistsPerTask - 1) / playlistsPerTask;
+    this->threads = (unsigned)std::max<size_t>(1, std::min<size_t>(threads, tasks));
+}
+
+/**
+ * @brief Construtor que consulta as playlists de uma versão publicada.
+ *
+ * @param playlists Playlists da versão, que deve ser mantida enquanto o agregador é usado.
+ * @param threads Número de threads; 0 usa uma por núcleo.
+ */
+PlaylistAggregator::PlaylistAggregator(const std::vector<std::shared_ptr<const Playlist>> &playlists, unsigned threads){
+    for(size_t i = 0; i < playlists.size(); i++){
+        this->playlists.push_back(playlists[i].get());
+    }
+    if(threads == 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t tasks = (this->playlists.size() + playlistsPerTask - 1) / playlistsPerTask;
+    this->threads = (unsigned)std::max<size_t>(1, std::min<size_t>(threads, tasks));
+}
+
+/**
+ * @brief Executa work(t) para t de 0 a count - 1, cada um em uma thread. Com
+ * uma só, executa na thread atual.
+ *
+ * @param count Número de threads.
+ * @param work Trabalho de cada thread.
+ */
+template <typename Work>
+void PlaylistAggregator::run(unsigned count, Work work) const{
+    if(count == 1){
+        work(0u);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < count; t++){
+        workers.push_back(std::thread(work, t));
+    }
+    for(size_t t = 0; t < workers.size(); t++){
+        workers[t].join();
+    }
+}
+
+/**
+ * @brief Retorna as k músicas ou autores presentes em mais playlists. Cada
+ * item é contado uma vez por playlist. Cada thread conta as suas playlists
+ * em uma tabela por parte; depois a thread s junta a parte s de todas as
+ * threads e escolhe os k maiores dela. Os empates são resolvidos pelo hash do
+ * item, então o resultado é o mesmo com qualquer número de threads.
+ *
+ * @param subject Contar músicas ou autores.
+ * @param k Número de itens retornados.
+ * @param result Recebe os itens, da maior para a menor contagem.
+ */
+void PlaylistAggregator::top(Subject subject, size_t k, std::vector<Ranked> &result) const{
+    unsigned count = threads;
+    std::vector<std::vector<TallyMap>> partial(count, std::vector<TallyMap>(count));
+    std::atomic<size_t> next(0);
+
+    run(count, [this, subject, count, &partial, &next](unsigned t){
+        std::vector<TallyMap> &shards = partial[t];
+        for(;;){
+            size_t begin = next.fetch_add(playlistsPerTask);
+            if(begin >= playlists.size()){
+                return;
+            }
+            size_t end = std::min(begin + playlistsPerTask, playlists.size());
+            for(size_t i = begin; i < end; i++){
+                for(const Node<Song> *curr = playlists[i]->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    uint64_t key;
+                    if(!subjectKey(subject, curr->getValue(), key)){
+                        continue;
+                    }
+                    Tally &tally = shards[key % count][key];
+                    if(tally.count == 0){
+                        tally.sample = &curr->getValue();
+                    }
+                    else if(tally.last == i){
+                        continue;
+                    }
+                    tally.last = i;
+                    tally.count++;
+                }
+            }
+        }
+    });
+
+    std::vector<std::vector<Candidate>> best(count);
+    run(count, [count, k, &partial, &best](unsigned s){
+        TallyMap merged;
+        merged.swap(partial[0][s]);
+        for(unsigned t = 1; t < count; t++){
+            TallyMap &shard = partial[t][s];
+            for(auto it = shard.begin(); it != shard.end(); ++it){
+                auto inserted = merged.insert(*it);
+                if(!inserted.second){
+                    // As threads contam playlists diferentes, então as contagens somam
+                    inserted.first->second.count += it->second.count;
+                }
+            }
+            TallyMap().swap(shard);
+        }
+
+        std::vector<Candidate> &candidates = best[s];
+        candidates.reserve(merged.size());
+        for(auto it = merged.begin(); it != merged.end(); ++it){
+            Candidate candidate;
+            candidate.key = it->first;
+            candidate.count = it->second.count;
+            candidate.error = 0;
+            candidate.sample = it->second.sample;
+            candidates.push_back(candidate);
+        }
+        keepBest(candidates, k);
+    });
+
+    std::vector<Candidate> candidates;
+    for(unsigned s = 0; s < count; s++){
+        candidates.insert(candidates.end(), best[s].begin(), best[s].end());
+    }
+    keepBest(candidates, k);
+    buildRanking(subject, candidates, result);
+}
+
+/**
+ * @brief Estima as k músicas ou autores presentes em mais playlists, usando
+ * memória fixa: cada thread conta as suas playlists em um resumo
+ * Space-Saving de capacity itens, e os resumos são unidos no final. Todo
+ * item presente em mais de n / capacity playlists, com n o total de
+ * ocorrências contadas, aparece no resumo; capacity deve ser bem maior que k.
+ *
+ * @param subject Contar músicas ou autores.
+ * @param k Número de itens retornados.
+ * @param capacity Número de itens acompanhados por resumo.
+ * @param result Recebe os itens, da maior para a menor contagem estimada, com o erro máximo de cada uma.
+ */
+void PlaylistAggregator::approximateTop(Subject subject, size_t k, size_t capacity, std::vector<Ranked> &result) const{
+    unsigned count = threads;
+    std::vector<SpaceSaving> sketches(count, SpaceSaving(capacity));
+    std::atomic<size_t> next(0);
+
+    run(count, [this, subject, &sketches, &next](unsigned t){
+        SpaceSaving &sketch = sketches[t];
+        for(;;){
+            size_t begin = next.fetch_add(playlistsPerTask);
+            if(begin >= playlists.size()){
+                return;
+            }
+            size_t end = std::min(begin + playlistsPerTask, playlists.size());
+            for(size_t i = begin; i < end; i++){
+                for(const Node<Song> *curr = playlists[i]->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    uint64_t key;
+                    if(subjectKey(subject, curr->getValue(), key)){
+                        sketch.add(key, &curr->getValue(), i);
+                    }
+                }
+            }
+        }
+    });
+
+    for(unsigned t = 1; t < count; t++){
+        sketches[0].merge(sketches[t]);
+    }
+
+    const std::vector<SpaceSaving::Item> &items = sketches[0].getItems();
+    std::vector<Candidate> candidates;
+    candidates.reserve(items.size());
+    for(size_t i = 0; i < items.size(); i++){
+        Candidate candidate;
+        candidate.key = items[i].key;
+        candidate.count = items[i].count;
+        candidate.error = items[i].error;
+        candidate.sample = items[i].sample;
+        candidates.push_back(candidate);
+    }
+    keepBest(candidates, k);
+    buildRanking(subject, candidates, result);
+}
+
+/**
+ * @brief Conta as playlists por faixa de tamanho. A primeira faixa é a das
+ * playlists vazias, e a faixa b, para b >= 1, vai de 2^(b-1) a 2^b - 1
+ * músicas. Só são retornadas as faixas entre a primeira e a última não vazias.
+ *
+ * @param result Recebe as faixas, da menor para a maior.
+ */
+void PlaylistAggregator::sizeHistogram(std::vector<SizeBucket> &result) const{
+    result.clear();
+    unsigned count = threads;
+    std::vector<std::vector<size_t>> partial(count, std::vector<size_t>(sizeBuckets, 0));
+    std::atomic<size_t> next(0);
+
+    run(count, [this, &partial, &next](unsigned t){
+        std::vector<size_t> &buckets = partial[t];
+        for(;;){
+            size_t begin = next.fetch_add(playlistsPerTask);
+            if(begin >= playlists.size()){
+                return;
+            }
+            size_t end = std::min(begin + playlistsPerTask, playlists.size());
+            for(size_t i = begin; i < end; i++){
+                size_t bucket = 0;
+                for(size_t size = playlists[i]->getSize(); size > 0; size >>= 1){
+                    bucket++;
+                }
+                buckets[bucket]++;
+            }
+        }
+    });
+
+    std::vector<size_t> totals(sizeBuckets, 0);
+    for(unsigned t = 0; t < count; t++){
+        for(size_t b = 0; b < sizeBuckets; b++){
+            totals[b] += partial[t][b];
+        }
+    }
+
+    size_t first = 0;
+    while(first < sizeBuckets && totals[first] == 0){
+        first++;
+    }
+    size_t last = sizeBuckets;
+    while(last > first && totals[last - 1] == 0){
+        last--;
+    }
+    for(size_t b = first; b < last; b++){
+        SizeBucket bucket;
+        bucket.low = b == 0 ? 0 : (size_t)1 << (b - 1);
+        bucket.high = b == 0 ? 0 : bucket.low + (bucket.low - 1);
+        bucket.playlists = totals[b];
+        result.push_back(bucket);
+    }
+}
+
+/**
+ * @brief Retorna o número de threads usadas, limitado pelo número de grupos
+ * de playlists.
+ *
+ * @return Número de threads.
+ */
+unsigned PlaylistAggregator::getThreads() const{
+    return threads;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file PlaylistCombiner.cpp
+ * @brief Arquivo que implementa os métodos da classe PlaylistCombiner.
+ */
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+#include "PlaylistCombiner.hpp"
+
+/**
+ * @brief Presença de uma música nas playlists, contada por uma parte.
+ */
+struct Presence{
+    size_t playlists; //!< Número de playlists que contêm a música.
+    size_t last; //!< Última playlist em que a música foi contada.
+};
+
+//! Tabela da presença de cada música, indexada pela identidade.
+typedef std::unordered_map<const Song*, Presence, SongHash, SongEqual> PresenceMap;
+
+/**
+ * @brief Retorna a parte de uma música, pelo hash da identidade. Usa os bits
+ * altos do hash, pois os baixos escolhem a posição na tabela da parte.
+ *
+ * @param song Música.
+ * @param parts Número de partes.
+ * @return Parte da música, de 0 a parts - 1.
+ */
+static size_t partOf(const Song &song, size_t parts){
+    return (size_t)(song.getFingerprint() >> 32) % parts;
+}
+
+/**
+ * @brief Executa work(t) para t de 0 a count - 1, cada um em uma thread. Com
+ * uma só, executa na thread atual.
+ *
+ * @param count Número de threads.
+ * @param work Trabalho de cada thread.
+ */
+template <typename Work>
+static void runThreads(unsigned count, Work work){
+    if(count == 1){
+        work(0u);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < count; t++){
+        workers.push_back(std::thread(work, t));
+    }
+    for(size_t t = 0; t < workers.size(); t++){
+        workers[t].join();
+    }
+}
+
+/**
+ * @brief Construtor que recebe as playlists.
+ *
+ * @param playlists Playlists combinadas, na ordem da operação; a primeira é a
+ * base da interseção e da diferença.
+ * @param threads Número de threads; 0 usa uma por núcleo.
+ */
+PlaylistCombiner::PlaylistCombiner(const std::vector<const Playlist*> &playlists, unsigned threads){
+    this->playlists = playlists;
+    if(threads == 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->threads = threads;
+}
+
+/**
+ * @brief Decide quais ocorrências de uma parte das músicas entram no
+ * resultado, percorrendo a parte de cada playlist em ordem.
+ *
+ * Na união, a primeira playlist entra inteira, e cada música das outras entra
+ * na primeira vez em que aparece. Na interseção e na diferença, só as músicas
+ * da primeira playlist entram na tabela; as outras playlists apenas contam em
+ * quantas playlists cada uma aparece, e as ocorrências da primeira são
+ * decididas no final.
+ *
+ * @param operation Operação aplicada.
+ * @param part Parte das músicas.
+ * @param inputs Ocorrências de cada playlist, que recebem as decisões da parte.
+ */
+void PlaylistCombiner::combinePart(Operation operation, size_t part, std::vector<Input> &inputs) const{
+    PresenceMap presence;
+    Presence first;
+    first.playlists = 1;
+    first.last = 0;
+
+    for(size_t i = 0; i < inputs.size(); i++){
+        Input &input = inputs[i];
+        size_t count = threads == 1 ? input.songs.size() : input.parts[part].size();
+        for(size_t k = 0; k < count; k++){
+            uint32_t position = threads == 1 ? (uint32_t)k : input.parts[part][k];
+            const Song *song = input.songs[position];
+            if(i == 0){
+                presence.insert(std::make_pair(song, first));
+                input.kept[position] = operation == Union;
+            }
+            else if(operation == Union){
+                input.kept[position] = presence.insert(std::make_pair(song, first)).second;
+            }
+            else{
+                auto it = presence.find(song);
+                if(it != presence.end() && it->second.last != i){
+                    it->second.last = i;
+                    it->second.playlists++;
+                }
+            }
+        }
+    }
+
+    if(operation == Union){
+        return;
+    }
+    Input &base = inputs[0];
+    size_t count = threads == 1 ? base.songs.size() : base.parts[part].size();
+    for(size_t k = 0; k < count; k++){
+        uint32_t position = threads == 1 ? (uint32_t)k : base.parts[part][k];
+        size_t playlists = presence.find(base.songs[position])->second.playlists;
+        base.kept[position] = operation == Intersection ? playlists == inputs.size() : playlists == 1;
+    }
+}
+
+/**
+ * @brief Calcula as músicas do resultado da operação. Primeiro as playlists
+ * são lidas, cada thread pegando uma por vez, e as posições das músicas são
+ * separadas por parte; depois cada thread decide as ocorrências da sua parte
+ * (combinePart), e o resultado é montado na ordem das playlists.
+ *
+ * @param operation Operação aplicada.
+ * @param result Recebe as músicas do resultado, que apontam para as músicas das playlists.
+ */
+void PlaylistCombiner::combine(Operation operation, std::vector<const Song*> &result) const{
+    result.clear();
+    if(playlists.empty()){
+        return;
+    }
+
+    std::vector<Input> inputs(playlists.size());
+    std::atomic<size_t> next(0);
+    runThreads(threads, [this, &inputs, &next](unsigned){
+        for(;;){
+            size_t i = next.fetch_add(1);
+            if(i >= playlists.size()){
+                return;
+            }
+            Input &input = inputs[i];
+            for(const Node<Song> *curr = playlists[i]->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                input.songs.push_back(&curr->getValue());
+            }
+            input.kept.assign(input.songs.size(), 0);
+            if(threads > 1){
+                input.parts.resize(threads);
+                for(uint32_t position = 0; position < input.songs.size(); position++){
+                    input.parts[partOf(*input.songs[position], threads)].push_back(position);
+                }
+            }
+        }
+    });
+
+    runThreads(threads, [this, operation, &inputs](unsigned part){
+        combinePart(operation, part, inputs);
+    });
+
+    for(size_t i = 0; i < inputs.size(); i++){
+        for(size_t position = 0; position < inputs[i].songs.size(); position++){
+            if(inputs[i].kept[position]){
+                result.push_back(inputs[i].songs[position]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Cria uma playlist com o resultado da operação.
+ *
+ * @param operation Operação aplicada.
+ * @param name Nome da nova playlist.
+ * @return A playlist criada.
+ */
+Playlist PlaylistCombiner::materialize(Operation operation, std::string name) const{
+    Playlist playlist(name);
+    std::vector<const Song*> songs;
+    combine(operation, songs);
+    playlist.addSongs(songs);
+    return playlist;
+}
+
+/**
+ * @brief Retorna o número de threads usadas.
+ *
+ * @return Número de threads.
+ */
+unsigned PlaylistCombiner::getThreads() const{
+    return threads;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file PlaylistSignature.cpp
+ * @brief Arquivo que implementa os métodos da classe PlaylistSignature.
+ */
+
+#include <cstdint>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "PlaylistSignature.hpp"
+
+const size_t PlaylistSignature::size;
+
+/**
+ * @brief Coeficientes das funções de hash h(x) = (a * x + b) >> 32, com a
+ * ímpar, sorteados uma única vez com uma semente fixa para que as
+ * assinaturas sejam comparáveis entre execuções.
+ */
+struct SignatureFunctions{
+    uint64_t a[PlaylistSignature::size]; //!< Multiplicador de cada função.
+    uint64_t b[PlaylistSignature::size]; //!< Soma de cada função.
+
+    SignatureFunctions(){
+        uint64_t state = 0x5eed5eed5eed5eedULL;
+        for(size_t i = 0; i < PlaylistSignature::size; i++){
+            a[i] = nextRandom(state) | 1;
+            b[i] = nextRandom(state);
+        }
+    }
+
+    // Gerador splitmix64.
+    static uint64_t nextRandom(uint64_t &state){
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+};
+
+static const SignatureFunctions functions;
+
+/**
+ * @brief Construtor da assinatura de uma playlist vazia.
+ */
+PlaylistSignature::PlaylistSignature(){
+    clear();
+}
+
+/**
+ * @brief Adiciona uma música à assinatura, mantendo o menor hash de cada função.
+ *
+ * @param song Música que entrou na playlist.
+ */
+void PlaylistSignature::add(const Song &song){
+    uint64_t x = song.getFingerprint();
+    for(size_t i = 0; i < size; i++){
+        uint32_t hash = (uint32_t)((functions.a[i] * x + functions.b[i]) >> 32);
+        if(hash < mins[i]){
+            mins[i] = hash;
+        }
+    }
+}
+
+/**
+ * @brief Adiciona à assinatura as músicas de um nó até o fim da lista.
+ *
+ * @param first Primeiro nó, ou nullptr se não há músicas.
+ */
+void PlaylistSignature::add(const Node<Song> *first){
+    for(const Node<Song> *curr = first; curr != nullptr; curr = curr->getNext()){
+        add(curr->getValue());
+    }
+}
+
+/**
+ * @brief Retira uma música da assinatura. Se o hash da música é o mínimo de
+ * alguma função, o próximo mínimo não é conhecido, e a assinatura fica
+ * desatualizada até ser recalculada.
+ *
+ * @param song Música que saiu da playlist.
+ */
+void PlaylistSignature::remove(const Song &song){
+    if(stale){
+        return;
+    }
+    uint64_t x = song.getFingerprint();
+    for(size_t i = 0; i < size; i++){
+        if((uint32_t)((functions.a[i] * x + functions.b[i]) >> 32) == mins[i]){
+            stale = true;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Adiciona à assinatura as músicas de outra, como quando as músicas de
+ * uma playlist são movidas para esta.
+ *
+ * @param other Assinatura das músicas adicionadas.
+ */
+void PlaylistSignature::merge(const PlaylistSignature &other){
+    for(size_t i = 0; i < size; i++){
+        if(other.mins[i] < mins[i]){
+            mins[i] = other.mins[i];
+        }
+    }
+    stale = stale || other.stale;
+}
+
+/**
+ * @brief Volta à assinatura de uma playlist vazia, que está atualizada.
+ */
+void PlaylistSignature::clear(){
+    for(size_t i = 0; i < size; i++){
+        mins[i] = UINT32_MAX;
+    }
+    stale = false;
+}
+
+/**
+ * @brief Verifica se a assinatura deve ser recalculada a partir das músicas.
+ *
+ * @return true se uma música retirada pode ter sido um dos mínimos.
+ */
+bool PlaylistSignature::isStale() const{
+    return stale;
+}
+
+/**
+ * @brief Verifica se a assinatura é de uma playlist vazia.
+ *
+ * @return true se nenhuma música foi adicionada.
+ */
+bool PlaylistSignature::isEmpty() const{
+    for(size_t i = 0; i < size; i++){
+        if(mins[i] != UINT32_MAX){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Retorna o menor hash das músicas em uma das funções.
+ *
+ * @param function Índice da função, menor que size.
+ * @return Menor hash, ou UINT32_MAX se a playlist está vazia.
+ */
+uint32_t PlaylistSignature::get(size_t function) const{
+    return mins[function];
+}
+
+/**
+ * @brief Estima a semelhança de Jaccard entre as playlists das duas
+ * assinaturas, pela fração de funções com o mesmo mínimo.
+ *
+ * @param other Outra assinatura.
+ * @return Semelhança estimada, entre 0 e 1; 0 se alguma playlist está vazia.
+ */
+double PlaylistSignature::similarity(const PlaylistSignature &other) const{
+    if(isEmpty() || other.isEmpty()){
+        return 0;
+    }
+    size_t equal = 0;
+    for(size_t i = 0; i < size; i++){
+        equal += (mins[i] == other.mins[i]);
+    }
+    return (double)equal / size;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file PlaylistStats.cpp
+ * @brief Arquivo que implementa os métodos da classe PlaylistStats.
+ */
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "Node.hpp"
+#include "TextView.hpp"
+#include "Song.hpp"
+#include "TextKey.hpp"
+#include "PlaylistSignature.hpp"
+#include "PlaylistStats.hpp"
+
+const size_t PlaylistStats::fewAuthorsLimit;
+
+/**
+ * @brief Construtor dos totais de uma playlist vazia.
+ */
+PlaylistStats::PlaylistStats(){
+    clear();
+}
+
+/**
+ * @brief Soma count à contagem de músicas de um autor. O autor é procurado
+ * no vetor pequeno; se ele não está lá e o vetor está cheio, as contagens
+ * passam para a tabela de hash.
+ *
+ * @param hash Hash da chave do autor.
+ * @param count Número de músicas do autor a somar.
+ */
+void PlaylistStats::addAuthor(uint64_t hash, size_t count){
+    if(authors.empty()){
+        for(size_t i = 0; i < fewAuthors.size(); i++){
+            if(fewAuthors[i].first == hash){
+                fewAuthors[i].second += count;
+                return;
+            }
+        }
+        if(fewAuthors.size() < fewAuthorsLimit){
+            if(fewAuthors.empty()){
+                fewAuthors.reserve(fewAuthorsLimit);
+            }
+            fewAuthors.push_back(std::make_pair(hash, count));
+            return;
+        }
+        authors.insert(fewAuthors.begin(), fewAuthors.end());
+        fewAuthors = std::vector<std::pair<uint64_t, size_t>>();
+    }
+    authors[hash] += count;
+}
+
+/**
+ * @brief Adiciona uma música aos totais. Músicas sem autor não contam como
+ * um autor.
+ *
+ * @param song Música que entrou na playlist.
+ */
+void PlaylistStats::add(const Song &song){
+    tracks++;
+    if(song.getDuration() != 0){
+        duration += song.getDuration();
+    }
+    else{
+        untimed++;
+    }
+    TextView author = song.getAuthorKey();
+    if(!author.empty()){
+        addAuthor(hashBytes(author.data(), author.size()), 1);
+    }
+    signature.add(song);
+}
+
+/**
+ * @brief Adiciona aos totais as músicas de um nó até o fim da lista, como as
+ * acrescentadas de uma vez ao final de uma playlist.
+ *
+ * @param first Primeiro nó, ou nullptr se não há músicas.
+ */
+void PlaylistStats::add(const Node<Song> *first){
+    for(const Node<Song> *curr = first; curr != nullptr; curr = curr->getNext()){
+        add(curr->getValue());
+    }
+}
+
+/**
+ * @brief Retira uma música dos totais. A música deve ter sido adicionada antes.
+ *
+ * @param song Música que saiu da playlist.
+ */
+void PlaylistStats::remove(const Song &song){
+    tracks--;
+    if(song.getDuration() != 0){
+        duration -= song.getDuration();
+    }
+    else{
+        untimed--;
+    }
+    signature.remove(song);
+    TextView author = song.getAuthorKey();
+    if(author.empty()){
+        return;
+    }
+    uint64_t hash = hashBytes(author.data(), author.size());
+    for(size_t i = 0; i < fewAuthors.size(); i++){
+        if(fewAuthors[i].first == hash){
+            if(--fewAuthors[i].second == 0){
+                fewAuthors[i] = fewAuthors.back();
+                fewAuthors.pop_back();
+            }
+            return;
+        }
+    }
+    auto it = authors.find(hash);
+    if(it != authors.end() && --it->second == 0){
+        authors.erase(it);
+    }
+}
+
+/**
+ * @brief Soma aos totais os de outra playlist, cujas músicas foram movidas
+ * para esta, e zera os totais da outra. Se esta playlist está vazia, a
+ * contagem de autores é apenas trocada, sem ser percorrida.
+ *
+ * @param other Totais da playlist de onde as músicas saíram.
+ */
+void PlaylistStats::merge(PlaylistStats &other){
+    if(&other == this){
+        return;
+    }
+    if(tracks == 0){
+        fewAuthors.swap(other.fewAuthors);
+        authors.swap(other.authors);
+    }
+    else{
+        for(size_t i = 0; i < other.fewAuthors.size(); i++){
+            addAuthor(other.fewAuthors[i].first, other.fewAuthors[i].second);
+        }
+        for(auto it = other.authors.begin(); it != other.authors.end(); ++it){
+            addAuthor(it->first, it->second);
+        }
+    }
+    tracks += other.tracks;
+    duration += other.duration;
+    untimed += other.untimed;
+    signature.merge(other.signature);
+    other.clear();
+}
+
+/**
+ * @brief Zera os totais, como os de uma playlist vazia.
+ */
+void PlaylistStats::clear(){
+    tracks = 0;
+    duration = 0;
+    untimed = 0;
+    fewAuthors.clear();
+    authors.clear();
+    signature.clear();
+}
+
+/**
+ * @brief Retorna o número de músicas.
+ *
+ * @return Número de músicas.
+ */
+size_t PlaylistStats::getTracks() const{
+    return tracks;
+}
+
+/**
+ * @brief Retorna a soma das durações conhecidas.
+ *
+ * @return Duração total em segundos, sem as músicas de duração desconhecida.
+ */
+unsigned long long PlaylistStats::getDuration() const{
+    return duration;
+}
+
+/**
+ * @brief Retorna o número de músicas com duração desconhecida.
+ *
+ * @return Número de músicas sem duração.
+ */
+size_t PlaylistStats::getUntimedTracks() const{
+    return untimed;
+}
+
+/**
+ * @brief Retorna o número de autores diferentes.
+ *
+ * @return Número de autores, sem contar músicas sem autor.
+ */
+size_t PlaylistStats::getAuthors() const{
+    return fewAuthors.size() + authors.size();
+}
+
+/**
+ * @brief Retorna a assinatura MinHash das músicas. Se isStale() é verdadeiro,
+ * ela deve ser recalculada com refreshSignature antes de ser usada.
+ *
+ * @return Referência para a assinatura.
+ */
+const PlaylistSignature &PlaylistStats::getSignature() const{
+    return signature;
+}
+
+/**
+ * @brief Recalcula a assinatura a partir das músicas da playlist, sem mudar
+ * os outros totais.
+ *
+ * @param first Primeiro nó da lista de músicas, ou nullptr se ela está vazia.
+ */
+void PlaylistStats::refreshSignature(const Node<Song> *first){
+    signature.clear();
+    signature.add(first);
+}
+
+/**
+ * @brief Sobrecarga do operador de inserção dos totais, como em
+ * "12 música(s), 45:10, 7 autor(es)". A duração é omitida se nenhuma música
+ * tem duração, e indicada como parcial se alguma não tem.
+ */
+std::ostream& operator<<(std::ostream& os, const PlaylistStats& stats){
+    os << stats.tracks << " música(s)";
+    if(stats.untimed < stats.tracks){
+        os << ", " << Song::formatDuration(stats.duration);
+        if(stats.untimed > 0){
+            os << " (" << stats.untimed << " sem duração)";
+        }
+    }
+    os << ", " << stats.getAuthors() << " autor(es)";
+    return os;
+}
@@ -0,0 +1,284 @@
+/**
+ * @file PlaylistView.cpp
+ * @brief Arquivo que implementa os métodos da classe PlaylistView.
+ */
+
+#include <string>
+#include <iostream>
+#include <utility>
+#include <unordered_map>
+#include "Node.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "LinkedList.hpp"
+#include "Playlist.hpp"
+#include "PlaylistView.hpp"
+#include "ListPrinter.hpp"
+
+/**
+ * @brief Construtor da visão que contém apenas uma playlist.
+ *
+ * @param playlist Playlist inicial da visão.
+ */
+PlaylistView::PlaylistView(const Playlist &playlist){
+    terms.push_back(Term{&playlist, false});
+}
+
+/**
+ * @brief Retorna uma visão que mescla outra playlist à visão atual.
+ *
+ * @param b Playlist a ser mesclada.
+ * @return Nova visão, sem cópia das músicas.
+ */
+PlaylistView PlaylistView::operator+(const Playlist &b) const &{
+    PlaylistView result(*this);
+    result.terms.push_back(Term{&b, false});
+    return result;
+}
+
+/**
+ * @brief Versão para visões temporárias, que reaproveita os termos já existentes.
+ * Permite encadear A + B - C + D sem copiar a expressão a cada passo.
+ *
+ * @param b Playlist a ser mesclada.
+ * @return Nova visão, sem cópia das músicas.
+ */
+PlaylistView PlaylistView::operator+(const Playlist &b) &&{
+    terms.push_back(Term{&b, false});
+    return std::move(*this);
+}
+
+/**
+ * @brief Retorna uma visão que remove as músicas de outra playlist da visão atual.
+ *
+ * @param b Playlist a ser subtraída.
+ * @return Nova visão, sem cópia das músicas.
+ */
+PlaylistView PlaylistView::operator-(const Playlist &b) const &{
+    PlaylistView result(*this);
+    result.terms.push_back(Term{&b, true});
+    return result;
+}
+
+/**
+ * @brief Versão para visões temporárias, que reaproveita os termos já existentes.
+ *
+ * @param b Playlist a ser subtraída.
+ * @return Nova visão, sem cópia das músicas.
+ */
+PlaylistView PlaylistView::operator-(const Playlist &b) &&{
+    terms.push_back(Term{&b, true});
+    return std::move(*this);
+}
+
+/**
+ * @brief Marca as ocorrências dos termos mesclados que fazem parte do
+ * resultado, se alguma playlist mudou desde o último cálculo.
+ *
+ * Uma ocorrência de um termo mesclado é visível se nenhuma playlist subtraída
+ * depois dela contém a música e se a música ainda não estava no resultado
+ * quando o termo foi mesclado, como acontece em Playlist::operator+. Os
+ * termos são percorridos uma vez, em ordem, guardando para cada música o
+ * último termo subtraído que a contém e se ela está no resultado até o termo
+ * atual, então o custo é proporcional ao total de músicas dos termos.
+ */
+void PlaylistView::refresh(){
+    bool changed = versions.size() != terms.size();
+    for(size_t i = 0; i < terms.size() && !changed; i++){
+        changed = versions[i] != terms[i].playlist->readSongs().getVersion();
+    }
+    if(!changed){
+        return;
+    }
+
+    // Último termo subtraído que contém cada música
+    std::unordered_map<const Song*, size_t, SongHash, SongEqual> removedBy;
+    for(size_t k = 0; k < terms.size(); k++){
+        if(terms[k].subtract){
+            for(const Node<Song> *curr = terms[k].playlist->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                removedBy[&curr->getValue()] = k;
+            }
+        }
+    }
+
+    // Músicas no resultado depois dos termos já percorridos
+    std::unordered_map<const Song*, bool, SongHash, SongEqual> present;
+    versions.assign(terms.size(), 0);
+    visible.assign(terms.size(), std::vector<bool>());
+    for(size_t term = 0; term < terms.size(); term++){
+        const LinkedList<Song> &songs = terms[term].playlist->readSongs();
+        versions[term] = songs.getVersion();
+        if(terms[term].subtract){
+            for(const Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+                present[&curr->getValue()] = false;
+            }
+            continue;
+        }
+
+        visible[term].reserve(songs.getSize());
+        for(const Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+            const Song *song = &curr->getValue();
+            bool &inResult = present[song];
+            std::unordered_map<const Song*, size_t, SongHash, SongEqual>::const_iterator removal = removedBy.find(song);
+            // A primeira playlist mantém músicas repetidas, assim como Playlist::operator+;
+            // nas demais, só a primeira ocorrência de uma música ausente do resultado entra
+            bool shown = (term == 0 || !inResult) && (removal == removedBy.end() || removal->second < term);
+            visible[term].push_back(shown);
+            inResult = true;
+        }
+    }
+}
+
+/**
+ * @brief Avança até a primeira ocorrência visível a partir da posição recebida.
+ * Termos subtraídos são pulados, pois não fornecem músicas ao resultado.
+ *
+ * @param term Índice do termo atual, atualizado pela função.
+ * @param node Nó atual, atualizado pela função (nullptr indica o fim da visão).
+ * @param position Posição do nó atual na playlist do termo, atualizada pela função.
+ */
+void PlaylistView::seek(size_t &term, const Node<Song> *&node, size_t &position){
+    while(term < terms.size()){
+        if(!terms[term].subtract){
+            while(node != nullptr){
+                if(visible[term][position]){
+                    return;
+                }
+                node = node->getNext();
+                position++;
+            }
+        }
+        term++;
+        position = 0;
+        if(term < terms.size()){
+            node = terms[term].playlist->readSongs().getHead();
+        }
+    }
+    node = nullptr;
+}
+
+/**
+ * @brief Retorna o iterador para a primeira música da visão.
+ *
+ * @return Iterador para a primeira música.
+ */
+PlaylistView::Iterator PlaylistView::begin(){
+    refresh();
+    size_t term = 0;
+    size_t position = 0;
+    const Node<Song> *node = terms[0].playlist->readSongs().getHead();
+    seek(term, node, position);
+    return Iterator(this, term, node, position);
+}
+
+/**
+ * @brief Retorna o iterador que indica o fim da visão.
+ *
+ * @return Iterador de fim.
+ */
+PlaylistView::Iterator PlaylistView::end(){
+    return Iterator(this, terms.size(), nullptr);
+}
+
+/**
+ * @brief Retorna o número de músicas da visão.
+ * @note O tamanho é calculado percorrendo toda a visão, em tempo proporcional
+ * ao total de músicas das playlists.
+ *
+ * @return Número de músicas.
+ */
+size_t PlaylistView::getSize(){
+    size_t size = 0;
+    for(Iterator it = begin(); it != end(); ++it){
+        size++;
+    }
+    return size;
+}
+
+/**
+ * @brief Imprime as músicas da visão, uma por linha.
+ *
+ * @param os Fluxo que recebe as músicas.
+ */
+void PlaylistView::print(std::ostream &os){
+    ListPrinter out(os);
+    for(Iterator it = begin(); it != end(); ++it){
+        out.line(*it);
+    }
+}
+
+/**
+ * @brief Cria uma playlist com as músicas da visão.
+ *
+ * @param name Nome da nova playlist.
+ * @return A playlist materializada.
+ */
+Playlist PlaylistView::materialize(std::string name){
+    Playlist playlist(name);
+    std::vector<const Song*> songs;
+    for(Iterator it = begin(); it != end(); ++it){
+        songs.push_back(&*it);
+    }
+    playlist.addSongs(songs);
+    return playlist;
+}
+
+/**
+ * @brief Construtor do iterador.
+ *
+ * @param view Visão percorrida.
+ * @param term Índice do termo atual.
+ * @param node Nó atual, ou nullptr no fim da visão.
+ * @param position Posição do nó atual na playlist do termo.
+ */
+PlaylistView::Iterator::Iterator(PlaylistView *view, size_t term, const Node<Song> *node, size_t position){
+    this->view = view;
+    this->term = term;
+    this->node = node;
+    this->position = position;
+    if(node == nullptr){
+        this->term = view->terms.size();
+    }
+}
+
+/**
+ * @brief Retorna a música atual.
+ *
+ * @return Referência para a música.
+ */
+const Song &PlaylistView::Iterator::operator*(){
+    return node->getValue();
+}
+
+/**
+ * @brief Retorna um ponteiro para a música atual.
+ *
+ * @return Ponteiro para a música.
+ */
+const Song *PlaylistView::Iterator::operator->(){
+    return &(node->getValue());
+}
+
+/**
+ * @brief Avança para a próxima música da visão.
+ *
+ * @return Referência para o iterador.
+ */
+PlaylistView::Iterator &PlaylistView::Iterator::operator++(){
+    node = node->getNext();
+    position++;
+    view->seek(term, node, position);
+    if(node == nullptr){
+        term = view->terms.size();
+    }
+    return *this;
+}
+
+/**
+ * @brief Sobrecarga do operador de igualdade.
+ *
+ * @return Retorna true se os iteradores apontam para a mesma posição.
+ */
+bool PlaylistView::Iterator::operator==(const Iterator &b) const{
+    return view == b.view && term == b.term && node == b.node;
+}
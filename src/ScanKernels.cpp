@@ -0,0 +1,219 @@
+/**
+ * @file ScanKernels.cpp
+ * @brief Arquivo que implementa as funções de varredura vetorizada.
+ *
+ * Em processadores x86 são usadas instruções SSE2 e, quando disponíveis em
+ * tempo de execução, AVX2. Nos demais casos é usada a versão escalar.
+ */
+
+#include <cstring>
+#include <string>
+#include "ScanKernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Versão escalar de scanFind.
+ */
+static size_t scanFindScalar(const char *data, size_t size, const char *needle, size_t length){
+    if(length > size){
+        return SCAN_NOT_FOUND;
+    }
+    const char *last = data + size - length;
+    for(const char *p = data; p <= last; p++){
+        p = (const char*)std::memchr(p, needle[0], last - p + 1);
+        if(p == nullptr){
+            break;
+        }
+        if(std::memcmp(p + 1, needle + 1, length - 1) == 0){
+            return p - data;
+        }
+    }
+    return SCAN_NOT_FOUND;
+}
+
+/**
+ * @brief Versão escalar de scanHash.
+ */
+static size_t scanHashScalar(const uint64_t *hashes, size_t size, uint64_t hash){
+    for(size_t i = 0; i < size; i++){
+        if(hashes[i] == hash){
+            return i;
+        }
+    }
+    return SCAN_NOT_FOUND;
+}
+
+#ifdef SCAN_X86
+
+/**
+ * @brief Versão SSE2 de scanFind. Compara 16 posições de uma vez com o primeiro
+ * e o último byte da sequência, e só verifica o restante nas posições em que
+ * os dois coincidem.
+ */
+static size_t scanFindSse2(const char *data, size_t size, const char *needle, size_t length){
+    if(length > size){
+        return SCAN_NOT_FOUND;
+    }
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[length - 1]);
+
+    size_t i = 0;
+    for(; i + length - 1 + 16 <= size; i += 16){
+        __m128i blockFirst = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i blockLast = _mm_loadu_si128((const __m128i*)(data + i + length - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst),
+                                                        _mm_cmpeq_epi8(last, blockLast)));
+        while(mask != 0){
+            unsigned bit = __builtin_ctz(mask);
+            if(length <= 2 || std::memcmp(data + i + bit + 1, needle + 1, length - 2) == 0){
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    size_t rest = scanFindScalar(data + i, size - i, needle, length);
+    return rest == SCAN_NOT_FOUND ? rest : i + rest;
+}
+
+/**
+ * @brief Versão AVX2 de scanFind, que compara 32 posições de uma vez.
+ */
+__attribute__((target("avx2")))
+static size_t scanFindAvx2(const char *data, size_t size, const char *needle, size_t length){
+    if(length > size){
+        return SCAN_NOT_FOUND;
+    }
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[length - 1]);
+
+    size_t i = 0;
+    for(; i + length - 1 + 32 <= size; i += 32){
+        __m256i blockFirst = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i blockLast = _mm256_loadu_si256((const __m256i*)(data + i + length - 1));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst),
+                                                                        _mm256_cmpeq_epi8(last, blockLast)));
+        while(mask != 0){
+            unsigned bit = __builtin_ctz(mask);
+            if(length <= 2 || std::memcmp(data + i + bit + 1, needle + 1, length - 2) == 0){
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    size_t rest = scanFindSse2(data + i, size - i, needle, length);
+    return rest == SCAN_NOT_FOUND ? rest : i + rest;
+}
+
+/**
+ * @brief Versão SSE2 de scanHash. Como SSE2 não compara inteiros de 64 bits,
+ * as metades de 32 bits são comparadas e combinadas.
+ */
+static size_t scanHashSse2(const uint64_t *hashes, size_t size, uint64_t hash){
+    const __m128i target = _mm_set1_epi64x((long long)hash);
+
+    size_t i = 0;
+    for(; i + 2 <= size; i += 2){
+        __m128i eq32 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(hashes + i)), target);
+        __m128i eq64 = _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+        unsigned mask = _mm_movemask_pd(_mm_castsi128_pd(eq64));
+        if(mask != 0){
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    size_t rest = scanHashScalar(hashes + i, size - i, hash);
+    return rest == SCAN_NOT_FOUND ? rest : i + rest;
+}
+
+/**
+ * @brief Versão AVX2 de scanHash, que compara quatro hashes de uma vez.
+ */
+__attribute__((target("avx2")))
+static size_t scanHashAvx2(const uint64_t *hashes, size_t size, uint64_t hash){
+    const __m256i target = _mm256_set1_epi64x((long long)hash);
+
+    size_t i = 0;
+    for(; i + 4 <= size; i += 4){
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(hashes + i)), target);
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if(mask != 0){
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    size_t rest = scanHashScalar(hashes + i, size - i, hash);
+    return rest == SCAN_NOT_FOUND ? rest : i + rest;
+}
+
+/**
+ * @brief Verifica, uma única vez, se o processador suporta AVX2.
+ *
+ * @return Retorna true se as versões AVX2 podem ser usadas.
+ */
+static bool hasAvx2(){
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif
+
+/**
+ * @brief Procura uma sequência de bytes em um bloco de memória.
+ *
+ * @param data Início do bloco.
+ * @param size Tamanho do bloco em bytes.
+ * @param needle Sequência procurada.
+ * @param length Tamanho da sequência. Deve ser maior que zero.
+ * @return Posição da primeira ocorrência, ou SCAN_NOT_FOUND.
+ */
+size_t scanFind(const char *data, size_t size, const char *needle, size_t length){
+    if(length == 0){
+        return 0;
+    }
+#ifdef SCAN_X86
+    if(hasAvx2()){
+        return scanFindAvx2(data, size, needle, length);
+    }
+    return scanFindSse2(data, size, needle, length);
+#else
+    return scanFindScalar(data, size, needle, length);
+#endif
+}
+
+/**
+ * @brief Procura um valor em um vetor de hashes.
+ *
+ * @param hashes Início do vetor.
+ * @param size Número de hashes.
+ * @param hash Valor procurado.
+ * @return Índice da primeira ocorrência, ou SCAN_NOT_FOUND.
+ */
+size_t scanHash(const uint64_t *hashes, size_t size, uint64_t hash){
+#ifdef SCAN_X86
+    if(hasAvx2()){
+        return scanHashAvx2(hashes, size, hash);
+    }
+    return scanHashSse2(hashes, size, hash);
+#else
+    return scanHashScalar(hashes, size, hash);
+#endif
+}
+
+/**
+ * @brief Retorna o nome da implementação vetorizada em uso.
+ *
+ * @return "AVX2", "SSE2" ou "escalar".
+ */
+std::string scanImplementation(){
+#ifdef SCAN_X86
+    return hasAvx2() ? "AVX2" : "SSE2";
+#else
+    return "escalar";
+#endif
+}
@@ -0,0 +1,359 @@
+/**
+ * @file SearchIndex.cpp
+ * @brief Arquivo que implementa os métodos da classe SearchIndex.
+ */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "LinkedList.hpp"
+#include "ColumnarCatalog.hpp"
+#include "TextKey.hpp"
+#include "SearchIndex.hpp"
+
+/**
+ * @brief Verifica se um byte separa palavras. Bytes de caracteres UTF-8
+ * multibyte são considerados parte das palavras.
+ *
+ * @param c Byte a ser verificado.
+ * @return Retorna true se o byte é um separador.
+ */
+static bool isSeparator(unsigned char c){
+    return c < 0x80 && !std::isalnum(c);
+}
+
+/**
+ * @brief Retorna o trigrama que começa na posição especificada.
+ *
+ * @param key Texto normalizado.
+ * @param pos Posição do primeiro byte.
+ * @return Os três bytes agrupados em um inteiro.
+ */
+static uint32_t trigramAt(const std::string &key, size_t pos){
+    return (uint32_t)(unsigned char)key[pos] << 16 |
+           (uint32_t)(unsigned char)key[pos + 1] << 8 |
+           (uint32_t)(unsigned char)key[pos + 2];
+}
+
+/**
+ * @brief Adiciona ou remove uma música de uma lista de ocorrências.
+ *
+ * @param postings Lista de ocorrências.
+ * @param song Música.
+ * @param insert true para adicionar, false para remover.
+ */
+static void updatePostings(std::vector<Song*> &postings, Song *song, bool insert){
+    if(insert){
+        postings.push_back(song);
+        return;
+    }
+    auto it = std::find(postings.begin(), postings.end(), song);
+    if(it != postings.end()){
+        *it = postings.back();
+        postings.pop_back();
+    }
+}
+
+/**
+ * @brief Construtor do índice vazio.
+ */
+SearchIndex::SearchIndex(){
+    columnsStale = false;
+}
+
+/**
+ * @brief Normaliza um texto para comparação nas buscas, da mesma forma que as
+ * chaves das músicas (sem acentos e em minúsculas).
+ *
+ * @param text Texto original.
+ * @return Texto normalizado.
+ */
+std::string SearchIndex::normalize(const std::string &text){
+    return foldText(text);
+}
+
+/**
+ * @brief Adiciona ou remove um campo de uma música nos índices de palavras e trigramas.
+ *
+ * @param key Campo normalizado.
+ * @param song Música.
+ * @param insert true para adicionar, false para remover.
+ * @param words Índice do início das palavras do campo.
+ * @param trigrams Índice de trigramas do campo.
+ */
+void SearchIndex::indexField(const std::string &key, Song *song, bool insert,
+                             std::map<std::string, std::vector<Song*>> &words,
+                             std::unordered_map<uint32_t, std::vector<Song*>> &trigrams){
+    for(size_t i = 0; i < key.size(); i++){
+        bool wordStart = !isSeparator(key[i]) && (i == 0 || isSeparator(key[i - 1]));
+        if(wordStart){
+            std::string suffix = key.substr(i);
+            updatePostings(words[suffix], song, insert);
+            if(!insert && words[suffix].empty()){
+                words.erase(suffix);
+            }
+        }
+    }
+
+    // Cada trigrama é registrado uma única vez por música
+    std::vector<uint32_t> grams;
+    for(size_t i = 0; i + 3 <= key.size(); i++){
+        grams.push_back(trigramAt(key, i));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    for(size_t i = 0; i < grams.size(); i++){
+        std::vector<Song*> &postings = trigrams[grams[i]];
+        updatePostings(postings, song, insert);
+        if(!insert && postings.empty()){
+            trigrams.erase(grams[i]);
+        }
+    }
+}
+
+/**
+ * @brief Adiciona uma música ao índice. Músicas já indexadas são ignoradas.
+ *
+ * @param song Ponteiro para a música no catálogo.
+ */
+void SearchIndex::add(Song *song){
+    if(song == nullptr || entries.count(song) > 0){
+        return;
+    }
+    Entry &entry = entries[song];
+    entry.title = song->getTitleKey().str();
+    entry.author = song->getAuthorKey().str();
+
+    indexField(entry.title, song, true, titleWords, titleTrigrams);
+    indexField(entry.author, song, true, authorWords, authorTrigrams);
+    identities.insert(song);
+    if(!columnsStale){
+        columns.append(song, entry.title, entry.author);
+    }
+}
+
+/**
+ * @brief Remove uma música do índice.
+ *
+ * @param song Ponteiro para a música no catálogo.
+ */
+void SearchIndex::remove(Song *song){
+    auto it = entries.find(song);
+    if(it == entries.end()){
+        return;
+    }
+    indexField(it->second.title, song, false, titleWords, titleTrigrams);
+    indexField(it->second.author, song, false, authorWords, authorTrigrams);
+    auto same = identities.find(song);
+    if(same != identities.end() && *same == song){
+        identities.erase(same);
+    }
+    entries.erase(it);
+    columnsStale = true;
+}
+
+/**
+ * @brief Remove todas as músicas do índice.
+ */
+void SearchIndex::clear(){
+    entries.clear();
+    identities.clear();
+    titleWords.clear();
+    authorWords.clear();
+    titleTrigrams.clear();
+    authorTrigrams.clear();
+    columns.clear();
+    columnsStale = false;
+}
+
+/**
+ * @brief Reconstrói a cópia em colunas a partir das músicas indexadas, caso
+ * alguma música tenha sido removida desde a última reconstrução.
+ */
+void SearchIndex::refreshColumns(){
+    if(!columnsStale){
+        return;
+    }
+    columns.clear();
+    for(auto it = entries.begin(); it != entries.end(); ++it){
+        columns.append(it->first, it->second.title, it->second.author);
+    }
+    columnsStale = false;
+}
+
+/**
+ * @brief Reconstrói o índice a partir de todas as músicas do catálogo.
+ *
+ * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
+ */
+void SearchIndex::rebuild(LinkedList<Song> &songs){
+    clear();
+    Node<Song> *curr = songs.getHead();
+    while(curr != nullptr){
+        add(&(curr->getValue()));
+        curr = curr->getNext();
+    }
+}
+
+/**
+ * @brief Retorna o número de músicas indexadas.
+ *
+ * @return Número de músicas.
+ */
+size_t SearchIndex::getSize() const{
+    return entries.size();
+}
+
+/**
+ * @brief Estima a memória ocupada pelo índice, sem contar as músicas: as
+ * tabelas (cada elemento com o ponteiro para o próximo e o hash guardado, e
+ * um ponteiro por balde), os mapas de palavras (três ponteiros e a cor por
+ * nó), os textos alocados das chaves, os vetores pela capacidade e a cópia em
+ * colunas.
+ *
+ * @return Número estimado de bytes.
+ */
+size_t SearchIndex::getBytes() const{
+    const size_t hashed = 2 * sizeof(void*);
+    const size_t sorted = 4 * sizeof(void*);
+    size_t bytes = entries.bucket_count() * sizeof(void*) +
+                   entries.size() * (sizeof(std::pair<Song* const, Entry>) + hashed);
+    for(auto it = entries.begin(); it != entries.end(); ++it){
+        bytes += heapBytes(it->second.title) + heapBytes(it->second.author);
+    }
+    bytes += identities.bucket_count() * sizeof(void*) + identities.size() * (sizeof(Song*) + hashed);
+
+    const std::map<std::string, std::vector<Song*>> *words[] = {&titleWords, &authorWords};
+    const std::unordered_map<uint32_t, std::vector<Song*>> *trigrams[] = {&titleTrigrams, &authorTrigrams};
+    for(size_t i = 0; i < 2; i++){
+        for(auto it = words[i]->begin(); it != words[i]->end(); ++it){
+            bytes += sizeof(*it) + sorted + heapBytes(it->first) + it->second.capacity() * sizeof(Song*);
+        }
+        bytes += trigrams[i]->bucket_count() * sizeof(void*);
+        for(auto it = trigrams[i]->begin(); it != trigrams[i]->end(); ++it){
+            bytes += sizeof(*it) + hashed + it->second.capacity() * sizeof(Song*);
+        }
+    }
+    return bytes + columns.getBytes();
+}
+
+/**
+ * @brief Procura a música do catálogo com a mesma identidade (título e autor)
+ * de uma música, sem percorrer o catálogo.
+ *
+ * @param song Música procurada.
+ * @return Ponteiro para a música no catálogo, ou nullptr se ela não está indexada.
+ */
+Song *SearchIndex::find(const Song &song) const{
+    auto it = identities.find(const_cast<Song*>(&song));
+    return (it != identities.end()) ? *it : nullptr;
+}
+
+/**
+ * @brief Busca as músicas com alguma palavra do campo começando com a consulta.
+ *
+ * @param query Consulta normalizada.
+ * @param words Índice do início das palavras do campo.
+ * @param result Vetor que recebe as músicas encontradas.
+ */
+void SearchIndex::searchPrefix(const std::string &query, std::map<std::string, std::vector<Song*>> &words,
+                               std::vector<Song*> &result){
+    auto it = words.lower_bound(query);
+    while(it != words.end() && it->first.compare(0, query.size(), query) == 0){
+        result.insert(result.end(), it->second.begin(), it->second.end());
+        ++it;
+    }
+}
+
+/**
+ * @brief Busca as músicas cujo campo contém a consulta.
+ *
+ * Consultas com pelo menos três bytes verificam apenas as músicas do trigrama
+ * menos frequente da consulta. Consultas menores percorrem a cópia em colunas.
+ *
+ * @param query Consulta normalizada.
+ * @param author true para buscar no autor, false para buscar no título.
+ * @param trigrams Índice de trigramas do campo.
+ * @param result Vetor que recebe as músicas encontradas.
+ */
+void SearchIndex::searchSubstring(const std::string &query, bool author,
+                                  std::unordered_map<uint32_t, std::vector<Song*>> &trigrams,
+                                  std::vector<Song*> &result){
+    if(query.size() < 3){
+        refreshColumns();
+        columns.findSubstring(query, author ? ColumnarCatalog::Author : ColumnarCatalog::Title, result);
+        return;
+    }
+
+    const std::vector<Song*> *candidates = nullptr;
+    for(size_t i = 0; i + 3 <= query.size(); i++){
+        auto it = trigrams.find(trigramAt(query, i));
+        if(it == trigrams.end()){
+            return;
+        }
+        if(candidates == nullptr || it->second.size() < candidates->size()){
+            candidates = &(it->second);
+        }
+    }
+
+    for(size_t i = 0; i < candidates->size(); i++){
+        Entry &entry = entries[(*candidates)[i]];
+        const std::string &key = author ? entry.author : entry.title;
+        if(key.find(query) != std::string::npos){
+            result.push_back((*candidates)[i]);
+        }
+    }
+}
+
+/**
+ * @brief Busca músicas no índice e retorna uma página do resultado.
+ *
+ * O resultado completo é ordenado por título e autor, então páginas
+ * consecutivas não repetem nem pulam músicas enquanto o catálogo não mudar.
+ *
+ * @param query Texto buscado. Letras maiúsculas e minúsculas são equivalentes.
+ * @param field Campo em que a busca é feita.
+ * @param mode Tipo de busca.
+ * @param offset Posição da primeira música da página.
+ * @param limit Número máximo de músicas na página.
+ * @return Página com as músicas encontradas e o total do resultado.
+ */
+SearchPage SearchIndex::search(const std::string &query, Field field, Mode mode, size_t offset, size_t limit){
+    std::string key = normalize(query);
+    std::vector<Song*> matches;
+
+    if(field != Author){
+        if(mode == Prefix) searchPrefix(key, titleWords, matches);
+        else if(mode == Substring) searchSubstring(key, false, titleTrigrams, matches);
+    }
+    if(field != Title){
+        if(mode == Prefix) searchPrefix(key, authorWords, matches);
+        else if(mode == Substring) searchSubstring(key, true, authorTrigrams, matches);
+    }
+    if(mode == Exact){
+        refreshColumns();
+        if(field != Author) columns.findEqual(key, ColumnarCatalog::Title, matches);
+        if(field != Title) columns.findEqual(key, ColumnarCatalog::Author, matches);
+    }
+
+    std::sort(matches.begin(), matches.end(), [this](Song *a, Song *b){
+        const Entry &ea = entries.at(a);
+        const Entry &eb = entries.at(b);
+        if(ea.title != eb.title) return ea.title < eb.title;
+        if(ea.author != eb.author) return ea.author < eb.author;
+        return a < b;
+    });
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    SearchPage page;
+    page.total = matches.size();
+    page.offset = std::min(offset, matches.size());
+    size_t last = std::min(matches.size(), page.offset + limit);
+    page.songs.assign(matches.begin() + page.offset, matches.begin() + last);
+    return page;
+}
@@ -0,0 +1,813 @@
+/**
+ * @file Server.cpp
+ * @brief Arquivo que implementa os métodos da classe Server.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "TextView.hpp"
+#include "Playlist.hpp"
+#include "SearchIndex.hpp"
+#include "SmartPlaylists.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+#include "Transaction.hpp"
+#include "PlaylistAggregator.hpp"
+#include "Server.hpp"
+
+//! Número mínimo de itens dos resumos usados por TOP_SONGS e TOP_AUTHORS com APPROX.
+static const size_t minSketchCapacity = 1024;
+
+//! Tamanho máximo de uma requisição, em bytes.
+static const size_t maxRequestSize = 64 * 1024;
+//! Quantidade de respostas pendentes a partir da qual a conexão deixa de ser lida.
+static const size_t maxPendingOutput = 1024 * 1024;
+//! Intervalo, em milissegundos, entre tentativas de aceitar conexões depois de atingir o limite de descritores.
+static const int acceptRetryMilliseconds = 100;
+
+/**
+ * @brief Aumenta o limite de descritores abertos até o máximo permitido, para
+ * que o servidor aceite milhares de conexões.
+ */
+static void raiseFileLimit(){
+    struct rlimit limit;
+    if(getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max){
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+/**
+ * @brief Separa os campos de uma requisição.
+ *
+ * @param line Requisição, sem o '\n' final.
+ * @return Campos separados por tabulação.
+ */
+static std::vector<std::string> splitFields(const std::string &line){
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while(true){
+        size_t end = line.find('\t', start);
+        if(end == std::string::npos){
+            fields.push_back(line.substr(start));
+            return fields;
+        }
+        fields.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+/**
+ * @brief Acrescenta uma música ao corpo de uma resposta.
+ *
+ * @param body Corpo da resposta.
+ * @param song Música.
+ */
+static void appendSong(std::string &body, const Song &song){
+    TextView title = song.getTitleView();
+    TextView author = song.getAuthorView();
+    body.append(title.data(), title.size());
+    body += '\t';
+    body.append(author.data(), author.size());
+    body += '\n';
+}
+
+/**
+ * @brief Acrescenta uma resposta de sucesso.
+ *
+ * @param response Respostas da conexão.
+ * @param count Número de linhas do corpo.
+ * @param body Corpo da resposta.
+ */
+static void reply(std::string &response, size_t count, const std::string &body){
+    response += "OK ";
+    response += std::to_string(count);
+    response += '\n';
+    response += body;
+}
+
+/**
+ * @brief Acrescenta uma resposta de erro.
+ *
+ * @param response Respostas da conexão.
+ * @param message Mensagem de erro.
+ */
+static void fail(std::string &response, const std::string &message){
+    response += "ERR ";
+    response += message;
+    response += '\n';
+}
+
+/**
+ * @brief Lê um número inteiro não negativo de um campo.
+ *
+ * @param text Campo.
+ * @param value Variável que recebe o número.
+ * @return Retorna true se o campo é um número válido.
+ */
+static bool parseNumber(const std::string &text, size_t &value){
+    if(text.empty() || text.find_first_not_of("0123456789") != std::string::npos){
+        return false;
+    }
+    value = std::strtoul(text.c_str(), nullptr, 10);
+    return true;
+}
+
+/**
+ * @brief Guarda em uma transação uma requisição de alteração de playlists,
+ * em vez de aplicá-la.
+ *
+ * @param transaction Transação aberta pela conexão.
+ * @param fields Campos da requisição.
+ * @return Retorna true se a requisição é uma alteração que pode ser guardada.
+ */
+static bool stageRequest(Transaction &transaction, const std::vector<std::string> &fields){
+    const std::string &command = fields[0];
+    if(command == "ADD_PLAYLIST" && fields.size() == 2 && !fields[1].empty()){
+        transaction.createPlaylist(fields[1]);
+    }
+    else if(command == "REMOVE_PLAYLIST" && fields.size() == 2){
+        transaction.removePlaylist(fields[1]);
+    }
+    else if(command == "ADD_TO_PLAYLIST" && fields.size() == 4){
+        transaction.addSong(fields[1], Song(fields[2], fields[3]));
+    }
+    else if(command == "REMOVE_FROM_PLAYLIST" && fields.size() == 4){
+        transaction.removeSong(fields[1], Song(fields[2], fields[3]));
+    }
+    else if(command == "MERGE_PLAYLIST" && fields.size() == 3){
+        transaction.merge(fields[1], fields[2]);
+    }
+    else{
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Construtor do servidor. O socket só é criado por start.
+ *
+ * @param library Biblioteca atendida.
+ * @param path Caminho do socket Unix.
+ */
+Server::Server(Library &library, const std::string &path) : library(library), path(path){
+    listenFd = -1;
+    epollFd = -1;
+    stopFd = -1;
+    accepting = false;
+    requests = 0;
+}
+
+/**
+ * @brief Destrutor do servidor, que fecha todas as conexões e remove o socket.
+ */
+Server::~Server(){
+    while(!connections.empty()){
+        closeConnection(connections.begin()->first);
+    }
+    if(listenFd != -1){
+        close(listenFd);
+        unlink(path.c_str());
+    }
+    if(stopFd != -1){
+        close(stopFd);
+    }
+    if(epollFd != -1){
+        close(epollFd);
+    }
+}
+
+/**
+ * @brief Cria o socket e começa a aceitar conexões. Um socket antigo no mesmo
+ * caminho é substituído.
+ *
+ * @return Retorna true se o servidor está pronto para executar run.
+ */
+bool Server::start(){
+    struct sockaddr_un address;
+    if(path.size() >= sizeof(address.sun_path)){
+        std::cerr << "Erro: Caminho do socket muito longo.\n";
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    struct stat info;
+    if(lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)){
+        unlink(path.c_str());
+    }
+
+    raiseFileLimit();
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listenFd == -1 || bind(listenFd, (struct sockaddr*)&address, sizeof(address)) == -1 ||
+       listen(listenFd, SOMAXCONN) == -1){
+        std::cerr << "Erro: Não foi possível abrir o socket \"" << path << "\": " << std::strerror(errno) << "\n";
+        if(listenFd != -1){
+            close(listenFd);
+            listenFd = -1;
+        }
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(epollFd == -1 || stopFd == -1){
+        std::cerr << "Erro: Não foi possível criar o laço de eventos: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = stopFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event);
+    accepting = true;
+    return true;
+}
+
+/**
+ * @brief Executa o laço de eventos até que stop seja chamado.
+ *
+ * Enquanto o limite de descritores impede novas conexões, o socket que as
+ * aceita não é observado; o laço tenta aceitá-las de novo quando uma conexão
+ * é fechada ou, se nenhuma for, a cada acceptRetryMilliseconds.
+ */
+void Server::run(){
+    const int maxEvents = 256;
+    struct epoll_event events[maxEvents];
+    bool running = true;
+
+    while(running){
+        int count = epoll_wait(epollFd, events, maxEvents, accepting ? -1 : acceptRetryMilliseconds);
+        if(count == -1){
+            if(errno == EINTR){
+                continue;
+            }
+            std::cerr << "Erro: Falha no laço de eventos: " << std::strerror(errno) << "\n";
+            return;
+        }
+        bool released = false;
+        for(int i = 0; i < count; i++){
+            int fd = events[i].data.fd;
+            if(fd == stopFd){
+                running = false;
+                continue;
+            }
+            if(fd == listenFd){
+                acceptConnections();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if(it == connections.end()){
+                continue;
+            }
+            bool open = true;
+            if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)){
+                open = receive(fd, it->second);
+            }
+            if(open && (events[i].events & EPOLLOUT)){
+                open = send(fd, it->second) && process(fd, it->second);
+            }
+            // O cliente encerrou o envio: fecha assim que as respostas forem enviadas
+            if(open && it->second.inputClosed && it->second.written == it->second.output.size()){
+                open = false;
+            }
+            if(!open){
+                closeConnection(fd);
+                released = true;
+            }
+        }
+        if(!accepting && (count == 0 || released)){
+            acceptConnections();
+        }
+    }
+}
+
+/**
+ * @brief Interrompe o laço de eventos. Usa apenas uma escrita no descritor de
+ * parada, então pode ser chamado de outra thread ou de um tratador de sinal.
+ */
+void Server::stop(){
+    uint64_t one = 1;
+    if(write(stopFd, &one, sizeof(one)) == -1){
+        // O descritor já tem um aviso pendente
+    }
+}
+
+/**
+ * @brief Retorna o número de requisições atendidas desde o início.
+ *
+ * @return Número de requisições.
+ */
+unsigned long long Server::getRequests() const{
+    return requests;
+}
+
+/**
+ * @brief Aceita todas as conexões pendentes e as registra no epoll.
+ *
+ * Se o limite de descritores foi atingido, as conexões pendentes continuam na
+ * fila do socket e ele deixa de ser observado, pois continuaria pronto para
+ * leitura e o laço de eventos não faria outra coisa. O socket volta a ser
+ * observado quando a fila esvaziar (ver run).
+ */
+void Server::acceptConnections(){
+    while(true){
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd == -1){
+            if(errno == EMFILE || errno == ENFILE){
+                if(accepting){
+                    std::cerr << "Aviso: Limite de conexões atingido.\n";
+                }
+                setAccepting(false);
+            }
+            else{
+                setAccepting(true);
+            }
+            return;
+        }
+
+        Connection &connection = connections[fd];
+        connection.written = 0;
+        connection.events = EPOLLIN;
+        connection.inputClosed = false;
+        connection.transactionOpen = false;
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+/**
+ * @brief Registra no epoll, ou remove dele, o socket que aceita conexões.
+ *
+ * @param accepting Indica se novas conexões devem ser aceitas.
+ */
+void Server::setAccepting(bool accepting){
+    if(accepting == this->accepting){
+        return;
+    }
+    if(accepting){
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    }
+    else{
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+    }
+    this->accepting = accepting;
+}
+
+/**
+ * @brief Lê os bytes disponíveis em uma conexão e atende as requisições completas.
+ *
+ * @param fd Descritor da conexão.
+ * @param connection Estado da conexão.
+ * @return Retorna false se a conexão deve ser fechada.
+ */
+bool Server::receive(int fd, Connection &connection){
+    char buffer[16 * 1024];
+
+    while(!connection.inputClosed){
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if(count > 0){
+            connection.input.append(buffer, count);
+            if(count < (ssize_t)sizeof(buffer)){
+                break;
+            }
+        }
+        else if(count == 0){
+            // Deixa de ler: o fim do envio continuaria sendo avisado pelo epoll
+            connection.inputClosed = true;
+            break;
+        }
+        else if(errno == EINTR){
+            continue;
+        }
+        else if(errno == EAGAIN || errno == EWOULDBLOCK){
+            break;
+        }
+        else{
+            return false;
+        }
+    }
+
+    return process(fd, connection);
+}
+
+/**
+ * @brief Atende, em ordem, as requisições completas recebidas de uma conexão,
+ * enquanto as respostas pendentes não passarem do limite, e envia as respostas.
+ * Se o envio abrir espaço, continua com as requisições que ficaram esperando,
+ * pois elas já foram lidas e nenhum evento do epoll avisaria delas.
+ *
+ * @param fd Descritor da conexão.
+ * @param connection Estado da conexão.
+ * @return Retorna false se a conexão deve ser fechada.
+ */
+bool Server::process(int fd, Connection &connection){
+    while(true){
+        size_t start = 0;
+        while(connection.output.size() - connection.written < maxPendingOutput){
+            size_t end = connection.input.find('\n', start);
+            if(end == std::string::npos){
+                break;
+            }
+            size_t length = end - start;
+            if(length > 0 && connection.input[end - 1] == '\r'){
+                length--;
+            }
+            handle(connection, connection.input.substr(start, length), connection.output);
+            requests++;
+            start = end + 1;
+        }
+        connection.input.erase(0, start);
+
+        if(connection.input.size() > maxRequestSize && connection.input.find('\n') == std::string::npos){
+            return false;
+        }
+        if(!send(fd, connection)){
+            return false;
+        }
+        if(connection.output.size() - connection.written >= maxPendingOutput ||
+           connection.input.find('\n') == std::string::npos){
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Envia o máximo possível das respostas pendentes de uma conexão.
+ *
+ * @param fd Descritor da conexão.
+ * @param connection Estado da conexão.
+ * @return Retorna false se a conexão deve ser fechada.
+ */
+bool Server::send(int fd, Connection &connection){
+    while(connection.written < connection.output.size()){
+        ssize_t count = ::send(fd, connection.output.data() + connection.written,
+                               connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if(count > 0){
+            connection.written += count;
+        }
+        else if(count == -1 && errno == EINTR){
+            continue;
+        }
+        else if(count == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            break;
+        }
+        else{
+            return false;
+        }
+    }
+
+    if(connection.written == connection.output.size()){
+        connection.output.clear();
+        connection.written = 0;
+    }
+    watch(fd, connection);
+    return true;
+}
+
+/**
+ * @brief Atualiza os eventos registrados no epoll para uma conexão: espera poder
+ * escrever enquanto houver respostas pendentes, e deixa de ler enquanto elas
+ * passarem do limite ou depois que o cliente encerrar o envio.
+ *
+ * @param fd Descritor da conexão.
+ * @param connection Estado da conexão.
+ */
+void Server::watch(int fd, Connection &connection){
+    size_t pending = connection.output.size() - connection.written;
+    uint32_t events = 0;
+    if(pending < maxPendingOutput && !connection.inputClosed){
+        events |= EPOLLIN;
+    }
+    if(pending > 0){
+        events |= EPOLLOUT;
+    }
+    if(events != connection.events){
+        struct epoll_event event;
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+        connection.events = events;
+    }
+}
+
+/**
+ * @brief Fecha uma conexão e descarta seu estado.
+ *
+ * @param fd Descritor da conexão.
+ */
+void Server::closeConnection(int fd){
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
+
+/**
+ * @brief Atende uma requisição e acrescenta a resposta às respostas da conexão.
+ *
+ * As consultas de listas usam a versão publicada da biblioteca e as buscas
+ * usam o índice por Library::search, sem publicar uma nova versão. As
+ * alterações obtêm um Library::Editor e procuram as músicas do catálogo pelo
+ * índice. Entre BEGIN e COMMIT, as alterações de playlists são guardadas na
+ * transação da conexão e só são conferidas e aplicadas no COMMIT.
+ *
+ * @param connection Conexão que enviou a requisição.
+ * @param request Requisição, sem o '\n' final.
+ * @param response Respostas da conexão.
+ */
+void Server::handle(Connection &connection, const std::string &request, std::string &response){
+    std::vector<std::string> fields = splitFields(request);
+    const std::string &command = fields[0];
+    std::string body;
+
+    if(connection.transactionOpen && stageRequest(connection.transaction, fields)){
+        reply(response, 0, body);
+    }
+    else if(command == "PING" && fields.size() == 1){
+        reply(response, 0, body);
+    }
+    else if(command == "BEGIN" && fields.size() == 1){
+        if(connection.transactionOpen){
+            fail(response, "transação já aberta");
+            return;
+        }
+        connection.transactionOpen = true;
+        reply(response, 0, body);
+    }
+    else if((command == "COMMIT" || command == "ABORT") && fields.size() == 1){
+        if(!connection.transactionOpen){
+            fail(response, "nenhuma transação aberta");
+            return;
+        }
+        connection.transactionOpen = false;
+        std::string error;
+        size_t count = connection.transaction.getSize();
+        bool applied = command == "ABORT" || connection.transaction.commit(library, error);
+        connection.transaction.clear();
+        if(!applied){
+            fail(response, error);
+            return;
+        }
+        body += std::to_string(command == "ABORT" ? 0 : count);
+        body += '\n';
+        reply(response, 1, body);
+    }
+    else if(command == "MERGE_PLAYLIST" && fields.size() == 3){
+        Transaction transaction;
+        transaction.merge(fields[1], fields[2]);
+        std::string error;
+        if(!transaction.commit(library, error)){
+            fail(response, "playlist inválida");
+            return;
+        }
+        reply(response, 0, body);
+    }
+    else if(command == "LIST_PLAYLISTS" && fields.size() == 1){
+        std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+        for(size_t i = 0; i < snapshot->playlists.size(); i++){
+            body += snapshot->playlists[i]->getName();
+            body += '\n';
+        }
+        reply(response, snapshot->playlists.size(), body);
+    }
+    else if(command == "LIST_SONGS" && fields.size() <= 2){
+        std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+        // O catálogo é publicado em partes; uma playlist é uma parte só
+        std::vector<const LinkedList<Song>*> parts;
+        for(size_t i = 0; i < snapshot->songs.size(); i++){
+            parts.push_back(snapshot->songs[i].get());
+        }
+        if(fields.size() == 2){
+            const Playlist *pl = snapshot->findPlaylist(fields[1]);
+            if(pl == nullptr){
+                fail(response, "playlist inválida");
+                return;
+            }
+            parts.assign(1, &pl->readSongs());
+        }
+        size_t count = 0;
+        for(size_t i = 0; i < parts.size(); i++){
+            for(const Node<Song> *curr = parts[i]->getHead(); curr != nullptr; curr = curr->getNext()){
+                appendSong(body, curr->getValue());
+                count++;
+            }
+        }
+        reply(response, count, body);
+    }
+    else if(command == "ADD_PLAYLIST" && fields.size() == 2 && !fields[1].empty()){
+        Library::Editor editor(library);
+        if(editor.findPlaylist(fields[1]) != nullptr){
+            fail(response, "playlist já existe");
+            return;
+        }
+        EditHistory::Batch batch(&editor.history(), "Adicionar a playlist " + fields[1]);
+        unsigned long long prior = editor.playlists().getVersion();
+        Node<Playlist> *lastKnown = editor.playlists().getTail();
+        editor.playlists().add(Playlist(fields[1]));
+        editor.history().playlistsAppended(prior, lastKnown);
+        reply(response, 0, body);
+    }
+    else if(command == "REMOVE_PLAYLIST" && fields.size() == 2){
+        Library::Editor editor(library);
+        if(editor.findPlaylist(fields[1]) == nullptr){
+            fail(response, "playlist inválida");
+            return;
+        }
+        EditHistory::Batch batch(&editor.history(), "Remover a playlist " + fields[1]);
+        editor.history().removePlaylist(fields[1]);
+        reply(response, 0, body);
+    }
+    else if(command == "ADD_SONG" && fields.size() == 3 && !fields[1].empty()){
+        Library::Editor editor(library);
+        Song song(fields[1], fields[2]);
+        if(editor.index().find(song) != nullptr){
+            fail(response, "música já existe");
+            return;
+        }
+        EditHistory::Batch batch(&editor.history(), "Adicionar a música " + fields[1]);
+        unsigned long long prior = editor.songs().getVersion();
+        Node<Song> *lastKnown = editor.songs().getTail();
+        editor.songs().add(song);
+        editor.index().add(&(editor.songs().getTail()->getValue()));
+        editor.smartPlaylists().added(editor.songs(), prior, editor.songs().getTail()->getValue());
+        editor.history().catalogAppended(prior, lastKnown);
+        reply(response, 0, body);
+    }
+    else if(command == "REMOVE_SONG" && fields.size() == 3){
+        Library::Editor editor(library);
+        Song *found = editor.index().find(Song(fields[1], fields[2]));
+        if(found == nullptr){
+            fail(response, "música inválida");
+            return;
+        }
+        EditHistory::Batch batch(&editor.history(), "Remover a música " + fields[1]);
+        Song song = *found;
+        editor.index().remove(found);
+        unsigned long long prior = editor.songs().getVersion();
+        editor.history().removeFromCatalog(song);
+        editor.smartPlaylists().removed(editor.songs(), prior, song);
+        for(Node<Playlist> *curr = editor.playlists().getHead(); curr != nullptr; curr = curr->getNext()){
+            curr->getValue().removeSong(song);
+        }
+        reply(response, 0, body);
+    }
+    else if((command == "ADD_TO_PLAYLIST" || command == "REMOVE_FROM_PLAYLIST") && fields.size() == 4){
+        Library::Editor editor(library);
+        Playlist *pl = editor.findPlaylist(fields[1]);
+        if(pl == nullptr){
+            fail(response, "playlist inválida");
+            return;
+        }
+        Song song(fields[2], fields[3]);
+        if(command == "ADD_TO_PLAYLIST"){
+            Song *found = editor.index().find(song);
+            if(found == nullptr){
+                fail(response, "música inválida");
+                return;
+            }
+            if(pl->searchSong(*found) != nullptr){
+                fail(response, "música já está na playlist");
+                return;
+            }
+            pl->addSong(*found);
+        }
+        else{
+            if(pl->searchSong(song) == nullptr){
+                fail(response, "música não está na playlist");
+                return;
+            }
+            pl->removeSong(song);
+        }
+        reply(response, 0, body);
+    }
+    else if((command == "UNDO" || command == "REDO") && fields.size() == 1){
+        std::string label;
+        EditHistory::Result result;
+        {
+            Library::Editor editor(library);
+            result = (command == "UNDO") ? editor.history().undo(label) : editor.history().redo(label);
+        }
+        if(result == EditHistory::Nothing){
+            fail(response, command == "UNDO" ? "nada para desfazer" : "nada para refazer");
+            return;
+        }
+        if(result == EditHistory::Conflict){
+            fail(response, "histórico descartado: as listas mudaram sem registro");
+            return;
+        }
+        body += label;
+        body += '\n';
+        reply(response, 1, body);
+    }
+    else if(command == "SEARCH" && fields.size() == 6){
+        SearchIndex::Field field;
+        SearchIndex::Mode mode;
+        size_t offset, limit;
+
+        if(fields[1] == "TITLE") field = SearchIndex::Title;
+        else if(fields[1] == "AUTHOR") field = SearchIndex::Author;
+        else if(fields[1] == "ANY") field = SearchIndex::Any;
+        else{
+            fail(response, "campo inválido");
+            return;
+        }
+        if(fields[2] == "PREFIX") mode = SearchIndex::Prefix;
+        else if(fields[2] == "SUBSTRING") mode = SearchIndex::Substring;
+        else if(fields[2] == "EXACT") mode = SearchIndex::Exact;
+        else{
+            fail(response, "modo inválido");
+            return;
+        }
+        if(!parseNumber(fields[3], offset) || !parseNumber(fields[4], limit)){
+            fail(response, "número inválido");
+            return;
+        }
+
+        std::vector<Song> found;
+        size_t total = library.search(fields[5], field, mode, offset, limit, found);
+        body += std::to_string(total);
+        body += '\n';
+        for(size_t i = 0; i < found.size(); i++){
+            appendSong(body, found[i]);
+        }
+        reply(response, found.size() + 1, body);
+    }
+    else if((command == "TOP_SONGS" || command == "TOP_AUTHORS") && (fields.size() == 2 || fields.size() == 3)){
+        size_t k;
+        if(!parseNumber(fields[1], k)){
+            fail(response, "número inválido");
+            return;
+        }
+        if(fields.size() == 3 && fields[2] != "APPROX"){
+            fail(response, "modo inválido");
+            return;
+        }
+
+        std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+        PlaylistAggregator aggregator(snapshot->playlists);
+        PlaylistAggregator::Subject subject = command == "TOP_SONGS" ? PlaylistAggregator::Songs : PlaylistAggregator::Authors;
+        std::vector<PlaylistAggregator::Ranked> ranked;
+        if(fields.size() == 3){
+            aggregator.approximateTop(subject, k, std::max(minSketchCapacity, 16 * k), ranked);
+        }
+        else{
+            aggregator.top(subject, k, ranked);
+        }
+        for(size_t i = 0; i < ranked.size(); i++){
+            body += std::to_string(ranked[i].count);
+            body += '\t';
+            if(subject == PlaylistAggregator::Songs){
+                body += ranked[i].title;
+                body += '\t';
+            }
+            body += ranked[i].author;
+            body += '\n';
+        }
+        reply(response, ranked.size(), body);
+    }
+    else if(command == "SIZE_HISTOGRAM" && fields.size() == 1){
+        std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+        PlaylistAggregator aggregator(snapshot->playlists);
+        std::vector<PlaylistAggregator::SizeBucket> sizes;
+        aggregator.sizeHistogram(sizes);
+        for(size_t i = 0; i < sizes.size(); i++){
+            body += std::to_string(sizes[i].low);
+            body += '\t';
+            body += std::to_string(sizes[i].high);
+            body += '\t';
+            body += std::to_string(sizes[i].playlists);
+            body += '\n';
+        }
+        reply(response, sizes.size(), body);
+    }
+    else{
+        fail(response, "requisição inválida");
+    }
+}
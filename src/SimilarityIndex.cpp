@@ -0,0 +1,361 @@
+/**
+ * @file SimilarityIndex.cpp
+ * @brief Arquivo que implementa os métodos da classe SimilarityIndex.
+ */
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <unordered_set>
+#include "LinkedList.hpp"
+#include "Playlist.hpp"
+#include "PlaylistSignature.hpp"
+#include "SimilarityIndex.hpp"
+
+const size_t SimilarityIndex::rows;
+const size_t SimilarityIndex::bands;
+
+//! Número de baldes que cada thread pega por vez em findDuplicates.
+static const size_t bucketsPerTask = 256;
+
+/**
+ * @brief Ordena os resultados da maior para a menor semelhança, e pelo nome
+ * nos empates.
+ */
+static bool moreSimilar(const SimilarityIndex::Match &a, const SimilarityIndex::Match &b){
+    if(a.similarity != b.similarity){
+        return a.similarity > b.similarity;
+    }
+    return a.name < b.name;
+}
+
+/**
+ * @brief Ordena os pares da maior para a menor semelhança, e pelos nomes nos
+ * empates.
+ */
+static bool moreSimilarPair(const SimilarityIndex::Pair &a, const SimilarityIndex::Pair &b){
+    if(a.similarity != b.similarity){
+        return a.similarity > b.similarity;
+    }
+    if(a.first != b.first){
+        return a.first < b.first;
+    }
+    return a.second < b.second;
+}
+
+/**
+ * @brief Construtor do índice vazio.
+ */
+SimilarityIndex::SimilarityIndex() : slots(bands){
+    generation = 0;
+    indexed = 0;
+}
+
+/**
+ * @brief Retorna a chave de uma faixa da assinatura, um hash de 32 bits dos
+ * mínimos das funções da faixa. Faixas diferentes podem ter a mesma chave;
+ * quem usa os baldes confere os mínimos com sameBand.
+ *
+ * @param signature Assinatura.
+ * @param band Índice da faixa.
+ * @return Chave da faixa.
+ */
+uint32_t SimilarityIndex::bandKey(const PlaylistSignature &signature, size_t band){
+    uint64_t key = 0xcbf29ce484222325ULL;
+    for(size_t i = band * rows; i < (band + 1) * rows; i++){
+        key = (key ^ signature.get(i)) * 0x100000001b3ULL;
+        key ^= key >> 29;
+    }
+    return (uint32_t)(key >> 32);
+}
+
+/**
+ * @brief Verifica se duas assinaturas têm os mesmos mínimos em uma faixa, ou
+ * seja, se as playlists dividem o balde dessa faixa.
+ *
+ * @param a Uma assinatura.
+ * @param b Outra assinatura.
+ * @param band Índice da faixa.
+ * @return true se os mínimos da faixa são iguais.
+ */
+bool SimilarityIndex::sameBand(const PlaylistSignature &a, const PlaylistSignature &b, size_t band){
+    for(size_t i = band * rows; i < (band + 1) * rows; i++){
+        if(a.get(i) != b.get(i)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Tira dos baldes as playlists marcadas e coloca as novas. Em cada
+ * faixa, as posições das playlists tiradas são removidas do vetor, e as das
+ * novas são ordenadas e intercaladas com as restantes, em O(n) mais a
+ * ordenação das novas.
+ *
+ * @param dropped Indica, para cada posição de entries, se a playlist sai dos baldes.
+ * @param added Posições das playlists que entram nos baldes.
+ */
+void SimilarityIndex::rebucket(const std::vector<char> &dropped, const std::vector<uint32_t> &added){
+    bool anyDropped = std::find(dropped.begin(), dropped.end(), 1) != dropped.end();
+
+    for(size_t band = 0; band < bands; band++){
+        std::vector<Slot> &table = slots[band];
+        if(anyDropped){
+            size_t kept = 0;
+            for(size_t i = 0; i < table.size(); i++){
+                if(!dropped[table[i].entry]){
+                    table[kept++] = table[i];
+                }
+            }
+            table.resize(kept);
+        }
+
+        size_t middle = table.size();
+        for(size_t i = 0; i < added.size(); i++){
+            Slot slot;
+            slot.key = bandKey(entries[added[i]].signature, band);
+            slot.entry = added[i];
+            table.push_back(slot);
+        }
+        std::sort(table.begin() + middle, table.end());
+        std::inplace_merge(table.begin(), table.begin() + middle, table.end());
+    }
+}
+
+/**
+ * @brief Atualiza o índice com as playlists da lista. Playlists cuja lista
+ * de músicas e nome não mudaram desde a última atualização são mantidas sem
+ * serem lidas; as alteradas e as novas são recalculadas, e as que saíram da
+ * lista são retiradas do índice.
+ *
+ * @param playlists Lista de playlists indexada.
+ * @return Número de playlists recalculadas.
+ */
+size_t SimilarityIndex::update(LinkedList<Playlist> &playlists){
+    std::vector<char> dropped(entries.size(), 0);
+    std::vector<uint32_t> added;
+    bool anyDropped = false;
+    generation++;
+
+    for(Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+        Playlist &playlist = curr->getValue();
+        auto it = positions.find(&playlist);
+        uint32_t entry;
+        if(it != positions.end()){
+            entry = it->second;
+            Entry &found = entries[entry];
+            found.seen = generation;
+            if(found.version == playlist.readSongs().getVersion() && found.name == playlist.getName()){
+                continue;
+            }
+            if(found.indexed){
+                dropped[entry] = 1;
+                anyDropped = true;
+                indexed--;
+            }
+        }
+        else{
+            if(freeEntries.empty()){
+                entries.push_back(Entry());
+                entry = (uint32_t)(entries.size() - 1);
+            }
+            else{
+                entry = freeEntries.back();
+                freeEntries.pop_back();
+            }
+            positions[&playlist] = entry;
+        }
+
+        Entry &updated = entries[entry];
+        updated.playlist = &playlist;
+        updated.name = playlist.getName();
+        updated.signature = playlist.getSignature();
+        updated.version = playlist.readSongs().getVersion();
+        updated.seen = generation;
+        // Playlists vazias não se parecem com nenhuma outra
+        updated.indexed = !updated.signature.isEmpty();
+        if(updated.indexed){
+            added.push_back(entry);
+            indexed++;
+        }
+    }
+
+    // Playlists que não estão mais na lista
+    for(uint32_t entry = 0; entry < dropped.size(); entry++){
+        Entry &removed = entries[entry];
+        if(removed.playlist != nullptr && removed.seen != generation){
+            if(removed.indexed){
+                dropped[entry] = 1;
+                anyDropped = true;
+                indexed--;
+            }
+            positions.erase(removed.playlist);
+            removed.playlist = nullptr;
+            removed.name.clear();
+            removed.indexed = false;
+            freeEntries.push_back(entry);
+        }
+    }
+
+    if(anyDropped || !added.empty()){
+        dropped.resize(entries.size(), 0);
+        rebucket(dropped, added);
+    }
+    return added.size();
+}
+
+/**
+ * @brief Busca as playlists indexadas parecidas com uma playlist, que não
+ * precisa estar no índice. Só são comparadas as playlists que dividem algum
+ * balde com ela; a própria playlist não entra no resultado.
+ *
+ * @param playlist Playlist buscada.
+ * @param threshold Semelhança estimada mínima, entre 0 e 1.
+ * @param matches Recebe as playlists encontradas, da mais para a menos parecida.
+ */
+void SimilarityIndex::findSimilar(Playlist &playlist, double threshold, std::vector<Match> &matches) const{
+    matches.clear();
+    const PlaylistSignature &signature = playlist.getSignature();
+    if(signature.isEmpty()){
+        return;
+    }
+
+    std::unordered_set<uint32_t> candidates;
+    for(size_t band = 0; band < bands; band++){
+        const std::vector<Slot> &table = slots[band];
+        Slot first;
+        first.key = bandKey(signature, band);
+        first.entry = 0;
+        for(auto it = std::lower_bound(table.begin(), table.end(), first); it != table.end() && it->key == first.key; ++it){
+            const Entry &candidate = entries[it->entry];
+            if(candidate.playlist == &playlist || !sameBand(signature, candidate.signature, band) ||
+               !candidates.insert(it->entry).second){
+                continue;
+            }
+            double similarity = signature.similarity(candidate.signature);
+            if(similarity >= threshold){
+                Match match;
+                match.name = candidate.name;
+                match.similarity = similarity;
+                matches.push_back(match);
+            }
+        }
+    }
+    std::sort(matches.begin(), matches.end(), moreSimilar);
+}
+
+/**
+ * @brief Compara os pares de playlists de alguns baldes. Um par que divide
+ * baldes de várias faixas só é comparado na primeira delas.
+ *
+ * @param buckets Baldes com mais de uma playlist.
+ * @param begin Primeiro balde comparado.
+ * @param end Posição depois do último balde comparado.
+ * @param threshold Semelhança estimada mínima.
+ * @param pairs Recebe os pares encontrados.
+ */
+void SimilarityIndex::comparePairs(const std::vector<Bucket> &buckets, size_t begin, size_t end, double threshold,
+                                   std::vector<Pair> &pairs) const{
+    for(size_t i = begin; i < end; i++){
+        size_t band = buckets[i].band;
+        const std::vector<Slot> &table = slots[band];
+
+        for(size_t a = buckets[i].begin; a < buckets[i].end; a++){
+            const Entry &first = entries[table[a].entry];
+            for(size_t b = a + 1; b < buckets[i].end; b++){
+                const Entry &second = entries[table[b].entry];
+                if(!sameBand(first.signature, second.signature, band)){
+                    continue;
+                }
+
+                bool seenBefore = false;
+                for(size_t earlier = 0; earlier < band && !seenBefore; earlier++){
+                    seenBefore = sameBand(first.signature, second.signature, earlier);
+                }
+                if(seenBefore){
+                    continue;
+                }
+
+                double similarity = first.signature.similarity(second.signature);
+                if(similarity >= threshold){
+                    Pair pair;
+                    pair.first = std::min(first.name, second.name);
+                    pair.second = std::max(first.name, second.name);
+                    pair.similarity = similarity;
+                    pairs.push_back(pair);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Busca os pares de playlists indexadas quase iguais. Só são
+ * comparados os pares que dividem algum balde; os baldes são repartidos entre
+ * as threads em grupos, pegos conforme cada thread termina o anterior.
+ *
+ * @param threshold Semelhança estimada mínima, entre 0 e 1; valores acima de
+ * 0,5 aproveitam melhor o índice.
+ * @param threads Número de threads; 0 usa uma por núcleo.
+ * @param pairs Recebe os pares encontrados, do mais para o menos parecido.
+ */
+void SimilarityIndex::findDuplicates(double threshold, unsigned threads, std::vector<Pair> &pairs) const{
+    pairs.clear();
+
+    std::vector<Bucket> buckets;
+    for(size_t band = 0; band < bands; band++){
+        const std::vector<Slot> &table = slots[band];
+        for(size_t begin = 0, end; begin < table.size(); begin = end){
+            for(end = begin + 1; end < table.size() && table[end].key == table[begin].key; end++);
+            if(end - begin > 1){
+                Bucket bucket;
+                bucket.band = band;
+                bucket.begin = begin;
+                bucket.end = end;
+                buckets.push_back(bucket);
+            }
+        }
+    }
+
+    if(threads == 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t tasks = (buckets.size() + bucketsPerTask - 1) / bucketsPerTask;
+    threads = (unsigned)std::max<size_t>(1, std::min<size_t>(threads, tasks));
+
+    std::atomic<size_t> next(0);
+    std::vector<std::vector<Pair>> found(threads);
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < threads; t++){
+        workers.push_back(std::thread([this, &buckets, &next, &found, threshold, t](){
+            for(;;){
+                size_t begin = next.fetch_add(bucketsPerTask);
+                if(begin >= buckets.size()){
+                    return;
+                }
+                comparePairs(buckets, begin, std::min(begin + bucketsPerTask, buckets.size()), threshold, found[t]);
+            }
+        }));
+    }
+    for(size_t t = 0; t < workers.size(); t++){
+        workers[t].join();
+    }
+
+    for(size_t t = 0; t < found.size(); t++){
+        pairs.insert(pairs.end(), found[t].begin(), found[t].end());
+    }
+    std::sort(pairs.begin(), pairs.end(), moreSimilarPair);
+}
+
+/**
+ * @brief Retorna o número de playlists indexadas, sem contar as vazias.
+ *
+ * @return Número de playlists nos baldes.
+ */
+size_t SimilarityIndex::getSize() const{
+    return indexed;
+}
@@ -0,0 +1,829 @@
+/**
+ * @file SmartPlaylists.cpp
+ * @brief Arquivo que implementa os métodos da classe SmartPlaylists.
+ */
+
+#include <string>
+#include <vector>
+#include <climits>
+#include <cctype>
+#include <utility>
+#include <unordered_map>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+#include "TextKey.hpp"
+#include "SmartPlaylists.hpp"
+
+const size_t SmartPlaylists::none;
+
+/**
+ * @brief Avança a posição até o próximo caractere que não é espaço.
+ *
+ * @param text Texto da regra.
+ * @param pos Posição atual, atualizada.
+ */
+static void skipSpaces(const std::string &text, size_t &pos){
+    while(pos < text.size() && std::isspace((unsigned char)text[pos])){
+        pos++;
+    }
+}
+
+/**
+ * @brief Lê uma palavra: letras, dígitos e caracteres acentuados.
+ *
+ * @param text Texto da regra.
+ * @param pos Posição da palavra, atualizada para depois dela.
+ * @return A palavra lida, possivelmente vazia.
+ */
+static std::string readWord(const std::string &text, size_t &pos){
+    size_t start = pos;
+    while(pos < text.size() && (std::isalnum((unsigned char)text[pos]) || (unsigned char)text[pos] >= 0x80)){
+        pos++;
+    }
+    return text.substr(start, pos - start);
+}
+
+/**
+ * @brief Lê o nome de um autor ou de uma playlist. Um nome entre aspas pode
+ * conter qualquer caractere; sem aspas, ele termina em &, |, parênteses ou
+ * em um - precedido de espaço.
+ *
+ * @param text Texto da regra.
+ * @param pos Posição do nome, atualizada para depois dele.
+ * @return O nome lido, sem os espaços das pontas.
+ */
+static std::string readName(const std::string &text, size_t &pos){
+    skipSpaces(text, pos);
+    if(pos < text.size() && text[pos] == '"'){
+        size_t end = text.find('"', pos + 1);
+        if(end == std::string::npos){
+            end = text.size();
+        }
+        std::string name = text.substr(pos + 1, end - pos - 1);
+        pos = (end < text.size()) ? end + 1 : end;
+        return name;
+    }
+
+    size_t start = pos;
+    while(pos < text.size()){
+        char c = text[pos];
+        if(c == '&' || c == '|' || c == '(' || c == ')' ||
+           (c == '-' && pos > start && std::isspace((unsigned char)text[pos - 1]))){
+            break;
+        }
+        pos++;
+    }
+    size_t end = pos;
+    while(end > start && std::isspace((unsigned char)text[end - 1])){
+        end--;
+    }
+    return text.substr(start, end - start);
+}
+
+/**
+ * @brief Converte um número inteiro sem sinal, com no máximo 9 dígitos.
+ *
+ * @param text Texto do número.
+ * @param number Recebe o número.
+ * @return true se o texto é um número válido.
+ */
+static bool readNumber(const std::string &text, unsigned &number){
+    if(text.empty() || text.size() > 9){
+        return false;
+    }
+    number = 0;
+    for(size_t i = 0; i < text.size(); i++){
+        if(text[i] < '0' || text[i] > '9'){
+            return false;
+        }
+        number = number * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * @brief Construtor, que começa a acompanhar o catálogo.
+ *
+ * @param catalog Catálogo de músicas, usado nas folhas de autor e de atributo.
+ */
+SmartPlaylists::SmartPlaylists(const LinkedList<Song> &catalog) : catalog(catalog){
+    catalogSource.list = &catalog;
+    catalogSource.version = catalog.getVersion();
+    catalogSource.stale = false;
+    bound[&catalog] = &catalogSource;
+}
+
+/**
+ * @brief Retorna o identificador de uma música. Uma música nova recebe o
+ * próximo identificador e uma cópia dela é guardada, para ser adicionada às
+ * playlists inteligentes.
+ *
+ * @param song Música.
+ * @return Identificador da música.
+ */
+size_t SmartPlaylists::intern(const Song &song){
+    std::unordered_map<const Song*, size_t, SongHash, SongEqual>::iterator it = ids.find(&song);
+    if(it != ids.end()){
+        return it->second;
+    }
+    songs.push_back(song);
+    ids.emplace(&songs.back(), songs.size() - 1);
+    return songs.size() - 1;
+}
+
+/**
+ * @brief Verifica se uma música faz parte do resultado de um nó.
+ *
+ * @param rule Nó da regra.
+ * @param id Identificador da música.
+ * @return true se a música está no resultado.
+ */
+bool SmartPlaylists::contains(const Rule &rule, size_t id){
+    return id < rule.count.size() && rule.count[id] > 0;
+}
+
+/**
+ * @brief Verifica se uma música da fonte de uma folha é escolhida por ela.
+ * Atributos desconhecidos (0) nunca são escolhidos.
+ *
+ * @param rule Folha da regra.
+ * @param song Música da fonte.
+ * @return true se a música é escolhida.
+ */
+bool SmartPlaylists::matches(const Rule &rule, const Song &song){
+    if(rule.kind == Rule::Author){
+        return song.getAuthorKey() == rule.text;
+    }
+    if(rule.kind == Rule::Attribute){
+        unsigned value = (rule.field == Rule::Year) ? song.getYear() :
+                         (rule.field == Rule::Duration) ? song.getDuration() : song.getPlays();
+        return value != 0 && value >= rule.low && value <= rule.high;
+    }
+    return true;
+}
+
+/**
+ * @brief Altera o número de ocorrências de uma música em uma folha. Se a
+ * música entrou ou saiu da folha, a mudança é propagada aos nós acima.
+ *
+ * @param smart Índice da playlist inteligente.
+ * @param leaf Índice da folha.
+ * @param id Identificador da música.
+ * @param occurrences Novo número de ocorrências.
+ */
+void SmartPlaylists::count(size_t smart, size_t leaf, size_t id, uint32_t occurrences){
+    Rule &rule = smarts[smart].rules[leaf];
+    if(id >= rule.count.size()){
+        if(occurrences == 0){
+            return;
+        }
+        rule.count.resize(id + 1, 0);
+    }
+    bool before = rule.count[id] > 0;
+    rule.count[id] = occurrences;
+    if(before != (occurrences > 0)){
+        propagate(smarts[smart], leaf, id);
+    }
+}
+
+/**
+ * @brief Recalcula, para uma música, o resultado dos nós acima de um nó cujo
+ * resultado mudou, parando no primeiro que não muda. Se a raiz muda, a
+ * música é marcada para o próximo sync.
+ *
+ * @param smart Playlist inteligente.
+ * @param node Nó cujo resultado mudou.
+ * @param id Identificador da música.
+ */
+void SmartPlaylists::propagate(Smart &smart, size_t node, size_t id){
+    size_t curr = smart.rules[node].parent;
+    while(curr != none){
+        Rule &rule = smart.rules[curr];
+        bool left = contains(smart.rules[rule.left], id);
+        bool right = contains(smart.rules[rule.right], id);
+        bool result = (rule.kind == Rule::Union) ? (left || right) :
+                      (rule.kind == Rule::Intersection) ? (left && right) : (left && !right);
+        if(result == contains(rule, id)){
+            return;
+        }
+        if(id >= rule.count.size()){
+            rule.count.resize(id + 1, 0);
+        }
+        rule.count[id] = result;
+        curr = rule.parent;
+    }
+
+    if(id >= smart.isTouched.size()){
+        smart.isTouched.resize(id + 1, 0);
+    }
+    if(!smart.isTouched[id]){
+        smart.isTouched[id] = 1;
+        smart.touched.push_back(id);
+    }
+}
+
+/**
+ * @brief Recalcula uma folha a partir da sua fonte: conta as ocorrências de
+ * cada música escolhida e propaga apenas as músicas cuja presença mudou.
+ *
+ * @param smart Índice da playlist inteligente.
+ * @param leaf Índice da folha.
+ * @param list Lista da fonte, ou nullptr se a playlist não existe.
+ */
+void SmartPlaylists::scan(size_t smart, size_t leaf, const LinkedList<Song> *list){
+    std::vector<uint32_t> fresh;
+    if(list != nullptr){
+        const Rule &rule = smarts[smart].rules[leaf];
+        for(const Node<Song> *curr = list->getHead(); curr != nullptr; curr = curr->getNext()){
+            if(matches(rule, curr->getValue())){
+                size_t id = intern(curr->getValue());
+                if(id >= fresh.size()){
+                    fresh.resize(id + 1, 0);
+                }
+                fresh[id]++;
+            }
+        }
+    }
+
+    Rule &rule = smarts[smart].rules[leaf];
+    size_t size = (fresh.size() > rule.count.size()) ? fresh.size() : rule.count.size();
+    for(size_t id = 0; id < size; id++){
+        uint32_t now = (id < fresh.size()) ? fresh[id] : 0;
+        uint32_t before = (id < rule.count.size()) ? rule.count[id] : 0;
+        if(now != before){
+            count(smart, leaf, id, now);
+        }
+    }
+    rule.scanned = true;
+}
+
+/**
+ * @brief Liga uma fonte à lista atual com o seu nome. Se a lista é outra ou
+ * mudou sem aviso, todas as folhas da fonte são recalculadas; senão, apenas
+ * as folhas novas.
+ *
+ * @param source Fonte.
+ * @param list Lista atual da fonte, ou nullptr se a playlist não existe.
+ */
+void SmartPlaylists::refresh(Source &source, const LinkedList<Song> *list){
+    if(source.list != list){
+        if(source.list != nullptr){
+            std::unordered_map<const LinkedList<Song>*, Source*>::iterator it = bound.find(source.list);
+            if(it != bound.end() && it->second == &source){
+                bound.erase(it);
+            }
+        }
+        source.list = list;
+        source.stale = true;
+        if(list != nullptr){
+            bound[list] = &source;
+        }
+    }
+    if(list != nullptr && source.version != list->getVersion()){
+        source.stale = true;
+    }
+
+    for(size_t i = 0; i < source.leaves.size(); i++){
+        const Rule &rule = smarts[source.leaves[i].first].rules[source.leaves[i].second];
+        if(source.stale || !rule.scanned){
+            scan(source.leaves[i].first, source.leaves[i].second, list);
+        }
+    }
+    source.stale = false;
+    source.version = (list != nullptr) ? list->getVersion() : 0;
+}
+
+/**
+ * @brief Aplica à playlist inteligente as músicas que entraram ou saíram do
+ * resultado da regra: as que saíram são removidas em uma passagem e as que
+ * entraram são adicionadas ao final. Se a playlist é nova ou foi alterada
+ * diretamente, suas músicas são trocadas pelo resultado completo.
+ *
+ * @param smart Playlist inteligente.
+ * @param output Playlist da biblioteca com o nome da playlist inteligente.
+ */
+void SmartPlaylists::flush(Smart &smart, Playlist &output){
+    const Rule &root = smart.rules[smart.root];
+
+    if(output.readSongs().getVersion() != smart.outputVersion){
+        std::vector<Song*> all;
+        smart.listed.assign(songs.size(), 0);
+        for(size_t id = 0; id < root.count.size(); id++){
+            if(root.count[id] > 0){
+                all.push_back(&songs[id]);
+                smart.listed[id] = 1;
+            }
+        }
+        Playlist rebuilt;
+        rebuilt.addSongs(all);
+        output.replaceSongs(rebuilt);
+    }
+    else{
+        std::vector<Song*> added;
+        SongSet removed;
+        for(size_t i = 0; i < smart.touched.size(); i++){
+            size_t id = smart.touched[i];
+            bool inside = contains(root, id);
+            if(id >= smart.listed.size()){
+                smart.listed.resize(id + 1, 0);
+            }
+            if(inside && !smart.listed[id]){
+                added.push_back(&songs[id]);
+                smart.listed[id] = 1;
+            }
+            else if(!inside && smart.listed[id]){
+                removed.insert(&songs[id]);
+                smart.listed[id] = 0;
+            }
+        }
+        if(!removed.empty()){
+            output.removeSongs(removed);
+        }
+        if(!added.empty()){
+            output.addSongs(added);
+        }
+    }
+
+    for(size_t i = 0; i < smart.touched.size(); i++){
+        smart.isTouched[smart.touched[i]] = 0;
+    }
+    smart.touched.clear();
+    smart.outputVersion = output.readSongs().getVersion();
+}
+
+/**
+ * @brief Refaz a lista de folhas de cada fonte, depois que playlists
+ * inteligentes são criadas ou removidas, e descarta as fontes sem folhas.
+ */
+void SmartPlaylists::relink(){
+    catalogSource.leaves.clear();
+    for(std::unordered_map<std::string, Source>::iterator it = playlistSources.begin(); it != playlistSources.end(); ++it){
+        it->second.leaves.clear();
+    }
+
+    for(size_t i = 0; i < smarts.size(); i++){
+        for(size_t j = 0; j < smarts[i].rules.size(); j++){
+            const Rule &rule = smarts[i].rules[j];
+            if(rule.kind == Rule::Author || rule.kind == Rule::Attribute){
+                catalogSource.leaves.push_back(std::make_pair(i, j));
+            }
+            else if(rule.kind == Rule::Member){
+                playlistSources[rule.text].leaves.push_back(std::make_pair(i, j));
+            }
+        }
+    }
+
+    std::unordered_map<std::string, Source>::iterator it = playlistSources.begin();
+    while(it != playlistSources.end()){
+        if(it->second.leaves.empty()){
+            std::unordered_map<const LinkedList<Song>*, Source*>::iterator link = bound.find(it->second.list);
+            if(link != bound.end() && link->second == &it->second){
+                bound.erase(link);
+            }
+            it = playlistSources.erase(it);
+        }
+        else{
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Retorna a fonte de uma lista, se o aviso está em ordem: a lista
+ * estava na última versão vista, ou o aviso é de uma operação que já avisou
+ * outra música e gerou a versão atual. Caso contrário, a lista mudou sem
+ * aviso e a fonte é marcada para ser recalculada.
+ *
+ * @param list Lista alterada.
+ * @param prior Versão da lista antes da alteração.
+ * @return A fonte, ou nullptr se a lista não é acompanhada ou o aviso deve ser ignorado.
+ */
+SmartPlaylists::Source *SmartPlaylists::accept(const LinkedList<Song> &list, unsigned long long prior){
+    std::unordered_map<const LinkedList<Song>*, Source*>::iterator it = bound.find(&list);
+    if(it == bound.end()){
+        return nullptr;
+    }
+    Source &source = *it->second;
+    if(source.stale){
+        return nullptr;
+    }
+    if(source.version != prior && source.version != list.getVersion()){
+        source.stale = true;
+        return nullptr;
+    }
+    source.version = list.getVersion();
+    return &source;
+}
+
+/**
+ * @brief Combina dois nós da regra em um nó interno.
+ *
+ * @param rules Nós da regra.
+ * @param kind Operação do nó: Union, Intersection ou Difference.
+ * @param left Filho da esquerda.
+ * @param right Filho da direita.
+ * @return Índice do novo nó.
+ */
+size_t SmartPlaylists::combine(std::vector<Rule> &rules, Rule::Kind kind, size_t left, size_t right){
+    Rule rule;
+    rule.kind = kind;
+    rule.field = Rule::Year;
+    rule.low = rule.high = 0;
+    rule.left = left;
+    rule.right = right;
+    rule.parent = none;
+    rule.scanned = true;
+    rules.push_back(rule);
+
+    size_t index = rules.size() - 1;
+    rules[left].parent = index;
+    rules[right].parent = index;
+    return index;
+}
+
+/**
+ * @brief Lê termos ligados por | (união) e - (diferença), da esquerda para a direita.
+ *
+ * @param text Texto da regra.
+ * @param pos Posição atual, atualizada.
+ * @param rules Recebe os nós lidos.
+ * @param error Recebe a mensagem de erro, se houver.
+ * @return Índice do nó lido.
+ */
+size_t SmartPlaylists::parseUnion(const std::string &text, size_t &pos, std::vector<Rule> &rules, std::string &error){
+    size_t left = parseIntersection(text, pos, rules, error);
+    while(error.empty()){
+        skipSpaces(text, pos);
+        if(pos >= text.size() || (text[pos] != '|' && text[pos] != '-')){
+            break;
+        }
+        Rule::Kind kind = (text[pos] == '|') ? Rule::Union : Rule::Difference;
+        pos++;
+        size_t right = parseIntersection(text, pos, rules, error);
+        if(error.empty()){
+            left = combine(rules, kind, left, right);
+        }
+    }
+    return left;
+}
+
+/**
+ * @brief Lê termos ligados por & (interseção), que tem precedência sobre | e -.
+ *
+ * @param text Texto da regra.
+ * @param pos Posição atual, atualizada.
+ * @param rules Recebe os nós lidos.
+ * @param error Recebe a mensagem de erro, se houver.
+ * @return Índice do nó lido.
+ */
+size_t SmartPlaylists::parseIntersection(const std::string &text, size_t &pos, std::vector<Rule> &rules, std::string &error){
+    size_t left = parseTerm(text, pos, rules, error);
+    while(error.empty()){
+        skipSpaces(text, pos);
+        if(pos >= text.size() || text[pos] != '&'){
+            break;
+        }
+        pos++;
+        size_t right = parseTerm(text, pos, rules, error);
+        if(error.empty()){
+            left = combine(rules, Rule::Intersection, left, right);
+        }
+    }
+    return left;
+}
+
+/**
+ * @brief Lê uma expressão entre parênteses ou uma folha: autor:nome,
+ * playlist:nome ou um atributo (ano, duração, execuções) comparado a um
+ * valor com <, <=, =, >= ou >.
+ *
+ * @param text Texto da regra.
+ * @param pos Posição atual, atualizada.
+ * @param rules Recebe os nós lidos.
+ * @param error Recebe a mensagem de erro, se houver.
+ * @return Índice do nó lido.
+ */
+size_t SmartPlaylists::parseTerm(const std::string &text, size_t &pos, std::vector<Rule> &rules, std::string &error){
+    skipSpaces(text, pos);
+    if(pos >= text.size()){
+        error = "regra incompleta";
+        return none;
+    }
+    if(text[pos] == '('){
+        pos++;
+        size_t inner = parseUnion(text, pos, rules, error);
+        if(!error.empty()){
+            return none;
+        }
+        skipSpaces(text, pos);
+        if(pos >= text.size() || text[pos] != ')'){
+            error = "falta ')' na posição " + std::to_string(pos + 1);
+            return none;
+        }
+        pos++;
+        return inner;
+    }
+
+    size_t start = pos;
+    std::string word = readWord(text, pos);
+    std::string key = foldText(word);
+    Rule rule;
+    rule.field = Rule::Year;
+    rule.low = rule.high = 0;
+    rule.left = rule.right = rule.parent = none;
+    rule.scanned = false;
+    skipSpaces(text, pos);
+
+    if(pos < text.size() && text[pos] == ':' && (key == "autor" || key == "playlist")){
+        pos++;
+        std::string name = readName(text, pos);
+        if(name.empty()){
+            error = "falta o nome depois de \"" + word + ":\"";
+            return none;
+        }
+        rule.kind = (key == "autor") ? Rule::Author : Rule::Member;
+        rule.text = (key == "autor") ? foldText(name) : name;
+    }
+    else if(key == "ano" || key == "duracao" || key == "execucoes"){
+        std::string op;
+        while(pos < text.size() && (text[pos] == '<' || text[pos] == '>' || text[pos] == '=')){
+            op += text[pos++];
+        }
+        skipSpaces(text, pos);
+        size_t valueStart = pos;
+        while(pos < text.size() && (std::isdigit((unsigned char)text[pos]) || text[pos] == ':')){
+            pos++;
+        }
+        std::string value = text.substr(valueStart, pos - valueStart);
+        unsigned number = 0;
+        bool valid = (key == "duracao") ? Song::parseDuration(value, number) : readNumber(value, number);
+        if(!valid){
+            error = "valor inválido para \"" + word + "\"";
+            return none;
+        }
+
+        rule.kind = Rule::Attribute;
+        rule.field = (key == "ano") ? Rule::Year : (key == "duracao") ? Rule::Duration : Rule::Plays;
+        rule.low = 1;
+        rule.high = UINT_MAX;
+        if(op == "<"){
+            rule.high = number - 1;
+        }
+        else if(op == "<="){
+            rule.high = number;
+        }
+        else if(op == "="){
+            rule.low = rule.high = number;
+        }
+        else if(op == ">="){
+            rule.low = (number > 1) ? number : 1;
+        }
+        else if(op == ">"){
+            rule.low = number + 1;
+            if(number == UINT_MAX){
+                rule.high = 0;
+            }
+        }
+        else{
+            error = "comparação inválida para \"" + word + "\"";
+            return none;
+        }
+        if(number == 0 && (op == "<" || op == "=")){
+            rule.high = 0;
+        }
+    }
+    else{
+        error = "termo desconhecido na posição " + std::to_string(start + 1);
+        return none;
+    }
+
+    rules.push_back(rule);
+    return rules.size() - 1;
+}
+
+/**
+ * @brief Cria uma playlist inteligente, adicionando à lista de playlists uma
+ * playlist vazia com o nome especificado. As músicas são calculadas no
+ * próximo sync, feito quando a biblioteca publica as alterações.
+ *
+ * Exemplos de regras: "autor:Simone Mendes", "playlist:Rock & playlist:Pop",
+ * "(playlist:A | playlist:B) - autor:Queen", "ano>=2000 & duração<4:00".
+ *
+ * @param name Nome da playlist, que não pode existir na lista.
+ * @param text Regra.
+ * @param playlists Lista de playlists que recebe a playlist inteligente.
+ * @param error Recebe a mensagem de erro, se a regra for inválida.
+ * @return true se a playlist foi criada.
+ */
+bool SmartPlaylists::define(const std::string &name, const std::string &text, LinkedList<Playlist> &playlists,
+                            std::string &error){
+    std::vector<Rule> rules;
+    size_t pos = 0;
+    error.clear();
+    size_t root = parseUnion(text, pos, rules, error);
+    if(error.empty()){
+        skipSpaces(text, pos);
+        if(pos < text.size()){
+            error = "texto inesperado na posição " + std::to_string(pos + 1);
+        }
+    }
+    if(!error.empty()){
+        return false;
+    }
+
+    if(playlists.searchValue(Playlist(name)) != nullptr){
+        error = "já existe uma playlist com esse nome";
+        return false;
+    }
+    for(size_t i = 0; i < rules.size(); i++){
+        if(rules[i].kind == Rule::Member && rules[i].text == name){
+            error = "a regra não pode usar a própria playlist";
+            return false;
+        }
+    }
+    // As playlists inteligentes são atualizadas em ordem de definição
+    for(size_t i = 0; i < smarts.size(); i++){
+        for(size_t j = 0; j < smarts[i].rules.size(); j++){
+            if(smarts[i].rules[j].kind == Rule::Member && smarts[i].rules[j].text == name){
+                error = "a playlist inteligente \"" + smarts[i].name + "\" já usa esse nome em sua regra";
+                return false;
+            }
+        }
+    }
+
+    Smart smart;
+    smart.name = name;
+    smart.text = text;
+    smart.rules.swap(rules);
+    smart.root = root;
+    smart.outputVersion = 0;
+    smarts.push_back(std::move(smart));
+    relink();
+
+    playlists.add(Playlist(name));
+    return true;
+}
+
+/**
+ * @brief Aplica às playlists inteligentes as mudanças desde o último sync.
+ * Se a lista de playlists mudou de forma (reshaped), liga a este objeto as
+ * playlists da lista, para que elas avisem suas alterações, e refaz o mapa
+ * das playlists pelo nome (só se houver playlists inteligentes, pois as
+ * definições novas também mudam a lista); caso contrário, o mapa anterior
+ * continua valendo e nenhuma playlist é percorrida. Depois, recalcula as fontes alteradas sem
+ * aviso e atualiza cada playlist inteligente, em ordem de definição.
+ * Playlists inteligentes que não estão mais na lista deixam de ser mantidas.
+ * @note Deve ser chamado com a biblioteca travada para escrita.
+ *
+ * @param playlists Lista de playlists da biblioteca.
+ * @param reshaped true se playlists entraram, saíram ou mudaram de nome
+ * desde o último sync.
+ */
+void SmartPlaylists::sync(LinkedList<Playlist> &playlists, bool reshaped){
+    if(reshaped){
+        byName.clear();
+        for(Node<Playlist> *curr = playlists.getHead(); curr != nullptr; curr = curr->getNext()){
+            curr->getValue().setSmartPlaylists(this);
+            if(!smarts.empty()){
+                byName[curr->getValue().getName()] = &curr->getValue();
+            }
+        }
+    }
+    if(smarts.empty()){
+        return;
+    }
+
+    refresh(catalogSource, &catalog);
+    for(std::unordered_map<std::string, Source>::iterator it = playlistSources.begin(); it != playlistSources.end(); ++it){
+        std::unordered_map<std::string, Playlist*>::iterator found = byName.find(it->first);
+        refresh(it->second, (found != byName.end()) ? &found->second->readSongs() : nullptr);
+    }
+
+    std::vector<char> dropped(smarts.size(), 0);
+    for(size_t i = 0; i < smarts.size(); i++){
+        std::unordered_map<std::string, Playlist*>::iterator found = byName.find(smarts[i].name);
+        if(found == byName.end()){
+            dropped[i] = 1;
+            continue;
+        }
+        flush(smarts[i], *found->second);
+        // Playlists inteligentes definidas depois podem usar esta
+        std::unordered_map<std::string, Source>::iterator dependent = playlistSources.find(smarts[i].name);
+        if(dependent != playlistSources.end()){
+            refresh(dependent->second, &found->second->readSongs());
+        }
+    }
+
+    size_t kept = 0;
+    for(size_t i = 0; i < smarts.size(); i++){
+        if(!dropped[i]){
+            if(kept != i){
+                smarts[kept] = std::move(smarts[i]);
+            }
+            kept++;
+        }
+    }
+    if(kept != smarts.size()){
+        smarts.resize(kept);
+        relink();
+    }
+}
+
+/**
+ * @brief Avisa que uma música foi adicionada a uma lista. As folhas que leem
+ * a lista e escolhem a música contam mais uma ocorrência.
+ *
+ * @param list Lista alterada.
+ * @param prior Versão da lista antes da alteração.
+ * @param song Música adicionada.
+ */
+void SmartPlaylists::added(const LinkedList<Song> &list, unsigned long long prior, const Song &song){
+    Source *source = accept(list, prior);
+    if(source == nullptr){
+        return;
+    }
+    for(size_t i = 0; i < source->leaves.size(); i++){
+        size_t smart = source->leaves[i].first;
+        size_t leaf = source->leaves[i].second;
+        const Rule &rule = smarts[smart].rules[leaf];
+        if(rule.scanned && matches(rule, song)){
+            size_t id = intern(song);
+            count(smart, leaf, id, ((id < rule.count.size()) ? rule.count[id] : 0) + 1);
+        }
+    }
+}
+
+/**
+ * @brief Avisa que uma música foi removida de uma lista. As folhas que
+ * contavam a música contam uma ocorrência a menos; a música é reconhecida
+ * pela identidade, então basta que ela tenha o mesmo título e autor.
+ *
+ * @param list Lista alterada.
+ * @param prior Versão da lista antes da alteração.
+ * @param song Música removida.
+ */
+void SmartPlaylists::removed(const LinkedList<Song> &list, unsigned long long prior, const Song &song){
+    Source *source = accept(list, prior);
+    if(source == nullptr || source->leaves.empty()){
+        return;
+    }
+    std::unordered_map<const Song*, size_t, SongHash, SongEqual>::iterator it = ids.find(&song);
+    if(it == ids.end()){
+        return;
+    }
+    for(size_t i = 0; i < source->leaves.size(); i++){
+        size_t smart = source->leaves[i].first;
+        size_t leaf = source->leaves[i].second;
+        const Rule &rule = smarts[smart].rules[leaf];
+        if(contains(rule, it->second)){
+            count(smart, leaf, it->second, rule.count[it->second] - 1);
+        }
+    }
+}
+
+/**
+ * @brief Avisa que uma lista mudou de ordem sem mudar as músicas, para que
+ * a nova versão não seja tomada por uma alteração sem aviso.
+ *
+ * @param list Lista alterada.
+ * @param prior Versão da lista antes da alteração.
+ */
+void SmartPlaylists::reordered(const LinkedList<Song> &list, unsigned long long prior){
+    accept(list, prior);
+}
+
+/**
+ * @brief Avisa que as músicas de uma lista foram trocadas de uma vez. As
+ * folhas que leem a lista são recalculadas no próximo sync.
+ *
+ * @param list Lista alterada.
+ */
+void SmartPlaylists::replaced(const LinkedList<Song> &list){
+    std::unordered_map<const LinkedList<Song>*, Source*>::iterator it = bound.find(&list);
+    if(it != bound.end()){
+        it->second->stale = true;
+    }
+}
+
+/**
+ * @brief Retorna o número de playlists inteligentes.
+ *
+ * @return Número de playlists mantidas.
+ */
+size_t SmartPlaylists::getSize() const{
+    return smarts.size();
+}
+
+/**
+ * @brief Exibe o nome e a regra de cada playlist inteligente, uma por linha.
+ *
+ * @param os Stream de saída.
+ */
+void SmartPlaylists::print(std::ostream &os) const{
+    for(size_t i = 0; i < smarts.size(); i++){
+        os << "\"" << smarts[i].name << "\": " << smarts[i].text << "\n";
+    }
+}
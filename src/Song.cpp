@@ -4,15 +4,35 @@
  */
 
 #include "Song.hpp"
+#include "TextKey.hpp"
 #include <string>
+#include <new>
+#include <cstring>
+#include <algorithm>
+
+/**
+ * @brief Retorna os hashes da música sem título e sem autor, calculados uma vez.
+ *
+ * @param titleHash Recebe o hash da chave do título vazia.
+ * @param fingerprint Recebe o hash da identidade vazia.
+ */
+static void emptyHashes(uint64_t &titleHash, uint64_t &fingerprint){
+    static const uint64_t emptyTitle = hashBytes("", 0);
+    static const uint64_t emptyIdentity = hashBytes("\x1f", 1);
+    titleHash = emptyTitle;
+    fingerprint = emptyIdentity;
+}
 
 /**
  * @brief Construtor padrão da música.
  * 
  */
 Song::Song(){
-    setTitle("");
-    setAuthor("");
+    text = nullptr;
+    emptyHashes(titleHash, fingerprint);
+    duration = 0;
+    year = 0;
+    plays = 0;
 }
 
 /**
@@ -22,8 +42,157 @@ Song::Song(){
  * @param author (Opcional) Autor da música.
  */
 Song::Song(std::string title, std::string author){
-    setTitle(title);
-    setAuthor(author);
+    text = nullptr;
+    setText(title, author);
+    duration = 0;
+    year = 0;
+    plays = 0;
+}
+
+/**
+ * @brief Construtor de cópia. Os textos não são copiados: as duas músicas
+ * passam a usar a mesma alocação.
+ *
+ * @param b Música copiada.
+ */
+Song::Song(const Song &b) : text(b.text), titleHash(b.titleHash), fingerprint(b.fingerprint),
+    duration(b.duration), year(b.year), plays(b.plays){
+    if(text != nullptr){
+        text->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Construtor de movimento. A música movida fica sem título e sem autor.
+ *
+ * @param b Música movida.
+ */
+Song::Song(Song &&b) : text(b.text), titleHash(b.titleHash), fingerprint(b.fingerprint),
+    duration(b.duration), year(b.year), plays(b.plays){
+    b.text = nullptr;
+    emptyHashes(b.titleHash, b.fingerprint);
+}
+
+/**
+ * @brief Destrutor da música, que libera os textos se nenhuma outra cópia os usa.
+ */
+Song::~Song(){
+    releaseText();
+}
+
+/**
+ * @brief Atribuição por cópia, que passa a compartilhar os textos de outra música.
+ *
+ * @param b Música copiada.
+ * @return Referência para esta música.
+ */
+Song &Song::operator=(const Song &b){
+    if(b.text != nullptr){
+        b.text->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    releaseText();
+    text = b.text;
+    titleHash = b.titleHash;
+    fingerprint = b.fingerprint;
+    duration = b.duration;
+    year = b.year;
+    plays = b.plays;
+    return *this;
+}
+
+/**
+ * @brief Atribuição por movimento. A música movida fica sem título e sem autor.
+ *
+ * @param b Música movida.
+ * @return Referência para esta música.
+ */
+Song &Song::operator=(Song &&b){
+    if(this != &b){
+        releaseText();
+        text = b.text;
+        titleHash = b.titleHash;
+        fingerprint = b.fingerprint;
+        duration = b.duration;
+        year = b.year;
+        plays = b.plays;
+        b.text = nullptr;
+        emptyHashes(b.titleHash, b.fingerprint);
+    }
+    return *this;
+}
+
+/**
+ * @brief Substitui os textos da música por uma nova alocação com o título, o
+ * autor e suas chaves, e recalcula os hashes. As outras cópias da música
+ * continuam com a alocação anterior.
+ *
+ * @param title Novo título.
+ * @param author Novo autor.
+ */
+void Song::setText(const std::string &title, const std::string &author){
+    std::string titleKey = foldText(title);
+    std::string authorKey = foldText(author);
+    std::string identity = titleKey;
+    identity += '\x1f';
+    identity += authorKey;
+    titleHash = hashBytes(titleKey.data(), titleKey.size());
+    fingerprint = hashBytes(identity.data(), identity.size());
+
+    Text *created = nullptr;
+    if(!title.empty() || !author.empty()){
+        const std::string *texts[4] = {&title, &author, &titleKey, &authorKey};
+        uint32_t start[4];
+        size_t total = 0;
+        for(int i = Title; i <= AuthorKey; i++){
+            // Chaves iguais ao texto original, como em textos sem acentos e em minúsculas, não são repetidas
+            if(i >= TitleKey && *texts[i] == *texts[i - TitleKey]){
+                start[i] = start[i - TitleKey];
+            }
+            else{
+                start[i] = (uint32_t)total;
+                total += texts[i]->size() + 1;
+            }
+        }
+
+        created = new(::operator new(sizeof(Text) + total)) Text;
+        created->refs.store(1, std::memory_order_relaxed);
+        char *data = reinterpret_cast<char*>(created + 1);
+        for(int i = Title; i <= AuthorKey; i++){
+            created->start[i] = start[i];
+            created->size[i] = (uint32_t)texts[i]->size();
+            if(i < TitleKey || start[i] != start[i - TitleKey]){
+                std::memcpy(data + start[i], texts[i]->c_str(), texts[i]->size() + 1);
+            }
+        }
+    }
+    releaseText();
+    text = created;
+}
+
+/**
+ * @brief Deixa de usar a alocação dos textos, e a libera se nenhuma outra
+ * cópia da música a usa.
+ */
+void Song::releaseText(){
+    if(text != nullptr && text->refs.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        text->~Text();
+        ::operator delete(text);
+    }
+    text = nullptr;
+}
+
+/**
+ * @brief Retorna um dos textos da música, sem copiá-lo. O texto vale enquanto
+ * a música existir e não for alterada.
+ *
+ * @param field Texto desejado.
+ * @return Trecho com o texto, vazio se a música não tem textos.
+ */
+TextView Song::getText(TextField field) const{
+    if(text == nullptr){
+        return TextView();
+    }
+    return TextView(reinterpret_cast<const char*>(text + 1) + text->start[field], text->size[field]);
 }
 
 /**
@@ -32,7 +201,7 @@ Song::Song(std::string title, std::string author){
  * @return Título da música.
  */
 std::string Song::getTitle(){
-    return title;
+    return getText(Title).str();
 }
 
 /**
@@ -41,7 +210,25 @@ std::string Song::getTitle(){
  * @return Autor da música.
  */
 std::string Song::getAuthor(){
-    return author;
+    return getText(Author).str();
+}
+
+/**
+ * @brief Retorna o título da música sem copiá-lo.
+ *
+ * @return Trecho com o título, válido enquanto a música não for alterada.
+ */
+TextView Song::getTitleView() const{
+    return getText(Title);
+}
+
+/**
+ * @brief Retorna o autor da música sem copiá-lo.
+ *
+ * @return Trecho com o autor, válido enquanto a música não for alterada.
+ */
+TextView Song::getAuthorView() const{
+    return getText(Author);
 }
 
 /**
@@ -50,7 +237,7 @@ std::string Song::getAuthor(){
  * @param title Novo título.
  */
 void Song::setTitle(std::string title){
-    this->title = title;
+    setText(title, getText(Author).str());
 }
 
 /**
@@ -59,23 +246,270 @@ void Song::setTitle(std::string title){
  * @param author Novo autor.
  */
 void Song::setAuthor(std::string author){
-    this->author = author;
+    setText(getText(Title).str(), author);
+}
+
+/**
+ * @brief Retorna a duração da música.
+ * 
+ * @return Duração em segundos, ou 0 se desconhecida.
+ */
+unsigned Song::getDuration() const{
+    return duration;
+}
+
+/**
+ * @brief Altera a duração da música.
+ * 
+ * @param duration Nova duração em segundos, ou 0 se desconhecida.
+ */
+void Song::setDuration(unsigned duration){
+    this->duration = duration;
+}
+
+/**
+ * @brief Retorna o ano de lançamento da música.
+ * 
+ * @return Ano de lançamento, ou 0 se desconhecido.
+ */
+unsigned Song::getYear() const{
+    return year;
+}
+
+/**
+ * @brief Altera o ano de lançamento da música.
+ * 
+ * @param year Novo ano, ou 0 se desconhecido.
+ */
+void Song::setYear(unsigned year){
+    this->year = year;
 }
 
 /**
- * @brief Sobrecarga do operador de igualdade, que compara o título de duas músicas.
- * @note Duas músicas com títulos iguais e autores diferentes serão consideradas iguais.
+ * @brief Retorna o número de execuções da música.
  * 
- * @return Retorna true caso o título das músicas seja igual, e false caso contrário.
+ * @return Número de execuções, ou 0 se desconhecido.
+ */
+unsigned Song::getPlays() const{
+    return plays;
+}
+
+/**
+ * @brief Altera o número de execuções da música.
+ * 
+ * @param plays Novo número de execuções, ou 0 se desconhecido.
+ */
+void Song::setPlays(unsigned plays){
+    this->plays = plays;
+}
+
+/**
+ * @brief Retorna a chave de comparação do título, calculada quando o título é alterado.
+ * 
+ * @return Título sem acentos e em minúsculas.
+ */
+TextView Song::getTitleKey() const{
+    return getText(TitleKey);
+}
+
+/**
+ * @brief Retorna a chave de comparação do autor, calculada quando o autor é alterado.
+ * 
+ * @return Autor sem acentos e em minúsculas.
+ */
+TextView Song::getAuthorKey() const{
+    return getText(AuthorKey);
+}
+
+/**
+ * @brief Retorna o hash da chave do título, calculado quando o título é alterado.
+ * 
+ * @return Hash de 64 bits.
+ */
+uint64_t Song::getTitleHash() const{
+    return titleHash;
+}
+
+/**
+ * @brief Retorna o hash da identidade da música, calculado quando o título ou
+ * o autor é alterado.
+ * 
+ * @return Hash de 64 bits do par (título, autor).
+ */
+uint64_t Song::getFingerprint() const{
+    return fingerprint;
+}
+
+/**
+ * @brief Retorna a parte desta música na memória alocada pelos textos (título,
+ * autor e suas chaves). A alocação é dividida entre as cópias que a usam, de
+ * forma que a soma sobre todas as cópias é a memória realmente alocada.
+ *
+ * @return Bytes alocados pelos textos, divididos pelo número de cópias.
+ */
+size_t Song::getHeapBytes() const{
+    if(text == nullptr){
+        return 0;
+    }
+    size_t end = 0;
+    for(int i = Title; i <= AuthorKey; i++){
+        end = std::max(end, (size_t)text->start[i] + text->size[i] + 1);
+    }
+    return (sizeof(Text) + end) / text->refs.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Verifica se duas músicas têm o mesmo título, sem diferenciar acentos
+ * e letras maiúsculas, independente do autor.
+ * 
+ * @param b Música a ser comparada.
+ * @return Retorna true caso os títulos sejam equivalentes.
+ */
+bool Song::hasSameTitle(const Song &b) const{
+    return titleHash == b.titleHash && (text == b.text || getText(TitleKey) == b.getText(TitleKey));
+}
+
+/**
+ * @brief Verifica se duas músicas têm o mesmo título e o mesmo autor, sem
+ * diferenciar acentos e letras maiúsculas. Os hashes da identidade são
+ * comparados antes das chaves, então músicas diferentes quase sempre são
+ * descartadas com uma única comparação de inteiros; cópias da mesma música
+ * compartilham os textos e nem precisam comparar as chaves.
+ * 
+ * @param b Música a ser comparada.
+ * @return Retorna true caso as músicas sejam a mesma.
+ */
+bool Song::equals(const Song &b) const{
+    return fingerprint == b.fingerprint &&
+        (text == b.text || (getText(TitleKey) == b.getText(TitleKey) && getText(AuthorKey) == b.getText(AuthorKey)));
+}
+
+/**
+ * @brief Verifica se a música é uma cópia de outra: se compartilha a
+ * alocação dos textos e tem a mesma duração, ano e número de execuções.
+ * Músicas criadas separadamente não são cópias, mesmo que sejam iguais.
+ *
+ * @param b Música a ser comparada.
+ * @return Retorna true caso uma música seja cópia da outra.
+ */
+bool Song::isCopyOf(const Song &b) const{
+    return text == b.text && duration == b.duration && year == b.year && plays == b.plays;
+}
+
+/**
+ * @brief Compara o título da música com o de outra música. As chaves são
+ * comparadas primeiro, para que "Água" fique junto de "agua"; o texto original
+ * só desempata.
+ *
+ * @param b Música a ser comparada.
+ * @return Valor negativo, zero ou positivo, como em std::string::compare.
+ */
+int Song::compareTitle(const Song &b) const{
+    int result = getText(TitleKey).compare(b.getText(TitleKey));
+    return result != 0 ? result : getText(Title).compare(b.getText(Title));
+}
+
+/**
+ * @brief Compara o autor da música com o de outra música, da mesma forma que compareTitle.
+ *
+ * @param b Música a ser comparada.
+ * @return Valor negativo, zero ou positivo, como em std::string::compare.
+ */
+int Song::compareAuthor(const Song &b) const{
+    int result = getText(AuthorKey).compare(b.getText(AuthorKey));
+    return result != 0 ? result : getText(Author).compare(b.getText(Author));
+}
+
+/**
+ * @brief Sobrecarga do operador de igualdade, que compara o título e o autor
+ * de duas músicas (veja equals).
+ * @note Duas músicas com títulos iguais e autores diferentes são consideradas diferentes.
+ * 
+ * @return Retorna true caso as músicas sejam a mesma, e false caso contrário.
  */
 bool Song::operator==(Song &b){
-    return this->getTitle() == b.getTitle();
+    return equals(b);
+}
+
+/**
+ * @brief Converte uma duração escrita como segundos ("225"), minutos e
+ * segundos ("3:45") ou horas, minutos e segundos ("1:03:45").
+ *
+ * @param text Texto da duração.
+ * @param seconds Recebe a duração em segundos, se o texto for válido.
+ * @return Retorna false caso o texto não seja uma duração válida.
+ */
+bool Song::parseDuration(const std::string &text, unsigned &seconds){
+    unsigned long long total = 0;
+    unsigned long long part = 0;
+    size_t parts = 0;
+    size_t digits = 0;
+
+    for(size_t i = 0; i <= text.size(); i++){
+        if(i == text.size() || text[i] == ':'){
+            // Minutos e segundos depois do primeiro campo vão de 0 a 59
+            if(digits == 0 || (parts > 0 && part >= 60) || ++parts > 3){
+                return false;
+            }
+            total = total * 60 + part;
+            part = 0;
+            digits = 0;
+        }
+        else if(text[i] >= '0' && text[i] <= '9'){
+            part = part * 10 + (text[i] - '0');
+            if(++digits > 9){
+                return false;
+            }
+        }
+        else{
+            return false;
+        }
+    }
+
+    if(total > 0xffffffffULL){
+        return false;
+    }
+    seconds = (unsigned)total;
+    return true;
+}
+
+/**
+ * @brief Escreve uma duração como minutos e segundos ("3:45"), ou como horas,
+ * minutos e segundos ("1:03:45") a partir de uma hora.
+ *
+ * @param seconds Duração em segundos.
+ * @return Texto da duração.
+ */
+std::string Song::formatDuration(unsigned long long seconds){
+    unsigned long long hours = seconds / 3600;
+    unsigned long long minutes = (seconds / 60) % 60;
+    seconds %= 60;
+
+    std::string text;
+    if(hours > 0){
+        text = std::to_string(hours) + ":";
+        text += (minutes < 10 ? "0" : "");
+    }
+    text += std::to_string(minutes) + ":";
+    text += (seconds < 10 ? "0" : "");
+    text += std::to_string(seconds);
+    return text;
 }
 
 /**
- * @brief Sobrecarga do operador de inserção da música.
+ * @brief Sobrecarga do operador de inserção da música. A duração, o ano e o
+ * número de execuções só são exibidos quando conhecidos.
  */
 std::ostream& operator<<(std::ostream& os, const Song &song){
-    os << "Título: \"" << song.title << "\" - Autor: \"" << song.author << "\"";
+    os << "Título: \"" << song.getTitleView() << "\" - Autor: \"" << song.getAuthorView() << "\"";
+    if(song.duration != 0){
+        os << " - Duração: " << Song::formatDuration(song.duration);
+    }
+    if(song.year != 0){
+        os << " - Ano: " << song.year;
+    }
+    if(song.plays != 0){
+        os << " - Execuções: " << song.plays;
+    }
     return os;
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ * @file SongOrder.cpp
+ * @brief Arquivo que implementa os métodos da classe SongOrder.
+ */
+
+#include <string>
+#include "Song.hpp"
+#include "SongOrder.hpp"
+
+/**
+ * @brief Construtor da ordenação sem chaves, que representa a ordem de inserção.
+ */
+SongOrder::SongOrder(){
+}
+
+/**
+ * @brief Construtor que recebe as chaves da ordenação.
+ *
+ * @param keys Chaves, da mais para a menos importante.
+ */
+SongOrder::SongOrder(std::initializer_list<Key> keys) : keys(keys){
+}
+
+/**
+ * @brief Verifica se a ordenação não tem chaves.
+ *
+ * @return Retorna true se a ordenação é a ordem de inserção.
+ */
+bool SongOrder::isEmpty() const{
+    return keys.empty();
+}
+
+/**
+ * @brief Retorna a descrição da ordenação, para ser exibida no menu.
+ *
+ * @return Descrição, como "título" ou "autor, título".
+ */
+std::string SongOrder::getDescription() const{
+    if(keys.empty()){
+        return "ordem de inserção";
+    }
+
+    std::string description;
+    for(size_t i = 0; i < keys.size(); i++){
+        if(i > 0){
+            description += ", ";
+        }
+        description += (keys[i] == Title) ? "título" : "autor";
+    }
+    return description;
+}
+
+/**
+ * @brief Compara duas músicas segundo a ordenação.
+ *
+ * @param a Primeira música.
+ * @param b Segunda música.
+ * @return Retorna true se a primeira música vem antes da segunda.
+ */
+bool SongOrder::operator()(const Song &a, const Song &b) const{
+    for(size_t i = 0; i < keys.size(); i++){
+        int result = (keys[i] == Title) ? a.compareTitle(b) : a.compareAuthor(b);
+        if(result != 0){
+            return result < 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sobrecarga do operador de igualdade.
+ *
+ * @return Retorna true se as duas ordenações usam as mesmas chaves.
+ */
+bool SongOrder::operator==(const SongOrder &b) const{
+    return keys == b.keys;
+}
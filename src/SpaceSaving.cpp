@@ -0,0 +1,262 @@
+/**
+ * @file SpaceSaving.cpp
+ * @brief Arquivo que implementa os métodos da classe SpaceSaving.
+ */
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "Song.hpp"
+#include "SpaceSaving.hpp"
+
+const size_t SpaceSaving::empty;
+
+/**
+ * @brief Ordena os itens da maior para a menor contagem.
+ */
+static bool countsMore(const SpaceSaving::Item &a, const SpaceSaving::Item &b){
+    return a.count > b.count;
+}
+
+/**
+ * @brief Construtor do resumo vazio.
+ *
+ * @param capacity Número máximo de itens acompanhados, pelo menos 1.
+ */
+SpaceSaving::SpaceSaving(size_t capacity) : capacity(capacity > 0 ? capacity : 1){
+    heap.reserve(this->capacity);
+    // Tabela com pelo menos o dobro de posições que itens, para sondagens curtas
+    size_t size = 1;
+    while(size < 2 * this->capacity){
+        size <<= 1;
+    }
+    Slot free;
+    free.key = 0;
+    free.position = empty;
+    slots.assign(size, free);
+    mask = size - 1;
+}
+
+/**
+ * @brief Procura um item na tabela, a partir da posição dada pelo hash e
+ * seguindo para as próximas até achar o item ou uma posição livre.
+ *
+ * @param key Hash do item.
+ * @return Posição da tabela com o item, ou a posição livre onde ele entraria.
+ */
+size_t SpaceSaving::find(uint64_t key) const{
+    size_t slot = (size_t)(key ^ (key >> 32)) & mask;
+    while(slots[slot].position != empty && slots[slot].key != key){
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Tira um item da tabela, trazendo para trás os itens seguintes que
+ * foram colocados adiante por sondagem, para que as buscas continuem
+ * encontrando-os.
+ *
+ * @param key Hash do item, que deve estar na tabela.
+ */
+void SpaceSaving::erase(uint64_t key){
+    size_t hole = find(key);
+    size_t slot = hole;
+    while(true){
+        slot = (slot + 1) & mask;
+        if(slots[slot].position == empty){
+            break;
+        }
+        size_t home = (size_t)(slots[slot].key ^ (slots[slot].key >> 32)) & mask;
+        // O item pode ocupar o buraco se o buraco está entre a posição inicial dele e a atual
+        if(((slot - home) & mask) >= ((slot - hole) & mask)){
+            slots[hole] = slots[slot];
+            hole = slot;
+        }
+    }
+    slots[hole].position = empty;
+}
+
+/**
+ * @brief Desce um item no heap, subindo o filho de menor contagem para o
+ * lugar dele, até que nenhum filho tenha contagem menor. Só as posições dos
+ * itens movidos são atualizadas na tabela, cada uma uma vez.
+ *
+ * @param position Posição do item no heap.
+ */
+void SpaceSaving::siftDown(size_t position){
+    Item item = heap[position];
+    while(true){
+        size_t smallest = 2 * position + 1;
+        if(smallest >= heap.size()){
+            break;
+        }
+        if(smallest + 1 < heap.size() && heap[smallest + 1].count < heap[smallest].count){
+            smallest++;
+        }
+        if(heap[smallest].count >= item.count){
+            break;
+        }
+        heap[position] = heap[smallest];
+        slots[find(heap[position].key)].position = position;
+        position = smallest;
+    }
+    heap[position] = item;
+    slots[find(item.key)].position = position;
+}
+
+/**
+ * @brief Sobe um item no heap, descendo o pai para o lugar dele, enquanto o
+ * pai tiver contagem maior.
+ *
+ * @param position Posição do item no heap.
+ */
+void SpaceSaving::siftUp(size_t position){
+    Item item = heap[position];
+    while(position > 0){
+        size_t parent = (position - 1) / 2;
+        if(heap[parent].count <= item.count){
+            break;
+        }
+        heap[position] = heap[parent];
+        slots[find(heap[position].key)].position = position;
+        position = parent;
+    }
+    heap[position] = item;
+    slots[find(item.key)].position = position;
+}
+
+/**
+ * @brief Reconstrói o heap e as posições depois que os itens foram trocados.
+ */
+void SpaceSaving::rebuild(){
+    for(size_t i = 0; i < slots.size(); i++){
+        slots[i].position = empty;
+    }
+    for(size_t i = 0; i < heap.size(); i++){
+        Slot &slot = slots[find(heap[i].key)];
+        slot.key = heap[i].key;
+        slot.position = i;
+    }
+    for(size_t i = heap.size() / 2; i-- > 0;){
+        siftDown(i);
+    }
+}
+
+/**
+ * @brief Conta um item. Um item é contado uma única vez por grupo: se ele
+ * já foi contado no mesmo grupo (a mesma playlist), a chamada é ignorada.
+ * Os grupos devem ser contados um de cada vez.
+ *
+ * @param key Hash que identifica o item.
+ * @param sample Música que representa o item.
+ * @param group Grupo em que o item aparece.
+ */
+void SpaceSaving::add(uint64_t key, const Song *sample, size_t group){
+    size_t slot = find(key);
+    if(slots[slot].position != empty){
+        Item &item = heap[slots[slot].position];
+        if(item.last != group){
+            item.last = group;
+            item.count++;
+            siftDown(slots[slot].position);
+        }
+        return;
+    }
+
+    Item item;
+    item.key = key;
+    item.last = group;
+    item.sample = sample;
+    if(heap.size() < capacity){
+        item.count = 1;
+        item.error = 0;
+        heap.push_back(item);
+        slots[slot].key = key;
+        slots[slot].position = heap.size() - 1;
+        siftUp(heap.size() - 1);
+        return;
+    }
+
+    // Toma o lugar do item de menor contagem
+    item.count = heap[0].count + 1;
+    item.error = heap[0].count;
+    erase(heap[0].key);
+    heap[0] = item;
+    slot = find(key);
+    slots[slot].key = key;
+    slots[slot].position = 0;
+    siftDown(0);
+}
+
+/**
+ * @brief Une a este resumo um resumo feito sobre outra parte dos dados. Um
+ * item que falta em um dos resumos pode ter sido contado lá até a menor
+ * contagem dele, que é somada à contagem e ao erro. Ficam os capacity itens
+ * de maior contagem.
+ *
+ * @param other Resumo da outra parte, com grupos diferentes dos deste.
+ */
+void SpaceSaving::merge(const SpaceSaving &other){
+    size_t minimum = getMinimum();
+    size_t otherMinimum = other.getMinimum();
+
+    std::vector<Item> combined;
+    combined.reserve(heap.size() + other.heap.size());
+    for(size_t i = 0; i < heap.size(); i++){
+        Item item = heap[i];
+        size_t slot = other.find(item.key);
+        if(other.slots[slot].position != empty){
+            item.count += other.heap[other.slots[slot].position].count;
+            item.error += other.heap[other.slots[slot].position].error;
+        }
+        else{
+            item.count += otherMinimum;
+            item.error += otherMinimum;
+        }
+        combined.push_back(item);
+    }
+    for(size_t i = 0; i < other.heap.size(); i++){
+        if(slots[find(other.heap[i].key)].position == empty){
+            Item item = other.heap[i];
+            item.count += minimum;
+            item.error += minimum;
+            combined.push_back(item);
+        }
+    }
+
+    if(combined.size() > capacity){
+        std::nth_element(combined.begin(), combined.begin() + capacity, combined.end(), countsMore);
+        combined.resize(capacity);
+    }
+    heap.swap(combined);
+    rebuild();
+}
+
+/**
+ * @brief Retorna a menor contagem do resumo cheio. Um item fora do resumo foi
+ * contado no máximo essa quantidade de vezes.
+ *
+ * @return Menor contagem, ou 0 se o resumo ainda não encheu.
+ */
+size_t SpaceSaving::getMinimum() const{
+    return heap.size() == capacity ? heap[0].count : 0;
+}
+
+/**
+ * @brief Retorna o número máximo de itens acompanhados.
+ *
+ * @return Capacidade do resumo.
+ */
+size_t SpaceSaving::getCapacity() const{
+    return capacity;
+}
+
+/**
+ * @brief Retorna os itens acompanhados.
+ *
+ * @return Itens, na ordem do heap.
+ */
+const std::vector<SpaceSaving::Item> &SpaceSaving::getItems() const{
+    return heap;
+}
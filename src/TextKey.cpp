@@ -0,0 +1,149 @@
+/**
+ * @file TextKey.cpp
+ * @brief Arquivo que implementa as funções que geram chaves de comparação de textos.
+ */
+
+#include <string>
+#include <cstdint>
+#include "TextKey.hpp"
+
+/**
+ * @brief Faixa de caracteres Unicode com a mesma letra base.
+ */
+struct FoldRange{
+    uint32_t first; //!< Primeiro caractere da faixa.
+    uint32_t last; //!< Último caractere da faixa.
+    const char *base; //!< Letras base, em minúsculas e sem acento.
+};
+
+//! Letras base dos blocos Latin-1 Supplement e Latin Extended-A.
+static const FoldRange foldRanges[] = {
+    {0x00C0, 0x00C5, "a"}, {0x00C6, 0x00C6, "ae"}, {0x00C7, 0x00C7, "c"}, {0x00C8, 0x00CB, "e"},
+    {0x00CC, 0x00CF, "i"}, {0x00D0, 0x00D0, "d"}, {0x00D1, 0x00D1, "n"}, {0x00D2, 0x00D6, "o"},
+    {0x00D8, 0x00D8, "o"}, {0x00D9, 0x00DC, "u"}, {0x00DD, 0x00DD, "y"}, {0x00DE, 0x00DE, "th"},
+    {0x00DF, 0x00DF, "ss"}, {0x00E0, 0x00E5, "a"}, {0x00E6, 0x00E6, "ae"}, {0x00E7, 0x00E7, "c"},
+    {0x00E8, 0x00EB, "e"}, {0x00EC, 0x00EF, "i"}, {0x00F0, 0x00F0, "d"}, {0x00F1, 0x00F1, "n"},
+    {0x00F2, 0x00F6, "o"}, {0x00F8, 0x00F8, "o"}, {0x00F9, 0x00FC, "u"}, {0x00FD, 0x00FD, "y"},
+    {0x00FE, 0x00FE, "th"}, {0x00FF, 0x00FF, "y"},
+    {0x0100, 0x0105, "a"}, {0x0106, 0x010D, "c"}, {0x010E, 0x0111, "d"}, {0x0112, 0x011B, "e"},
+    {0x011C, 0x0123, "g"}, {0x0124, 0x0127, "h"}, {0x0128, 0x0131, "i"}, {0x0132, 0x0133, "ij"},
+    {0x0134, 0x0135, "j"}, {0x0136, 0x0138, "k"}, {0x0139, 0x0142, "l"}, {0x0143, 0x014B, "n"},
+    {0x014C, 0x0151, "o"}, {0x0152, 0x0153, "oe"}, {0x0154, 0x0159, "r"}, {0x015A, 0x0161, "s"},
+    {0x0162, 0x0167, "t"}, {0x0168, 0x0173, "u"}, {0x0174, 0x0175, "w"}, {0x0176, 0x0178, "y"},
+    {0x0179, 0x017E, "z"}, {0x017F, 0x017F, "s"}
+};
+
+/**
+ * @brief Decodifica um caractere UTF-8.
+ *
+ * @param text Texto.
+ * @param pos Posição do primeiro byte do caractere.
+ * @param length Recebe o número de bytes do caractere.
+ * @return O caractere decodificado, ou o próprio byte se a sequência for inválida.
+ */
+static uint32_t decodeUtf8(const std::string &text, size_t pos, size_t &length){
+    unsigned char c = text[pos];
+    uint32_t code;
+
+    if(c < 0x80){ length = 1; return c; }
+    else if((c & 0xE0) == 0xC0){ length = 2; code = c & 0x1F; }
+    else if((c & 0xF0) == 0xE0){ length = 3; code = c & 0x0F; }
+    else if((c & 0xF8) == 0xF0){ length = 4; code = c & 0x07; }
+    else{ length = 1; return c; }
+
+    if(pos + length > text.size()){
+        length = 1;
+        return c;
+    }
+    for(size_t i = 1; i < length; i++){
+        unsigned char next = text[pos + i];
+        if((next & 0xC0) != 0x80){
+            length = 1;
+            return c;
+        }
+        code = (code << 6) | (next & 0x3F);
+    }
+    return code;
+}
+
+/**
+ * @brief Gera a chave de comparação de um texto em UTF-8.
+ *
+ * Letras ASCII são convertidas para minúsculas, letras latinas acentuadas
+ * (como "ã", "É" e "ç") são trocadas pela letra base e acentos combinados
+ * (U+0300 a U+036F) são descartados. Os demais caracteres são mantidos.
+ * Assim, "Leão", "LEAO" e "leao" geram a mesma chave.
+ *
+ * @param text Texto original.
+ * @return Chave de comparação do texto.
+ */
+std::string foldText(const std::string &text){
+    std::string key;
+    key.reserve(text.size());
+
+    size_t pos = 0;
+    while(pos < text.size()){
+        size_t length;
+        uint32_t code = decodeUtf8(text, pos, length);
+
+        if(length == 1){
+            unsigned char c = text[pos];
+            key += (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : (char)c;
+        }
+        else if(code >= 0x0300 && code <= 0x036F){
+            // Acento combinado: descartado
+        }
+        else{
+            const char *base = nullptr;
+            if(code >= 0x00C0 && code <= 0x017F){
+                for(size_t i = 0; i < sizeof(foldRanges) / sizeof(foldRanges[0]); i++){
+                    if(code >= foldRanges[i].first && code <= foldRanges[i].last){
+                        base = foldRanges[i].base;
+                        break;
+                    }
+                }
+            }
+            if(base != nullptr){
+                key += base;
+            }
+            else{
+                key.append(text, pos, length);
+            }
+        }
+        pos += length;
+    }
+    return key;
+}
+
+/**
+ * @brief Calcula o hash FNV-1a de 64 bits de uma sequência de bytes.
+ *
+ * @param data Início da sequência.
+ * @param size Tamanho da sequência.
+ * @return Hash da sequência.
+ */
+uint64_t hashBytes(const char *data, size_t size){
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < size; i++){
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Retorna a memória alocada por um texto fora do próprio objeto.
+ * Textos curtos ficam dentro do objeto (std::string guarda alguns bytes sem
+ * alocar), e nesse caso nada é contado.
+ *
+ * @param text Texto.
+ * @return Bytes alocados para os caracteres, ou 0 se eles estão no objeto.
+ */
+size_t heapBytes(const std::string &text){
+    const char *data = text.data();
+    const char *object = reinterpret_cast<const char*>(&text);
+    if(data >= object && data < object + sizeof(text)){
+        return 0;
+    }
+    return text.capacity() + 1;
+}
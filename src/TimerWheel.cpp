@@ -0,0 +1,132 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief Arquivo que implementa os métodos da classe TimerWheel.
+ */
+
+#include "TimerWheel.hpp"
+
+const unsigned TimerWheel::levelBits;
+const size_t TimerWheel::slotCount;
+const unsigned TimerWheel::levels;
+
+/**
+ * @brief Construtor da roda vazia.
+ *
+ * @param start Tique inicial.
+ */
+TimerWheel::TimerWheel(unsigned long long start){
+    now = start;
+    pending = 0;
+    for(unsigned level = 0; level < levels; level++){
+        for(size_t i = 0; i < slotCount; i++){
+            slots[level][i].prev = &slots[level][i];
+            slots[level][i].next = &slots[level][i];
+        }
+    }
+}
+
+/**
+ * @brief Liga um temporizador ao final da posição que corresponde ao seu
+ * vencimento: o menor nível cujo intervalo, a partir do tique atual, contém
+ * o vencimento. Vencimentos além do último nível ficam na posição mais
+ * distante dele e descem quando ela é redistribuída.
+ *
+ * @param timer Temporizador, com expires já definido e maior ou igual ao tique atual.
+ */
+void TimerWheel::insert(Timer &timer){
+    unsigned long long delta = timer.expires - now;
+    unsigned long long expires = timer.expires;
+    unsigned level = 0;
+    while(level + 1 < levels && delta >= (1ULL << ((level + 1) * levelBits))){
+        level++;
+    }
+    if(level == levels - 1 && delta >= (1ULL << (levels * levelBits))){
+        expires = now + (1ULL << (levels * levelBits)) - 1;
+    }
+
+    Timer &head = slots[level][(expires >> (level * levelBits)) & (slotCount - 1)];
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+}
+
+/**
+ * @brief Redistribui os temporizadores de uma posição de um nível pelos
+ * níveis de baixo, de acordo com o tempo que falta para cada um vencer.
+ *
+ * @param level Nível da posição.
+ * @param index Índice da posição no nível.
+ */
+void TimerWheel::cascade(unsigned level, size_t index){
+    Timer &head = slots[level][index];
+    Timer *curr = head.next;
+    head.next = &head;
+    head.prev = &head;
+
+    while(curr != &head){
+        Timer *next = curr->next;
+        insert(*curr);
+        curr = next;
+    }
+}
+
+/**
+ * @brief Desliga um temporizador da lista em que está e o marca como não agendado.
+ *
+ * @param timer Temporizador agendado.
+ */
+void TimerWheel::unlink(Timer &timer){
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = nullptr;
+    timer.next = nullptr;
+}
+
+/**
+ * @brief Agenda um temporizador. Se ele já estava agendado, o agendamento
+ * anterior é substituído. Um vencimento que já passou é adiado para o
+ * próximo tique.
+ *
+ * @param timer Temporizador a agendar.
+ * @param expires Tique em que o temporizador deve vencer.
+ */
+void TimerWheel::schedule(Timer &timer, unsigned long long expires){
+    if(timer.isScheduled()){
+        unlink(timer);
+        pending--;
+    }
+    timer.expires = (expires > now) ? expires : now + 1;
+    insert(timer);
+    pending++;
+}
+
+/**
+ * @brief Cancela um temporizador. Não faz nada se ele não está agendado.
+ *
+ * @param timer Temporizador a cancelar.
+ */
+void TimerWheel::cancel(Timer &timer){
+    if(timer.isScheduled()){
+        unlink(timer);
+        pending--;
+    }
+}
+
+/**
+ * @brief Retorna o tique atual.
+ *
+ * @return Último tique já processado.
+ */
+unsigned long long TimerWheel::getTime() const{
+    return now;
+}
+
+/**
+ * @brief Retorna o número de temporizadores agendados.
+ *
+ * @return Número de temporizadores que ainda não venceram.
+ */
+size_t TimerWheel::getPending() const{
+    return pending;
+}
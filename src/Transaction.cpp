@@ -0,0 +1,386 @@
+/**
+ * @file Transaction.cpp
+ * @brief Arquivo que implementa os métodos da classe Transaction.
+ */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "Node.hpp"
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+#include "SearchIndex.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+#include "Transaction.hpp"
+
+/**
+ * @brief Guarda uma alteração.
+ *
+ * @param kind Tipo da alteração.
+ * @param playlist Nome da playlist alterada.
+ * @param source Nome da playlist mesclada, em Merge.
+ * @param song Música adicionada ou removida.
+ */
+void Transaction::push(Kind kind, const std::string &playlist, const std::string &source, const Song &song){
+    Change change;
+    change.kind = kind;
+    change.playlist = playlist;
+    change.source = source;
+    change.song = song;
+    changes.push_back(change);
+}
+
+/**
+ * @brief Guarda a criação de uma playlist vazia. O nome não pode estar em uso
+ * quando a alteração for conferida.
+ *
+ * @param name Nome da playlist.
+ */
+void Transaction::createPlaylist(const std::string &name){
+    push(CreatePlaylist, name, "", Song());
+}
+
+/**
+ * @brief Guarda a remoção de uma playlist.
+ *
+ * @param name Nome da playlist.
+ */
+void Transaction::removePlaylist(const std::string &name){
+    push(RemovePlaylist, name, "", Song());
+}
+
+/**
+ * @brief Guarda a adição de uma música do catálogo ao final de uma playlist.
+ * A música deve estar no catálogo e ainda não estar na playlist.
+ *
+ * @param playlist Nome da playlist.
+ * @param song Música, comparada pela identidade.
+ */
+void Transaction::addSong(const std::string &playlist, const Song &song){
+    push(AddSong, playlist, "", song);
+}
+
+/**
+ * @brief Guarda a remoção da primeira ocorrência de uma música de uma playlist.
+ *
+ * @param playlist Nome da playlist.
+ * @param song Música, comparada pela identidade.
+ */
+void Transaction::removeSong(const std::string &playlist, const Song &song){
+    push(RemoveSong, playlist, "", song);
+}
+
+/**
+ * @brief Guarda a mescla de uma playlist em outra: as músicas de source que
+ * playlist não tem são adicionadas ao final dela, na ordem de source, como em
+ * Playlist::operator+.
+ *
+ * @param playlist Nome da playlist que recebe as músicas.
+ * @param source Nome da playlist mesclada, que não é alterada.
+ */
+void Transaction::merge(const std::string &playlist, const std::string &source){
+    push(Merge, playlist, source, Song());
+}
+
+/**
+ * @brief Retorna o número de alterações guardadas.
+ *
+ * @return Número de alterações.
+ */
+size_t Transaction::getSize() const{
+    return changes.size();
+}
+
+/**
+ * @brief Descarta as alterações guardadas.
+ */
+void Transaction::clear(){
+    changes.clear();
+}
+
+/**
+ * @brief Verifica se uma playlist tem uma música, depois das alterações já
+ * conferidas.
+ *
+ * @param playlist Estado da playlist; a música deve estar em counts, se a
+ * playlist não tiver todas as músicas contadas.
+ * @param song Música, comparada pela identidade.
+ * @return true se a playlist tem a música.
+ */
+bool Transaction::contains(Staged &playlist, const Song *song){
+    if(playlist.keepsLive){
+        SongCounts::iterator found = playlist.counts.find(song);
+        if(found != playlist.counts.end() && found->second.live > found->second.removed){
+            return true;
+        }
+    }
+    return playlist.addedMembers.count(song) > 0;
+}
+
+/**
+ * @brief Monta as músicas de uma playlist depois das alterações já
+ * conferidas: as músicas da playlist da biblioteca, sem as ocorrências
+ * removidas, seguidas das músicas adicionadas.
+ *
+ * @param playlist Estado da playlist.
+ * @param songs Recebe as músicas, em ordem.
+ */
+void Transaction::listSongs(Staged &playlist, std::vector<const Song*> &songs){
+    songs.clear();
+    if(playlist.keepsLive){
+        std::unordered_map<const Song*, size_t, SongHash, SongEqual> skipped;
+        for(SongCounts::iterator it = playlist.counts.begin(); it != playlist.counts.end(); ++it){
+            if(it->second.removed > 0){
+                skipped[it->first] = it->second.removed;
+            }
+        }
+        for(const Node<Song> *curr = playlist.live->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+            if(!skipped.empty()){
+                auto found = skipped.find(&curr->getValue());
+                if(found != skipped.end() && found->second > 0){
+                    found->second--;
+                    continue;
+                }
+            }
+            songs.push_back(&curr->getValue());
+        }
+    }
+    songs.insert(songs.end(), playlist.added.begin(), playlist.added.end());
+}
+
+/**
+ * @brief Confere as alterações em ordem, montando em staged o estado de cada
+ * playlist afetada. A biblioteca não é alterada.
+ *
+ * As playlists da biblioteca são procuradas pelo nome no editor, e as músicas
+ * do catálogo pelo índice de busca. Cada playlist afetada é percorrida uma
+ * única vez, contando apenas as músicas que as alterações adicionam ou
+ * removem; só as playlists que recebem uma mescla têm todas as músicas
+ * contadas. As músicas das playlists não são copiadas: o estado guarda as
+ * músicas adicionadas e quantas ocorrências de cada música foram removidas.
+ *
+ * @param editor Editor da biblioteca.
+ * @param staged Recebe o estado das playlists afetadas, pelo nome.
+ * @param error Recebe a descrição da primeira alteração inválida.
+ * @return true se todas as alterações são válidas.
+ */
+bool Transaction::stage(Library::Editor &editor, std::unordered_map<std::string, Staged> &staged, std::string &error){
+    for(size_t i = 0; i < changes.size(); i++){
+        for(int k = 0; k < ((changes[i].kind == Merge) ? 2 : 1); k++){
+            const std::string &name = (k == 0) ? changes[i].playlist : changes[i].source;
+            if(staged.count(name) > 0){
+                continue;
+            }
+            Staged &playlist = staged[name];
+            playlist.live = editor.findPlaylist(name);
+            playlist.exists = playlist.live != nullptr;
+            playlist.created = false;
+            playlist.keepsLive = playlist.exists;
+            playlist.complete = false;
+            playlist.rewritten = false;
+            playlist.creation = 0;
+        }
+        Staged &playlist = staged[changes[i].playlist];
+        if(changes[i].kind == AddSong || changes[i].kind == RemoveSong){
+            Occurrences none = {0, 0};
+            playlist.counts.insert(std::make_pair(&changes[i].song, none));
+        }
+        else if(changes[i].kind == Merge){
+            playlist.complete = true;
+        }
+    }
+
+    // Uma passagem por playlist, contando as músicas procuradas (ou todas, no destino de uma mescla)
+    for(auto it = staged.begin(); it != staged.end(); ++it){
+        Staged &playlist = it->second;
+        if(playlist.live == nullptr || (!playlist.complete && playlist.counts.empty())){
+            continue;
+        }
+        for(const Node<Song> *curr = playlist.live->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+            if(playlist.complete){
+                playlist.counts[&curr->getValue()].live++;
+            }
+            else{
+                SongCounts::iterator found = playlist.counts.find(&curr->getValue());
+                if(found != playlist.counts.end()){
+                    found->second.live++;
+                }
+            }
+        }
+    }
+
+    size_t created = 0;
+    for(size_t i = 0; i < changes.size(); i++){
+        Change &change = changes[i];
+        Staged &playlist = staged[change.playlist];
+        std::string message;
+
+        if(change.kind == CreatePlaylist){
+            if(playlist.exists){
+                message = "playlist já existe";
+            }
+            else{
+                playlist.exists = true;
+                playlist.created = true;
+                playlist.keepsLive = false;
+                playlist.rewritten = false;
+                playlist.added.clear();
+                playlist.addedMembers.clear();
+                playlist.creation = created++;
+            }
+        }
+        else if(!playlist.exists){
+            message = "playlist inválida";
+        }
+        else if(change.kind == RemovePlaylist){
+            playlist.exists = false;
+            playlist.created = false;
+            playlist.keepsLive = false;
+            playlist.added.clear();
+            playlist.addedMembers.clear();
+        }
+        else if(change.kind == AddSong){
+            Song *found = editor.index().find(change.song);
+            if(found == nullptr){
+                message = "música inválida";
+            }
+            else if(contains(playlist, found)){
+                message = "música já está na playlist";
+            }
+            else{
+                playlist.added.push_back(found);
+                playlist.addedMembers.insert(found);
+            }
+        }
+        else if(change.kind == RemoveSong){
+            SongCounts::iterator counted = playlist.counts.find(&change.song);
+            if(playlist.keepsLive && counted != playlist.counts.end() && counted->second.live > counted->second.removed){
+                counted->second.removed++;
+                playlist.rewritten = true;
+            }
+            else{
+                // Remover uma música adicionada pela própria transação não impede a troca só dos nós novos
+                auto found = std::find_if(playlist.added.begin(), playlist.added.end(), [&change](const Song *song){
+                    return song->equals(change.song);
+                });
+                if(found == playlist.added.end()){
+                    message = "música não está na playlist";
+                }
+                else{
+                    playlist.addedMembers.erase(*found);
+                    playlist.added.erase(found);
+                }
+            }
+        }
+        else{
+            Staged &source = staged[change.source];
+            if(!source.exists){
+                message = "playlist inválida";
+            }
+            else if(&source != &playlist){
+                std::vector<const Song*> songs;
+                listSongs(source, songs);
+                for(size_t k = 0; k < songs.size(); k++){
+                    if(!contains(playlist, songs[k])){
+                        playlist.added.push_back(songs[k]);
+                        playlist.addedMembers.insert(songs[k]);
+                    }
+                }
+            }
+        }
+
+        if(!message.empty()){
+            error = "alteração " + std::to_string(i + 1) + ": " + message;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Confere e aplica todas as alterações, ou nenhuma.
+ *
+ * Primeiro as alterações são conferidas (stage) e as novas músicas de cada
+ * playlist afetada são copiadas para fora da biblioteca; qualquer falha até
+ * aqui deixa a biblioteca como estava. Depois, sob o mesmo editor, as
+ * playlists removidas saem da lista, as playlists que só receberam músicas no
+ * final recebem os nós novos (Playlist::moveSongs), as demais trocam a lista
+ * inteira (Playlist::replaceSongs), e as playlists criadas entram no final,
+ * na ordem de criação. A nova versão é publicada quando o editor termina.
+ *
+ * @param library Biblioteca alterada.
+ * @param error Recebe a descrição da primeira alteração inválida.
+ * @return true se as alterações foram aplicadas; nesse caso, elas são descartadas da transação.
+ */
+bool Transaction::commit(Library &library, std::string &error){
+    Library::Editor editor(library);
+    std::unordered_map<std::string, Staged> staged;
+    if(!stage(editor, staged, error)){
+        return false;
+    }
+
+    std::unordered_set<const Playlist*> removed;
+    std::vector<std::pair<const std::string, Staged>*> created;
+    for(auto it = staged.begin(); it != staged.end(); ++it){
+        Staged &playlist = it->second;
+        if(playlist.live != nullptr && (playlist.created || !playlist.exists)){
+            removed.insert(playlist.live);
+        }
+        if(!playlist.exists){
+            continue;
+        }
+        if(playlist.created || playlist.rewritten){
+            std::vector<const Song*> songs;
+            listSongs(playlist, songs);
+            playlist.content.addSongs(songs);
+        }
+        else if(!playlist.added.empty()){
+            playlist.content.addSongs(playlist.added);
+        }
+        if(playlist.created){
+            created.push_back(&*it);
+        }
+    }
+    std::sort(created.begin(), created.end(), [](const std::pair<const std::string, Staged> *a,
+                                                 const std::pair<const std::string, Staged> *b){
+        return a->second.creation < b->second.creation;
+    });
+
+    EditHistory &history = editor.history();
+    std::string label = (changes.size() == 1) ? "Aplicar 1 alteração em lote" :
+                        "Aplicar " + std::to_string(changes.size()) + " alterações em lote";
+    EditHistory::Batch batch(&history, label);
+    if(!removed.empty()){
+        history.removePlaylistsIf([&removed](Playlist &playlist){ return removed.count(&playlist) > 0; });
+    }
+    for(auto it = staged.begin(); it != staged.end(); ++it){
+        Staged &playlist = it->second;
+        if(playlist.live == nullptr || playlist.created || !playlist.exists){
+            continue;
+        }
+        if(playlist.rewritten){
+            playlist.live->replaceSongs(playlist.content);
+        }
+        else if(!playlist.added.empty()){
+            playlist.live->moveSongs(playlist.content);
+        }
+    }
+
+    LinkedList<Playlist> &playlists = editor.playlists();
+    unsigned long long prior = playlists.getVersion();
+    Node<Playlist> *lastKnown = playlists.getTail();
+    for(size_t i = 0; i < created.size(); i++){
+        playlists.add(Playlist(created[i]->first));
+        playlists.getTail()->getValue().moveSongs(created[i]->second.content);
+    }
+    if(!created.empty()){
+        history.playlistsAppended(prior, lastKnown);
+    }
+    changes.clear();
+    return true;
+}
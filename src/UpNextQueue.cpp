@@ -0,0 +1,193 @@
+/**
+ * @file UpNextQueue.cpp
+ * @brief Arquivo que implementa os métodos da classe UpNextQueue.
+ */
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include "Song.hpp"
+#include "MpscRing.hpp"
+#include "UpNextQueue.hpp"
+
+/**
+ * @brief Construtor da fila vazia. A fila circular de pedidos e o vetor de
+ * músicas pendentes têm a mesma capacidade, uma potência de 2, com uma
+ * posição a mais de pedidos guardada para clear.
+ *
+ * @param capacity Número mínimo de músicas, e de pedidos ainda não aplicados, que a fila comporta.
+ */
+UpNextQueue::UpNextQueue(size_t capacity)
+    : commands(capacity + 1), pending(commands.getCapacity(), nullptr), clearsSent(0){
+    first = 0;
+    count = 0;
+    hasStalled = false;
+    clearsApplied = 0;
+}
+
+/**
+ * @brief Envia um pedido à thread de reprodução, sem esperar. Os pedidos que
+ * adicionam músicas deixam uma posição livre na fila de pedidos, então um
+ * Clear é aceito mesmo quando eles já a encheram.
+ *
+ * @param type Tipo do pedido.
+ * @param song Música do pedido.
+ * @return true se o pedido foi enviado, false se a fila de pedidos está cheia.
+ */
+bool UpNextQueue::send(Command::Type type, const Song *song){
+    Command command;
+    command.type = type;
+    command.song = song;
+    return commands.push(command, type == Command::Clear ? 0 : 1);
+}
+
+/**
+ * @brief Aplica um pedido às músicas pendentes. Um pedido Clear sempre é
+ * aplicado; os outros precisam de espaço em pending.
+ *
+ * @param command Pedido a ser aplicado.
+ * @return true se o pedido foi aplicado, false se não há espaço.
+ */
+bool UpNextQueue::apply(const Command &command){
+    size_t mask = pending.size() - 1;
+
+    if(command.type == Command::Clear){
+        count = 0;
+        return true;
+    }
+    if(count == pending.size()){
+        return false;
+    }
+    if(command.type == Command::Push){
+        pending[(first + count) & mask] = command.song;
+    }
+    else{
+        first = (first + mask) & mask;
+        pending[first] = command.song;
+    }
+    count++;
+    return true;
+}
+
+/**
+ * @brief Aplica, em ordem, os pedidos recebidos. Se um pedido não cabe nas
+ * músicas pendentes, ele é guardado e os seguintes esperam na fila circular.
+ *
+ * Um Clear enviado passa à frente dos pedidos que esperam: se clearsSent
+ * indica pedidos Clear ainda não aplicados, as músicas pendentes e o pedido
+ * guardado são descartados, assim como os pedidos da fila circular até o
+ * último desses Clear. Sem isso, um Clear atrás de um pedido guardado só
+ * seria aplicado depois que a reprodução tirasse músicas da fila.
+ */
+void UpNextQueue::drain(){
+    Command command;
+    if((std::ptrdiff_t)(clearsSent.load(std::memory_order_acquire) - clearsApplied) > 0){
+        count = 0;
+        hasStalled = false;
+        while((std::ptrdiff_t)(clearsSent.load(std::memory_order_acquire) - clearsApplied) > 0 &&
+              commands.pop(command)){
+            if(command.type == Command::Clear){
+                clearsApplied++;
+            }
+        }
+    }
+
+    if(hasStalled){
+        if(!apply(stalled)){
+            return;
+        }
+        hasStalled = false;
+    }
+    while(commands.pop(command)){
+        if(command.type == Command::Clear){
+            clearsApplied++;
+        }
+        if(!apply(command)){
+            stalled = command;
+            hasStalled = true;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Adiciona uma música ao fim da fila. Pode ser chamado por qualquer
+ * thread, ao mesmo tempo que a reprodução.
+ *
+ * @param song Música a ser adicionada.
+ * @return true se o pedido foi aceito, false se a fila está cheia.
+ */
+bool UpNextQueue::push(const Song *song){
+    return send(Command::Push, song);
+}
+
+/**
+ * @brief Adiciona uma música ao início da fila, para tocar depois da música
+ * atual. Pode ser chamado por qualquer thread, ao mesmo tempo que a reprodução.
+ *
+ * @param song Música a ser adicionada.
+ * @return true se o pedido foi aceito, false se a fila está cheia.
+ */
+bool UpNextQueue::insertNext(const Song *song){
+    return send(Command::InsertNext, song);
+}
+
+/**
+ * @brief Remove todas as músicas da fila, incluindo as de pedidos anteriores
+ * ainda não aplicados. Pode ser chamado por qualquer thread, ao mesmo tempo
+ * que a reprodução.
+ *
+ * Uma posição da fila de pedidos é guardada para este pedido, então ele só
+ * é recusado se outro clear já a ocupa; nesse caso, o pedido pendente
+ * também remove as músicas enviadas até aqui. Depois de enviado, o pedido é
+ * contado em clearsSent, para que a reprodução o aplique mesmo com pedidos
+ * anteriores esperando espaço.
+ *
+ * @return true se o pedido foi aceito, false se a fila de pedidos está cheia.
+ */
+bool UpNextQueue::clear(){
+    if(!send(Command::Clear, nullptr)){
+        return false;
+    }
+    clearsSent.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Retira a próxima música da fila, depois de aplicar os pedidos
+ * recebidos. Deve ser chamado sempre pela mesma thread.
+ *
+ * @return A música, ou nullptr se a fila está vazia.
+ */
+const Song *UpNextQueue::take(){
+    drain();
+    if(count == 0){
+        return nullptr;
+    }
+    const Song *song = pending[first];
+    first = (first + 1) & (pending.size() - 1);
+    count--;
+    return song;
+}
+
+/**
+ * @brief Retorna a próxima música da fila, sem retirá-la, depois de aplicar
+ * os pedidos recebidos. Deve ser chamado sempre pela mesma thread.
+ *
+ * @return A música, ou nullptr se a fila está vazia.
+ */
+const Song *UpNextQueue::peek(){
+    drain();
+    return count > 0 ? pending[first] : nullptr;
+}
+
+/**
+ * @brief Retorna o número de músicas na fila, depois de aplicar os pedidos
+ * recebidos. Deve ser chamado sempre pela mesma thread.
+ *
+ * @return Número de músicas.
+ */
+size_t UpNextQueue::getSize(){
+    drain();
+    return count;
+}
@@ -0,0 +1,570 @@
+/**
+ * @file Watcher.cpp
+ * @brief Arquivo que implementa os métodos da classe Watcher.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include "LinkedList.hpp"
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "SongSet.hpp"
+#include "TextKey.hpp"
+#include "EditHistory.hpp"
+#include "Library.hpp"
+#include "Loader.hpp"
+#include "Watcher.hpp"
+
+//! Tempo sem mudanças esperado antes de recarregar um arquivo.
+static const std::chrono::milliseconds settleTime(200);
+//! Eventos do inotify acompanhados em cada pasta.
+static const uint32_t watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+/**
+ * @brief Retorna a pasta de um arquivo, com '/' no final.
+ *
+ * @param path Caminho do arquivo.
+ * @return Caminho da pasta, ou vazio se o arquivo está na pasta atual.
+ */
+static std::string parentPrefix(const std::string &path){
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+/**
+ * @brief Verifica se duas músicas são a mesma e têm a mesma duração, ano e
+ * número de execuções, para que uma linha que só mudou esses atributos
+ * também atualize a playlist.
+ *
+ * @param a Primeira música.
+ * @param b Segunda música.
+ * @return Retorna true caso as músicas e seus atributos sejam iguais.
+ */
+static bool sameSong(const Song &a, const Song &b){
+    return a.equals(b) && a.getDuration() == b.getDuration() && a.getYear() == b.getYear() &&
+           a.getPlays() == b.getPlays();
+}
+
+/**
+ * @brief Construtor do Watcher.
+ *
+ * @param library Biblioteca que recebe as alterações.
+ */
+Watcher::Watcher(Library &library) : library(library){
+    verbose = false;
+    inotifyFd = -1;
+    stopFd = -1;
+    knownSongsVersion = 0;
+    knownPlaylistsVersion = 0;
+}
+
+/**
+ * @brief Destrutor do Watcher, que interrompe o acompanhamento.
+ */
+Watcher::~Watcher(){
+    stop();
+}
+
+/**
+ * @brief Começa a acompanhar, em uma thread separada, os arquivos e pastas
+ * indicados. O conteúdo atual dos arquivos é tomado como já carregado na
+ * biblioteca (pelo Loader); apenas as mudanças seguintes são aplicadas.
+ *
+ * @param paths Caminhos de arquivos ou pastas com playlists.
+ * @return Retorna false se o acompanhamento já foi iniciado ou se o inotify
+ * não pôde ser usado.
+ */
+bool Watcher::start(const std::vector<std::string> &paths){
+    if(worker.joinable()){
+        return false;
+    }
+
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(inotifyFd == -1 || stopFd == -1){
+        std::cerr << "Erro: Não foi possível acompanhar os arquivos: " << std::strerror(errno) << "\n";
+        stop();
+        return false;
+    }
+
+    this->paths = paths;
+    worker = std::thread(&Watcher::run, this);
+    return true;
+}
+
+/**
+ * @brief Interrompe o acompanhamento e espera o fim da thread.
+ */
+void Watcher::stop(){
+    if(worker.joinable()){
+        uint64_t one = 1;
+        if(write(stopFd, &one, sizeof(one)) == -1){
+            std::cerr << "Erro: Não foi possível interromper o acompanhamento: " << std::strerror(errno) << "\n";
+        }
+        worker.join();
+    }
+    if(inotifyFd != -1){
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+    if(stopFd != -1){
+        close(stopFd);
+        stopFd = -1;
+    }
+    watches.clear();
+    watchedDirs.clear();
+}
+
+/**
+ * @brief Define se o resultado de cada recarga é exibido na saída padrão
+ * assim que termina.
+ *
+ * @param verbose true para exibir o resultado.
+ */
+void Watcher::setVerbose(bool verbose){
+    this->verbose = verbose;
+}
+
+/**
+ * @brief Retorna os resultados das recargas feitas desde a última chamada.
+ * Pode ser chamado de qualquer thread.
+ *
+ * @return Resultados das recargas, na ordem em que foram feitas.
+ */
+std::vector<Watcher::Reload> Watcher::takeReports(){
+    std::lock_guard<std::mutex> lock(reportsMutex);
+    std::vector<Reload> taken;
+    taken.swap(reports);
+    return taken;
+}
+
+/**
+ * @brief Exibe o resultado de uma recarga em uma linha.
+ *
+ * @param os Fluxo de saída.
+ * @param reload Resultado da recarga.
+ */
+void Watcher::printReload(std::ostream &os, const Reload &reload){
+    os << "Arquivo recarregado: " << reload.path << ": ";
+    if(!reload.error.empty()){
+        os << "erro: " << reload.error << "\n";
+        return;
+    }
+    os << reload.lines << " linhas alteradas, " << reload.added << " playlists adicionadas, "
+       << reload.removed << " removidas, " << reload.replaced << " alteradas em "
+       << (long long)(reload.seconds * 1000) << " ms\n";
+}
+
+/**
+ * @brief Acompanha uma pasta com o inotify.
+ *
+ * @param prefix Caminho da pasta, com '/' no final, ou vazio para a pasta atual.
+ * @param tree Indica se arquivos novos da pasta também devem ser acompanhados.
+ */
+void Watcher::watch(const std::string &prefix, bool tree){
+    auto existing = watchedDirs.find(prefix);
+    if(existing != watchedDirs.end()){
+        watches[existing->second].tree |= tree;
+        return;
+    }
+
+    int wd = inotify_add_watch(inotifyFd, prefix.empty() ? "." : prefix.c_str(), watchMask);
+    if(wd == -1){
+        std::cerr << "Erro: Não foi possível acompanhar a pasta \"" << (prefix.empty() ? "." : prefix)
+                  << "\": " << std::strerror(errno) << "\n";
+        return;
+    }
+    Watch &entry = watches[wd];
+    entry.prefix = prefix;
+    entry.tree = tree;
+    watchedDirs[prefix] = wd;
+}
+
+/**
+ * @brief Guarda o hash, o texto e o nome da playlist de cada linha de um
+ * arquivo, sem alterar a biblioteca.
+ *
+ * @param path Caminho do arquivo.
+ */
+void Watcher::track(const std::string &path){
+    std::unordered_map<uint64_t, Line> &lines = files[path];
+    std::ifstream inputFile(path, std::ios::binary);
+
+    std::string line;
+    size_t position = 0;
+    while(std::getline(inputFile, line)){
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.erase(line.size() - 1);
+        }
+        if(line.empty()){
+            continue;
+        }
+
+        Line &entry = lines[hashBytes(line.data(), line.size())];
+        if(entry.count++ == 0){
+            entry.name = line.substr(0, line.find(';'));
+            entry.text = line;
+            entry.position = position;
+        }
+        names[entry.name]++;
+        position++;
+    }
+}
+
+/**
+ * @brief Lê os eventos do inotify e marca os arquivos alterados.
+ *
+ * @param dirty Arquivos a recarregar.
+ */
+void Watcher::readEvents(std::set<std::string> &dirty){
+    alignas(struct inotify_event) char buffer[16 * 1024];
+
+    while(true){
+        ssize_t count = read(inotifyFd, buffer, sizeof(buffer));
+        if(count <= 0){
+            return;
+        }
+
+        for(char *p = buffer; p < buffer + count; ){
+            struct inotify_event *event = (struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + event->len;
+
+            if(event->mask & IN_Q_OVERFLOW){
+                for(auto it = files.begin(); it != files.end(); ++it){
+                    dirty.insert(it->first);
+                }
+                continue;
+            }
+            auto entry = watches.find(event->wd);
+            if(entry == watches.end() || event->len == 0 || (event->mask & IN_ISDIR) || event->name[0] == '.'){
+                continue;
+            }
+
+            std::string path = entry->second.prefix + event->name;
+            if(entry->second.tree || files.count(path) != 0){
+                dirty.insert(path);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Acompanha os arquivos até stop ser chamado. Primeiro guarda as
+ * linhas atuais de cada arquivo; depois recarrega cada arquivo alterado
+ * quando ele fica settleTime sem mudanças.
+ */
+void Watcher::run(){
+    for(size_t i = 0; i < paths.size(); i++){
+        struct stat info;
+        bool tree = (stat(paths[i].c_str(), &info) == 0 && S_ISDIR(info.st_mode));
+        if(tree){
+            watch(paths[i] + "/", true);
+        }
+        else{
+            watch(parentPrefix(paths[i]), false);
+        }
+
+        std::vector<std::string> found;
+        std::string error;
+        Loader::listFiles(paths[i], found, error);
+        for(size_t j = 0; j < found.size(); j++){
+            if(tree){
+                watch(parentPrefix(found[j]), true);
+            }
+            track(found[j]);
+        }
+        if(!tree && found.empty()){
+            files[paths[i]];
+        }
+    }
+
+    std::set<std::string> dirty;
+    std::chrono::steady_clock::time_point lastChange;
+    struct pollfd fds[2];
+    fds[0].fd = stopFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = inotifyFd;
+    fds[1].events = POLLIN;
+
+    while(true){
+        int timeout = -1;
+        if(!dirty.empty()){
+            std::chrono::steady_clock::duration left = lastChange + settleTime - std::chrono::steady_clock::now();
+            timeout = std::max(0, (int)std::chrono::duration_cast<std::chrono::milliseconds>(left).count() + 1);
+        }
+
+        int count = poll(fds, 2, timeout);
+        if(count == -1 && errno != EINTR){
+            std::cerr << "Erro: Falha ao acompanhar os arquivos: " << std::strerror(errno) << "\n";
+            return;
+        }
+        if(count > 0 && (fds[0].revents & POLLIN)){
+            return;
+        }
+        if(count > 0 && (fds[1].revents & POLLIN)){
+            size_t before = dirty.size();
+            readEvents(dirty);
+            if(dirty.size() != before || !dirty.empty()){
+                lastChange = std::chrono::steady_clock::now();
+            }
+            continue;
+        }
+
+        if(dirty.empty() || std::chrono::steady_clock::now() < lastChange + settleTime){
+            continue;
+        }
+        for(auto it = dirty.begin(); it != dirty.end(); ++it){
+            Reload result = reload(*it);
+            if(verbose){
+                printReload(std::cout, result);
+            }
+            std::lock_guard<std::mutex> lock(reportsMutex);
+            reports.push_back(result);
+        }
+        dirty.clear();
+    }
+}
+
+/**
+ * @brief Recarrega um arquivo, aplicando à biblioteca apenas as linhas
+ * adicionadas e removidas desde a última leitura.
+ *
+ * Linhas iguais às já conhecidas são reconhecidas pelo hash e não são
+ * analisadas. Cada nome de playlist com linhas novas ou removidas é montado
+ * de novo com todas as suas linhas atuais, em todos os arquivos acompanhados
+ * (na ordem dos caminhos e, em cada arquivo, na ordem das linhas), unindo as
+ * músicas como no Loader:
+ * - se a playlist não existe, ela é adicionada;
+ * - senão, ela passa a ter as músicas montadas, caso sejam diferentes das
+ *   atuais. Assim, apagar ou editar uma das linhas de um nome com várias
+ *   linhas também altera a playlist.
+ * Só as linhas já conhecidas desses nomes são analisadas de novo. Playlists
+ * sem nenhuma linha em nenhum arquivo são removidas em uma única passagem
+ * pela lista. Um arquivo apagado é tratado como vazio. A recarga
+ * forma um único passo no histórico, que pode ser desfeito pelo menu.
+ *
+ * @param path Caminho do arquivo.
+ * @return Resultado da recarga.
+ */
+Watcher::Reload Watcher::reload(const std::string &path){
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    Reload result;
+    result.path = path;
+    result.lines = 0;
+    result.added = 0;
+    result.removed = 0;
+    result.replaced = 0;
+    result.seconds = 0;
+
+    struct stat info;
+    bool exists = (stat(path.c_str(), &info) == 0);
+    std::ifstream inputFile;
+    if(exists){
+        inputFile.open(path, std::ios::binary);
+    }
+    if(exists ? !inputFile.is_open() : errno != ENOENT){
+        result.error = "não foi possível abrir o arquivo";
+        return result;
+    }
+
+    std::unordered_map<uint64_t, Line> &previous = files[path];
+    std::unordered_map<uint64_t, Line> current;
+    current.reserve(previous.size());
+    // Playlists das linhas novas, já analisadas, pelo hash
+    std::unordered_map<uint64_t, Playlist> fresh;
+
+    std::string line;
+    size_t position = 0;
+    while(std::getline(inputFile, line)){
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.erase(line.size() - 1);
+        }
+        if(line.empty()){
+            continue;
+        }
+
+        uint64_t hash = hashBytes(line.data(), line.size());
+        Line &entry = current[hash];
+        if(entry.count++ > 0){
+            position++;
+            continue;
+        }
+        auto known = previous.find(hash);
+        if(known != previous.end()){
+            entry.name = known->second.name;
+        }
+        else{
+            entry.name = fresh.insert(std::make_pair(hash, Loader::parsePlaylist(line))).first->second.getName();
+        }
+        entry.text = line;
+        entry.position = position++;
+    }
+
+    // Linhas novas e removidas de cada nome
+    std::unordered_map<std::string, size_t> gained;
+    std::unordered_map<std::string, size_t> lost;
+    for(auto it = current.begin(); it != current.end(); ++it){
+        auto known = previous.find(it->first);
+        size_t before = (known == previous.end()) ? 0 : known->second.count;
+        if(it->second.count > before){
+            gained[it->second.name] += it->second.count - before;
+            result.lines += it->second.count - before;
+        }
+    }
+    for(auto it = previous.begin(); it != previous.end(); ++it){
+        auto now = current.find(it->first);
+        size_t after = (now == current.end()) ? 0 : now->second.count;
+        if(it->second.count > after){
+            lost[it->second.name] += it->second.count - after;
+            result.lines += it->second.count - after;
+        }
+    }
+    for(auto it = gained.begin(); it != gained.end(); ++it){
+        names[it->first] += it->second;
+    }
+    std::unordered_map<std::string, size_t> dropped;
+    for(auto it = lost.begin(); it != lost.end(); ++it){
+        size_t &count = names[it->first];
+        count -= std::min(count, it->second);
+        if(count == 0){
+            names.erase(it->first);
+            dropped[it->first] = 0;
+        }
+    }
+
+    if(exists){
+        previous.swap(current);
+    }
+    else{
+        files.erase(path);
+    }
+
+    if(!gained.empty() || !lost.empty()){
+        Library::Editor editor(library);
+        LinkedList<Song> &songs = editor.songs();
+        LinkedList<Playlist> &lists = editor.playlists();
+        EditHistory &history = editor.history();
+        EditHistory::Batch batch(&history, "Recarregar " + path);
+
+        if(songs.getVersion() != knownSongsVersion){
+            knownSongs.clear();
+            for(Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+                knownSongs.insert(&curr->getValue());
+            }
+        }
+        if(lists.getVersion() != knownPlaylistsVersion){
+            knownPlaylists.clear();
+            for(Node<Playlist> *curr = lists.getHead(); curr != nullptr; curr = curr->getNext()){
+                knownPlaylists.insert(std::make_pair(curr->getValue().getName(), &curr->getValue()));
+            }
+        }
+
+        // Junta todas as linhas atuais dos nomes alterados, na ordem dos arquivos e das linhas
+        std::unordered_map<std::string, Playlist> merged;
+        for(auto file = files.begin(); file != files.end(); ++file){
+            std::vector<std::pair<size_t, uint64_t>> order;
+            for(auto it = file->second.begin(); it != file->second.end(); ++it){
+                if(gained.count(it->second.name) != 0 || lost.count(it->second.name) != 0){
+                    order.push_back(std::make_pair(it->second.position, it->first));
+                }
+            }
+            std::sort(order.begin(), order.end());
+
+            for(size_t i = 0; i < order.size(); i++){
+                auto parsed = (file->first == path) ? fresh.find(order[i].second) : fresh.end();
+                Playlist playlist = (parsed != fresh.end()) ? parsed->second :
+                                    Loader::parsePlaylist(file->second[order[i].second].text);
+                for(const Node<Song> *curr = playlist.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    if(knownSongs.count(&curr->getValue()) == 0){
+                        unsigned long long prior = songs.getVersion();
+                        Node<Song> *lastKnown = songs.getTail();
+                        songs.add(curr->getValue());
+                        Song *song = &songs.getTail()->getValue();
+                        editor.index().add(song);
+                        editor.smartPlaylists().added(songs, prior, *song);
+                        history.catalogAppended(prior, lastKnown);
+                        knownSongs.insert(song);
+                    }
+                }
+
+                auto first = merged.find(playlist.getName());
+                if(first == merged.end()){
+                    merged.insert(std::make_pair(playlist.getName(), Playlist(playlist.getName()))).first->second.moveSongs(playlist);
+                    continue;
+                }
+                SongSet present;
+                Playlist &target = first->second;
+                for(const Node<Song> *curr = target.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    present.insert(&curr->getValue());
+                }
+                // As músicas que faltam são acrescentadas de uma vez
+                std::vector<const Song*> missing;
+                for(const Node<Song> *curr = playlist.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+                    if(present.insert(&curr->getValue()).second){
+                        missing.push_back(&curr->getValue());
+                    }
+                }
+                if(!missing.empty()){
+                    target.addSongs(missing);
+                }
+            }
+        }
+
+        for(auto it = merged.begin(); it != merged.end(); ++it){
+            Playlist &playlist = it->second;
+            auto existing = knownPlaylists.find(it->first);
+            if(existing == knownPlaylists.end()){
+                unsigned long long prior = lists.getVersion();
+                Node<Playlist> *lastKnown = lists.getTail();
+                lists.add(Playlist(it->first));
+                lists.getTail()->getValue().moveSongs(playlist);
+                history.playlistsAppended(prior, lastKnown);
+                knownPlaylists[it->first] = &lists.getTail()->getValue();
+                result.added++;
+                continue;
+            }
+
+            // A playlist passa a ter as músicas montadas, se forem diferentes das atuais
+            Playlist &target = *existing->second;
+            const Node<Song> *a = target.readSongs().getHead();
+            const Node<Song> *b = playlist.readSongs().getHead();
+            while(a != nullptr && b != nullptr && sameSong(a->getValue(), b->getValue())){
+                a = a->getNext();
+                b = b->getNext();
+            }
+            if(a == nullptr && b == nullptr){
+                continue;
+            }
+            target.replaceSongs(playlist);
+            result.replaced++;
+        }
+
+        if(!dropped.empty()){
+            result.removed = history.removePlaylistsIf([&dropped](Playlist &playlist){
+                return dropped.count(playlist.getName()) != 0;
+            });
+            for(auto it = dropped.begin(); it != dropped.end(); ++it){
+                knownPlaylists.erase(it->first);
+            }
+        }
+
+        knownSongsVersion = songs.getVersion();
+        knownPlaylistsVersion = lists.getVersion();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    result.seconds = elapsed.count();
+    return result;
+}
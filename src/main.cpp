@@ -5,74 +5,51 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <sstream>
-#include <fstream>
+#include <cstdlib>
+#include <csignal>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <atomic>
 #include "Node.hpp"
 #include "LinkedList.hpp"
 #include "Song.hpp"
 #include "Playlist.hpp"
+#include "SearchIndex.hpp"
+#include "Library.hpp"
+#include "Loader.hpp"
+#include "Watcher.hpp"
+#include "Server.hpp"
+#include "LoadGenerator.hpp"
+#include "PlaybackScheduler.hpp"
+#include "UpNextQueue.hpp"
+#include "PlaylistAggregator.hpp"
+#include "MemoryReport.hpp"
 #include "menu.hpp"
 
+//! Arquivo de exemplos do projeto, usado quando nenhum arquivo é configurado (relativo à pasta em que o programa é executado)
+static const std::string dataFile = "test.txt";
 
 /**
- * @brief Analisa uma linha de um arquivo de texto e cria um objeto Playlist.
- *
- * Esta função recebe uma linha de um arquivo de texto que representa uma
- * playlist com músicas e a analisa para criar um objeto Playlist. A linha
- * deve ter o seguinte formato:
- *    NomePlaylist;TituloMusica1:AutorMusica1,TituloMusica2:AutorMusica2,...
- *
- * @param line A linha do arquivo de texto que representa a playlist.
- * @param songs Uma referência para a LinkedList de músicas do sistema.
- *
- * @return O objeto Playlist analisado.
- */
-Playlist parsePlaylist(const std::string& line, LinkedList<Song>& songs) {
-    std::stringstream ss(line);
-    std::string playlistName;
-    std::getline(ss, playlistName, ';');
-
-    Playlist playlist(playlistName);
-
-    std::string songInfo;
-    while (std::getline(ss, songInfo, ',')) {
-        std::stringstream songSS(songInfo);
-        std::string songTitle, songAuthor;
-        std::getline(songSS, songTitle, ':');
-        std::getline(songSS, songAuthor);
-
-        Song song(songTitle, songAuthor);
-        songs.add(song);
-
-        playlist.addSong(song);
-    }
-
-    return playlist;
-}
-
-
-/**
- * @brief Lê as playlists e músicas de um arquivo de texto e adiciona ao sistema.
+ * @brief Separa os caminhos de uma lista separada por ':', como na variável
+ * de ambiente PLAYLIST_DATA.
  * 
- * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
- * @param filename Nome do arquivo de texto a ser lido.
+ * @param list Lista de caminhos.
+ * @param paths Vetor que recebe os caminhos não vazios.
  */
-void readDataFromFile(LinkedList<Song>& songs, LinkedList<Playlist>& playlists, const std::string& filename) {
-    std::ifstream inputFile(filename);
-    if (!inputFile.is_open()) {
-        std::cerr << "Erro ao abrir o arquivo." << std::endl;
-        return;
-    }
-
-    std::string line;
-    while (std::getline(inputFile, line)) {
-        if (!line.empty()) {
-            playlists.add(parsePlaylist(line, songs));
+void splitPaths(const std::string &list, std::vector<std::string> &paths){
+    std::stringstream ss(list);
+    std::string path;
+    while(std::getline(ss, path, ':')){
+        if(!path.empty()){
+            paths.push_back(path);
         }
     }
-
-    inputFile.close();
 }
 
 /**
@@ -80,12 +57,22 @@ void readDataFromFile(LinkedList<Song>& songs, LinkedList<Playlist>& playlists,
  * músicas e playlists para demonstrar as funcionalidades do
  * programa.
  * 
- * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * Os exemplos são carregados em segundo plano, então o menu pode ser usado
+ * enquanto o arquivo é lido. Se arquivos foram configurados pela linha de
+ * comando ou pela variável PLAYLIST_DATA, eles são importados sem perguntar.
+ * 
+ * @param loader Carregador de playlists da biblioteca do sistema.
+ * @param paths Arquivos e pastas configurados, ou vazio para usar os exemplos.
  */
-void setup(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
+void setup(Loader &loader, const std::vector<std::string> &paths){
     int choice;
 
+    if(!paths.empty()){
+        loader.start(paths);
+        std::cout << "Importando " << paths.size() << " caminho(s) em segundo plano.\n";
+        return;
+    }
+
     std::cout << "Deseja executar o setup inicial? Isso irá adicionar\n" <<
                  "alguns exemplos de músicas e playlists\n";
     std::cout << "1. Sim\n";
@@ -97,48 +84,473 @@ void setup(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
 
     if(choice == 0) return;
 
+    loader.start(std::vector<std::string>(1, dataFile));
 
-    std::string filename = "/home/mariemerenc/Downloads/playlist-main/test.txt"; // Nome do arquivo de texto contendo os exemplos
-    readDataFromFile(songs, playlists, filename);
-
-    
-
-    std::cout << "Setup completo\n";
+    std::cout << "Os exemplos estão sendo carregados em segundo plano.\n";
     std::cout << "Pressione ENTER para continuar.";
     std::cin.get();
 }
 
+//! Servidor em execução, interrompido pelos sinais de término.
+static Server *activeServer = nullptr;
+
+/**
+ * @brief Tratador de SIGINT e SIGTERM, que interrompe o servidor. O número do
+ * sinal recebido não é usado.
+ */
+static void stopServer(int){
+    if(activeServer != nullptr){
+        activeServer->stop();
+    }
+}
+
+/**
+ * @brief Modo servidor: atende clientes pelo socket Unix até receber SIGINT
+ * ou SIGTERM. Os exemplos são carregados em segundo plano, e os clientes já
+ * podem usar a parte carregada.
+ * 
+ * @param path Caminho do socket.
+ * @param paths Arquivos e pastas a importar, ou vazio para usar os exemplos.
+ * @param watch Indica se os arquivos alterados devem ser recarregados.
+ * @return O valor de saída do programa.
+ */
+int serve(const std::string &path, const std::vector<std::string> &paths, bool watch){
+    std::vector<std::string> files = paths.empty() ? std::vector<std::string>(1, dataFile) : paths;
+    Library library;
+    Loader loader(library);
+    loader.setVerbose(true);
+    loader.start(files);
+
+    Watcher watcher(library);
+    if(watch){
+        watcher.setVerbose(true);
+        watcher.start(files);
+    }
+
+    Server server(library, path);
+    if(!server.start()){
+        return 1;
+    }
+
+    activeServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+
+    std::cout << "Servidor aguardando conexões em \"" << path << "\".\n";
+    server.run();
+
+    activeServer = nullptr;
+    std::cout << "Servidor encerrado após " << server.getRequests() << " requisições.\n";
+    return 0;
+}
+
+/**
+ * @brief Modo de simulação: toca playlists em várias sessões ao mesmo tempo
+ * (ver PlaybackScheduler) e exibe o número de trocas de música, a vazão e,
+ * acompanhando o relógio, os percentis do atraso das trocas.
+ *
+ * A sessão i toca a playlist i módulo o número de playlists com músicas, a
+ * partir de uma música e de um instante sorteados, para que as trocas não
+ * aconteçam todas juntas.
+ *
+ * Enquanto a reprodução avança, cada thread de controle envia sem parar
+ * pedidos às filas de músicas a tocar em seguida (UpNextQueue) das primeiras
+ * sessões, todas disputando as mesmas filas, cedendo o processador entre um
+ * pedido e outro: 70% adicionam uma música do catálogo ao fim da fila, 20% a
+ * adicionam ao início e 10% limpam a fila.
+ *
+ * @param paths Arquivos e pastas a importar, ou vazio para usar os exemplos.
+ * @param sessionCount Número de sessões.
+ * @param seconds Tempo simulado, em segundos.
+ * @param speed Fator de velocidade em relação ao relógio, ou 0 para simular o mais rápido possível.
+ * @param controlThreads Número de threads de controle.
+ * @return O valor de saída do programa.
+ */
+int simulate(const std::vector<std::string> &paths, size_t sessionCount, double seconds, double speed,
+             size_t controlThreads){
+    typedef std::chrono::steady_clock Clock;
+
+    Library library;
+    Loader loader(library);
+    loader.start(paths.empty() ? std::vector<std::string>(1, dataFile) : paths);
+    loader.wait();
+
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+    std::vector<const Playlist*> playlists;
+    std::vector<size_t> sizes;
+    for(size_t i = 0; i < snapshot->playlists.size(); i++){
+        size_t size = snapshot->playlists[i]->getSize();
+        if(size > 0){
+            playlists.push_back(snapshot->playlists[i].get());
+            sizes.push_back(size);
+        }
+    }
+    if(playlists.empty()){
+        std::cerr << "Erro: Nenhuma playlist com músicas para tocar.\n";
+        return 1;
+    }
+
+    PlaybackScheduler scheduler(snapshot);
+    std::mt19937 random(1);
+    Clock::time_point begin = Clock::now();
+    for(size_t i = 0; i < sessionCount; i++){
+        size_t k = i % playlists.size();
+        scheduler.addSession(playlists[k], random() % sizes[k], random() % 180000);
+    }
+    std::chrono::duration<double> setup = Clock::now() - begin;
+
+    std::vector<const Song*> catalog;
+    for(size_t i = 0; i < snapshot->songs.size(); i++){
+        const LinkedList<Song> &part = *snapshot->songs[i];
+        for(const Node<Song> *curr = part.getHead(); curr != nullptr; curr = curr->getNext()){
+            catalog.push_back(&curr->getValue());
+        }
+    }
+    if(catalog.empty() || sessionCount == 0){
+        controlThreads = 0;
+    }
+    // Sessões cujas filas recebem os pedidos das threads de controle
+    size_t hotSessions = sessionCount < 64 ? sessionCount : 64;
+    std::atomic<bool> stop(false);
+    std::vector<size_t> accepted(controlThreads, 0), rejected(controlThreads, 0);
+    std::vector<std::thread> controls;
+    for(size_t t = 0; t < controlThreads; t++){
+        controls.push_back(std::thread([&, t](){
+            std::mt19937 random(t + 2);
+            size_t sent[2] = {0, 0};
+            while(!stop.load(std::memory_order_relaxed)){
+                UpNextQueue &queue = scheduler.getQueue(random() % hotSessions);
+                const Song *song = catalog[random() % catalog.size()];
+                unsigned kind = random() % 10;
+                bool ok = kind < 7 ? queue.push(song) : kind < 9 ? queue.insertNext(song) : queue.clear();
+                sent[ok]++;
+                std::this_thread::yield();
+            }
+            accepted[t] = sent[1];
+            rejected[t] = sent[0];
+        }));
+    }
+
+    std::vector<double> delays;
+    size_t changes;
+    size_t queued = 0;
+    unsigned long long until = (unsigned long long)(seconds * 1000);
+    begin = Clock::now();
+    if(speed > 0){
+        changes = scheduler.run(until, speed, [&delays, &queued](const PlaybackScheduler::TrackChange &change){
+            delays.push_back(change.late);
+            queued += change.queued;
+        });
+    }
+    else{
+        changes = scheduler.advance(until, [&queued](const PlaybackScheduler::TrackChange &change){
+            queued += change.queued;
+        });
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - begin;
+
+    stop.store(true);
+    for(size_t t = 0; t < controls.size(); t++){
+        controls[t].join();
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Sessões: " << sessionCount << " em " << playlists.size() << " playlists, iniciadas em "
+              << setup.count() << " s\n";
+    std::cout << "Tempo simulado: " << seconds << " s, em " << elapsed.count() << " s\n";
+    std::cout << "Trocas de música: " << changes << std::setprecision(0) << " (" << changes / elapsed.count()
+              << " trocas/s";
+    if(speed <= 0){
+        std::cout << ", " << std::setprecision(1) << elapsed.count() * 1e9 / (changes > 0 ? changes : 1)
+                  << " ns por troca";
+    }
+    std::cout << ")\n";
+    if(controlThreads > 0){
+        size_t sent = 0, refused = 0;
+        for(size_t t = 0; t < controlThreads; t++){
+            sent += accepted[t];
+            refused += rejected[t];
+        }
+        std::cout << "Pedidos às filas (" << controlThreads << " threads, " << hotSessions << " sessões): "
+                  << sent << " aceitos, " << refused << " recusados com a fila cheia\n";
+        std::cout << "Trocas vindas das filas: " << queued << "\n";
+    }
+
+    if(!delays.empty()){
+        std::sort(delays.begin(), delays.end());
+        const double percentiles[] = {50, 90, 99, 99.9};
+        const char *labels[] = {"p50", "p90", "p99", "p99.9"};
+        std::cout << "Atraso das trocas (ms):" << std::setprecision(3);
+        for(size_t i = 0; i < 4; i++){
+            size_t rank = (size_t)std::ceil(percentiles[i] / 100 * delays.size());
+            std::cout << " " << labels[i] << "=" << delays[rank == 0 ? 0 : rank - 1];
+        }
+        std::cout << " max=" << delays.back() << "\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief Exibe uma classificação de músicas ou autores e o tempo da consulta.
+ *
+ * @param label Descrição da consulta.
+ * @param ranked Classificação.
+ * @param seconds Tempo da consulta, em segundos.
+ */
+static void printRanking(const std::string &label, const std::vector<PlaylistAggregator::Ranked> &ranked,
+                         double seconds){
+    std::cout << label << " (" << std::fixed << std::setprecision(3) << seconds * 1000 << " ms):\n";
+    for(size_t i = 0; i < ranked.size(); i++){
+        std::cout << std::setw(4) << i + 1 << ". " << ranked[i].count;
+        if(ranked[i].error > 0){
+            std::cout << " (erro até " << ranked[i].error << ")";
+        }
+        std::cout << "  ";
+        if(!ranked[i].title.empty()){
+            std::cout << ranked[i].title << " - ";
+        }
+        std::cout << ranked[i].author << "\n";
+    }
+}
+
+/**
+ * @brief Carrega as playlists e exibe as consultas sobre todas elas, com o
+ * tempo de cada uma: as músicas e os autores presentes em mais playlists,
+ * contados com exatidão e estimados com resumos de tamanho fixo, e o
+ * histograma do tamanho das playlists. Rodar com números diferentes de
+ * threads mostra como as consultas escalam com os núcleos.
+ *
+ * @param paths Arquivos e pastas a importar, ou vazio para usar os exemplos.
+ * @param k Número de músicas e autores exibidos.
+ * @param threads Número de threads; 0 usa uma por núcleo.
+ * @param capacity Número de itens dos resumos das consultas aproximadas.
+ * @return O valor de saída do programa.
+ */
+int aggregate(const std::vector<std::string> &paths, size_t k, unsigned threads, size_t capacity){
+    typedef std::chrono::steady_clock Clock;
+
+    Library library;
+    Loader loader(library);
+    loader.start(paths.empty() ? std::vector<std::string>(1, dataFile) : paths);
+    loader.wait();
+
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+    PlaylistAggregator aggregator(snapshot->playlists, threads);
+    std::cout << "Playlists: " << snapshot->playlists.size() << ", threads: " << aggregator.getThreads() << "\n";
+
+    std::vector<PlaylistAggregator::Ranked> ranked;
+    Clock::time_point begin = Clock::now();
+    aggregator.top(PlaylistAggregator::Songs, k, ranked);
+    printRanking("Músicas presentes em mais playlists", ranked,
+                 std::chrono::duration<double>(Clock::now() - begin).count());
+
+    begin = Clock::now();
+    aggregator.approximateTop(PlaylistAggregator::Songs, k, capacity, ranked);
+    printRanking("Músicas presentes em mais playlists, estimadas com " + std::to_string(capacity) + " itens", ranked,
+                 std::chrono::duration<double>(Clock::now() - begin).count());
+
+    begin = Clock::now();
+    aggregator.top(PlaylistAggregator::Authors, k, ranked);
+    printRanking("Autores presentes em mais playlists", ranked,
+                 std::chrono::duration<double>(Clock::now() - begin).count());
+
+    begin = Clock::now();
+    aggregator.approximateTop(PlaylistAggregator::Authors, k, capacity, ranked);
+    printRanking("Autores presentes em mais playlists, estimados com " + std::to_string(capacity) + " itens", ranked,
+                 std::chrono::duration<double>(Clock::now() - begin).count());
+
+    std::vector<PlaylistAggregator::SizeBucket> sizes;
+    begin = Clock::now();
+    aggregator.sizeHistogram(sizes);
+    std::chrono::duration<double> elapsed = Clock::now() - begin;
+    std::cout << "Playlists por número de músicas (" << elapsed.count() * 1000 << " ms):\n";
+    for(size_t i = 0; i < sizes.size(); i++){
+        std::cout << std::setw(10) << sizes[i].low << " a " << std::setw(10) << sizes[i].high << ": "
+                  << sizes[i].playlists << "\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief Percorre todas as músicas das playlists de uma versão publicada,
+ * como fazem as consultas dos leitores, somando as durações.
+ *
+ * @param snapshot Versão percorrida.
+ * @param duration Recebe a soma das durações, para que a passagem não seja descartada.
+ * @return Tempo da passagem, em segundos.
+ */
+double scanPlaylists(const Library::Snapshot &snapshot, unsigned long long &duration){
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    duration = 0;
+    for(size_t i = 0; i < snapshot.playlists.size(); i++){
+        const LinkedList<Song> &songs = snapshot.playlists[i]->readSongs();
+        for(const Node<Song> *curr = songs.getHead(); curr != nullptr; curr = curr->getNext()){
+            duration += curr->getValue().getDuration();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count();
+}
+
+/**
+ * @brief Carrega as playlists e exibe a memória usada pela biblioteca e o
+ * tempo de uma passagem por todas as playlists, antes e depois de compactá-las
+ * (Library::compact), com a memória residente do processo.
+ *
+ * @param paths Arquivos e pastas a importar, ou vazio para usar os exemplos.
+ * @param limit Número de playlists exibidas no relatório.
+ * @return O valor de saída do programa.
+ */
+int memory(const std::vector<std::string> &paths, size_t limit){
+    Library library;
+    Loader loader(library);
+    loader.start(paths.empty() ? std::vector<std::string>(1, dataFile) : paths);
+    loader.wait();
+
+    MemoryReport report;
+    unsigned long long duration;
+    report.measure(library);
+    report.print(std::cout, limit);
+    double seconds = scanPlaylists(*library.snapshot(), duration);
+    std::cout << "Passagem por todas as playlists: " << std::fixed << std::setprecision(3) << seconds * 1000 << " ms\n";
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    size_t released = library.compact();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << "Compactação: " << elapsed.count() * 1000 << " ms, " << released / 1024
+              << " KB de nós devolvidos ao sistema\n";
+
+    report.measure(library);
+    report.print(std::cout, limit);
+    seconds = scanPlaylists(*library.snapshot(), duration);
+    std::cout << "Passagem por todas as playlists: " << seconds * 1000 << " ms\n";
+    return 0;
+}
+
 /**
  * @brief Função principal do programa.
  *
  * A função `main` é responsável por iniciar a execução do programa.
- * Nela, são criadas as listas encadeadas para armazenar as playlists
- * e as músicas. Em seguida, é chamada a função `setup` para adicionar
- * exemplos de músicas e playlists. Após o setup, é iniciado um loop
+ * Nela, é criada a biblioteca que armazena as playlists, as músicas
+ * e o índice de busca. Em seguida, é chamada a função `setup`, que começa a
+ * carregar exemplos de músicas e playlists em segundo plano. Logo após, é iniciado um loop
  * que exibe o menu principal e permite a interação com o usuário.
- * Quando o usuário escolhe sair do programa, as listas são limpas e o
+ * Quando o usuário escolhe sair do programa, a biblioteca é destruída e o
  * programa é encerrado.
  *
+ * Opções:
+ * - `--data <caminho>`: arquivo ou pasta de playlists a importar; pode ser
+ *   repetida. Sem ela, são usados os caminhos da variável de ambiente
+ *   PLAYLIST_DATA, separados por ':'.
+ * - `--serve <socket>`: atende clientes por um socket Unix (ver Server).
+ * - `--watch`: recarrega os arquivos de playlists quando são alterados,
+ *   aplicando apenas as linhas alteradas (ver Watcher).
+ * - `--loadgen <socket> [conexões] [requisições] [em paralelo]`: gera
+ *   carga no servidor e exibe os percentis do tempo de resposta.
+ * - `--simulate [sessões] [segundos] [velocidade] [threads de controle]`:
+ *   toca as playlists em várias sessões ao mesmo tempo e exibe a vazão de
+ *   trocas de música; com velocidade maior que zero, acompanha o relógio e
+ *   exibe o atraso das trocas. As threads de controle alteram as filas das
+ *   sessões durante a reprodução.
+ * - `--aggregate [k] [threads] [capacidade]`: exibe as k músicas e autores
+ *   presentes em mais playlists, exatos e estimados com resumos de capacidade
+ *   itens, e o histograma do tamanho das playlists, com o tempo de cada
+ *   consulta (ver PlaylistAggregator).
+ * - `--memory [playlists]`: exibe a memória usada pela biblioteca e o tempo
+ *   de percorrer todas as playlists, antes e depois de compactá-las, com as
+ *   playlists que mais ocupam memória (ver MemoryReport).
+ *
  * @param argc O número de argumentos de linha de comando passados para o programa.
  * @param argv Um array de strings contendo os argumentos de linha de comando.
  *
- * @return O valor de saída do programa. Neste caso, sempre será 0.
+ * @return O valor de saída do programa.
  */
 int main(int argc,char *argv[]){
-    LinkedList<Playlist> playlists;
-    LinkedList<Song> songs;
+    std::vector<std::string> paths;
+    std::string socketPath;
+    bool watch = false;
+
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--data" && i + 1 < argc){
+            paths.push_back(argv[++i]);
+        }
+        else if(arg == "--watch"){
+            watch = true;
+        }
+        else if(arg == "--serve" && i + 1 < argc){
+            socketPath = argv[++i];
+        }
+        else if(arg == "--loadgen" && i + 1 < argc){
+            size_t connections = i + 2 < argc ? std::strtoul(argv[i + 2], nullptr, 10) : 100;
+            size_t requests = i + 3 < argc ? std::strtoul(argv[i + 3], nullptr, 10) : 100000;
+            size_t depth = i + 4 < argc ? std::strtoul(argv[i + 4], nullptr, 10) : 8;
+            LoadGenerator generator(argv[i + 1], connections, requests, depth);
+            return generator.run() ? 0 : 1;
+        }
+        else if(arg == "--simulate"){
+            size_t sessions = i + 1 < argc ? std::strtoul(argv[i + 1], nullptr, 10) : 100000;
+            double seconds = i + 2 < argc ? std::strtod(argv[i + 2], nullptr) : 3600;
+            double speed = i + 3 < argc ? std::strtod(argv[i + 3], nullptr) : 0;
+            size_t controls = i + 4 < argc ? std::strtoul(argv[i + 4], nullptr, 10) : 0;
+            const char *environment = std::getenv("PLAYLIST_DATA");
+            if(paths.empty() && environment != nullptr){
+                splitPaths(environment, paths);
+            }
+            return simulate(paths, sessions, seconds, speed, controls);
+        }
+        else if(arg == "--aggregate"){
+            size_t k = i + 1 < argc ? std::strtoul(argv[i + 1], nullptr, 10) : 10;
+            unsigned threads = i + 2 < argc ? (unsigned)std::strtoul(argv[i + 2], nullptr, 10) : 0;
+            size_t capacity = i + 3 < argc ? std::strtoul(argv[i + 3], nullptr, 10) : 4096;
+            const char *environment = std::getenv("PLAYLIST_DATA");
+            if(paths.empty() && environment != nullptr){
+                splitPaths(environment, paths);
+            }
+            return aggregate(paths, k, threads, capacity);
+        }
+        else if(arg == "--memory"){
+            size_t limit = i + 1 < argc ? std::strtoul(argv[i + 1], nullptr, 10) : 10;
+            const char *environment = std::getenv("PLAYLIST_DATA");
+            if(paths.empty() && environment != nullptr){
+                splitPaths(environment, paths);
+            }
+            return memory(paths, limit);
+        }
+        else{
+            std::cerr << "Uso: " << argv[0] << " [--data caminho]... [--watch] [--serve socket]\n"
+                      << "     " << argv[0] << " --loadgen socket [conexões] [requisições] [em paralelo]\n"
+                      << "     " << argv[0] << " [--data caminho]... --simulate [sessões] [segundos] [velocidade] [threads de controle]\n"
+                      << "     " << argv[0] << " [--data caminho]... --aggregate [k] [threads] [capacidade]\n"
+                      << "     " << argv[0] << " [--data caminho]... --memory [playlists]\n";
+            return 1;
+        }
+    }
+
+    const char *environment = std::getenv("PLAYLIST_DATA");
+    if(paths.empty() && environment != nullptr){
+        splitPaths(environment, paths);
+    }
+
+    if(!socketPath.empty()){
+        return serve(socketPath, paths, watch);
+    }
+
+    Library library;
+    Loader loader(library);
+    Watcher watcher(library);
     
-    setup(songs, playlists);
+    setup(loader, paths);
+    if(watch){
+        watcher.start(paths.empty() ? std::vector<std::string>(1, dataFile) : paths);
+    }
 
     int exit{0};
 
     while(exit == 0){
-        exit = mainMenu(songs, playlists);
+        exit = mainMenu(library, loader, watcher);
     }
 
-    playlists.clear();
-    songs.clear();
-
     return 0;
 }
 
@@ -6,25 +6,341 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <utility>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <algorithm>
 #include "Node.hpp"
 #include "LinkedList.hpp"
 #include "Song.hpp"
 #include "Playlist.hpp"
+#include "PlaylistView.hpp"
+#include "SongOrder.hpp"
+#include "ListPrinter.hpp"
+#include "UpNextQueue.hpp"
+#include "SearchIndex.hpp"
+#include "SimilarityIndex.hpp"
+#include "PlaylistAggregator.hpp"
+#include "PlaylistCombiner.hpp"
+#include "EditHistory.hpp"
+#include "MemoryReport.hpp"
 #include "menu.hpp"
 
+//! Número de linhas de cada página das listagens.
+static const size_t pageSize = 10;
 
+/**
+ * @brief Exibe uma listagem em páginas de pageSize linhas. Após cada página,
+ * o usuário pode ver a próxima, exibir todas as restantes de uma vez ou voltar.
+ *
+ * @param total Número de linhas da listagem.
+ * @param printPage Função que recebe a saída e o número máximo de linhas,
+ * imprime as próximas linhas e retorna quantas foram impressas.
+ */
+template <typename PrintPage>
+static void showPages(size_t total, PrintPage printPage){
+    size_t shown = 0;
+    int choice;
+
+    while(true){
+        size_t printed;
+        {
+            ListPrinter out(std::cout);
+            printed = printPage(out, pageSize);
+        }
+        shown += printed;
+        if(printed == 0 || shown >= total){
+            return;
+        }
+
+        std::cout << "Exibindo " << shown << " de " << total << ".\n";
+        std::cout << "1. Próxima página\n";
+        std::cout << "2. Exibir todas\n";
+        std::cout << "0. Voltar\n";
+        std::cout << "Digite sua escolha: ";
+        std::cin >> choice;
+        std::cin.ignore();
+
+        if(choice == 2){
+            ListPrinter out(std::cout);
+            printPage(out, total - shown);
+            return;
+        }
+        if(choice != 1){
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Exibe em páginas os elementos de uma lista encadeada. Cada página
+ * continua do nó em que a anterior parou.
+ *
+ * @param list Lista a ser exibida.
+ */
+template <typename T>
+static void showPages(const LinkedList<T> &list){
+    ListCursor<T> cursor;
+    showPages(list.getSize(), [&list, &cursor](ListPrinter &out, size_t limit){
+        return list.visitPage(cursor, limit, [&out](const T &value){
+            out.line(value);
+        });
+    });
+}
+
+/**
+ * @brief Exibe em páginas os elementos de um vetor de ponteiros, como o
+ * retornado por uma ordenação.
+ *
+ * @param items Elementos a serem exibidos.
+ */
+template <typename T>
+static void showPages(const std::vector<T*> &items){
+    size_t next = 0;
+    showPages(items.size(), [&items, &next](ListPrinter &out, size_t limit){
+        size_t printed = 0;
+        for(; printed < limit && next < items.size(); printed++){
+            out.line(*items[next++]);
+        }
+        return printed;
+    });
+}
+
+/**
+ * @brief Exibe em páginas as músicas de uma visão de playlists. Cada página
+ * continua do iterador em que a anterior parou.
+ *
+ * @param view Visão a ser exibida.
+ */
+static void showPages(PlaylistView &view){
+    PlaylistView::Iterator next = view.begin();
+    PlaylistView::Iterator end = view.end();
+    showPages(view.getSize(), [&next, &end](ListPrinter &out, size_t limit){
+        size_t printed = 0;
+        for(; printed < limit && next != end; printed++){
+            out.line(*next);
+            ++next;
+        }
+        return printed;
+    });
+}
+
+/**
+ * @brief Pergunta ao usuário a ordenação das músicas.
+ *
+ * @return A ordenação escolhida. Uma ordenação vazia representa a ordem de inserção.
+ */
+static SongOrder readSongOrder(){
+    int choice;
+
+    std::cout << "Ordenar por:\n";
+    std::cout << "1. Ordem de inserção\n";
+    std::cout << "2. Título\n";
+    std::cout << "3. Autor\n";
+    std::cout << "4. Autor e título\n";
+    std::cout << "Digite sua escolha: ";
+
+    std::cin >> choice;
+    std::cin.ignore();
+
+    switch(choice){
+        case 2:
+            return SongOrder({SongOrder::Title});
+        case 3:
+            return SongOrder({SongOrder::Author});
+        case 4:
+            return SongOrder({SongOrder::Author, SongOrder::Title});
+        default:
+            return SongOrder();
+    }
+}
+
+/**
+ * @brief Procura uma música pelo título em uma sequência de listas, como as
+ * partes do catálogo publicado. Caso existam músicas com esse título e
+ * autores diferentes, pergunta ao usuário qual é o autor.
+ *
+ * @param lists Listas encadeadas (LinkedList) de músicas (Song) em que a música é procurada, em ordem.
+ * @param title Título da música.
+ * @return Ponteiro para a primeira ocorrência da música escolhida, ou nullptr
+ * caso ela não esteja nas listas.
+ */
+static const Song *selectSong(const std::vector<const LinkedList<Song>*> &lists, const std::string &title){
+    Song wanted(title);
+    std::vector<const Song*> matches;
+
+    for(size_t k = 0; k < lists.size(); k++){
+        for(const Node<Song> *curr = lists[k]->getHead(); curr != nullptr; curr = curr->getNext()){
+            const Song &song = curr->getValue();
+            if(song.hasSameTitle(wanted)){
+                bool repeated = false;
+                for(size_t i = 0; i < matches.size() && !repeated; i++){
+                    repeated = matches[i]->equals(song);
+                }
+                if(!repeated){
+                    matches.push_back(&song);
+                }
+            }
+        }
+    }
+
+    if(matches.size() <= 1){
+        return matches.empty() ? nullptr : matches[0];
+    }
+
+    std::cout << "Existem " << matches.size() << " músicas com o título \"" << title << "\":\n";
+    for(size_t i = 0; i < matches.size(); i++){
+        std::cout << *matches[i] << "\n";
+    }
+    std::string author;
+    std::cout << "Digite o nome do autor:\n";
+    std::getline(std::cin, author);
+
+    wanted.setAuthor(author);
+    for(size_t i = 0; i < matches.size(); i++){
+        if(matches[i]->equals(wanted)){
+            return matches[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Procura uma música pelo título em uma lista. Caso existam músicas com
+ * esse título e autores diferentes, pergunta ao usuário qual é o autor.
+ *
+ * @param list Lista encadeada (LinkedList) de músicas (Song) em que a música é procurada.
+ * @param title Título da música.
+ * @return Ponteiro para a primeira ocorrência da música escolhida, ou nullptr
+ * caso ela não esteja na lista.
+ */
+static const Song *selectSong(const LinkedList<Song> &list, const std::string &title){
+    return selectSong(std::vector<const LinkedList<Song>*>(1, &list), title);
+}
+/**
+ * @brief Retorna as partes do catálogo de uma versão publicada, em ordem,
+ * para procurar ou exibir músicas sem obter a trava de escrita.
+ *
+ * @param snapshot Versão publicada da biblioteca.
+ * @return Ponteiros para as partes do catálogo.
+ */
+static std::vector<const LinkedList<Song>*> catalogOf(const Library::Snapshot &snapshot){
+    std::vector<const LinkedList<Song>*> catalog;
+    for(size_t i = 0; i < snapshot.songs.size(); i++){
+        catalog.push_back(snapshot.songs[i].get());
+    }
+    return catalog;
+}
+
+/**
+ * @brief Exibe em páginas as músicas de uma sequência de listas, como as
+ * partes do catálogo publicado. Cada página continua do nó em que a
+ * anterior parou.
+ *
+ * @param lists Listas a serem exibidas, em ordem.
+ */
+static void showPages(const std::vector<const LinkedList<Song>*> &lists){
+    size_t total = 0;
+    for(size_t k = 0; k < lists.size(); k++){
+        total += lists[k]->getSize();
+    }
+    size_t part = 0;
+    const Node<Song> *curr = lists.empty() ? nullptr : lists[0]->getHead();
+    showPages(total, [&lists, &part, &curr](ListPrinter &out, size_t limit){
+        size_t printed = 0;
+        while(printed < limit && part < lists.size()){
+            if(curr == nullptr){
+                if(++part < lists.size()){
+                    curr = lists[part]->getHead();
+                }
+                continue;
+            }
+            out.line(curr->getValue());
+            curr = curr->getNext();
+            printed++;
+        }
+        return printed;
+    });
+}
+
+/**
+ * @brief Retorna as músicas de listas de uma versão publicada ordenadas, sem
+ * alterá-las. Como em SortedView, a última ordenação é guardada e
+ * reaproveitada enquanto a versão, as listas e a ordenação forem as mesmas;
+ * a versão fica guardada junto, então os ponteiros continuam válidos.
+ *
+ * @param snapshot Versão publicada que contém as listas.
+ * @param lists Listas ordenadas juntas, como as partes do catálogo.
+ * @param order Ordenação das músicas.
+ * @return Ponteiros para as músicas ordenadas, válidos até a próxima chamada.
+ */
+static const std::vector<const Song*> &sortSongs(const std::shared_ptr<const Library::Snapshot> &snapshot,
+                                                 const std::vector<const LinkedList<Song>*> &lists, SongOrder order){
+    static std::shared_ptr<const Library::Snapshot> sortedSnapshot;
+    static std::vector<const LinkedList<Song>*> sortedLists;
+    static SongOrder sortedOrder;
+    static std::vector<const Song*> sorted;
+
+    if(snapshot != sortedSnapshot || lists != sortedLists || order != sortedOrder){
+        sorted.clear();
+        for(size_t k = 0; k < lists.size(); k++){
+            for(const Node<Song> *curr = lists[k]->getHead(); curr != nullptr; curr = curr->getNext()){
+                sorted.push_back(&curr->getValue());
+            }
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [&order](const Song *a, const Song *b){
+            return order(*a, *b);
+        });
+        sortedSnapshot = snapshot;
+        sortedLists = lists;
+        sortedOrder = order;
+    }
+    return sorted;
+}
+
+/**
+ * @brief Adiciona à biblioteca uma nova playlist com as músicas de outra,
+ * sem copiá-las, registrando a criação no histórico. A trava de escrita só é
+ * obtida aqui, depois que o usuário escolheu as músicas.
+ *
+ * @param library Biblioteca alterada.
+ * @param created Playlist com as músicas, que fica vazia se for adicionada.
+ * @param name Nome da nova playlist.
+ * @return true se a playlist foi adicionada, false se já existe uma playlist com o nome.
+ */
+static bool addPlaylist(Library &library, Playlist &created, const std::string &name){
+    Library::Editor editor(library);
+    if(editor.findPlaylist(name) != nullptr){
+        return false;
+    }
+    LinkedList<Playlist> &playlists = editor.playlists();
+    EditHistory &history = editor.history();
+    EditHistory::Batch batch(&history, "Criar a playlist " + name);
+    unsigned long long prior = playlists.getVersion();
+    Node<Playlist> *lastKnown = playlists.getTail();
+    playlists.add(Playlist(name));
+    playlists.getTail()->getValue().moveSongs(created);
+    history.playlistsAppended(prior, lastKnown);
+    return true;
+}
 
 /**
  * @brief Executa outras opções do menu.
  *
  * Essa função exibe um menu com diferentes opções e executa a ação selecionada pelo usuário.
  * As opções incluem adicionar músicas de uma playlist a outra, remover músicas de uma playlist em outra,
- * criar uma nova playlist que mescla outras duas e criar uma nova playlist que é a diferença entre duas outras.
+ * criar uma nova playlist que mescla outras duas, criar uma nova playlist que é a diferença entre duas outras
+ * visualizar uma combinação de várias playlists sem criá-la, filtrar o catálogo em uma nova playlist,
+ * criar playlists inteligentes, procurar playlists parecidas ou quase iguais e combinar várias
+ * playlists de uma vez.
+ *
+ * As playlists são procuradas e combinadas na versão publicada; a trava de
+ * escrita só é obtida em cada alteração, depois das perguntas ao usuário.
  *
- * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * @param library Biblioteca de músicas e playlists do sistema.
  */
-void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
+void otherMethods(Library &library){
      // Exibe o menu de opções
     std::cout << "======================\n";
     std::cout << "Outras opções\n";
@@ -32,6 +348,13 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
     std::cout << "2. Remover músicas de uma playlist em outra\n";
     std::cout << "3. Criar uma nova playlist que mescla outras duas\n";
     std::cout << "4. Criar uma nova playlist que é a diferença entre duas outras\n";
+    std::cout << "5. Visualizar ou tocar uma combinação de playlists sem criá-la\n";
+    std::cout << "6. Criar uma playlist com as músicas do catálogo que contêm um texto\n";
+    std::cout << "7. Criar uma playlist inteligente, definida por uma regra\n";
+    std::cout << "8. Listar as playlists inteligentes\n";
+    std::cout << "9. Procurar playlists parecidas com uma playlist\n";
+    std::cout << "10. Listar playlists quase iguais\n";
+    std::cout << "11. Criar uma playlist que une, intersecta ou subtrai várias playlists\n";
     std::cout << "0. Voltar\n";
 
     int choice;
@@ -39,6 +362,7 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
     std::cin >> choice;
     std::cin.ignore();
     std::string line;
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
 
     switch(choice){
         case 1:
@@ -46,17 +370,19 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
             std::cout << "Digite o nome da playlist que deseja adicionar músicas, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != ""){
-                auto pl1ptr = playlists.searchValue(Playlist(line));
-                if(pl1ptr == nullptr){
-                    std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
+                std::string target = line;
+                if(snapshot->findPlaylist(target) == nullptr){
+                    std::cout << "Erro: A playlist \"" << target << "\" não existe.\n";
                 }
                 else{
                     std::cout << "Digite o nome da playlist que deseja adicionar músicas, ou deixe em branco para cancelar:\n";
                     std::getline(std::cin, line);
                     if(line != ""){
-                        auto pl2ptr = playlists.searchValue(Playlist(line));
-                        if(pl2ptr == nullptr){
-                            std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
+                        Library::Editor editor(library);
+                        Playlist *pl1ptr = editor.findPlaylist(target);
+                        Playlist *pl2ptr = editor.findPlaylist(line);
+                        if(pl1ptr == nullptr || pl2ptr == nullptr){
+                            std::cout << "Erro: A playlist \"" << (pl1ptr == nullptr ? target : line) << "\" não existe.\n";
                         }
                         else{
                             pl1ptr->addSong(*pl2ptr);
@@ -72,17 +398,19 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
             std::cout << "Digite o nome da playlist que deseja remover músicas, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != ""){
-                auto pl1ptr = playlists.searchValue(Playlist(line));
-                if(pl1ptr == nullptr){
-                    std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
+                std::string target = line;
+                if(snapshot->findPlaylist(target) == nullptr){
+                    std::cout << "Erro: A playlist \"" << target << "\" não existe.\n";
                 }
                 else{
                     std::cout << "Digite o nome da playlist que deseja remover músicas, ou deixe em branco para cancelar:\n";
                     std::getline(std::cin, line);
                     if(line != ""){
-                        auto pl2ptr = playlists.searchValue(Playlist(line));
-                        if(pl2ptr == nullptr){
-                            std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
+                        Library::Editor editor(library);
+                        Playlist *pl1ptr = editor.findPlaylist(target);
+                        Playlist *pl2ptr = editor.findPlaylist(line);
+                        if(pl1ptr == nullptr || pl2ptr == nullptr){
+                            std::cout << "Erro: A playlist \"" << (pl1ptr == nullptr ? target : line) << "\" não existe.\n";
                         }
                         else{
                             pl1ptr->removeSong(*pl2ptr);
@@ -98,15 +426,15 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
             std::cout << "Digite o nome da playlist que deseja criar, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != ""){
-                auto pl1ptr = playlists.searchValue(Playlist(line));
-                if(pl1ptr != nullptr){
-                    std::cout << "Erro: A playlist \"" << line << "\" já existe.\n";
+                std::string name = line;
+                if(snapshot->findPlaylist(name) != nullptr){
+                    std::cout << "Erro: A playlist \"" << name << "\" já existe.\n";
                 }
                 else{
                     std::cout << "Digite o nome da playlist que deseja mesclar, ou deixe em branco para cancelar:\n";
                     std::getline(std::cin, line);
                     if(line != ""){
-                        auto pl2ptr = playlists.searchValue(Playlist(line));
+                        const Playlist *pl2ptr = snapshot->findPlaylist(line);
                         if(pl2ptr == nullptr){
                             std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
                         }
@@ -114,13 +442,18 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
                             std::cout << "Digite o nome da playlist que deseja mesclar, ou deixe em branco para cancelar:\n";
                             std::getline(std::cin, line);
                             if(line != ""){
-                                auto pl3ptr = playlists.searchValue(Playlist(line));
+                                const Playlist *pl3ptr = snapshot->findPlaylist(line);
                                 if(pl3ptr == nullptr){
                                     std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
                                 }
                                 else{
-                                     pl1ptr->addSong(*pl2ptr);
-                                    std::cout << "Playlist \"" << line << "\" criada com sucesso.\n";
+                                    Playlist created = (pl2ptr->view() + *pl3ptr).materialize(name);
+                                    if(addPlaylist(library, created, name)){
+                                        std::cout << "Playlist \"" << name << "\" criada com sucesso.\n";
+                                    }
+                                    else{
+                                        std::cout << "Erro: A playlist \"" << name << "\" já existe.\n";
+                                    }
                                 }
                             }
                         }
@@ -134,15 +467,15 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
             std::cout << "Digite o nome da playlist que deseja criar, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != ""){
-                Playlist *pl1ptr = playlists.searchValue(Playlist(line));
-                if(pl1ptr != nullptr){
-                    std::cout << "Erro: A playlist \"" << line << "\" já existe.\n";
+                std::string name = line;
+                if(snapshot->findPlaylist(name) != nullptr){
+                    std::cout << "Erro: A playlist \"" << name << "\" já existe.\n";
                 }
                 else{
                     std::cout << "Digite o nome da playlist que deseja subtrair, ou deixe em branco para cancelar:\n";
                     std::getline(std::cin, line);
                     if(line != ""){
-                        Playlist *pl2ptr = playlists.searchValue(Playlist(line));
+                        const Playlist *pl2ptr = snapshot->findPlaylist(line);
                         if(pl2ptr == nullptr){
                             std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
                         }
@@ -150,13 +483,18 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
                             std::cout << "Digite o nome da playlist que deseja subtrair, ou deixe em branco para cancelar:\n";
                             std::getline(std::cin, line);
                             if(line != ""){
-                                auto pl3ptr = playlists.searchValue(Playlist(line));
+                                const Playlist *pl3ptr = snapshot->findPlaylist(line);
                                 if(pl3ptr == nullptr){
                                     std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
                                 }
                                 else{
-                                    pl1ptr->removeSong(*pl2ptr);
-                                    std::cout << "Playlist \"" << line << "\" criada com sucesso.\n";
+                                    Playlist created = (pl2ptr->view() - *pl3ptr).materialize(name);
+                                    if(addPlaylist(library, created, name)){
+                                        std::cout << "Playlist \"" << name << "\" criada com sucesso.\n";
+                                    }
+                                    else{
+                                        std::cout << "Erro: A playlist \"" << name << "\" já existe.\n";
+                                    }
                                 }
                             }
                         }
@@ -165,6 +503,271 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
             }
             break;
 
+        case 5: {
+        // Visualizar uma combinação de playlists sem criá-la
+            std::cout << "Digite o nome da primeira playlist, ou deixe em branco para cancelar:\n";
+            std::getline(std::cin, line);
+            if(line == ""){
+                break;
+            }
+            const Playlist *first = snapshot->findPlaylist(line);
+            if(first == nullptr){
+                std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
+                break;
+            }
+            PlaylistView view = first->view();
+            std::string expression = line;
+
+            while(true){
+                std::cout << "Digite + ou - seguido do nome de uma playlist (ex.: +Rock), ou deixe em branco para terminar:\n";
+                std::getline(std::cin, line);
+                if(line == ""){
+                    break;
+                }
+                if(line.size() < 2 || (line[0] != '+' && line[0] != '-')){
+                    std::cout << "Erro: Operação inválida.\n";
+                    continue;
+                }
+                const Playlist *other = snapshot->findPlaylist(line.substr(1));
+                if(other == nullptr){
+                    std::cout << "Erro: A playlist \"" << line.substr(1) << "\" não existe.\n";
+                    continue;
+                }
+                view = (line[0] == '+') ? std::move(view) + *other : std::move(view) - *other;
+                expression += " " + line.substr(0, 1) + " " + line.substr(1);
+            }
+
+            PlaylistStats stats;
+            for(PlaylistView::Iterator it = view.begin(); it != view.end(); ++it){
+                stats.add(*it);
+            }
+            std::cout << "Músicas de " << expression << " (" << stats << "):\n";
+            showPages(view);
+            std::cout << "1. Tocar\n";
+            std::cout << "2. Salvar como nova playlist\n";
+            std::cout << "0. Voltar\n";
+            std::cout << "Digite sua escolha: ";
+            std::cin >> choice;
+            std::cin.ignore();
+
+            if(choice == 1){
+                playView(view, expression, stats, catalogOf(*snapshot));
+            }
+            if(choice == 2){
+                std::cout << "Digite o nome da nova playlist, ou deixe em branco para cancelar:\n";
+                std::getline(std::cin, line);
+                if(line != ""){
+                    Playlist created = view.materialize(line);
+                    if(addPlaylist(library, created, line)){
+                        std::cout << "Playlist \"" << line << "\" criada com sucesso.\n";
+                    }
+                    else{
+                        std::cout << "Erro: A playlist \"" << line << "\" já existe.\n";
+                    }
+                }
+            }
+            break;
+        }
+
+        case 6: {
+        // Criar uma playlist com as músicas do catálogo que contêm um texto
+            std::cout << "Digite o nome da playlist que deseja criar, ou deixe em branco para cancelar:\n";
+            std::getline(std::cin, line);
+            if(line == ""){
+                break;
+            }
+            if(snapshot->findPlaylist(line) != nullptr){
+                std::cout << "Erro: A playlist \"" << line << "\" já existe.\n";
+                break;
+            }
+            Playlist playlist(line);
+
+            std::cout << "Digite o texto que o título ou o autor deve conter:\n";
+            std::getline(std::cin, line);
+
+            // O índice já remove as músicas encontradas pelo título e pelo autor
+            std::vector<Song> found;
+            library.search(line, SearchIndex::Any, SearchIndex::Substring, 0, snapshot->getSongCount(), found);
+            playlist.addSongs(found.begin(), found.end());
+            size_t size = playlist.getSize();
+            if(addPlaylist(library, playlist, playlist.getName())){
+                std::cout << "Playlist \"" << playlist.getName() << "\" criada com " << size << " música(s).\n";
+            }
+            else{
+                std::cout << "Erro: A playlist \"" << playlist.getName() << "\" já existe.\n";
+            }
+            break;
+        }
+
+        case 7: {
+        // Criar uma playlist inteligente
+            std::cout << "Digite o nome da playlist inteligente, ou deixe em branco para cancelar:\n";
+            std::getline(std::cin, line);
+            if(line == ""){
+                break;
+            }
+            std::string name = line;
+            std::cout << "Digite a regra. Termos: autor:nome, playlist:nome, ano, duração ou execuções\n";
+            std::cout << "comparados com <, <=, =, >= ou >. Combine com & (e), | (ou), - (exceto) e parênteses;\n";
+            std::cout << "use aspas em nomes com esses símbolos. Exemplo: playlist:Rock & ano>=2000\n";
+            std::getline(std::cin, line);
+
+            Library::Editor editor(library);
+            LinkedList<Playlist> &playlists = editor.playlists();
+            EditHistory &history = editor.history();
+            std::string error;
+            unsigned long long prior = playlists.getVersion();
+            Node<Playlist> *lastKnown = playlists.getTail();
+            EditHistory::Batch batch(&history, "Criar a playlist inteligente " + name);
+            if(!editor.smartPlaylists().define(name, line, playlists, error)){
+                std::cout << "Erro: " << error << ".\n";
+            }
+            else{
+                history.playlistsAppended(prior, lastKnown);
+                std::cout << "Playlist inteligente \"" << name << "\" criada. Ela é atualizada sempre que o catálogo\n";
+                std::cout << "ou as playlists da regra mudam.\n";
+            }
+            break;
+        }
+
+        case 8: {
+        // Listar as playlists inteligentes
+            Library::Editor editor(library);
+            SmartPlaylists &smart = editor.smartPlaylists();
+            if(smart.getSize() == 0){
+                std::cout << "Nenhuma playlist inteligente.\n";
+            }
+            else{
+                smart.print(std::cout);
+            }
+            break;
+        }
+
+        case 9: {
+        // Procurar playlists parecidas com uma playlist
+            std::cout << "Digite o nome da playlist, ou deixe em branco para cancelar:\n";
+            std::getline(std::cin, line);
+            if(line == ""){
+                break;
+            }
+
+            // Mantém o índice entre as buscas; só as playlists alteradas são recalculadas
+            static SimilarityIndex similar;
+            std::vector<SimilarityIndex::Match> matches;
+            {
+                // O índice acompanha as playlists dos editores, então é consultado com a trava obtida
+                Library::Editor editor(library);
+                Playlist *pl = editor.findPlaylist(line);
+                if(pl == nullptr){
+                    std::cout << "Erro: Playlist inválida.\n";
+                    break;
+                }
+                similar.update(editor.playlists());
+                similar.findSimilar(*pl, 0.3, matches);
+            }
+
+            if(matches.empty()){
+                std::cout << "Nenhuma playlist parecida com \"" << line << "\".\n";
+                break;
+            }
+            std::cout << "Playlists parecidas com \"" << line << "\" (músicas em comum, estimado):\n";
+            size_t next = 0;
+            showPages(matches.size(), [&matches, &next](ListPrinter &out, size_t limit){
+                size_t printed = 0;
+                for(; printed < limit && next < matches.size(); printed++, next++){
+                    out.line("\"" + matches[next].name + "\" - " +
+                             std::to_string((int)(matches[next].similarity * 100 + 0.5)) + "%");
+                }
+                return printed;
+            });
+            break;
+        }
+
+        case 10: {
+        // Listar playlists quase iguais
+            static SimilarityIndex duplicates;
+            std::vector<SimilarityIndex::Pair> pairs;
+            {
+                Library::Editor editor(library);
+                duplicates.update(editor.playlists());
+                duplicates.findDuplicates(0.8, 0, pairs);
+            }
+
+            if(pairs.empty()){
+                std::cout << "Nenhum par de playlists quase iguais.\n";
+                break;
+            }
+            std::cout << "Pares de playlists com pelo menos 80% das músicas em comum (estimado):\n";
+            size_t next = 0;
+            showPages(pairs.size(), [&pairs, &next](ListPrinter &out, size_t limit){
+                size_t printed = 0;
+                for(; printed < limit && next < pairs.size(); printed++, next++){
+                    out.line("\"" + pairs[next].first + "\" e \"" + pairs[next].second + "\" - " +
+                             std::to_string((int)(pairs[next].similarity * 100 + 0.5)) + "%");
+                }
+                return printed;
+            });
+            break;
+        }
+
+        case 11: {
+        // Criar uma playlist que une, intersecta ou subtrai várias playlists
+            std::cout << "Digite o nome da playlist que deseja criar, ou deixe em branco para cancelar:\n";
+            std::getline(std::cin, line);
+            if(line == ""){
+                break;
+            }
+            if(snapshot->findPlaylist(line) != nullptr){
+                std::cout << "Erro: A playlist \"" << line << "\" já existe.\n";
+                break;
+            }
+            std::string name = line;
+
+            std::cout << "1. União: músicas de todas as playlists\n";
+            std::cout << "2. Interseção: músicas da primeira playlist que estão em todas as outras\n";
+            std::cout << "3. Diferença: músicas da primeira playlist que não estão em nenhuma das outras\n";
+            std::cout << "Digite a operação: ";
+            std::cin >> choice;
+            std::cin.ignore();
+            if(choice < 1 || choice > 3){
+                std::cout << "Erro: Operação inválida.\n";
+                break;
+            }
+            PlaylistCombiner::Operation operation = choice == 1 ? PlaylistCombiner::Union :
+                                                    choice == 2 ? PlaylistCombiner::Intersection :
+                                                                  PlaylistCombiner::Difference;
+
+            std::vector<const Playlist*> inputs;
+            while(true){
+                std::cout << "Digite o nome de uma playlist, ou deixe em branco para terminar:\n";
+                std::getline(std::cin, line);
+                if(line == ""){
+                    break;
+                }
+                const Playlist *pl = snapshot->findPlaylist(line);
+                if(pl == nullptr){
+                    std::cout << "Erro: A playlist \"" << line << "\" não existe.\n";
+                }
+                else{
+                    inputs.push_back(pl);
+                }
+            }
+            if(inputs.empty()){
+                std::cout << "Ação cancelada.\n";
+                break;
+            }
+
+            Playlist created = PlaylistCombiner(inputs, 0).materialize(operation, name);
+            size_t size = created.getSize();
+            if(addPlaylist(library, created, name)){
+                std::cout << "Playlist \"" << name << "\" criada com " << size << " música(s).\n";
+            }
+            else{
+                std::cout << "Erro: A playlist \"" << name << "\" já existe.\n";
+            }
+            break;
+        }
+
         case 0:
         // Voltar ao menu principal
             return;
@@ -177,11 +780,15 @@ void otherMethods(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
 }
 
 /**
- * @brief Menu de playlists, que permite adicionar, remover ou listar músicas no sistema.
+ * @brief Menu de playlists, que permite adicionar, remover ou listar playlists no sistema e ver
+ * estatísticas de todas elas.
  * 
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * As listagens e as estatísticas usam a versão publicada; a trava de escrita
+ * só é obtida para adicionar ou remover a playlist, depois das perguntas.
+ *
+ * @param library Biblioteca de músicas e playlists do sistema.
  */
-void playlistMenu(LinkedList<Playlist> &playlists){
+void playlistMenu(Library &library){
     int choice;
 
     std::cout << "======================\n";
@@ -189,6 +796,7 @@ void playlistMenu(LinkedList<Playlist> &playlists){
     std::cout << "1. Adicionar playlist\n";
     std::cout << "2. Remover playlist\n";
     std::cout << "3. Listar playlists\n";
+    std::cout << "4. Estatísticas das playlists\n";
     std::cout << "0. Voltar\n";
     std::cout << "Digite sua escolha: ";
 
@@ -196,17 +804,25 @@ void playlistMenu(LinkedList<Playlist> &playlists){
     std::cin.ignore();
 
     std::string line;
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
 
     switch(choice){
         case 1: // Adicionar playlist
             std::cout << "Digite o nome da playlist para adicionar, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != "") {
-                if(playlists.searchValue(Playlist(line)) != nullptr){
+                Library::Editor editor(library);
+                if(editor.findPlaylist(line) != nullptr){
                     std::cout << "Erro: A playlist \"" << line << "\" já existe.\n";
                 }
                 else{
+                    LinkedList<Playlist> &playlists = editor.playlists();
+                    EditHistory &history = editor.history();
+                    EditHistory::Batch batch(&history, "Adicionar a playlist " + line);
+                    unsigned long long prior = playlists.getVersion();
+                    Node<Playlist> *lastKnown = playlists.getTail();
                     playlists.add(Playlist(line));
+                    history.playlistsAppended(prior, lastKnown);
                     std::cout << "Playlist \"" << line << "\" adicionada com sucesso.\n";
                 }
             }
@@ -219,11 +835,14 @@ void playlistMenu(LinkedList<Playlist> &playlists){
             std::cout << "Digite o nome da playlist para remover, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != ""){
-                if(playlists.searchValue(Playlist(line)) == nullptr){
+                Library::Editor editor(library);
+                if(editor.findPlaylist(line) == nullptr){
                     std::cout << "Erro: Playlist inválida.\n";
                 }
                 else{
-                    playlists.removeValue(Playlist(line));
+                    EditHistory &history = editor.history();
+                    EditHistory::Batch batch(&history, "Remover a playlist " + line);
+                    history.removePlaylist(line);
                     std::cout << "Playlist \"" << line << "\" removida com sucesso.\n";
                 }
             }
@@ -233,16 +852,56 @@ void playlistMenu(LinkedList<Playlist> &playlists){
             break;
 
         case 3: // Listar playlists
-            if(playlists.getSize() == 0){
+            if(snapshot->playlists.empty()){
                 std::cout << "Nenhuma playlist cadastrada.\n";
             }
             else{
+                std::vector<const Playlist*> playlists;
+                for(size_t i = 0; i < snapshot->playlists.size(); i++){
+                    playlists.push_back(snapshot->playlists[i].get());
+                }
                 std::cout << "Playlists:\n";
-                playlists.print();
+                showPages(playlists);
             }
 
             break;
 
+        case 4: // Estatísticas das playlists
+            if(snapshot->playlists.empty()){
+                std::cout << "Nenhuma playlist cadastrada.\n";
+            }
+            else{
+                PlaylistAggregator aggregator(snapshot->playlists);
+                std::vector<PlaylistAggregator::Ranked> ranked;
+                std::vector<PlaylistAggregator::SizeBucket> sizes;
+
+                aggregator.top(PlaylistAggregator::Songs, pageSize, ranked);
+                std::cout << "Músicas presentes em mais playlists:\n";
+                for(size_t i = 0; i < ranked.size(); i++){
+                    std::cout << i + 1 << ". " << ranked[i].title << " - " << ranked[i].author << " ("
+                              << ranked[i].count << " playlists)\n";
+                }
+
+                aggregator.top(PlaylistAggregator::Authors, pageSize, ranked);
+                std::cout << "Autores presentes em mais playlists:\n";
+                for(size_t i = 0; i < ranked.size(); i++){
+                    std::cout << i + 1 << ". " << ranked[i].author << " (" << ranked[i].count << " playlists)\n";
+                }
+
+                aggregator.sizeHistogram(sizes);
+                std::cout << "Playlists por número de músicas:\n";
+                for(size_t i = 0; i < sizes.size(); i++){
+                    if(sizes[i].low == sizes[i].high){
+                        std::cout << sizes[i].low;
+                    }
+                    else{
+                        std::cout << sizes[i].low << " a " << sizes[i].high;
+                    }
+                    std::cout << ": " << sizes[i].playlists << "\n";
+                }
+            }
+            break;
+
         case 0:
             return;
 
@@ -257,10 +916,12 @@ void playlistMenu(LinkedList<Playlist> &playlists){
 /**
  * @brief Menu de músicas, que permite adicionar, remover ou listar músicas no sistema.
  * 
- * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * As músicas são escolhidas e listadas na versão publicada; a trava de
+ * escrita só é obtida para alterar o catálogo, depois das perguntas.
+ *
+ * @param library Biblioteca de músicas e playlists do sistema.
  */
-void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
+void songMenu(Library &library){
     int choice;
 
     std::cout << "======================\n";
@@ -268,6 +929,7 @@ void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
     std::cout << "1. Adicionar música\n";
     std::cout << "2. Remover música\n";
     std::cout << "3. Listar músicas\n";
+    std::cout << "4. Ordenar músicas\n";
     std::cout << "0. Voltar\n";
     std::cout << "Digite sua escolha: ";
 
@@ -275,21 +937,42 @@ void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
     std::cin.ignore();
 
     std::string line;
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
 
     switch(choice){
         case 1: {// Adicionar música
             std::cout << "Digite o nome da música para adicionar, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != "") {
-                if(songs.searchValue(Song(line)) != nullptr){
-                    std::cout << "Erro: A música \"" << line << "\" já existe.\n";
+                std::string author;
+                std::cout << "Digite o nome do autor:\n";
+                std::getline(std::cin, author);
+                std::string duration;
+                std::cout << "Digite a duração (ex.: 3:45), ou deixe em branco se for desconhecida:\n";
+                std::getline(std::cin, duration);
+
+                Song song(line, author);
+                unsigned seconds = 0;
+                if(duration != "" && !Song::parseDuration(duration, seconds)){
+                    std::cout << "Erro: Duração inválida.\n";
+                    break;
                 }
-                else{
-                    std::string author;
-                    std::cout << "Digite o nome do autor:\n";
-                    std::getline(std::cin, author);
 
-                    songs.add(Song(line, author));
+                Library::Editor editor(library);
+                LinkedList<Song> &songs = editor.songs();
+                if(editor.index().find(song) != nullptr){
+                    std::cout << "Erro: A música \"" << line << "\" de \"" << author << "\" já existe.\n";
+                }
+                else{
+                    EditHistory &history = editor.history();
+                    song.setDuration(seconds);
+                    EditHistory::Batch batch(&history, "Adicionar a música " + line);
+                    unsigned long long prior = songs.getVersion();
+                    Node<Song> *lastKnown = songs.getTail();
+                    songs.add(song);
+                    editor.index().add(&(songs.getTail()->getValue()));
+                    editor.smartPlaylists().added(songs, prior, songs.getTail()->getValue());
+                    history.catalogAppended(prior, lastKnown);
                     std::cout << "Música \"" << line << "\" adicionada com sucesso.\n";
                 }
             }
@@ -299,20 +982,37 @@ void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
             break;
         }
                 
-        case 2: // Remover música
+        case 2: { // Remover música
             std::cout << "Digite o nome da música para remover, ou deixe em branco para cancelar:\n";
             std::getline(std::cin, line);
             if(line != ""){
-                if(songs.searchValue(Song(line)) == nullptr){
+                const Song *found = selectSong(catalogOf(*snapshot), line);
+                if(found == nullptr){
+                    std::cout << "Erro: Música inválida.\n";
+                    break;
+                }
+                Song song = *found;
+
+                Library::Editor editor(library);
+                SearchIndex &index = editor.index();
+                Song *live = index.find(song);
+                if(live == nullptr){
                     std::cout << "Erro: Música inválida.\n";
                 }
                 else{
-                    songs.removeValue(Song(line));
+                    // A música sai do catálogo e de todas as playlists em um único passo
+                    LinkedList<Song> &songs = editor.songs();
+                    EditHistory &history = editor.history();
+                    EditHistory::Batch batch(&history, "Remover a música " + line);
+                    index.remove(live);
+                    unsigned long long prior = songs.getVersion();
+                    history.removeFromCatalog(song);
+                    editor.smartPlaylists().removed(songs, prior, song);
 
-                    Node<Playlist> *curr = playlists.getHead();
+                    Node<Playlist> *curr = editor.playlists().getHead();
 
                     while(curr != nullptr){
-                        curr->getValue().removeSong(Song(line));
+                        curr->getValue().removeSong(song);
                         curr = curr->getNext();
                     }
 
@@ -323,17 +1023,45 @@ void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
                 std::cout << "Ação cancelada.\n";
             }
             break;
+        }
 
         case 3: // Listar músicas
-            if(songs.getSize() == 0){
+            if(snapshot->getSongCount() == 0){
                 std::cout << "Nenhuma música cadastrada.\n";
             }
             else{
-                std::cout << "Músicas:\n";
-                songs.print();
+                std::vector<const LinkedList<Song>*> catalog = catalogOf(*snapshot);
+                SongOrder order = readSongOrder();
+
+                std::cout << "Músicas (" << order.getDescription() << "):\n";
+                if(order.isEmpty()){
+                    showPages(catalog);
+                }
+                else{
+                    // A última ordenação calculada é mantida até o catálogo mudar
+                    showPages(sortSongs(snapshot, catalog, order));
+                }
             }
             break;
 
+        case 4: { // Ordenar músicas
+            SongOrder order = readSongOrder();
+            if(order.isEmpty()){
+                std::cout << "Ação cancelada.\n";
+            }
+            else{
+                Library::Editor editor(library);
+                LinkedList<Song> &songs = editor.songs();
+                EditHistory &history = editor.history();
+                EditHistory::Batch batch(&history, "Ordenar as músicas por " + order.getDescription());
+                unsigned long long prior = songs.getVersion();
+                history.sortCatalog(order);
+                editor.smartPlaylists().reordered(songs, prior);
+                std::cout << "Músicas ordenadas por " << order.getDescription() << ".\n";
+            }
+            break;
+        }
+
         case 0:
             return;
 
@@ -349,10 +1077,13 @@ void songMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
  * @brief Menu de gerenciamento de músicas em playlists, que permite adicionar, remover ou listar
  * músicas nas playlists.
  * 
- * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * A playlist e as músicas são escolhidas na versão publicada; a trava de
+ * escrita só é obtida para alterar a playlist, que é procurada de novo nas
+ * listas dos editores.
+ *
+ * @param library Biblioteca de músicas e playlists do sistema.
  */
-void songPlaylistMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
+void songPlaylistMenu(Library &library){
     int choice;
 
     std::cout << "======================\n";
@@ -360,6 +1091,7 @@ void songPlaylistMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
     std::cout << "1. Adicionar música em playlist\n";
     std::cout << "2. Remover música de playlist\n";
     std::cout << "3. Listar músicas de playlist\n";
+    std::cout << "4. Ordenar músicas de playlist\n";
     std::cout << "0. Voltar\n";
     std::cout << "Digite sua escolha: ";
 
@@ -380,7 +1112,9 @@ void songPlaylistMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
         return;
     }
 
-    Playlist *pl = playlists.searchValue(Playlist(line));
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+    const Playlist *pl = snapshot->findPlaylist(line);
+    std::string name = line;
 
     if(pl == nullptr){
         std::cout << "Erro: Playlist inválida.\n";
@@ -393,43 +1127,91 @@ void songPlaylistMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
         case 1: { // Adicionar música em playlist
             std::cout << "Digite o nome da música para adicionar:\n";
             std::getline(std::cin, line);
-            Song* musica = songs.searchValue(Song(line));
+            const Song *musica = selectSong(catalogOf(*snapshot), line);
 
             //Caso música não exista no sistema
             if(musica == nullptr){ 
                 std::cout << "Erro: Música inválida. Adicione a música ao sistema primeiro.\n";
+                break;
+            }
+            Song song = *musica;
+
+            Library::Editor editor(library);
+            Playlist *live = editor.findPlaylist(name);
+            if(live == nullptr){
+                std::cout << "Erro: Playlist inválida.\n";
+            }
+            else if(editor.index().find(song) == nullptr){
+                std::cout << "Erro: Música inválida. Adicione a música ao sistema primeiro.\n";
             }
             //Caso música já esteja na playlist
-            else if(pl->searchSong(*musica) != nullptr){
+            else if(live->searchSong(song) != nullptr){
                 std::cout << "Erro: Música já está na playlist.\n";
             }
             else{
-                pl->addSong(*musica);
+                live->addSong(song);
                 std::cout << "Música adicionada com sucesso.\n";
             }
             break;
         }
-        case 2: //Remover música de playlist
+        case 2: { //Remover música de playlist
             std::cout << "Digite o nome da música para remover:\n";
             std::getline(std::cin, line);
 
-            if(pl->searchSong(Song(line)) != nullptr){
-                pl->removeSong(Song(line));
-                std::cout << "Música removida com sucesso.\n";
+            const Song *musica = selectSong(pl->readSongs(), line);
+            if(musica == nullptr){
+                std::cout << "Erro: Música não está na playlist.\n";
+                break;
             }
-            else{
+            Song song = *musica;
+
+            Library::Editor editor(library);
+            Playlist *live = editor.findPlaylist(name);
+            if(live == nullptr){
+                std::cout << "Erro: Playlist inválida.\n";
+            }
+            else if(live->searchSong(song) == nullptr){
                 std::cout << "Erro: Música não está na playlist.\n";
             }
+            else{
+                live->removeSong(song);
+                std::cout << "Música removida com sucesso.\n";
+            }
             break;
+        }
         case 3: // Listar músicas de playlist
             if(pl->getSize() > 0){
-                std::cout << "Músicas da playlist \"" << pl->getName() << "\":\n";
-                pl->printSongs();
+                SongOrder order = readSongOrder();
+                std::cout << "Músicas da playlist \"" << pl->getName() << "\" (" << order.getDescription() << "):\n";
+                if(order.isEmpty()){
+                    showPages(pl->readSongs());
+                }
+                else{
+                    showPages(sortSongs(snapshot, std::vector<const LinkedList<Song>*>(1, &pl->readSongs()), order));
+                }
             }
             else{
                 std::cout << "A playlist \"" << pl->getName() << "\" não possui músicas.\n";
             }
             break;
+        case 4: { // Ordenar músicas de playlist
+            SongOrder order = readSongOrder();
+            if(order.isEmpty()){
+                std::cout << "Ação cancelada.\n";
+                break;
+            }
+
+            Library::Editor editor(library);
+            Playlist *live = editor.findPlaylist(name);
+            if(live == nullptr){
+                std::cout << "Erro: Playlist inválida.\n";
+            }
+            else{
+                live->sort(order);
+                std::cout << "Playlist \"" << name << "\" ordenada por " << order.getDescription() << ".\n";
+            }
+            break;
+        }
     }
     std::cout << "Pressione ENTER para continuar.";
     std::cin.get();
@@ -438,9 +1220,12 @@ void songPlaylistMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
 /**
  * @brief Toca as músicas, em sequência, da playlist selecionada.
  * 
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * A reprodução usa a versão publicada da biblioteca, então não impede que
+ * outras partes do sistema alterem as playlists enquanto a música toca.
+ * 
+ * @param library Biblioteca de músicas e playlists do sistema.
  */
-void playSongs(LinkedList<Playlist> &playlists){
+void playSongs(Library &library){
     std::string line;
     std::cout << "Selecione a playlist para tocar, ou deixe em branco para cancelar:\n";
     std::getline(std::cin, line);
@@ -452,7 +1237,8 @@ void playSongs(LinkedList<Playlist> &playlists){
         return;
     }
 
-    Playlist *pl = playlists.searchValue(Playlist(line));
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+    const Playlist *pl = snapshot->findPlaylist(line);
 
     if(pl == nullptr) {
         std::cout << "Erro: Playlist inválida.\n";
@@ -468,24 +1254,79 @@ void playSongs(LinkedList<Playlist> &playlists){
         return;
     }
 
+    playView(pl->view(), pl->getName(), pl->getStats(), catalogOf(*snapshot));
+}
+
+/**
+ * @brief Toca as músicas, em sequência, de uma visão de playlist.
+ * 
+ * As músicas são calculadas conforme são tocadas, então combinações de
+ * playlists podem ser tocadas sem serem criadas. Músicas do catálogo podem
+ * ser adicionadas a uma fila (UpNextQueue), que toca antes de a playlist
+ * continuar de onde parou.
+ * 
+ * @param view Visão com as músicas a serem tocadas.
+ * @param name Nome exibido durante a reprodução.
+ * @param stats Totais das músicas da visão, exibidos durante a reprodução.
+ * @param catalog Listas com as músicas que podem ser adicionadas à fila, como
+ * as partes do catálogo publicado.
+ */
+void playView(PlaylistView view, std::string name, const PlaylistStats &stats, const std::vector<const LinkedList<Song>*> &catalog){
+    PlaylistView::Iterator curr = view.begin();
+
+    if(curr == view.end()){
+        std::cout << "\"" << name << "\" não tem nenhuma música.\n";
+        std::cout << "Pressione ENTER para continuar.";
+        std::cin.get();
+        return;
+    }
+
     int end = 0;
     int count = 1;
-    Node<Song> *curr = pl->getSongs().getHead();
+    size_t size = stats.getTracks();
+    // Duração das músicas que ainda não terminaram de tocar
+    unsigned long long remaining = stats.getDuration();
+    UpNextQueue queue;
+    // Música da fila tocando, ou nullptr se a música atual é curr
+    const Song *queued = nullptr;
+    std::string line;
 
     while(end == 0){
         int choice;
+        // Próxima música da playlist: curr, se a música atual veio da fila
+        PlaylistView::Iterator next = curr;
+        if(queued == nullptr){
+            ++next;
+        }
+        const Song *upNext = queue.peek();
 
         std::cout << "======================\n";
-        std::cout << "Tocando playlist \"" << pl->getName() <<"\".\n";
-        std::cout << "Música " << count << " de " << pl->getSize() << ":\n";
-        std::cout << curr->getValue() << "\n";
-        if(curr->getNext() == nullptr){
+        std::cout << "Tocando playlist \"" << name <<"\" (" << stats << ").\n";
+        if(queued != nullptr){
+            std::cout << "Música da fila:\n";
+            std::cout << *queued << "\n";
+        }
+        else{
+            std::cout << "Música " << count << " de " << size;
+            if(remaining > 0){
+                std::cout << " - Tempo restante: " << Song::formatDuration(remaining);
+            }
+            std::cout << ":\n";
+            std::cout << *curr << "\n";
+        }
+        if(upNext != nullptr){
+            std::cout << "Próxima música (fila, " << queue.getSize() << " na fila): " << *upNext << "\n";
+        }
+        else if(next == view.end()){
             std::cout << "Última música da playlist.\n";
         }
         else{
-            std::cout << "Próxima música: " << curr->getNext()->getValue() << "\n";
+            std::cout << "Próxima música: " << *next << "\n";
         }
         std::cout << "1. Tocar próxima música\n";
+        std::cout << "2. Adicionar uma música ao fim da fila\n";
+        std::cout << "3. Tocar uma música em seguida\n";
+        std::cout << "4. Limpar a fila\n";
         std::cout << "0. Parar de tocar\n";
         std::cout << "Digite sua escolha: ";
 
@@ -493,14 +1334,34 @@ void playSongs(LinkedList<Playlist> &playlists){
         std::cin.ignore();
 
         if(choice == 1){
-            curr = curr->getNext();
-            count++;
+            if(queued == nullptr){
+                remaining -= curr->getDuration();
+                count++;
+            }
+            curr = next;
+            queued = queue.take();
+        }
+        else if(choice == 2 || choice == 3){
+            std::cout << "Digite o título da música, ou deixe em branco para cancelar:\n";
+            std::getline(std::cin, line);
+            if(line != ""){
+                const Song *song = selectSong(catalog, line);
+                if(song == nullptr){
+                    std::cout << "Erro: A música não está no catálogo.\n";
+                }
+                else if(!(choice == 2 ? queue.push(song) : queue.insertNext(song))){
+                    std::cout << "Erro: A fila está cheia.\n";
+                }
+            }
+        }
+        else if(choice == 4){
+            queue.clear();
         }
         else{
             end = 1;
         }
 
-        if(curr == nullptr){
+        if(end == 0 && queued == nullptr && curr == view.end()){
             std::cout << "A playlist acabou.\n";
             std::cout << "Pressione ENTER para continuar.";
             std::cin.get();
@@ -511,51 +1372,243 @@ void playSongs(LinkedList<Playlist> &playlists){
     
 }
 
+/**
+ * @brief Menu de busca, que permite encontrar músicas pelo início das palavras
+ * ou por um trecho do título ou do autor. Os resultados são exibidos em páginas.
+ * 
+ * Cada página é buscada com Library::search, que copia as músicas
+ * encontradas; a trava de escrita não fica obtida enquanto a página é exibida.
+ *
+ * @param library Biblioteca de músicas e playlists do sistema.
+ */
+void searchMenu(Library &library){
+    int choice;
+
+    std::cout << "======================\n";
+    std::cout << "Buscar músicas\n";
+    std::cout << "1. Título começa com\n";
+    std::cout << "2. Título contém\n";
+    std::cout << "3. Autor começa com\n";
+    std::cout << "4. Autor contém\n";
+    std::cout << "5. Título ou autor contém\n";
+    std::cout << "6. Autor é igual a\n";
+    std::cout << "0. Voltar\n";
+    std::cout << "Digite sua escolha: ";
+
+    std::cin >> choice;
+    std::cin.ignore();
+
+    SearchIndex::Field field;
+    SearchIndex::Mode mode;
+
+    switch(choice){
+        case 1: field = SearchIndex::Title; mode = SearchIndex::Prefix; break;
+        case 2: field = SearchIndex::Title; mode = SearchIndex::Substring; break;
+        case 3: field = SearchIndex::Author; mode = SearchIndex::Prefix; break;
+        case 4: field = SearchIndex::Author; mode = SearchIndex::Substring; break;
+        case 5: field = SearchIndex::Any; mode = SearchIndex::Substring; break;
+        case 6: field = SearchIndex::Author; mode = SearchIndex::Exact; break;
+        case 0: return;
+        default:
+            std::cout << "Erro: Escolha inválida!\n";
+            std::cout << "Pressione ENTER para continuar.";
+            std::cin.get();
+            return;
+    }
+
+    std::string line;
+    std::cout << "Digite o texto a ser buscado, ou deixe em branco para cancelar:\n";
+    std::getline(std::cin, line);
+    if(line == ""){
+        std::cout << "Ação cancelada.\n";
+        std::cout << "Pressione ENTER para continuar.";
+        std::cin.get();
+        return;
+    }
+
+    size_t offset = 0;
+    std::vector<Song> songs;
+    while(true){
+        size_t total = library.search(line, field, mode, offset, pageSize, songs);
+
+        if(total == 0){
+            std::cout << "Nenhuma música encontrada.\n";
+            break;
+        }
+
+        std::cout << "Resultados " << offset + 1 << " a " << offset + songs.size()
+                  << " de " << total << ":\n";
+        for(size_t i = 0; i < songs.size(); i++){
+            std::cout << songs[i] << "\n";
+        }
+
+        if(offset + songs.size() >= total){
+            break;
+        }
+        std::cout << "1. Próxima página\n";
+        std::cout << "0. Voltar\n";
+        std::cout << "Digite sua escolha: ";
+        std::cin >> choice;
+        std::cin.ignore();
+        if(choice != 1){
+            return;
+        }
+        offset += songs.size();
+    }
+    std::cout << "Pressione ENTER para continuar.";
+    std::cin.get();
+}
+
 /**
  * @brief Menu principal, que permite chamar os submenus relacionados a músicas e playlists.
  * 
- * @param songs Lista encadeada (LinkedList) de músicas (Song) do sistema.
- * @param playlists Lista encadeada (LinkedList) de playlists (Playlist) do sistema.
+ * Os submenus consultam a versão publicada e só obtêm a trava de escrita da
+ * biblioteca (Library::Editor) em cada alteração, depois das perguntas ao
+ * usuário; cada alteração é publicada assim que termina.
+ * Enquanto os exemplos são carregados, o menu exibe o andamento e os submenus
+ * usam a parte já carregada. As recargas de arquivos alterados feitas desde a
+ * última exibição do menu também são exibidas. As opções de desfazer e
+ * refazer usam o histórico da biblioteca (EditHistory).
+ * 
+ * @param library Biblioteca de músicas e playlists do sistema.
+ * @param loader Carregador de playlists da biblioteca.
+ * @param watcher Acompanhamento dos arquivos de playlists.
  * @return Retorna 1 caso o programa seja encerrado, ou 0 caso contrário.
  */
-int mainMenu(LinkedList<Song> &songs, LinkedList<Playlist> &playlists){
+int mainMenu(Library &library, Loader &loader, Watcher &watcher){
+    // Indica se o fim do carregamento já foi exibido
+    static bool loadReported = false;
     int choice;
 
+    Loader::Progress progress = loader.getProgress();
+    bool loading = (progress.state == Loader::Loading);
+
     std::cout << "======================\n";
+    if(loading){
+        std::cout << "Carregando playlists: " << progress.getPercent() << "% (" << progress.playlists
+                  << " playlists carregadas)\n";
+        loadReported = false;
+    }
+    else if(progress.state != Loader::Idle && !loadReported){
+        if(progress.state == Loader::Failed){
+            std::cout << "Erro ao carregar os arquivos:\n";
+        }
+        else{
+            std::cout << (progress.state == Loader::Cancelled ? "Carregamento cancelado: " : "Carregamento concluído: ")
+                      << progress.playlists << " playlists em " << (long long)(progress.seconds * 1000) << " ms\n";
+        }
+        loader.printReport(std::cout);
+        loadReported = true;
+    }
+    std::vector<Watcher::Reload> reloads = watcher.takeReports();
+    for(size_t i = 0; i < reloads.size(); i++){
+        Watcher::printReload(std::cout, reloads[i]);
+    }
     std::cout << "Menu inicial\n";
     std::cout << "1. Gerenciar playlists\n";
     std::cout << "2. Gerenciar músicas\n";
     std::cout << "3. Gerenciar músicas em playlists\n";
     std::cout << "4. Tocar playlist\n";
     std::cout << "5. Outras opções\n";
+    std::cout << "6. Buscar músicas\n";
+    if(loading){
+        std::cout << "7. Cancelar carregamento\n";
+    }
+    std::cout << "8. Desfazer a última alteração\n";
+    std::cout << "9. Refazer a última alteração desfeita\n";
+    std::cout << "10. Uso de memória e compactação\n";
     std::cout << "0. Sair\n";
     std::cout << "Digite sua escolha: ";
 
     std::cin >> choice;
     std::cin.ignore();
 
+    if(choice == 7 && !loading){
+        choice = -1;
+    }
+
     switch(choice){
-        case 1: 
-            playlistMenu(playlists); 
+        case 1:
+            playlistMenu(library); 
             break;
 
-        case 2: 
-            songMenu(songs, playlists); 
+        case 2:
+            songMenu(library); 
             break;
 
         case 3:
-            songPlaylistMenu(songs, playlists);
+            songPlaylistMenu(library);
             break;
         
         case 4:
-            playSongs(playlists);
+            playSongs(library);
             break;
 
         case 5:
-            otherMethods(songs, playlists);
-            break;    
+            otherMethods(library);
+            break;
+
+        case 6:
+            searchMenu(library);
+            break;
 
+        case 7:
+            loader.cancel();
+            std::cout << "Carregamento cancelado. As playlists já carregadas foram mantidas.\n";
+            std::cout << "Pressione ENTER para continuar.";
+            std::cin.get();
+            break;
 
+        case 8:
+        case 9: {
+            std::string label;
+            EditHistory::Result result;
+            {
+                Library::Editor editor(library);
+                result = (choice == 8) ? editor.history().undo(label) : editor.history().redo(label);
+            }
+            if(result == EditHistory::Nothing){
+                std::cout << (choice == 8 ? "Nenhuma alteração para desfazer.\n" : "Nenhuma alteração para refazer.\n");
+            }
+            else if(result == EditHistory::Conflict){
+                std::cout << "Erro: As listas foram alteradas fora do histórico; o histórico foi descartado.\n";
+            }
+            else{
+                std::cout << (choice == 8 ? "Desfeito: " : "Refeito: ") << label << "\n";
+            }
+            std::cout << "Pressione ENTER para continuar.";
+            std::cin.get();
+            break;
+        }
+
+        case 10: {
+            MemoryReport report;
+            report.measure(library);
+            report.print(std::cout, 10);
+            std::cout << "1. Compactar as playlists\n";
+            std::cout << "0. Voltar\n";
+            std::cout << "Digite sua escolha: ";
+            std::cin >> choice;
+            std::cin.ignore();
+
+            if(choice == 1){
+                size_t before = MemoryReport::residentBytes();
+                std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                size_t released = library.compact();
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+                report.measure(library);
+                std::cout << "Playlists compactadas em " << (long long)(elapsed.count() * 1000) << " ms; "
+                          << released / 1024 << " KB de nós devolvidos ao sistema.\n";
+                if(before > 0){
+                    std::cout << "Memória residente: " << before / 1024 << " KB antes, "
+                              << report.getResidentBytes() / 1024 << " KB depois.\n";
+                }
+                report.print(std::cout, 10);
+            }
+            std::cout << "Pressione ENTER para continuar.";
+            std::cin.get();
+            break;
+        }
 
         case 0: 
             std::cout << "Programa encerrado.\n";
@@ -0,0 +1,159 @@
+/**
+ * @file SongIdentityTest.cpp
+ * @brief Testes da identidade das músicas: título e autor, sem diferenciar
+ * acentos e letras maiúsculas.
+ *
+ * Verifica Song::equals, a busca em um SongSet e as operações de conjunto de
+ * Playlist com músicas de mesmo título e autores diferentes, e com variações
+ * de acentos, maiúsculas e espaços. Retorna 0 se todos os testes passarem.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Song.hpp"
+#include "SongSet.hpp"
+#include "Playlist.hpp"
+
+//! Número de verificações que falharam.
+static int failures = 0;
+
+/**
+ * @brief Registra o resultado de uma verificação.
+ *
+ * @param condition Resultado esperado verdadeiro.
+ * @param description Descrição exibida se a verificação falhar.
+ */
+static void check(bool condition, const std::string &description){
+    if(!condition){
+        std::cerr << "Falhou: " << description << "\n";
+        failures++;
+    }
+}
+
+/**
+ * @brief Retorna os títulos e autores de uma playlist, em ordem.
+ *
+ * @param playlist Playlist.
+ * @return Um texto "título|autor" por música.
+ */
+static std::vector<std::string> contents(Playlist &playlist){
+    std::vector<std::string> songs;
+    for(const Node<Song> *curr = playlist.readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+        songs.push_back(curr->getValue().getTitleView().str() + "|" + curr->getValue().getAuthorView().str());
+    }
+    return songs;
+}
+
+/**
+ * @brief Músicas com o mesmo título e autores diferentes são diferentes, e a
+ * comparação só de títulos continua disponível.
+ */
+static void testSameTitleDifferentAuthors(){
+    Song a("Yesterday", "The Beatles");
+    Song b("Yesterday", "Ray Charles");
+    Song c("Yesterday", "The Beatles");
+
+    check(!a.equals(b), "mesmo título e autores diferentes são músicas diferentes");
+    check(a != b, "operator!= com autores diferentes");
+    check(a.equals(c) && a == c, "mesmo título e mesmo autor são a mesma música");
+    check(a.hasSameTitle(b), "hasSameTitle ignora o autor");
+    check(a.getFingerprint() != b.getFingerprint(), "autores diferentes geram fingerprints diferentes");
+    check(Song("Yesterday").equals(Song("Yesterday", "")), "autor vazio é o autor padrão");
+    check(!Song("Yesterday").equals(a), "autor vazio é diferente de um autor conhecido");
+}
+
+/**
+ * @brief Acentos (compostos ou combinados) e maiúsculas não mudam a
+ * identidade; espaços e outros caracteres mudam.
+ */
+static void testTextVariants(){
+    Song composed("Água de Beber", "Tom Jobim");
+    Song combining("A\xcc\x81gua de Beber", "Tom Jobim");
+    Song upper("ÁGUA DE BEBER", "TOM JOBIM");
+    Song plain("agua de beber", "tom jobim");
+
+    check(composed.equals(combining), "acento composto e acento combinado");
+    check(composed.equals(upper), "maiúsculas acentuadas");
+    check(composed.equals(plain), "texto sem acentos e em minúsculas");
+    check(composed.getFingerprint() == plain.getFingerprint(), "fingerprint igual para variações de acento");
+    check(composed.compareTitle(plain) != 0, "o texto original ainda desempata a ordenação");
+
+    check(!composed.equals(Song("Água  de Beber", "Tom Jobim")), "espaço repetido é outro título");
+    check(!composed.equals(Song("Água de Beber ", "Tom Jobim")), "espaço no fim é outro título");
+    check(!composed.equals(Song("Água de Beber", "Tom  Jobim")), "espaço repetido é outro autor");
+    check(!composed.equals(Song("Água de Beber", "Jobim")), "autor diferente com o mesmo título");
+}
+
+/**
+ * @brief SongSet encontra músicas pela identidade, e não confunde autores
+ * diferentes com o mesmo título.
+ */
+static void testSongSet(){
+    Song beatles("Yesterday", "The Beatles");
+    Song charles("Yesterday", "Ray Charles");
+    Song folded("YESTERDAY", "the beatles");
+    Song spaced("Yesterday ", "The Beatles");
+
+    SongSet set;
+    check(set.insert(&beatles).second, "inserção da primeira música");
+    check(set.insert(&charles).second, "mesmo título com outro autor é inserido");
+    check(!set.insert(&folded).second, "variação de maiúsculas não é inserida de novo");
+    check(set.count(&spaced) == 0, "variação de espaço não é encontrada");
+    check(set.size() == 2, "conjunto com duas músicas");
+    check(set.count(&folded) == 1 && *set.find(&folded) == &beatles, "busca pela variação encontra a original");
+}
+
+/**
+ * @brief Mescla, diferença, busca e remoção em playlists com músicas de mesmo
+ * título e autores diferentes.
+ */
+static void testPlaylistOperations(){
+    Playlist a("A");
+    a.addSongs({Song("Yesterday", "The Beatles"), Song("Hallelujah", "Leonard Cohen"), Song("Água de Beber", "Tom Jobim")});
+    Playlist b("B");
+    b.addSongs({Song("Yesterday", "Ray Charles"), Song("HALLELUJAH", "leonard cohen"), Song("Hallelujah", "Jeff Buckley")});
+
+    Playlist merged = a + b;
+    std::vector<std::string> expected = {"Yesterday|The Beatles", "Hallelujah|Leonard Cohen", "Água de Beber|Tom Jobim",
+                                         "Yesterday|Ray Charles", "Hallelujah|Jeff Buckley"};
+    check(contents(merged) == expected, "mescla mantém autores diferentes e ignora variações de maiúsculas");
+
+    Playlist difference = a - b;
+    expected = {"Yesterday|The Beatles", "Água de Beber|Tom Jobim"};
+    check(contents(difference) == expected, "diferença remove só o mesmo autor");
+
+    Song charles("Yesterday", "Ray Charles");
+    Playlist withoutCharles = merged - charles;
+    expected = {"Yesterday|The Beatles", "Hallelujah|Leonard Cohen", "Água de Beber|Tom Jobim", "Hallelujah|Jeff Buckley"};
+    check(contents(withoutCharles) == expected, "operator-(Song&) remove só a versão do autor");
+
+    check(a.searchSong(Song("Yesterday", "Ray Charles")) == nullptr, "busca com outro autor não encontra");
+    Song *found = a.searchSong(Song("agua de beber", "TOM JOBIM"));
+    check(found != nullptr && found->getAuthorView() == TextView("Tom Jobim"), "busca com variação de acentos encontra");
+
+    b.removeSong(Song("Hallelujah", "Jeff Buckley"));
+    expected = {"Yesterday|Ray Charles", "HALLELUJAH|leonard cohen"};
+    check(contents(b) == expected, "remoção retira só o autor especificado");
+    b.removeSong(Song("Água de Beber ", "Tom Jobim"));
+    check(b.getSize() == 2, "remoção de música ausente não altera a playlist");
+}
+
+/**
+ * @brief Executa os testes.
+ *
+ * @return 0 se todos passarem, 1 caso contrário.
+ */
+int main(){
+    testSameTitleDifferentAuthors();
+    testTextVariants();
+    testSongSet();
+    testPlaylistOperations();
+
+    if(failures > 0){
+        std::cerr << failures << " verificações falharam\n";
+        return 1;
+    }
+    std::cout << "Todos os testes de identidade passaram\n";
+    return 0;
+}
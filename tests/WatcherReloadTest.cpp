@@ -0,0 +1,136 @@
+/**
+ * @file WatcherReloadTest.cpp
+ * @brief Testes da recarga de arquivos alterados (Watcher) com várias linhas
+ * para a mesma playlist.
+ *
+ * Acompanha um arquivo em uma pasta temporária e o reescreve algumas vezes,
+ * esperando cada recarga: acrescentar, apagar e editar uma de várias linhas
+ * com o mesmo nome deve mudar as músicas da playlist, e apagar todas as
+ * linhas deve removê-la. Retorna 0 se todos os testes passarem.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <unistd.h>
+#include "Song.hpp"
+#include "Playlist.hpp"
+#include "Library.hpp"
+#include "Watcher.hpp"
+
+//! Número de verificações que falharam.
+static int failures = 0;
+
+/**
+ * @brief Registra o resultado de uma verificação.
+ *
+ * @param condition Resultado esperado verdadeiro.
+ * @param description Descrição exibida se a verificação falhar.
+ */
+static void check(bool condition, const std::string &description){
+    if(!condition){
+        std::cerr << "Falhou: " << description << "\n";
+        failures++;
+    }
+}
+
+/**
+ * @brief Reescreve o arquivo e espera o Watcher recarregá-lo.
+ *
+ * @param watcher Watcher que acompanha o arquivo.
+ * @param path Caminho do arquivo.
+ * @param content Novo conteúdo.
+ * @return true se a recarga terminou sem erro em até 5 s.
+ */
+static bool rewrite(Watcher &watcher, const std::string &path, const std::string &content){
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+    for(int waited = 0; waited < 5000; waited += 20){
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::vector<Watcher::Reload> reloads = watcher.takeReports();
+        for(size_t i = 0; i < reloads.size(); i++){
+            if(reloads[i].path == path){
+                return reloads[i].error.empty();
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Retorna os títulos das músicas de uma playlist publicada, em ordem,
+ * separados por vírgulas.
+ *
+ * @param library Biblioteca.
+ * @param name Nome da playlist.
+ * @return Os títulos, ou "-" se a playlist não existe.
+ */
+static std::string titles(Library &library, const std::string &name){
+    std::shared_ptr<const Library::Snapshot> snapshot = library.snapshot();
+    const Playlist *playlist = snapshot->findPlaylist(name);
+    if(playlist == nullptr){
+        return "-";
+    }
+    std::string text;
+    for(const Node<Song> *curr = playlist->readSongs().getHead(); curr != nullptr; curr = curr->getNext()){
+        text += (text.empty() ? "" : ",") + curr->getValue().getTitleView().str();
+    }
+    return text;
+}
+
+/**
+ * @brief Executa os testes.
+ *
+ * @return 0 se todos os testes passarem, 1 caso contrário.
+ */
+int main(){
+    char dir[] = "/tmp/watcherReloadTestXXXXXX";
+    if(mkdtemp(dir) == nullptr){
+        std::cerr << "Erro: não foi possível criar a pasta temporária\n";
+        return 1;
+    }
+    std::string path = std::string(dir) + "/playlists.txt";
+    std::ofstream(path.c_str()).close();
+
+    Library library;
+    Watcher watcher(library);
+    if(!watcher.start(std::vector<std::string>(1, path))){
+        return 1;
+    }
+    // Espera a thread guardar as linhas iniciais (vazias) do arquivo
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    check(rewrite(watcher, path, "X;a:A,b:B\nX;c:C\nY;a:A\n"), "recarga com duas linhas para X");
+    check(titles(library, "X") == "a,b,c", "as duas linhas de X são unidas");
+
+    check(rewrite(watcher, path, "X;a:A,b:B\nY;a:A\n"), "recarga sem a segunda linha de X");
+    check(titles(library, "X") == "a,b", "apagar uma das linhas de X tira as músicas dela");
+    check(titles(library, "Y") == "a", "Y não muda");
+
+    check(rewrite(watcher, path, "X;a:A,b:B\nX;c:C\nY;a:A\n"), "recarga com a segunda linha de volta");
+    check(rewrite(watcher, path, "X;a:A,b:B\nX;d:D,a:A\nY;a:A\n"), "recarga com a segunda linha editada");
+    check(titles(library, "X") == "a,b,d", "editar uma das linhas de X troca as músicas dela");
+
+    check(rewrite(watcher, path, "X;d:D,a:A\nY;a:A\n"), "recarga sem a primeira linha de X");
+    check(titles(library, "X") == "d,a", "X passa a ter só as músicas da linha restante");
+
+    check(rewrite(watcher, path, "Y;a:A\n"), "recarga sem nenhuma linha de X");
+    check(titles(library, "X") == "-", "X sem linhas é removida");
+
+    watcher.stop();
+    unlink(path.c_str());
+    rmdir(dir);
+
+    if(failures > 0){
+        std::cerr << failures << " verificações falharam\n";
+        return 1;
+    }
+    std::cout << "Todos os testes de recarga passaram\n";
+    return 0;
+}